@@ -28,7 +28,10 @@
 #include "sticky/common/includes.h"
 
 #include "sticky/algorithm/isort.h"
+#include "sticky/algorithm/meshopt.h"
 #include "sticky/algorithm/qsort.h"
+#include "sticky/algorithm/rsort.h"
+#include "sticky/algorithm/skyline.h"
 
 #include "sticky/audio/listener.h"
 #include "sticky/audio/sound.h"
@@ -38,6 +41,7 @@
 #include "sticky/common/types.h"
 
 #include "sticky/collections/linkedlist.h"
+#include "sticky/collections/spatialhash.h"
 #include "sticky/collections/tree.h"
 
 #include "sticky/concurrency/mutex.h"
@@ -47,7 +51,10 @@
 #include "sticky/input/keyboard.h"
 #include "sticky/input/mouse.h"
 
+#include "sticky/math/bvh.h"
+#include "sticky/math/fastmath.h"
 #include "sticky/math/frustum.h"
+#include "sticky/math/hierarchy.h"
 #include "sticky/math/math.h"
 #include "sticky/math/mat3.h"
 #include "sticky/math/mat4.h"
@@ -63,14 +70,23 @@
 #include "sticky/net/socket.h"
 #include "sticky/net/tcp.h"
 
+#include "sticky/util/assets.h"
+#include "sticky/util/hash.h"
 #include "sticky/util/random.h"
 #include "sticky/util/string.h"
 
+#include "sticky/video/atlas.h"
 #include "sticky/video/camera.h"
 #include "sticky/video/draw.h"
 #include "sticky/video/font.h"
+#include "sticky/video/glstate.h"
 #include "sticky/video/mesh.h"
+#include "sticky/video/renderqueue.h"
 #include "sticky/video/shader.h"
+#include "sticky/video/spritebatch.h"
+#include "sticky/video/streambuffer.h"
+#include "sticky/video/texformat.h"
+#include "sticky/video/textmesh.h"
 #include "sticky/video/texture.h"
 #include "sticky/video/window.h"
 
@@ -0,0 +1,302 @@
+/*
+ * This file is licensed under BSD 3-Clause.
+ * All license information is available in the included COPYING file.
+ */
+
+/*
+ * meshopt.h
+ * Mesh optimisation header.
+ *
+ * Author       : Finn Rayment <finn@rayment.fr>
+ * Date created : 18/10/2026
+ */
+
+#ifndef FR_RAYMENT_STICKY_MESHOPT_H
+#define FR_RAYMENT_STICKY_MESHOPT_H 1
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+#include "sticky/common/defines.h"
+#include "sticky/common/types.h"
+
+/**
+ * @addtogroup meshopt
+ * @{
+ */
+
+/**
+ * @brief The size of the FIFO vertex cache used to measure a mesh.
+ *
+ * @hideinitializer
+ * @since 1.0.0
+ */
+#define S_MESHOPT_CACHE_SIZE         16
+
+/**
+ * @brief The default overdraw threshold of a mesh optimisation.
+ *
+ * @see {@link S_meshopt_overdraw} For the meaning of the threshold.
+ * @hideinitializer
+ * @since 1.0.0
+ */
+#define S_MESHOPT_OVERDRAW_THRESHOLD 1.05f
+
+/**
+ * @brief Mesh optimisation struct.
+ *
+ * Holds a copy of the geometry of an indexed triangle mesh on the CPU, so that
+ * it may be reordered before being uploaded with {@link S_mesh_new}:
+ *
+ * @code
+ * S_mesh_new(opt->vertices, opt->vcount * 3, opt->indices, opt->icount,
+ *            opt->normals, opt->normals ? opt->vcount * 3 : 0,
+ *            opt->uv, opt->uv ? opt->vcount * 2 : 0);
+ * @endcode
+ *
+ * @since 1.0.0
+ */
+typedef struct
+Smeshopt_s
+{
+	/**
+	 * @brief The positions of the vertices (3 per vertex).
+	 */
+	Sfloat *vertices;
+	/**
+	 * @brief The normals of the vertices (3 per vertex), or <c>NULL</c>.
+	 */
+	Sfloat *normals;
+	/**
+	 * @brief The UVs of the vertices (2 per vertex), or <c>NULL</c>.
+	 */
+	Sfloat *uv;
+	/**
+	 * @brief The indices of the triangles (3 per triangle).
+	 */
+	Suint32 *indices;
+	/**
+	 * @brief The number of vertices.
+	 */
+	Ssize_t vcount;
+	/**
+	 * @brief The number of indices.
+	 */
+	Ssize_t icount;
+} Smeshopt;
+
+/**
+ * @brief Mesh statistics struct.
+ *
+ * Describes how efficiently a mesh uses the post-transform vertex cache of the
+ * GPU, as simulated by a FIFO cache.
+ *
+ * @since 1.0.0
+ */
+typedef struct
+Smeshopt_stats_s
+{
+	/**
+	 * @brief The average cache miss ratio, which is the number of vertices
+	 * transformed per triangle.
+	 *
+	 * This is at most @f$3@f$, and approaches @f$0.5@f$ for a large and
+	 * well-ordered regular grid.
+	 */
+	Sfloat acmr;
+	/**
+	 * @brief The average transformed to vertex ratio, which is the number of
+	 * times each vertex is transformed.
+	 *
+	 * This is at least @f$1@f$ for a mesh whose vertices are all referenced.
+	 */
+	Sfloat atvr;
+} Smeshopt_stats;
+
+/**
+ * @brief Copy a mesh into a new mesh optimisation.
+ *
+ * The arguments are the same as those of {@link S_mesh_new}.
+ * If @p indices is <c>NULL</c>, every three vertices make a triangle.
+ *
+ * @param[in] vertices The array of vertices (3 per point).
+ * @param[in] vlen The number of elements in the @p vertices array.
+ * @param[in] indices The array of indices (3 per triangle), or <c>NULL</c>.
+ * @param[in] ilen The number of elements in the @p indices array.
+ * @param[in] normals The array of normals (3 per point), or <c>NULL</c>.
+ * @param[in] nlen The number of elements in the @p normals array.
+ * @param[in] uv The array of UV points (2 per point), or <c>NULL</c>.
+ * @param[in] uvlen The number of elements in the @p uv array.
+ * @return A new mesh optimisation allocated on the heap. To correctly destroy
+ * it, call {@link S_meshopt_delete(Smeshopt *)}.
+ * @exception S_INVALID_VALUE If @p vertices is <c>NULL</c>, @p vlen is equal to
+ * 0, any of @p indices, @p normals or @p uv are <c>NULL</c> but their lengths
+ * are not 0, @p normals or @p uv hold fewer points than @p vertices, the
+ * number of indices is not a multiple of 3 or an index is out of range.
+ * @since 1.0.0
+ */
+STICKY_API Smeshopt *S_meshopt_new(const Sfloat *, Ssize_t,
+                                   const Suint32 *, Ssize_t,
+                                   const Sfloat *, Ssize_t,
+                                   const Sfloat *, Ssize_t);
+
+/**
+ * @brief Free a mesh optimisation from memory.
+ *
+ * @param[in,out] opt The mesh optimisation to free from memory.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid mesh optimisation is
+ * provided to the function.
+ * @since 1.0.0
+ */
+STICKY_API void      S_meshopt_delete(Smeshopt *);
+
+/**
+ * @brief Merge identical vertices.
+ *
+ * Vertices whose position, normal and UV are all bitwise equal are merged into
+ * one, and the indices are updated to match. The order of the remaining
+ * vertices is kept.
+ *
+ * @param[in,out] opt The mesh optimisation.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid mesh optimisation is
+ * provided to the function.
+ * @since 1.0.0
+ */
+STICKY_API void      S_meshopt_deduplicate(Smeshopt *);
+
+/**
+ * @brief Reorder triangles for the post-transform vertex cache.
+ *
+ * Reorders the triangles with Forsyth's linear-speed vertex cache optimisation,
+ * so that triangles sharing vertices are drawn close together and those
+ * vertices are only transformed once.
+ *
+ * @param[in,out] opt The mesh optimisation.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid mesh optimisation is
+ * provided to the function.
+ * @since 1.0.0
+ */
+STICKY_API void      S_meshopt_vertex_cache(Smeshopt *);
+
+/**
+ * @brief Reorder triangles to reduce overdraw.
+ *
+ * This should be called after {@link S_meshopt_vertex_cache}. The triangles
+ * are split into clusters, each of which keeps its order, and the clusters
+ * are sorted so that those facing away from the centre of the mesh are drawn
+ * first. Such clusters are the most likely to occlude the rest of the mesh,
+ * whose fragments then fail the depth test early.
+ *
+ * Smaller clusters sort better but cost more vertex cache misses. A cluster
+ * is ended as soon as its average cache miss ratio is within @p threshold
+ * times that of the whole mesh, so the ratio of the mesh grows by at most that
+ * factor.
+ *
+ * @param[in,out] opt The mesh optimisation.
+ * @param[in] threshold The allowed growth in the average cache miss ratio, at
+ * least @f$1@f$.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid mesh optimisation is
+ * provided to the function, or if @p threshold is less than @f$1@f$.
+ * @since 1.0.0
+ */
+STICKY_API void      S_meshopt_overdraw(Smeshopt *, Sfloat);
+
+/**
+ * @brief Reorder vertices for vertex fetch locality.
+ *
+ * The vertices are renumbered in the order in which the indices first refer to
+ * them, so that the GPU reads the vertex buffer close to sequentially.
+ * Vertices which are not referenced by any triangle are removed.
+ *
+ * This should be the last reordering, since it follows the triangle order.
+ *
+ * @param[in,out] opt The mesh optimisation.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid mesh optimisation is
+ * provided to the function.
+ * @since 1.0.0
+ */
+STICKY_API void      S_meshopt_vertex_fetch(Smeshopt *);
+
+/**
+ * @brief Run every optimisation on a mesh.
+ *
+ * Calls, in order, {@link S_meshopt_deduplicate},
+ * {@link S_meshopt_vertex_cache}, {@link S_meshopt_overdraw} with
+ * {@link S_MESHOPT_OVERDRAW_THRESHOLD} and {@link S_meshopt_vertex_fetch}.
+ *
+ * The statistics of the mesh before and after, measured with a cache of
+ * {@link S_MESHOPT_CACHE_SIZE} vertices, are written to @p before and
+ * @p after if they are not <c>NULL</c>.
+ *
+ * @param[in,out] opt The mesh optimisation.
+ * @param[out] before The statistics of the mesh before optimisation, or
+ * <c>NULL</c>.
+ * @param[out] after The statistics of the mesh after optimisation, or
+ * <c>NULL</c>.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid mesh optimisation is
+ * provided to the function.
+ * @since 1.0.0
+ */
+STICKY_API void      S_meshopt_optimize(Smeshopt *, Smeshopt_stats *,
+                                        Smeshopt_stats *);
+
+/**
+ * @brief Measure the vertex cache efficiency of a mesh.
+ *
+ * @param[in] opt The mesh optimisation.
+ * @param[in] cache_size The number of vertices in the simulated FIFO cache.
+ * @param[out] stats The output statistics.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid mesh optimisation or
+ * statistics struct is provided to the function, or if @p cache_size is equal
+ * to 0.
+ * @since 1.0.0
+ */
+STICKY_API void      S_meshopt_analyze(const Smeshopt *, Suint32,
+                                       Smeshopt_stats *);
+
+/**
+ * @brief Simplify a mesh into a level of detail.
+ *
+ * Edges are collapsed in order of the error they introduce, measured with the
+ * quadric error metric of Garland and Heckbert, until at most @p target
+ * indices remain or no edge can be collapsed within @p max_error. Each edge is
+ * collapsed onto one of its existing vertices, so the simplified indices
+ * refer to the vertices of the mesh optimisation unchanged and every level of
+ * detail of a mesh may share its vertex buffer, such as with
+ * {@link S_mesh_set_lod}.
+ *
+ * Vertices on an open border of the mesh, or which share a position with
+ * another vertex such as along a UV seam, are never moved, and collapses which
+ * would turn a triangle over are rejected.
+ *
+ * The mesh optimisation itself is not modified.
+ *
+ * @param[in] opt The mesh optimisation.
+ * @param[in] target The number of indices to reduce the mesh to.
+ * @param[in] max_error The largest distance that any collapse may move the
+ * surface, in the units of the vertices.
+ * @param[out] out The simplified indices, which must have room for all of the
+ * indices of @p opt.
+ * @param[out] error The largest distance that the surface was moved, or
+ * <c>NULL</c>.
+ * @return The number of indices written to @p out, which may be greater than
+ * @p target if the limit of @p max_error was reached.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid mesh optimisation or
+ * output array is provided to the function, or if @p max_error is negative.
+ * @since 1.0.0
+ */
+STICKY_API Ssize_t   S_meshopt_simplify(const Smeshopt *, Ssize_t, Sfloat,
+                                        Suint32 *, Sfloat *);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* FR_RAYMENT_STICKY_MESHOPT_H */
+
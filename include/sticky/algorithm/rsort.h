@@ -0,0 +1,67 @@
+/*
+ * This file is licensed under BSD 3-Clause.
+ * All license information is available in the included COPYING file.
+ */
+
+/*
+ * rsort.h
+ * Radix sort algorithm header.
+ *
+ * Author       : Finn Rayment <finn@rayment.fr>
+ * Date created : 18/10/2026
+ */
+
+#ifndef FR_RAYMENT_STICKY_RSORT_H
+#define FR_RAYMENT_STICKY_RSORT_H 1
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+#include "sticky/common/defines.h"
+#include "sticky/common/types.h"
+
+/**
+ * @addtogroup sort
+ * @{
+ */
+
+/**
+ * @brief Sort an array of 64-bit keys and their values using the radix sort
+ * algorithm.
+ *
+ * The keys are sorted in ascending order, one byte at a time from the least
+ * significant byte, in @f$O(n)@f$ time. Bytes that are equal across every key
+ * are skipped. The sort is stable, so keys that are equal keep their relative
+ * order.
+ *
+ * Each key may be accompanied by a 32-bit value, such as an index into another
+ * array, which is moved along with its key. Scratch arrays of the same length
+ * as the input must be provided, so that the sort does not allocate memory.
+ *
+ * @param[in,out] keys The array of keys to sort.
+ * @param[in,out] values The array of values to move along with the keys, or
+ * <c>NULL</c>.
+ * @param[in] elems The number of elements in the arrays.
+ * @param[out] tmpkeys A scratch array of at least @p elems keys.
+ * @param[out] tmpvalues A scratch array of at least @p elems values, or
+ * <c>NULL</c> if @p values is <c>NULL</c>.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> key or scratch key array is
+ * provided to the function, or if only one of @p values and @p tmpvalues is
+ * <c>NULL</c>.
+ * @exception S_INVALID_OPERATION If @p elems is equal to <c>0</c>.
+ * @since 1.0.0
+ */
+STICKY_API void S_rsort(Suint64 *, Suint32 *, Ssize_t, Suint64 *, Suint32 *);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* FR_RAYMENT_STICKY_RSORT_H */
+
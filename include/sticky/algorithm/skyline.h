@@ -0,0 +1,144 @@
+/*
+ * This file is licensed under BSD 3-Clause.
+ * All license information is available in the included COPYING file.
+ */
+
+/*
+ * skyline.h
+ * Skyline rectangle packing header.
+ *
+ * Author       : Finn Rayment <finn@rayment.fr>
+ * Date created : 18/10/2026
+ */
+
+#ifndef FR_RAYMENT_STICKY_SKYLINE_H
+#define FR_RAYMENT_STICKY_SKYLINE_H 1
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+#include "sticky/common/defines.h"
+#include "sticky/common/types.h"
+
+/**
+ * @addtogroup skyline
+ * @{
+ */
+
+/**
+ * @brief Skyline segment struct.
+ *
+ * A horizontal segment of the skyline, below which the area is taken.
+ *
+ * @since 1.0.0
+ */
+typedef struct
+Sskyline_node_s
+{
+	Suint32 x, y, width;
+} Sskyline_node;
+
+/**
+ * @brief Skyline packer struct.
+ *
+ * Packs rectangles into a fixed area by keeping only the upper outline of the
+ * rectangles packed so far, as a flat array of segments sorted from left to
+ * right. Each rectangle is placed where its top edge would be lowest, which
+ * wastes little space when rectangles of similar heights are packed, such as
+ * the glyphs of a font.
+ *
+ * Since the skyline has at most one segment per packed rectangle, packing is
+ * linear in the number of rectangles packed so far and needs no allocation
+ * beyond growing the array of segments.
+ *
+ * @since 1.0.0
+ */
+typedef struct
+Sskyline_s
+{
+	Sskyline_node *nodes;
+	Ssize_t len, cap;
+	Suint32 width, height;
+	Suint64 area;
+} Sskyline;
+
+/**
+ * @brief Create a new skyline packer.
+ *
+ * @param[in] width The width of the area to pack into.
+ * @param[in] height The height of the area to pack into.
+ * @return A new empty skyline packer allocated on the heap. To correctly
+ * destroy it, call {@link S_skyline_delete(Sskyline *)}.
+ * @exception S_INVALID_VALUE If @p width or @p height are equal to 0.
+ * @since 1.0.0
+ */
+STICKY_API Sskyline *S_skyline_new(Suint32, Suint32);
+
+/**
+ * @brief Free a skyline packer from memory.
+ *
+ * @param[in,out] skyline The skyline packer to free from memory.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid skyline packer is
+ * provided to the function.
+ * @since 1.0.0
+ */
+STICKY_API void      S_skyline_delete(Sskyline *);
+
+/**
+ * @brief Empty a skyline packer.
+ *
+ * Every rectangle which was packed is forgotten, so that the whole area may be
+ * packed again.
+ *
+ * @param[in,out] skyline The skyline packer.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid skyline packer is
+ * provided to the function.
+ * @since 1.0.0
+ */
+STICKY_API void      S_skyline_clear(Sskyline *);
+
+/**
+ * @brief Pack a rectangle.
+ *
+ * Rectangles are never moved once packed, and never overlap each other or the
+ * edges of the area.
+ *
+ * @param[in,out] skyline The skyline packer.
+ * @param[in] width The width of the rectangle.
+ * @param[in] height The height of the rectangle.
+ * @param[out] x The @f$x@f$ position of the packed rectangle.
+ * @param[out] y The @f$y@f$ position of the packed rectangle.
+ * @return {@link S_TRUE} if the rectangle was packed, or {@link S_FALSE} if
+ * there is no room left for it, in which case @p x and @p y are not written.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid skyline packer or
+ * position is provided to the function, or if @p width or @p height are equal
+ * to 0.
+ * @since 1.0.0
+ */
+STICKY_API Sbool     S_skyline_pack(Sskyline *, Suint32, Suint32,
+                                    Suint32 *, Suint32 *);
+
+/**
+ * @brief Get the fraction of the area of a skyline packer that is packed.
+ *
+ * @param[in] skyline The skyline packer.
+ * @return The total area of the packed rectangles divided by the area of the
+ * packer, between @f$0@f$ and @f$1@f$.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid skyline packer is
+ * provided to the function.
+ * @since 1.0.0
+ */
+STICKY_API Sfloat    S_skyline_get_occupancy(const Sskyline *);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* FR_RAYMENT_STICKY_SKYLINE_H */
+
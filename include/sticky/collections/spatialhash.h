@@ -0,0 +1,257 @@
+/*
+ * This file is licensed under BSD 3-Clause.
+ * All license information is available in the included COPYING file.
+ */
+
+/*
+ * spatialhash.h
+ * Spatial hash header.
+ *
+ * Author       : Finn Rayment <finn@rayment.fr>
+ * Date created : 18/10/2026
+ */
+
+#ifndef FR_RAYMENT_STICKY_SPATIALHASH_H
+#define FR_RAYMENT_STICKY_SPATIALHASH_H 1
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+#include "sticky/common/defines.h"
+#include "sticky/common/types.h"
+#include "sticky/math/vec3.h"
+
+/**
+ * @addtogroup spatialhash
+ * @{
+ */
+
+/**
+ * @brief Handle value representing no entry.
+ *
+ * Returned in place of a handle whenever an entry could not be inserted.
+ *
+ * @hideinitializer
+ * @since 1.0.0
+ */
+#define S_SPATIALHASH_NONE S_UINT32_MAX
+
+typedef struct
+_Sspatialhash_entry_s
+{
+	Svec3 pos;
+	Sfloat radius;
+	void *ptr;
+	Sint32 x, y, z;
+	Suint32 bucket, next, last;
+} _Sspatialhash_entry;
+
+/**
+ * @brief Spatial hash struct.
+ *
+ * A spatial hash divides space into a uniform grid of cubic cells and stores
+ * each entry in the cell that contains its centre. Only cells that contain
+ * entries consume memory, as cells are hashed into a fixed number of buckets
+ * that grows with the number of entries.
+ *
+ * Entries are stored in a single pool and linked into their bucket by index,
+ * so that inserting, moving and removing an entry each take @f$O(1)@f$ time
+ * regardless of the number of entries, except for removing the last entry of
+ * the largest radius. Moving an entry within its cell only updates its
+ * position.
+ *
+ * Each entry has a radius and queries are expanded by the largest radius of
+ * the entries held, so that the grid is <i>loose</i>: an entry never needs to
+ * be stored in more than one cell. For the best performance, the cell size
+ * should be around twice the typical query radius and no smaller than the
+ * largest entry.
+ *
+ * Entries are referred to by stable handles that remain valid until the entry
+ * is removed.
+ *
+ * Queries do not modify the spatial hash and may be run from several threads
+ * at once, so long as entries are not inserted, moved or removed at the same
+ * time.
+ *
+ * @warning The spatial hash is not thread safe for writing. To ensure
+ * synchronisation across threads, {@link Smutex} must be used to synchronise
+ * modifications of the spatial hash.
+ *
+ * @since 1.0.0
+ */
+typedef struct
+Sspatialhash_s
+{
+	_Sspatialhash_entry *entries;
+	Suint32 *buckets;
+	Sfloat cellsize, invcellsize, maxradius;
+	Suint32 len, cap, free, nbuckets, nmaxradius;
+} Sspatialhash;
+
+/**
+ * @brief Create a new spatial hash.
+ *
+ * Allocates a new, empty spatial hash to the heap with a given cell size.
+ *
+ * @param[in] cellsize The length of each side of a cell.
+ * @return A new spatial hash allocated on the heap, or <c>NULL</c> if the cell
+ * size is invalid. To correctly destroy the spatial hash, call
+ * {@link S_spatialhash_delete(Sspatialhash *)}.
+ * @exception S_INVALID_VALUE If @p cellsize is not greater than zero.
+ * @since 1.0.0
+ */
+STICKY_API Sspatialhash *S_spatialhash_new(Sfloat);
+
+/**
+ * @brief Free a spatial hash from memory.
+ *
+ * The user pointers of each entry are not freed.
+ *
+ * @param[in,out] hash The spatial hash to free from memory.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid spatial hash is
+ * provided to the function.
+ * @since 1.0.0
+ */
+STICKY_API void     S_spatialhash_delete(Sspatialhash *);
+
+/**
+ * @brief Remove all entries from a spatial hash.
+ *
+ * Every handle previously returned by the spatial hash becomes invalid.
+ *
+ * @param[in,out] hash The spatial hash to clear.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid spatial hash is
+ * provided to the function.
+ * @since 1.0.0
+ */
+STICKY_API void     S_spatialhash_clear(Sspatialhash *);
+
+/**
+ * @brief Insert an entry into a spatial hash.
+ *
+ * @param[in,out] hash The spatial hash to insert into.
+ * @param[in] pos The position of the centre of the entry.
+ * @param[in] radius The radius of the entry, or zero for a point.
+ * @param[in] ptr A user pointer to associate with the entry, or <c>NULL</c>.
+ * @return The handle of the new entry, or {@link S_SPATIALHASH_NONE} on error.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid spatial hash or
+ * position is provided to the function, or if @p radius is negative.
+ * @since 1.0.0
+ */
+STICKY_API Suint32  S_spatialhash_insert(Sspatialhash *, const Svec3 *, Sfloat,
+                                         void *);
+
+/**
+ * @brief Move an entry within a spatial hash.
+ *
+ * @param[in,out] hash The spatial hash.
+ * @param[in] handle The handle of the entry to move.
+ * @param[in] pos The new position of the centre of the entry.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid spatial hash or
+ * position is provided to the function.
+ * @exception S_INVALID_INDEX If @p handle does not refer to an entry.
+ * @since 1.0.0
+ */
+STICKY_API void     S_spatialhash_move(Sspatialhash *, Suint32, const Svec3 *);
+
+/**
+ * @brief Remove an entry from a spatial hash.
+ *
+ * The handle of the entry becomes invalid and may be reused by a later
+ * insertion.
+ *
+ * Removing the last entry with the largest radius finds the largest radius of
+ * the remaining entries, which takes @f$O(n)@f$ time, so that later queries are
+ * no longer expanded by the radius of an entry which is gone.
+ *
+ * @param[in,out] hash The spatial hash.
+ * @param[in] handle The handle of the entry to remove.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid spatial hash is
+ * provided to the function.
+ * @exception S_INVALID_INDEX If @p handle does not refer to an entry.
+ * @since 1.0.0
+ */
+STICKY_API void     S_spatialhash_remove(Sspatialhash *, Suint32);
+
+/**
+ * @brief Get the user pointer of an entry in a spatial hash.
+ *
+ * @param[in] hash The spatial hash.
+ * @param[in] handle The handle of the entry.
+ * @return The user pointer given when the entry was inserted.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid spatial hash is
+ * provided to the function.
+ * @exception S_INVALID_INDEX If @p handle does not refer to an entry.
+ * @since 1.0.0
+ */
+STICKY_API void    *S_spatialhash_get(const Sspatialhash *, Suint32);
+
+/**
+ * @brief Get the number of entries in a spatial hash.
+ *
+ * @param[in] hash The spatial hash.
+ * @return The number of entries.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid spatial hash is
+ * provided to the function.
+ * @since 1.0.0
+ */
+STICKY_API Ssize_t  S_spatialhash_size(const Sspatialhash *);
+
+/**
+ * @brief Find all entries within a radius of a point.
+ *
+ * Finds every entry whose sphere intersects the sphere of radius @p radius
+ * centred on @p centre.
+ *
+ * At most @p max handles are written to @p out, in no particular order, but the
+ * total number of entries found is returned.
+ *
+ * @param[in] hash The spatial hash.
+ * @param[in] centre The centre of the query sphere.
+ * @param[in] radius The radius of the query sphere.
+ * @param[out] out The output array of handles.
+ * @param[in] max The maximum number of handles to write to @p out.
+ * @return The number of entries found.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid spatial hash, vector
+ * or array is provided to the function, or if @p radius is negative.
+ * @since 1.0.0
+ */
+STICKY_API Ssize_t  S_spatialhash_query_radius(const Sspatialhash *,
+                                               const Svec3 *, Sfloat,
+                                               Suint32 *, Ssize_t);
+
+/**
+ * @brief Find all entries that overlap a bounding box.
+ *
+ * Finds every entry whose sphere intersects the box bounded by @p min and
+ * @p max.
+ *
+ * At most @p outmax handles are written to @p out, in no particular order, but
+ * the total number of entries found is returned.
+ *
+ * @param[in] hash The spatial hash.
+ * @param[in] min The minimum corner of the box.
+ * @param[in] max The maximum corner of the box.
+ * @param[out] out The output array of handles.
+ * @param[in] outmax The maximum number of handles to write to @p out.
+ * @return The number of entries found.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid spatial hash, vector
+ * or array is provided to the function.
+ * @since 1.0.0
+ */
+STICKY_API Ssize_t  S_spatialhash_query_bounds(const Sspatialhash *,
+                                               const Svec3 *, const Svec3 *,
+                                               Suint32 *, Ssize_t);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* FR_RAYMENT_STICKY_SPATIALHASH_H */
+
@@ -42,6 +42,7 @@
 /* FreeType */
 #include <ft2build.h>
 #include FT_FREETYPE_H
+#include FT_MODULE_H
 
 #endif /* FR_RAYMENT_STICKY_INCLUDES_H */
 
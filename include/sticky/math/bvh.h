@@ -0,0 +1,246 @@
+/*
+ * This file is licensed under BSD 3-Clause.
+ * All license information is available in the included COPYING file.
+ */
+
+/*
+ * bvh.h
+ * Bounding volume hierarchy header.
+ *
+ * Author       : Finn Rayment <finn@rayment.fr>
+ * Date created : 18/10/2026
+ */
+
+#ifndef FR_RAYMENT_STICKY_BVH_H
+#define FR_RAYMENT_STICKY_BVH_H 1
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+#include "sticky/common/defines.h"
+#include "sticky/common/types.h"
+#include "sticky/math/frustum.h"
+#include "sticky/math/vec3.h"
+
+/**
+ * @addtogroup bvh
+ * @{
+ */
+
+typedef struct
+_Sbvh_node_s
+{
+	Svec3 min, max;
+	Suint32 first, count;
+} _Sbvh_node;
+
+/**
+ * @brief Bounding volume hierarchy.
+ *
+ * A bounding volume hierarchy (BVH) is a binary tree of axis-aligned bounding
+ * boxes used to accelerate spatial queries over a set of primitives, such as
+ * the bounds of every model in a scene. Each primitive is identified by its
+ * index in the arrays passed to
+ * {@link S_bvh_build(Sbvh *, const Svec3 *, const Svec3 *, Ssize_t)}.
+ *
+ * The tree is built with the surface area heuristic (SAH), which minimises the
+ * expected cost of a query, and its nodes are stored in a single flat array
+ * where the two children of a node are adjacent.
+ *
+ * When primitives move, their bounds may be updated and the tree refitted
+ * without rebuilding it. Refitting is much cheaper than a full build, but the
+ * quality of the tree degrades as primitives move far from where they were at
+ * build time, at which point the tree should be rebuilt.
+ *
+ * Queries do not modify the tree and may be run from several threads at once,
+ * so long as the tree is not built or refitted at the same time.
+ *
+ * @since 1.0.0
+ */
+typedef struct
+Sbvh_s
+{
+	_Sbvh_node *nodes;
+	Svec3 *mins, *maxs;
+	Suint32 *prims;
+	Suint32 len, nlen;
+} Sbvh;
+
+/**
+ * @brief Create a new bounding volume hierarchy.
+ *
+ * Allocates a new, empty bounding volume hierarchy on the heap.
+ *
+ * @return A new bounding volume hierarchy allocated on the heap. To correctly
+ * destroy the hierarchy, call {@link S_bvh_delete(Sbvh *)}.
+ * @since 1.0.0
+ */
+STICKY_API Sbvh   *S_bvh_new(void);
+
+/**
+ * @brief Free a bounding volume hierarchy from memory.
+ *
+ * @param[in,out] bvh The bounding volume hierarchy to free from memory.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid bounding volume
+ * hierarchy is provided to the function.
+ * @since 1.0.0
+ */
+STICKY_API void    S_bvh_delete(Sbvh *);
+
+/**
+ * @brief Build a bounding volume hierarchy.
+ *
+ * Builds the hierarchy from @p len primitive bounding boxes, replacing any
+ * previous contents. The bounds are copied into the hierarchy.
+ *
+ * @param[in,out] bvh The bounding volume hierarchy to build.
+ * @param[in] mins An array of @p len minimum box corners.
+ * @param[in] maxs An array of @p len maximum box corners.
+ * @param[in] len The number of primitives.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid bounding volume
+ * hierarchy or array is provided to the function, or if @p len is too large.
+ * @since 1.0.0
+ */
+STICKY_API void    S_bvh_build(Sbvh *, const Svec3 *, const Svec3 *, Ssize_t);
+
+/**
+ * @brief Update the bounds of a primitive in a bounding volume hierarchy.
+ *
+ * The change does not take effect on queries until
+ * {@link S_bvh_refit(Sbvh *)} is called.
+ *
+ * @param[in,out] bvh The bounding volume hierarchy.
+ * @param[in] idx The index of the primitive.
+ * @param[in] min The new minimum box corner.
+ * @param[in] max The new maximum box corner.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid bounding volume
+ * hierarchy or vector is provided to the function.
+ * @exception S_INVALID_INDEX If @p idx is out of range.
+ * @since 1.0.0
+ */
+STICKY_API void    S_bvh_set_bounds(Sbvh *, Ssize_t,
+                                    const Svec3 *, const Svec3 *);
+
+/**
+ * @brief Refit a bounding volume hierarchy to updated primitive bounds.
+ *
+ * Recomputes the bounds of every node from the current bounds of the
+ * primitives, keeping the structure of the tree.
+ *
+ * @param[in,out] bvh The bounding volume hierarchy to refit.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid bounding volume
+ * hierarchy is provided to the function.
+ * @since 1.0.0
+ */
+STICKY_API void    S_bvh_refit(Sbvh *);
+
+/**
+ * @brief Get the number of primitives in a bounding volume hierarchy.
+ *
+ * @param[in] bvh The bounding volume hierarchy.
+ * @return The number of primitives.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid bounding volume
+ * hierarchy is provided to the function.
+ * @since 1.0.0
+ */
+STICKY_API Ssize_t S_bvh_size(const Sbvh *);
+
+/**
+ * @brief Find all primitives that lie within a frustum.
+ *
+ * Finds every primitive whose bounding box lies within or intersects
+ * @p frustum. Subtrees that lie entirely within the frustum are accepted
+ * without testing their primitives.
+ *
+ * At most @p max indices are written to @p out, in no particular order, but the
+ * total number of primitives found is returned.
+ *
+ * @param[in] bvh The bounding volume hierarchy.
+ * @param[in] frustum The frustum.
+ * @param[out] out The output array of primitive indices.
+ * @param[in] max The maximum number of indices to write to @p out.
+ * @return The number of primitives found.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid bounding volume
+ * hierarchy, frustum or array is provided to the function.
+ * @since 1.0.0
+ */
+STICKY_API Ssize_t S_bvh_query_frustum(const Sbvh *, const Sfrustum *,
+                                       Ssize_t *, Ssize_t);
+
+/**
+ * @brief Find all primitives that overlap a bounding box.
+ *
+ * At most @p max indices are written to @p out, in no particular order, but the
+ * total number of primitives found is returned.
+ *
+ * @param[in] bvh The bounding volume hierarchy.
+ * @param[in] min The minimum corner of the box.
+ * @param[in] max The maximum corner of the box.
+ * @param[out] out The output array of primitive indices.
+ * @param[in] outmax The maximum number of indices to write to @p out.
+ * @return The number of primitives found.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid bounding volume
+ * hierarchy, vector or array is provided to the function.
+ * @since 1.0.0
+ */
+STICKY_API Ssize_t S_bvh_query_bounds(const Sbvh *, const Svec3 *,
+                                      const Svec3 *, Ssize_t *, Ssize_t);
+
+/**
+ * @brief Find the first primitive hit by a ray.
+ *
+ * Casts a ray from @p origin in direction @p dir and finds the primitive whose
+ * bounding box is entered first, within a distance of @p maxdist. The
+ * direction does not need to be normalised, however distances are measured in
+ * multiples of its length.
+ *
+ * If the origin lies within a bounding box, that primitive is hit at a distance
+ * of zero.
+ *
+ * @param[in] bvh The bounding volume hierarchy.
+ * @param[in] origin The origin of the ray.
+ * @param[in] dir The direction of the ray.
+ * @param[in] maxdist The maximum distance along the ray.
+ * @param[out] hit The index of the primitive hit.
+ * @param[out] dist The distance along the ray to the primitive, or
+ * <c>NULL</c>.
+ * @return {@link S_TRUE} if a primitive was hit, otherwise {@link S_FALSE}.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid bounding volume
+ * hierarchy or vector is provided to the function.
+ * @since 1.0.0
+ */
+STICKY_API Sbool   S_bvh_raycast(const Sbvh *, const Svec3 *, const Svec3 *,
+                                 Sfloat, Ssize_t *, Sfloat *);
+
+/**
+ * @brief Find the primitive nearest to a point.
+ *
+ * Finds the primitive whose bounding box is closest to @p point. If the point
+ * lies within one or more bounding boxes, one of those primitives is returned
+ * with a distance of zero.
+ *
+ * @param[in] bvh The bounding volume hierarchy.
+ * @param[in] point The point.
+ * @param[out] hit The index of the nearest primitive.
+ * @param[out] dist The distance to the nearest primitive, or <c>NULL</c>.
+ * @return {@link S_TRUE} if a primitive was found, otherwise {@link S_FALSE}
+ * if the hierarchy is empty.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid bounding volume
+ * hierarchy or vector is provided to the function.
+ * @since 1.0.0
+ */
+STICKY_API Sbool   S_bvh_nearest(const Sbvh *, const Svec3 *, Ssize_t *,
+                                 Sfloat *);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* FR_RAYMENT_STICKY_BVH_H */
+
@@ -0,0 +1,241 @@
+/*
+ * This file is licensed under BSD 3-Clause.
+ * All license information is available in the included COPYING file.
+ */
+
+/*
+ * fastmath.h
+ * Fast approximate math header.
+ *
+ * Author       : Finn Rayment <finn@rayment.fr>
+ * Date created : 18/10/2026
+ */
+
+#ifndef FR_RAYMENT_STICKY_FASTMATH_H
+#define FR_RAYMENT_STICKY_FASTMATH_H 1
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+#include <string.h>
+
+#include "sticky/common/types.h"
+#include "sticky/math/math.h"
+
+#if defined(__SSE__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+#include <xmmintrin.h>
+#define _S_FASTMATH_SSE 1
+#endif /* __SSE__ || _M_X64 || _M_IX86_FP >= 1 */
+
+/**
+ * @addtogroup fastmath
+ * @{
+ */
+
+/* split of pi such that m*hi is exact for half-integers |m| < 2^15 */
+#define _S_FASTMATH_PI_HI 3.140625f
+#define _S_FASTMATH_PI_LO 0.0009676535897932f
+#define _S_FASTMATH_INVPI 0.3183098861837907f
+
+/**
+ * @brief Calculate the approximate reciprocal square root of a
+ * single-precision floating-point number.
+ *
+ * On x86, this uses the hardware reciprocal square root estimate refined with
+ * one Newton-Raphson step. Elsewhere, an integer estimate is refined with two
+ * Newton-Raphson steps.
+ *
+ * The relative error is at most @f$5\times10^{-6}@f$ for all positive normal
+ * inputs.
+ *
+ * @param[in] x A positive single-precision floating-point number.
+ * @return @f$\frac{1}{\sqrt{x}}@f$
+ * @since 1.0.0
+ */
+static inline
+Sfloat
+S_fast_rsqrt(Sfloat x)
+{
+#ifdef _S_FASTMATH_SSE
+	Sfloat y;
+	y = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(x)));
+	return y * (1.5f - 0.5f * x * y * y);
+#else /* _S_FASTMATH_SSE */
+	Suint32 i;
+	Sfloat y;
+	memcpy(&i, &x, sizeof(Sfloat));
+	i = 0x5f375a86u - (i >> 1);
+	memcpy(&y, &i, sizeof(Sfloat));
+	y = y * (1.5f - 0.5f * x * y * y);
+	return y * (1.5f - 0.5f * x * y * y);
+#endif /* _S_FASTMATH_SSE */
+}
+
+/* round to the nearest integer without branching */
+static inline
+Sint32
+_S_fast_round(Sfloat x)
+{
+	Sint32 i;
+	x += 0.5f;
+	i = (Sint32) x;
+	return i - ((Sfloat) i > x);
+}
+
+/* sine of x in [-pi/2,pi/2], negated if k is odd */
+static inline
+Sfloat
+_S_fast_sin_poly(Sfloat x,
+                 Sint32 k)
+{
+	Sfloat x2;
+	x2 = x * x;
+	x *= 1.0f - (Sfloat) ((k & 1) << 1);
+	return x * (9.999999765e-1f + x2 * (-1.666664759e-1f +
+	       x2 * (8.332899206e-3f + x2 * (-1.980086437e-4f +
+	       x2 * 2.590428344e-6f))));
+}
+
+/**
+ * @brief Calculate the approximate sine of a single-precision floating-point
+ * number.
+ *
+ * The argument is reduced to @f$[-\frac{\pi}{2},\frac{\pi}{2}]@f$ and
+ * evaluated with a 9th degree minimax polynomial, without branching.
+ *
+ * The absolute error is at most @f$5\times10^{-7}@f$ for
+ * @f$\vert x\vert\leq10^4@f$.
+ *
+ * @param[in] x An angle in radians.
+ * @return @f$\sin(x)@f$
+ * @since 1.0.0
+ */
+static inline
+Sfloat
+S_fast_sin(Sfloat x)
+{
+	Sfloat m;
+	Sint32 k;
+	/* x = k*pi + r, sin(x) = (-1)^k * sin(r) */
+	k = _S_fast_round(x * _S_FASTMATH_INVPI);
+	m = (Sfloat) k;
+	x = (x - m * _S_FASTMATH_PI_HI) - m * _S_FASTMATH_PI_LO;
+	return _S_fast_sin_poly(x, k);
+}
+
+/**
+ * @brief Calculate the approximate cosine of a single-precision floating-point
+ * number.
+ *
+ * The absolute error is at most @f$5\times10^{-7}@f$ for
+ * @f$\vert x\vert\leq10^4@f$.
+ *
+ * @param[in] x An angle in radians.
+ * @return @f$\cos(x)@f$
+ * @since 1.0.0
+ */
+static inline
+Sfloat
+S_fast_cos(Sfloat x)
+{
+	Sfloat m;
+	Sint32 k;
+	/* x = (k+1/2)*pi + r, cos(x) = (-1)^(k+1) * sin(r) */
+	k = _S_fast_round(x * _S_FASTMATH_INVPI - 0.5f);
+	m = (Sfloat) k + 0.5f;
+	x = (x - m * _S_FASTMATH_PI_HI) - m * _S_FASTMATH_PI_LO;
+	return _S_fast_sin_poly(x, k + 1);
+}
+
+/**
+ * @brief Calculate the approximate inverse cosine of a single-precision
+ * floating-point number.
+ *
+ * Uses the approximation of Abramowitz and Stegun (4.4.46). Inputs outside of
+ * @f$[-1,1]@f$ are clamped.
+ *
+ * The absolute error is at most @f$5\times10^{-7}@f$.
+ *
+ * @param[in] x A single-precision floating-point number.
+ * @return @f$\cos^{-1}(x)@f$
+ * @since 1.0.0
+ */
+static inline
+Sfloat
+S_fast_arccos(Sfloat x)
+{
+	Sfloat a, r;
+	a = S_min(S_abs(x), 1.0f);
+	r = 1.5707963050f + a * (-0.2145988016f + a * (0.0889789874f +
+	    a * (-0.0501743046f + a * (0.0308918810f + a * (-0.0170881256f +
+	    a * (0.0066700901f + a * -0.0012624911f))))));
+	r *= S_sqrt(1.0f - a);
+	return x < 0.0f ? S_PI - r : r;
+}
+
+/**
+ * @brief Calculate the approximate 2-argument inverse tangent of a
+ * single-precision floating-point number.
+ *
+ * The ratio of the smaller to the larger argument is evaluated with a 15th
+ * degree minimax polynomial and moved into the correct octant without
+ * branching.
+ *
+ * The absolute error is at most @f$5\times10^{-7}@f$. If both arguments are
+ * zero, zero is returned.
+ *
+ * @param[in] y The y-coordinate.
+ * @param[in] x The x-coordinate.
+ * @return @f$\mathrm{atan2}(y,x)@f$
+ * @since 1.0.0
+ */
+static inline
+Sfloat
+S_fast_arctan2(Sfloat y,
+               Sfloat x)
+{
+	Sfloat ax, ay, mx, a, a2, r;
+	ax = S_abs(x);
+	ay = S_abs(y);
+	mx = S_max(ax, ay);
+	a = S_min(ax, ay) / (mx > 0.0f ? mx : 1.0f);
+	a2 = a * a;
+	r = a * (9.999992509e-1f + a2 * (-3.332954450e-1f +
+	    a2 * (1.994314886e-1f + a2 * (-1.389235603e-1f +
+	    a2 * (9.602411859e-2f + a2 * (-5.539143977e-2f +
+	    a2 * (2.151566815e-2f + a2 * -3.961949652e-3f)))))));
+	r = ay > ax ? S_HALFPI - r : r;
+	r = x < 0.0f ? S_PI - r : r;
+	return y < 0.0f ? -r : r;
+}
+
+/*
+ * internal routing for library functions, enabled with ENABLE_FASTMATH
+ */
+#ifdef ENABLE_FASTMATH
+#define _S_RSQRT(x)     S_fast_rsqrt(x)
+#define _S_SIN(x)       S_fast_sin(x)
+#define _S_COS(x)       S_fast_cos(x)
+#define _S_ARCCOS(x)    S_fast_arccos(x)
+#define _S_ARCTAN2(x,y) S_fast_arctan2(x,y)
+#else /* ENABLE_FASTMATH */
+#define _S_RSQRT(x)     (1.0f / S_sqrt(x))
+#define _S_SIN(x)       S_sin(x)
+#define _S_COS(x)       S_cos(x)
+#define _S_ARCCOS(x)    S_arccos(x)
+#define _S_ARCTAN2(x,y) S_arctan2(x,y)
+#endif /* ENABLE_FASTMATH */
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* FR_RAYMENT_STICKY_FASTMATH_H */
+
@@ -139,9 +139,82 @@ STICKY_API Sbool S_frustum_intersects_point(const Sfrustum *, const Svec3 *);
 STICKY_API Sbool S_frustum_intersects_sphere(const Sfrustum *,
                                              const Svec3 *, Sfloat);
 
+/**
+ * @brief Check if an axis-aligned bounding box lies within a frustum.
+ *
+ * The box is given by its minimum and maximum corners in world space. For each
+ * plane of the frustum, only the corner of the box that lies furthest along
+ * the plane normal is tested.
+ *
+ * @param[in] frustum The frustum.
+ * @param[in] min The minimum corner of the box.
+ * @param[in] max The maximum corner of the box.
+ * @return {@link S_TRUE} If a given box lies within or intersects a frustum,
+ * otherwise {@link S_FALSE}.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid frustum or 3D point
+ * is provided to the function.
+ * @since 1.0.0
+ */
 STICKY_API Sbool S_frustum_intersects_bounds(const Sfrustum *,
                                              const Svec3 *, const Svec3 *);
 
+/**
+ * @brief Cull an array of spheres against a frustum.
+ *
+ * Tests @p len spheres against a frustum at once, giving the same result as
+ * calling {@link S_frustum_intersects_sphere(const Sfrustum *, const Svec3 *,
+ * Sfloat)} for each sphere. Where the target supports SSE2, four spheres are
+ * tested at a time.
+ *
+ * The visible spheres are written to @p mask and/or @p indices, either of
+ * which may be <c>NULL</c>. @p mask must hold at least
+ * <c>(len + 31) / 32</c> elements; bit <c>i % 32</c> of element
+ * <c>i / 32</c> is set if sphere <c>i</c> is visible and cleared otherwise.
+ * @p indices must hold at least @p len elements and receives the indices of
+ * the visible spheres in ascending order.
+ *
+ * @param[in] frustum The frustum.
+ * @param[in] points An array of @p len sphere center points.
+ * @param[in] radii An array of @p len sphere radii.
+ * @param[in] len The number of spheres.
+ * @param[out] mask The output visibility bitmask, or <c>NULL</c>.
+ * @param[out] indices The output list of visible indices, or <c>NULL</c>.
+ * @return The number of visible spheres.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid frustum or array is
+ * provided to the function.
+ * @since 1.0.0
+ */
+STICKY_API Ssize_t S_frustum_cull_spheres(const Sfrustum *, const Svec3 *,
+                                          const Sfloat *, Ssize_t,
+                                          Suint32 *, Ssize_t *);
+
+/**
+ * @brief Cull an array of axis-aligned bounding boxes against a frustum.
+ *
+ * Tests @p len boxes against a frustum at once, giving the same result as
+ * calling {@link S_frustum_intersects_bounds(const Sfrustum *, const Svec3 *,
+ * const Svec3 *)} for each box. Where the target supports SSE2, four boxes are
+ * tested at a time.
+ *
+ * The visible boxes are written to @p mask and/or @p indices in the same
+ * manner as {@link S_frustum_cull_spheres(const Sfrustum *, const Svec3 *,
+ * const Sfloat *, Ssize_t, Suint32 *, Ssize_t *)}.
+ *
+ * @param[in] frustum The frustum.
+ * @param[in] mins An array of @p len minimum box corners.
+ * @param[in] maxs An array of @p len maximum box corners.
+ * @param[in] len The number of boxes.
+ * @param[out] mask The output visibility bitmask, or <c>NULL</c>.
+ * @param[out] indices The output list of visible indices, or <c>NULL</c>.
+ * @return The number of visible boxes.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid frustum or array is
+ * provided to the function.
+ * @since 1.0.0
+ */
+STICKY_API Ssize_t S_frustum_cull_bounds(const Sfrustum *, const Svec3 *,
+                                         const Svec3 *, Ssize_t,
+                                         Suint32 *, Ssize_t *);
+
 /**
  * @}
  */
@@ -0,0 +1,273 @@
+/*
+ * This file is licensed under BSD 3-Clause.
+ * All license information is available in the included COPYING file.
+ */
+
+/*
+ * hierarchy.h
+ * Flat transform hierarchy header.
+ *
+ * Author       : Finn Rayment <finn@rayment.fr>
+ * Date created : 18/10/2026
+ */
+
+#ifndef FR_RAYMENT_STICKY_HIERARCHY_H
+#define FR_RAYMENT_STICKY_HIERARCHY_H 1
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+#include "sticky/common/defines.h"
+#include "sticky/common/types.h"
+#include "sticky/math/mat4.h"
+#include "sticky/math/transform.h"
+
+/**
+ * @addtogroup hierarchy
+ * @{
+ */
+
+/**
+ * @brief Handle value representing no node.
+ *
+ * Passed as a parent handle to create a root node, and returned in place of a
+ * handle whenever a node does not exist.
+ *
+ * @hideinitializer
+ * @since 1.0.0
+ */
+#define S_HIERARCHY_NONE S_UINT32_MAX
+
+/**
+ * @brief Flat transform hierarchy.
+ *
+ * A transform hierarchy stores the local transforms of a scene in a single
+ * contiguous array that is sorted by depth, such that every parent is stored
+ * before any of its children. Parent-child relations are stored as indices
+ * into the array rather than as pointers.
+ *
+ * World matrices are computed in one linear pass over the array, where each
+ * node multiplies its local matrix with the already-computed world matrix of
+ * its parent. Nodes of equal depth never depend on one another, so each depth
+ * level is processed in parallel when the library is built with OpenMP.
+ *
+ * Nodes are referred to by stable handles that remain valid until the node is
+ * removed. Structural changes (adding, removing or reparenting nodes) mark the
+ * hierarchy to be re-sorted on the next call to
+ * {@link S_hierarchy_update(Shierarchy *)}.
+ *
+ * The hierarchy is an alternative to the pointer-based parent-child graph
+ * provided by {@link Stransform} for scenes with many transforms.
+ *
+ * @warning The hierarchy is not thread safe.
+ * @since 1.0.0
+ */
+typedef struct
+Shierarchy_s
+{
+	Stransform *local;
+	Smat4 *world;
+	Suint32 *parent, *handle, *index, *levels;
+	Suint32 len, cap, hlen, hcap, hfree, nlevels;
+	Sbool dirty;
+} Shierarchy;
+
+/**
+ * @brief Create a new transform hierarchy.
+ *
+ * Allocates a new, empty transform hierarchy on the heap.
+ *
+ * @return A new transform hierarchy allocated on the heap. To correctly destroy
+ * the hierarchy, call {@link S_hierarchy_delete(Shierarchy *)}.
+ * @since 1.0.0
+ */
+STICKY_API Shierarchy *S_hierarchy_new(void);
+
+/**
+ * @brief Free a transform hierarchy from memory.
+ *
+ * Frees the hierarchy and every transform stored within it.
+ *
+ * @param[in,out] hierarchy The hierarchy to free from memory.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid hierarchy is provided
+ * to the function.
+ * @since 1.0.0
+ */
+STICKY_API void        S_hierarchy_delete(Shierarchy *);
+
+/**
+ * @brief Add a new node to a transform hierarchy.
+ *
+ * Creates a new blank transform (position is set to zero, rotation is set to
+ * zero and scale is set to 1) as a child of @p parent. If @p parent is
+ * {@link S_HIERARCHY_NONE}, the node is added as a root node.
+ *
+ * @param[in,out] hierarchy The hierarchy to add the node to.
+ * @param[in] parent The handle of the parent node, or
+ * {@link S_HIERARCHY_NONE}.
+ * @return The handle of the new node, or {@link S_HIERARCHY_NONE} if an error
+ * occurred.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid hierarchy is provided
+ * to the function.
+ * @exception S_INVALID_INDEX If @p parent is not a node of the hierarchy.
+ * @since 1.0.0
+ */
+STICKY_API Suint32     S_hierarchy_add(Shierarchy *, Suint32);
+
+/**
+ * @brief Copy a transform tree into a transform hierarchy.
+ *
+ * Adds a copy of @p transform and all of its descendants to the hierarchy as
+ * children of @p parent, keeping the local position, rotation and scale of
+ * each transform. The source transforms are not modified and are not linked to
+ * the hierarchy in any way once copied.
+ *
+ * @param[in,out] hierarchy The hierarchy to add the nodes to.
+ * @param[in] transform The root transform of the tree to copy.
+ * @param[in] parent The handle of the parent node, or
+ * {@link S_HIERARCHY_NONE}.
+ * @return The handle of the node copied from @p transform, or
+ * {@link S_HIERARCHY_NONE} if an error occurred.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid hierarchy or transform
+ * is provided to the function.
+ * @exception S_INVALID_INDEX If @p parent is not a node of the hierarchy.
+ * @since 1.0.0
+ */
+STICKY_API Suint32     S_hierarchy_add_tree(Shierarchy *, const Stransform *,
+                                            Suint32);
+
+/**
+ * @brief Remove a node from a transform hierarchy.
+ *
+ * Any children of the node will be inherited by the parent of the node. If the
+ * node has no parent, the children will become root nodes. The handle of the
+ * removed node may be reused by a later call to
+ * {@link S_hierarchy_add(Shierarchy *, Suint32)}.
+ *
+ * @param[in,out] hierarchy The hierarchy to remove the node from.
+ * @param[in] node The handle of the node to remove.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid hierarchy is provided
+ * to the function.
+ * @exception S_INVALID_INDEX If @p node is not a node of the hierarchy.
+ * @since 1.0.0
+ */
+STICKY_API void        S_hierarchy_remove(Shierarchy *, Suint32);
+
+/**
+ * @brief Set the parent of a node in a transform hierarchy.
+ *
+ * If @p parent is {@link S_HIERARCHY_NONE}, the node becomes a root node.
+ *
+ * If @p parent is a descendant of @p node, then the direct descendant of
+ * @p node from which @p parent originates will become a root node to avoid
+ * cyclic relations, as with
+ * {@link S_transform_set_parent(Stransform *, Stransform *)}.
+ *
+ * @param[in,out] hierarchy The hierarchy.
+ * @param[in] node The handle of the child node.
+ * @param[in] parent The handle of the parent node, or
+ * {@link S_HIERARCHY_NONE}.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid hierarchy is provided
+ * to the function, or if @p node and @p parent are equal.
+ * @exception S_INVALID_INDEX If @p node or @p parent is not a node of the
+ * hierarchy.
+ * @since 1.0.0
+ */
+STICKY_API void        S_hierarchy_set_parent(Shierarchy *, Suint32, Suint32);
+
+/**
+ * @brief Get the parent of a node in a transform hierarchy.
+ *
+ * @param[in] hierarchy The hierarchy.
+ * @param[in] node The handle of the node.
+ * @return The handle of the parent node, or {@link S_HIERARCHY_NONE} if the
+ * node is a root node.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid hierarchy is provided
+ * to the function.
+ * @exception S_INVALID_INDEX If @p node is not a node of the hierarchy.
+ * @since 1.0.0
+ */
+STICKY_API Suint32     S_hierarchy_get_parent(const Shierarchy *, Suint32);
+
+/**
+ * @brief Get the number of nodes in a transform hierarchy.
+ *
+ * @param[in] hierarchy The hierarchy.
+ * @return The number of nodes in the hierarchy.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid hierarchy is provided
+ * to the function.
+ * @since 1.0.0
+ */
+STICKY_API Suint32     S_hierarchy_size(const Shierarchy *);
+
+/**
+ * @brief Get the local transform of a node in a transform hierarchy.
+ *
+ * The returned transform may be modified with the position, rotation and scale
+ * functions of {@link Stransform}, such as
+ * {@link S_transform_set_pos(Stransform *, const Svec3 *)}. Changes take effect
+ * on the next call to {@link S_hierarchy_update(Shierarchy *)}.
+ *
+ * @warning The returned pointer is only valid until the next structural change
+ * to the hierarchy followed by a call to
+ * {@link S_hierarchy_update(Shierarchy *)}. The transform has neither a parent
+ * nor a list of children, and must not be passed to
+ * {@link S_transform_delete(Stransform *)}, to
+ * {@link S_transform_set_parent(Stransform *, Stransform *)} or to any function
+ * that queries its children.
+ * @param[in,out] hierarchy The hierarchy.
+ * @param[in] node The handle of the node.
+ * @return The local transform of the node, or <c>NULL</c> if an error
+ * occurred.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid hierarchy is provided
+ * to the function.
+ * @exception S_INVALID_INDEX If @p node is not a node of the hierarchy.
+ * @since 1.0.0
+ */
+STICKY_API Stransform *S_hierarchy_get_transform(Shierarchy *, Suint32);
+
+/**
+ * @brief Compute the world matrices of a transform hierarchy.
+ *
+ * If the structure of the hierarchy has changed since the last update, the
+ * nodes are first re-sorted by depth. The world matrix of every node is then
+ * recomputed from its local transform and the world matrix of its parent.
+ *
+ * @param[in,out] hierarchy The hierarchy to update.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid hierarchy is provided
+ * to the function.
+ * @since 1.0.0
+ */
+STICKY_API void        S_hierarchy_update(Shierarchy *);
+
+/**
+ * @brief Get the world matrix of a node in a transform hierarchy.
+ *
+ * The matrix returned is the one computed by the last call to
+ * {@link S_hierarchy_update(Shierarchy *)}.
+ *
+ * @param[in] hierarchy The hierarchy.
+ * @param[in] node The handle of the node.
+ * @param[out] dest The output world matrix.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid hierarchy or matrix is
+ * provided to the function.
+ * @exception S_INVALID_INDEX If @p node is not a node of the hierarchy.
+ * @exception S_INVALID_OPERATION If the structure of the hierarchy has changed
+ * since the last update.
+ * @since 1.0.0
+ */
+STICKY_API void        S_hierarchy_get_world_matrix(const Shierarchy *,
+                                                    Suint32, Smat4 *);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* FR_RAYMENT_STICKY_HIERARCHY_H */
+
@@ -0,0 +1,268 @@
+/*
+ * This file is licensed under BSD 3-Clause.
+ * All license information is available in the included COPYING file.
+ */
+
+/*
+ * assets.h
+ * Reference-counted asset cache header.
+ *
+ * Author       : Finn Rayment <finn@rayment.fr>
+ * Date created : 18/10/2026
+ */
+
+#ifndef FR_RAYMENT_STICKY_ASSETS_H
+#define FR_RAYMENT_STICKY_ASSETS_H 1
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+#include "sticky/audio/sound.h"
+#include "sticky/common/defines.h"
+#include "sticky/common/types.h"
+#include "sticky/video/font.h"
+#include "sticky/video/shader.h"
+#include "sticky/video/texture.h"
+
+/**
+ * @addtogroup assets
+ * @{
+ */
+
+/**
+ * @brief Textures loaded by {@link S_assets_load_texture}.
+ * @hideinitializer
+ *
+ * @since 1.0.0
+ */
+#define S_ASSET_TEXTURE 0
+/**
+ * @brief Shaders loaded by {@link S_assets_load_shader}.
+ * @hideinitializer
+ *
+ * @since 1.0.0
+ */
+#define S_ASSET_SHADER  1
+/**
+ * @brief Fonts loaded by {@link S_assets_load_font}.
+ * @hideinitializer
+ *
+ * @since 1.0.0
+ */
+#define S_ASSET_FONT    2
+/**
+ * @brief Sounds loaded by {@link S_assets_load_sound}.
+ * @hideinitializer
+ *
+ * @since 1.0.0
+ */
+#define S_ASSET_SOUND   3
+
+#define _S_ASSET_TYPES  4
+
+typedef struct
+_Sasset_s
+{
+	void *data;
+	Schar *key;
+	Ssize_t size;
+	Suint32 hash, refs;
+	Senum type;
+	struct _Sasset_s *next_key, *next_data;
+} _Sasset;
+
+/**
+ * @brief Asset cache struct.
+ *
+ * Loads each asset once no matter how many times it is asked for. Assets are
+ * interned by their type, the files they are loaded from and any parameters
+ * they are loaded with, so that asking for the same texture twice returns the
+ * same texture, decoded and uploaded only once.
+ *
+ * Every load takes a reference to the asset, which is given back with
+ * {@link S_assets_release}. The asset is freed once the last reference is
+ * released, and is loaded from file again the next time it is asked for.
+ * Assets are therefore owned by the cache, and must never be deleted
+ * directly.
+ *
+ * Assets are found both by key and by address through two hash tables of
+ * chained assets, which grow as assets are added.
+ *
+ * @since 1.0.0
+ */
+typedef struct
+Sassets_s
+{
+	_Sasset **keys, **data;
+	Ssize_t len, cap;
+	Ssize_t memory[_S_ASSET_TYPES];
+	Suint32 counts[_S_ASSET_TYPES];
+} Sassets;
+
+/**
+ * @brief Create a new asset cache.
+ *
+ * @return A new empty asset cache allocated on the heap. To correctly destroy
+ * it, call {@link S_assets_delete(Sassets *)}.
+ * @since 1.0.0
+ */
+STICKY_API Sassets  *S_assets_new(void);
+
+/**
+ * @brief Free an asset cache from memory.
+ *
+ * Every asset still held by the cache is freed, whether or not it has been
+ * released.
+ *
+ * @param[in,out] assets The asset cache to free from memory.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid asset cache is
+ * provided to the function.
+ * @since 1.0.0
+ */
+STICKY_API void      S_assets_delete(Sassets *);
+
+/**
+ * @brief Load a texture through an asset cache.
+ *
+ * The texture is loaded with {@link S_texture_load} unless it is already
+ * held by the cache.
+ *
+ * @param[in,out] assets The asset cache.
+ * @param[in] filename The file path to the texture.
+ * @return The texture, or <c>NULL</c> if it could not be loaded.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid asset cache or file
+ * path is provided to the function.
+ * @since 1.0.0
+ */
+STICKY_API Stexture *S_assets_load_texture(Sassets *, const Schar *);
+
+/**
+ * @brief Load a shader through an asset cache.
+ *
+ * The shader is loaded with {@link S_shader_load} unless a shader of the same
+ * pair of files is already held by the cache.
+ *
+ * @param[in,out] assets The asset cache.
+ * @param[in] vert_filename The file path to the vertex shader.
+ * @param[in] frag_filename The file path to the fragment shader.
+ * @return The shader, or <c>NULL</c> if it could not be loaded.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid asset cache or file
+ * path is provided to the function.
+ * @since 1.0.0
+ */
+STICKY_API Sshader  *S_assets_load_shader(Sassets *, const Schar *,
+                                          const Schar *);
+
+/**
+ * @brief Load a font through an asset cache.
+ *
+ * The font is loaded with {@link S_font_load} or {@link S_font_load_sdf}
+ * unless a font of the same file, pixel size and kind is already held by the
+ * cache.
+ *
+ * @param[in,out] assets The asset cache.
+ * @param[in] filename The file path to the font.
+ * @param[in] pixel_size The size of the font for generation.
+ * @param[in] sdf Whether to load the font as a signed distance field.
+ * @return The font, or <c>NULL</c> if it could not be loaded.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid asset cache or file
+ * path is provided to the function, or if @p pixel_size is less than or equal
+ * to @f$0@f$.
+ * @since 1.0.0
+ */
+STICKY_API Sfont    *S_assets_load_font(Sassets *, const Schar *, Sfloat,
+                                        Sbool);
+
+/**
+ * @brief Load a sound through an asset cache.
+ *
+ * The sound is loaded whole with {@link S_sound_load_wav} unless it is
+ * already held by the cache. Streamed sounds are never shared, since each
+ * stream is read from its own position in the file.
+ *
+ * @param[in,out] assets The asset cache.
+ * @param[in] filename The file path to the WAV file.
+ * @return The sound, or <c>NULL</c> if it could not be loaded.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid asset cache or file
+ * path is provided to the function.
+ * @since 1.0.0
+ */
+STICKY_API Ssound   *S_assets_load_sound(Sassets *, const Schar *);
+
+/**
+ * @brief Release a reference to an asset of an asset cache.
+ *
+ * The asset is freed once every reference to it has been released.
+ *
+ * @param[in,out] assets The asset cache.
+ * @param[in] asset The asset, as returned by one of the loading functions of
+ * the cache.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid asset cache or asset
+ * is provided to the function.
+ * @exception S_INVALID_INDEX If @p asset is not held by the cache.
+ * @since 1.0.0
+ */
+STICKY_API void      S_assets_release(Sassets *, const void *);
+
+/**
+ * @brief Get the number of references to an asset of an asset cache.
+ *
+ * @param[in] assets The asset cache.
+ * @param[in] asset The asset.
+ * @return The number of references which have not been released, or
+ * @f$0@f$ if @p asset is not held by the cache.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid asset cache or asset
+ * is provided to the function.
+ * @since 1.0.0
+ */
+STICKY_API Suint32   S_assets_get_refs(const Sassets *, const void *);
+
+/**
+ * @brief Get the number of assets of a type held by an asset cache.
+ *
+ * @param[in] assets The asset cache.
+ * @param[in] type The type of asset. One of {@link S_ASSET_TEXTURE},
+ * {@link S_ASSET_SHADER}, {@link S_ASSET_FONT} or {@link S_ASSET_SOUND}.
+ * @return The number of distinct assets of the type.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid asset cache is
+ * provided to the function.
+ * @exception S_INVALID_ENUM If @p type is not a type of asset.
+ * @since 1.0.0
+ */
+STICKY_API Suint32   S_assets_get_count(const Sassets *, Senum);
+
+/**
+ * @brief Get the memory taken by the assets of a type held by an asset cache.
+ *
+ * Textures and fonts count the video memory of their textures, and sounds the
+ * audio memory of their samples. Shaders take no memory that may be
+ * measured, and always count as @f$0@f$.
+ *
+ * @param[in] assets The asset cache.
+ * @param[in] type The type of asset. One of {@link S_ASSET_TEXTURE},
+ * {@link S_ASSET_SHADER}, {@link S_ASSET_FONT} or {@link S_ASSET_SOUND}.
+ * @return The number of bytes taken by every asset of the type.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid asset cache is
+ * provided to the function.
+ * @exception S_INVALID_ENUM If @p type is not a type of asset.
+ * @since 1.0.0
+ */
+STICKY_API Ssize_t   S_assets_get_memory(const Sassets *, Senum);
+
+_Sasset *_S_assets_find_data(const Sassets *, const void *);
+void *_S_assets_acquire(Sassets *, Senum, const Schar *);
+void _S_assets_insert(Sassets *, Senum, const Schar *, void *, Ssize_t);
+Sbool _S_assets_unref(Sassets *, _Sasset *);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* FR_RAYMENT_STICKY_ASSETS_H */
+
@@ -0,0 +1,69 @@
+/*
+ * This file is licensed under BSD 3-Clause.
+ * All license information is available in the included COPYING file.
+ */
+
+/*
+ * hash.h
+ * Non-cryptographic hash function header.
+ *
+ * Author       : Finn Rayment <finn@rayment.fr>
+ * Date created : 18/10/2026
+ */
+
+#ifndef FR_RAYMENT_STICKY_HASH_H
+#define FR_RAYMENT_STICKY_HASH_H 1
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+#include "sticky/common/defines.h"
+#include "sticky/common/types.h"
+
+/**
+ * @addtogroup hash
+ * @{
+ */
+
+/**
+ * @brief Calculate the 32-bit FNV-1a hash of a block of memory.
+ *
+ * FNV-1a is a fast, non-cryptographic hash function suitable for hash tables
+ * keyed by short strings or small structures. It must not be used where
+ * resistance to deliberate collisions is required.
+ *
+ * @param[in] data The block of memory to hash.
+ * @param[in] len The number of bytes to hash.
+ * @return The hash of @p data.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> pointer is provided to the
+ * function with a non-zero length.
+ * @since 1.0.0
+ */
+STICKY_API Suint32 S_hash_fnv1a(const void *, Ssize_t);
+
+/**
+ * @brief Calculate the 32-bit FNV-1a hash of a null-terminated string.
+ *
+ * The result is equal to that of {@link S_hash_fnv1a(const void *, Ssize_t)}
+ * over the characters of the string, excluding the null-terminator.
+ *
+ * @param[in] str The string to hash.
+ * @return The hash of @p str.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> string is provided to the
+ * function.
+ * @since 1.0.0
+ */
+STICKY_API Suint32 S_hash_fnv1a_string(const Schar *);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* FR_RAYMENT_STICKY_HASH_H */
+
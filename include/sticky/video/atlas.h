@@ -0,0 +1,254 @@
+/*
+ * This file is licensed under BSD 3-Clause.
+ * All license information is available in the included COPYING file.
+ */
+
+/*
+ * atlas.h
+ * Texture atlas header.
+ *
+ * Author       : Finn Rayment <finn@rayment.fr>
+ * Date created : 18/10/2026
+ */
+
+#ifndef FR_RAYMENT_STICKY_ATLAS_H
+#define FR_RAYMENT_STICKY_ATLAS_H 1
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+#include "sticky/common/defines.h"
+#include "sticky/common/includes.h"
+#include "sticky/common/types.h"
+#include "sticky/math/vec4.h"
+#include "sticky/video/texture.h"
+
+/**
+ * @addtogroup atlas
+ * @{
+ */
+
+/**
+ * @brief The number of texels repeated around the edges of each sprite.
+ * @hideinitializer
+ *
+ * Keeps linear filtering of a sprite from sampling its neighbours.
+ *
+ * @since 1.0.0
+ */
+#define S_ATLAS_PADDING 2
+
+/**
+ * @brief The index returned by {@link S_atlas_add} and
+ * {@link S_atlas_add_pixels} when a sprite could not be added.
+ * @hideinitializer
+ *
+ * @since 1.0.0
+ */
+#define S_ATLAS_INVALID S_UINT32_MAX
+
+/**
+ * @brief Texture atlas sprite struct.
+ *
+ * The location of a sprite within its layer of an atlas, excluding padding.
+ *
+ * @since 1.0.0
+ */
+typedef struct
+Satlas_sprite_s
+{
+	Suint8 *pixels;
+	Suint32 x, y, width, height, layer;
+} Satlas_sprite;
+
+/**
+ * @brief Texture atlas struct.
+ *
+ * An atlas gathers many small images and packs them into a single texture, so
+ * that sprites and materials using any of them share one binding. A sprite
+ * batch draws every quad of an atlas in a single call, where it would
+ * otherwise need a call per texture.
+ *
+ * Images are added to the atlas and kept in client memory until it is built,
+ * at which point they are packed largest first by a {@link Sskyline} and
+ * uploaded, either as one 2D texture with each sprite found by its texture
+ * coordinates, or as an array texture which may span many layers with each
+ * sprite found by its layer as well. The images are then released, but the
+ * location of each sprite is kept until the atlas is deleted. The textures
+ * are built without mipmaps, since they are only filtered with
+ * {@link S_TEXTURE_NEAREST} or {@link S_TEXTURE_LINEAR}.
+ *
+ * @since 1.0.0
+ */
+typedef struct
+Satlas_s
+{
+	Satlas_sprite *sprites;
+	Ssize_t len, cap;
+	Suint32 size, layers;
+	Sbool built;
+} Satlas;
+
+/**
+ * @brief Create a new texture atlas.
+ *
+ * @param[in] size The width and height of the texture, or of each layer of the
+ * array texture, that sprites are packed into.
+ * @return A new empty atlas allocated on the heap. To correctly destroy it,
+ * call {@link S_atlas_delete(Satlas *)}.
+ * @exception S_INVALID_VALUE If @p size is equal to 0.
+ * @since 1.0.0
+ */
+STICKY_API Satlas   *S_atlas_new(Suint32);
+
+/**
+ * @brief Free a texture atlas from memory.
+ *
+ * Textures built from the atlas are not deleted.
+ *
+ * @param[in,out] atlas The atlas to free from memory.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid atlas is provided to
+ * the function.
+ * @since 1.0.0
+ */
+STICKY_API void      S_atlas_delete(Satlas *);
+
+/**
+ * @brief Add an image file to a texture atlas.
+ *
+ * @param[in,out] atlas The atlas.
+ * @param[in] filename The file path to the image to add.
+ * @return The index of the new sprite, counting from @f$0@f$ in the order
+ * sprites are added, or {@link S_ATLAS_INVALID} if it could not be added.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid atlas or file path is
+ * provided to the function.
+ * @exception S_INVALID_OPERATION If the atlas has already been built.
+ * @since 1.0.0
+ */
+STICKY_API Suint32   S_atlas_add(Satlas *, const Schar *);
+
+/**
+ * @brief Add an image in memory to a texture atlas.
+ *
+ * The image is copied, so it may be freed once added.
+ *
+ * @param[in,out] atlas The atlas.
+ * @param[in] pixels The image, as @p width by @p height texels of four bytes
+ * of red, green, blue and alpha each.
+ * @param[in] width The width of the image.
+ * @param[in] height The height of the image.
+ * @return The index of the new sprite, counting from @f$0@f$ in the order
+ * sprites are added, or {@link S_ATLAS_INVALID} if it could not be added.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid atlas or image is
+ * provided to the function, or if @p width or @p height are equal to 0 or
+ * larger than the atlas.
+ * @exception S_INVALID_OPERATION If the atlas has already been built.
+ * @since 1.0.0
+ */
+STICKY_API Suint32   S_atlas_add_pixels(Satlas *, const Suint8 *, Suint32,
+                                        Suint32);
+
+/**
+ * @brief Pack every sprite of a texture atlas into a single texture.
+ *
+ * Requires an open window. Each sprite is drawn with the texture coordinates
+ * given by {@link S_atlas_get_uv}, and the texture may be drawn, filtered and
+ * deleted as any other.
+ *
+ * @param[in,out] atlas The atlas.
+ * @return A new texture allocated on the heap, or <c>NULL</c> if the sprites
+ * do not fit into one texture, in which case the atlas may still be built as
+ * an array texture. To correctly destroy the texture, call
+ * {@link S_texture_delete(Stexture *)}.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid atlas is provided to
+ * the function.
+ * @exception S_INVALID_OPERATION If the atlas has already been built or holds
+ * no sprites.
+ * @exception S_INVALID_INDEX If the sprites do not fit into one texture.
+ * @since 1.0.0
+ */
+STICKY_API Stexture *S_atlas_build(Satlas *);
+
+/**
+ * @brief Pack every sprite of a texture atlas into an array texture.
+ *
+ * Requires an open window. Sprites are packed into as many layers as they
+ * need, each of the size of the atlas, and are sampled in shaders through a
+ * <c>sampler2DArray</c> with the texture coordinates given by
+ * {@link S_atlas_get_uv} and the layer given by {@link S_atlas_get_layer}.
+ *
+ * @param[in,out] atlas The atlas.
+ * @return A new array texture allocated on the heap. To correctly destroy the
+ * texture, call {@link S_texture_delete(Stexture *)}.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid atlas is provided to
+ * the function.
+ * @exception S_INVALID_OPERATION If the atlas has already been built or holds
+ * no sprites.
+ * @since 1.0.0
+ */
+STICKY_API Stexture *S_atlas_build_array(Satlas *);
+
+/**
+ * @brief Get the texture coordinates of a sprite of a texture atlas.
+ *
+ * The coordinates are given in the form taken by
+ * {@link S_spritebatch_draw}.
+ *
+ * @param[in] atlas The atlas, which has been built.
+ * @param[in] sprite The index of the sprite.
+ * @param[out] uv The coordinates of the top-left corner of the sprite in
+ * <c>x</c> and <c>y</c>, and of its bottom-right corner in <c>z</c> and
+ * <c>w</c>.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid atlas or vector is
+ * provided to the function.
+ * @exception S_INVALID_INDEX If @p sprite is out of range or is
+ * {@link S_ATLAS_INVALID}.
+ * @exception S_INVALID_OPERATION If the atlas has not been built.
+ * @since 1.0.0
+ */
+STICKY_API void      S_atlas_get_uv(const Satlas *, Suint32, Svec4 *);
+
+/**
+ * @brief Get the layer of an array texture holding a sprite of a texture
+ * atlas.
+ *
+ * @param[in] atlas The atlas, which has been built.
+ * @param[in] sprite The index of the sprite.
+ * @return The layer of the sprite, which is always @f$0@f$ if the atlas was
+ * built as a single texture.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid atlas is provided to
+ * the function.
+ * @exception S_INVALID_INDEX If @p sprite is out of range or is
+ * {@link S_ATLAS_INVALID}.
+ * @exception S_INVALID_OPERATION If the atlas has not been built.
+ * @since 1.0.0
+ */
+STICKY_API Suint32   S_atlas_get_layer(const Satlas *, Suint32);
+
+/**
+ * @brief Get the number of layers of a texture atlas.
+ *
+ * @param[in] atlas The atlas, which has been built.
+ * @return The number of layers the sprites were packed into.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid atlas is provided to
+ * the function.
+ * @exception S_INVALID_OPERATION If the atlas has not been built.
+ * @since 1.0.0
+ */
+STICKY_API Suint32   S_atlas_get_layers(const Satlas *);
+
+Suint32 _S_atlas_pack(Satlas *, Suint32);
+void _S_atlas_fill(const Satlas *, Suint32, Suint8 *);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* FR_RAYMENT_STICKY_ATLAS_H */
+
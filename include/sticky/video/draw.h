@@ -27,6 +27,7 @@ extern "C"
 #include "sticky/util/string.h"
 #include "sticky/video/font.h"
 #include "sticky/video/model.h"
+#include "sticky/video/textmesh.h"
 #include "sticky/video/window.h"
 
 /**
@@ -34,6 +35,34 @@ extern "C"
  * @{
  */
 
+/**
+ * @brief The first vertex attribute location of the instance transform.
+ *
+ * When a model is drawn with instancing, the model matrix of each instance is
+ * bound as a <c>mat4</c> attribute occupying this location and the three
+ * following it.
+ *
+ * @hideinitializer
+ * @since 1.0.0
+ */
+#define S_DRAW_INSTANCE_TRANSFORM 3
+
+/**
+ * @brief The vertex attribute location of the instance colour.
+ *
+ * @hideinitializer
+ * @since 1.0.0
+ */
+#define S_DRAW_INSTANCE_COLOR     7
+
+/**
+ * @brief The vertex attribute location of the extra instance data.
+ *
+ * @hideinitializer
+ * @since 1.0.0
+ */
+#define S_DRAW_INSTANCE_DATA      8
+
 /**
  * @brief Draw a line in 3D space.
  *
@@ -68,6 +97,62 @@ STICKY_API void S_draw_line_3d(const Swindow *,
  */
 STICKY_API void S_draw_point_3d(const Swindow *, const Svec3 *);
 
+/**
+ * @brief Queue a debug line in 3D space.
+ *
+ * Adds a line between two points in world space to the debug queue, which is
+ * drawn in a single draw call when flushed by
+ * {@link S_draw_debug_flush(const Swindow *)} or when the window is swapped.
+ * Unlike {@link S_draw_line_3d(const Swindow *, const Svec3 *, const Svec3 *)},
+ * no transformation or uniforms are computed per line, so this is suitable for
+ * drawing many thousands of lines each frame.
+ *
+ * @param[in] window The window to draw to.
+ * @param[in] from The first point of the line.
+ * @param[in] to The second point of the line.
+ * @param[in] color The colour of the line, or <c>NULL</c> for the current draw
+ * colour of the window.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid window or 3D vector
+ * is provided to the function.
+ * @since 1.0.0
+ */
+STICKY_API void S_draw_debug_line_3d(const Swindow *,
+                                     const Svec3 *, const Svec3 *,
+                                     const Svec4 *);
+
+/**
+ * @brief Queue a debug point in 3D space.
+ *
+ * Adds a point in world space to the debug queue, which is drawn in a single
+ * draw call when flushed by {@link S_draw_debug_flush(const Swindow *)} or when
+ * the window is swapped.
+ *
+ * @param[in] window The window to draw to.
+ * @param[in] point The location of the point in 3D space.
+ * @param[in] color The colour of the point, or <c>NULL</c> for the current draw
+ * colour of the window.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid window or 3D vector
+ * is provided to the function.
+ * @since 1.0.0
+ */
+STICKY_API void S_draw_debug_point_3d(const Swindow *, const Svec3 *,
+                                      const Svec4 *);
+
+/**
+ * @brief Draw and clear the debug queue.
+ *
+ * Every queued line is drawn in one draw call and every queued point in
+ * another. This is called automatically by
+ * {@link S_window_swap(Swindow *)}, but may be called earlier to draw the
+ * queue beneath later draws.
+ *
+ * @param[in] window The window to draw to.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid window is provided to
+ * the function.
+ * @since 1.0.0
+ */
+STICKY_API void S_draw_debug_flush(const Swindow *);
+
 /**
  * @brief Draw a quad in 2D space.
  *
@@ -80,6 +165,12 @@ STICKY_API void S_draw_point_3d(const Swindow *, const Svec3 *);
  * The draw texture can be modified by calling the
  * {@link S_draw_set_texture(Swindow *, const Stexture *)} function.
  *
+ * Depth testing is left disabled after drawing, so that consecutive 2D draws do
+ * not toggle it. It is enabled again by the next 3D draw.
+ *
+ * Each call is a separate draw call. To draw many quads, use a
+ * {@link Sspritebatch} instead.
+ *
  * @param[in] window The window to draw to.
  * @param[in] from The location of one point of the quad on the screen.
  * @param[in] to The location diagonal to @p from of the quad on the screen.
@@ -122,9 +213,16 @@ STICKY_API void  S_draw_string_2d(const Swindow *, const Sfont *,
  * position and at a given scale. Note that the 2D space is defined by the
  * camera currently attached to the window.
  *
+ * The text is laid out from the layout cache of the font, so that text drawn
+ * every frame is only laid out again after it changes.
+ *
+ * As with
+ * {@link S_draw_quad_2d(const Swindow *, const Svec2 *, const Svec2 *)},
+ * depth testing is left disabled after drawing.
+ *
  * @param[in] window The window to draw to.
  * @param[in] font The font to draw.
- * @param[in] text The text to be drawn.
+ * @param[in] text The UTF-8 text to be drawn.
  * @param[in] len The number of chars in @p text to be drawn.
  * @param[in] x The @f$x@f$ position on the window at which to draw the text.
  * @param[in] y The @f$y@f$ position on the window at which to draw the text.
@@ -137,6 +235,51 @@ STICKY_API void  S_draw_text_2d(const Swindow *, const Sfont *,
                                 const Schar *, Ssize_t,
                                 Sfloat, Sfloat, Sfloat);
 
+/**
+ * @brief Draws raw text in 2D space wrapped within a width.
+ *
+ * Draws text in the same way as {@link S_draw_text_2d}, except that lines are
+ * broken to fit within @p width as described by
+ * {@link S_font_get_wrapped_extents}. The first line is drawn with its baseline
+ * at @p y and each following line one line height below the last.
+ *
+ * The wrapped layout is cached by the font, so text which is measured and then
+ * drawn, or drawn every frame, is only wrapped once.
+ *
+ * @param[in] window The window to draw to.
+ * @param[in] font The font to draw.
+ * @param[in] text The UTF-8 text to be drawn.
+ * @param[in] len The number of chars in @p text to be drawn.
+ * @param[in] x The @f$x@f$ position on the window at which to draw the text.
+ * @param[in] y The @f$y@f$ position on the window at which to draw the text.
+ * @param[in] scale The scale of the drawn text.
+ * @param[in] width The width to wrap the text within.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid window, font or string
+ * is provided to the function, or if @p scale or @p width are less than or
+ * equal to @f$0@f$.
+ * @since 1.0.0
+ */
+STICKY_API void  S_draw_text_wrapped_2d(const Swindow *, const Sfont *,
+                                        const Schar *, Ssize_t,
+                                        Sfloat, Sfloat, Sfloat, Sfloat);
+
+/**
+ * @brief Draws a text mesh in 2D space.
+ *
+ * Unlike {@link S_draw_text_2d}, the text is not laid out or uploaded again,
+ * and the whole mesh is drawn with one draw call. The text is only laid out
+ * again if the font has since evicted a page of its atlas. The 2D space is
+ * defined by the camera currently attached to the window, and depth testing
+ * is left disabled after drawing.
+ *
+ * @param[in] window The window to draw to.
+ * @param[in,out] mesh The text mesh to draw.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid window or text mesh is
+ * provided to the function.
+ * @since 1.0.0
+ */
+STICKY_API void  S_draw_textmesh_2d(const Swindow *, Stextmesh *);
+
 /**
  * @brief Draws a model in 3D space.
  *
@@ -145,6 +288,13 @@ STICKY_API void  S_draw_text_2d(const Swindow *, const Sfont *,
  * that are stored within the model, as well as automatically draw the child
  * hierarchy of the model.
  *
+ * Each call binds the shader, material and mesh of the model. To draw many
+ * models with as few changes of state as possible, use an
+ * {@link Srenderqueue} instead.
+ *
+ * The mesh is drawn at the level of detail last chosen for the model by
+ * {@link S_model_select_lod}, which is the full mesh by default.
+ *
  * @param[in] window The window to draw to.
  * @param[in] model The model to draw.
  * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid window or model is
@@ -153,6 +303,45 @@ STICKY_API void  S_draw_text_2d(const Swindow *, const Sfont *,
  */
 STICKY_API void  S_draw_model(const Swindow *, const Smodel *);
 
+/**
+ * @brief Draws many copies of a model in 3D space with one draw call.
+ *
+ * Draws @p count instances of a model, each with its own model matrix, and
+ * optionally its own colour and four components of extra data. The per-instance
+ * values are uploaded to an instance buffer and the mesh of the model is drawn
+ * once with hardware instancing, rather than once per copy as with
+ * {@link S_draw_model(const Swindow *, const Smodel *)}.
+ *
+ * The shader of the model receives the values as vertex attributes which
+ * advance once per instance:
+ *
+ * @code
+ * layout (location = 3) in mat4 i_model;
+ * layout (location = 7) in vec4 i_color;
+ * layout (location = 8) in vec4 i_data;
+ * @endcode
+ *
+ * If @p colors is <c>NULL</c>, every instance is given the colour
+ * @f$(1,1,1,1)@f$. If @p data is <c>NULL</c>, every instance is given
+ * @f$(0,0,0,0)@f$.
+ *
+ * Every instance is drawn at the level of detail of the model, as with
+ * {@link S_draw_model}.
+ *
+ * @param[in] window The window to draw to.
+ * @param[in] model The model to draw.
+ * @param[in] transforms The model matrix of each instance.
+ * @param[in] colors The colour of each instance, or <c>NULL</c>.
+ * @param[in] data The extra data of each instance, or <c>NULL</c>.
+ * @param[in] count The number of instances to draw.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid window, model or array
+ * of transforms is provided to the function.
+ * @since 1.0.0
+ */
+STICKY_API void  S_draw_model_instanced(const Swindow *, const Smodel *,
+                                        const Smat4 *, const Svec4 *,
+                                        const Svec4 *, Suint32);
+
 /**
  * @brief Set the colour for future window drawing.
  *
@@ -197,6 +386,8 @@ STICKY_API void S_draw_set_texture(Swindow *, const Stexture *);
 
 void _S_draw_init(Suint8, Suint8);
 void _S_draw_free(void);
+void _S_draw_instances(Smesh *, Suint32, const Smat4 *, const Svec4 *,
+                       const Svec4 *, Suint32);
 
 /**
  * @}
@@ -31,20 +31,70 @@ extern "C"
  * @{
  */
 
-#define S_GLYPH_BEGIN       32  /* first glyph to load */
-#define S_GLYPH_END         128 /* last glyph to load */
+#define S_GLYPH_BEGIN       32  /* first glyph to preload */
+#define S_GLYPH_END         128 /* last glyph to preload */
 #define S_GLYPH_NUM (S_GLYPH_END - S_GLYPH_BEGIN)
 #define S_GLYPH_BUFFER_SIZE 128 /* buffer size for draw call batching */
 
+/**
+ * @brief The spread of a signed distance field font in pixels.
+ *
+ * This is the furthest distance from the outline of a glyph that is recorded
+ * in the atlas of a font loaded by {@link S_font_load_sdf}, measured in pixels
+ * of the size at which the font was loaded. The larger the spread, the further
+ * the font may be scaled down before its edges lose their anti-aliasing.
+ *
+ * @hideinitializer
+ * @since 1.0.0
+ */
+#define S_FONT_SDF_SPREAD   8
+
+/**
+ * @brief The width and height of each page of a font atlas in texels.
+ *
+ * @hideinitializer
+ * @since 1.0.0
+ */
+#define S_FONT_PAGE_SIZE    512
+
+/**
+ * @brief The number of pages in the atlas of each font.
+ *
+ * Must be at most @f$32@f$.
+ *
+ * @hideinitializer
+ * @since 1.0.0
+ */
+#define S_FONT_PAGES        4
+
+#define _S_GLYPH_QUAD_FLOATS 30 /* six vertices of position, uv and page */
+
 typedef struct _Sglyph_s
 {
 	Svec2 size, offset;
 	Sint32 xbearing, ybearing, xadvance, yadvance;
-	Suint32 xtexsize, ytexsize;
-	Schar id;
-	Sbool fail;
+	Suint32 codepoint, page;
 } _Sglyph;
 
+typedef struct _Stextlayout_glyph_s
+{
+	Suint32 codepoint;
+	Sfloat x, y; /* pen position relative to the start of the text */
+} _Stextlayout_glyph;
+
+typedef struct _Stextlayout_s
+{
+	_Stextlayout_glyph *glyphs;
+	Schar *text;
+	Ssize_t len, count, cap;
+	Sfloat scale, wrap;
+	Sfloat xoff, yoff, width, height;
+	Suint32 hash, stamp, lines;
+	Sbool valid;
+} _Stextlayout;
+
+struct _Sfont_cache_s;
+
 /**
  * @brief Font data structure.
  *
@@ -53,6 +103,15 @@ typedef struct _Sglyph_s
  * processing TrueType and PostScript fonts among others whereby the font is
  * rasterised into a compact GL texture to be displayed on the screen.
  *
+ * Text is given to fonts as UTF-8. Glyphs are rasterised when they are first
+ * drawn or measured, into an array texture of {@link S_FONT_PAGES} pages of
+ * {@link S_FONT_PAGE_SIZE} texels packed by a skyline packer, and found again
+ * through a hash table of codepoints. Only the printable ASCII range is
+ * rasterised when the font is loaded. Once every page is full, the page which
+ * was drawn from least recently is cleared and reused. New glyphs are kept on
+ * the CPU until the next draw, which uploads them with one texture update per
+ * page.
+ *
  * @warning This module uses a built-in shader compiled for OpenGL 3.3 Core.
  * Ensure a compatible profile is used before attempting to call
  * {@link S_font_load(const Schar *, float)} or else all behaviour shall be
@@ -63,8 +122,8 @@ typedef struct Sfont_s
 {
 	GLuint texture;
 	Suint32 width, height;
-	_Sglyph glyphs[S_GLYPH_NUM];
-	GLuint vao, vbo;
+	Sbool sdf;
+	struct _Sfont_cache_s *cache;
 } Sfont;
 
 /**
@@ -84,6 +143,75 @@ typedef struct Sfont_s
  */
 STICKY_API Sfont *S_font_load(const Schar *, Sfloat);
 
+/**
+ * @brief Load a font from file as a signed distance field.
+ *
+ * Loads a font in the same way as {@link S_font_load}, except that each texel
+ * of the atlas holds the distance to the nearest outline of its glyph rather
+ * than its coverage, up to {@link S_FONT_SDF_SPREAD} pixels. The outline is
+ * found again when drawing by interpolating between texels, so the text keeps
+ * sharp edges at any scale and a single small atlas serves every size of the
+ * font. A pixel size of @f$32@f$ is usually enough.
+ *
+ * Fonts loaded by this function are drawn with a distance field shader by the
+ * same functions as any other font.
+ *
+ * @param[in] filename The file path to the font to be loaded.
+ * @param[in] pixel_size The size of the font for generation.
+ * @return A pointer to a newly allocated and loaded font.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid file path is provided
+ * to the function, or if @p pixel_size is less than or equal to @f$0@f$.
+ * @exception S_INVALID_OPERATION If the linked FreeType library is older than
+ * 2.11 and cannot render distance fields.
+ * @since 1.0.0
+ */
+STICKY_API Sfont *S_font_load_sdf(const Schar *, Sfloat);
+
+/**
+ * @brief Load a font from file and its atlas from a cache file.
+ *
+ * Loads a font whose atlas and glyph metrics were saved by
+ * {@link S_font_save_cache}, so that none of the glyphs in the cache are
+ * rasterised again. The font is loaded at the pixel size and as the kind of
+ * font, plain or signed distance field, that it was saved with. Glyphs missing
+ * from the cache are rasterised as they are needed as with any other font.
+ *
+ * Cache files are written in the byte order of the machine that saved them,
+ * and are rejected if they were saved from another face or by a build with a
+ * different atlas size, in which case the font should be loaded with
+ * {@link S_font_load} or {@link S_font_load_sdf} and saved again.
+ *
+ * @param[in] filename The file path to the font to be loaded.
+ * @param[in] cache_filename The file path to the cache file.
+ * @return A pointer to a newly allocated and loaded font, or <c>NULL</c> if the
+ * cache file could not be used.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid file path is provided
+ * to the function.
+ * @exception S_IO_ERROR If the cache file could not be read.
+ * @exception S_INVALID_FORMAT If the cache file is not a font cache file, or
+ * was saved from another face or with a different atlas size.
+ * @exception S_INVALID_OPERATION If the cache file holds a signed distance
+ * field font and the linked FreeType library is older than 2.11.
+ * @since 1.0.0
+ */
+STICKY_API Sfont *S_font_load_cache(const Schar *, const Schar *);
+
+/**
+ * @brief Save the atlas of a font to a cache file.
+ *
+ * Writes every glyph currently in the atlas of a font along with its metrics,
+ * so that the font may later be loaded by {@link S_font_load_cache} without
+ * rasterising them. Only the rows of each page that hold glyphs are written.
+ *
+ * @param[in] font The font to save.
+ * @param[in] filename The file path to write the cache file to.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid font or file path is
+ * provided to the function.
+ * @exception S_IO_ERROR If the cache file could not be written.
+ * @since 1.0.0
+ */
+STICKY_API void   S_font_save_cache(const Sfont *, const Schar *);
+
 /**
  * @brief Free a font from memory.
  *
@@ -105,19 +233,32 @@ STICKY_API void   S_font_delete(Sfont *);
  *
  * This is useful for calculating bounds and positioning text accordingly.
  * Note that the bounds include the ascender and descender portions of drawn
- * text.
+ * text. The width is measured from the position the text is drawn at to the
+ * right edge of its last glyph, and the height from the lowest to the highest
+ * edge of its glyphs. Each newline in the text starts a new line one line
+ * height below the last.
+ *
+ * The height is the distance between the top and the bottom of the glyphs as
+ * they are laid out, and so no longer adds the offset of the lowest glyph
+ * below the baseline to the height of the tallest glyph. Text centred on the
+ * height is therefore centred on its glyphs, which may shift it slightly from
+ * where it was centred before.
+ *
+ * The glyph positions and extents of recently measured or drawn text are
+ * cached by the font, keyed on the text and scale, so that measuring the same
+ * text several times a frame and then drawing it lays it out only once.
  *
  * If either @p w or @p h is equal to <c>NULL</c>, then that extent will not be
  * returned.
  *
  * @param[in] font The font from which the extents are derived.
- * @param[in] text The text from which the extents are derived.
+ * @param[in] text The UTF-8 text from which the extents are derived.
  * @param[in] len The number of chars in @p text.
  * @param[in] scale The scale of the text.
  * @param[out] xoff The x-offset extent of the text and font.
  * @param[out] yoff The y-offset extent of the text and font.
  * @param[out] w The width extent of the text and font.
- * @param[out] h The height extent of the text and font.
+ * @param[out] h The height from the bottom to the top of the laid out glyphs.
  * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid font, string is
  * provided to the function, or if @p pixel_size is less than or equal to
  * @f$0@f$.
@@ -127,8 +268,63 @@ STICKY_API void   S_font_get_extents(const Sfont *, const Schar *, Ssize_t,
                                      Sfloat,
 									 Sfloat *, Sfloat *, Sfloat *, Sfloat *);
 
+/**
+ * @brief Query for the extents of text wrapped within a width.
+ *
+ * Measures text in the same way as {@link S_font_get_extents}, except that a
+ * line is broken at its last space before any glyph would be placed past
+ * @p width, or before that glyph if the line has no space. Spaces are allowed
+ * to hang past the width at the end of a line. Each line is placed one line
+ * height below the last, as given by {@link S_font_get_line_height}.
+ *
+ * The wrapped layout is cached along with the width, and is drawn without
+ * being laid out again by {@link S_draw_text_wrapped_2d}.
+ *
+ * @param[in] font The font from which the extents are derived.
+ * @param[in] text The UTF-8 text from which the extents are derived.
+ * @param[in] len The number of chars in @p text.
+ * @param[in] scale The scale of the text.
+ * @param[in] width The width to wrap the text within.
+ * @param[out] xoff The x-offset extent of the text and font.
+ * @param[out] yoff The y-offset extent of the text and font.
+ * @param[out] w The width extent of the text and font.
+ * @param[out] h The height extent of the text and font.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid font or string is
+ * provided to the function, or if @p scale or @p width are less than or equal
+ * to @f$0@f$.
+ * @since 1.0.0
+ */
+STICKY_API void   S_font_get_wrapped_extents(const Sfont *, const Schar *,
+                                             Ssize_t, Sfloat, Sfloat,
+                                             Sfloat *, Sfloat *,
+                                             Sfloat *, Sfloat *);
+
+/**
+ * @brief Get the distance between the baselines of two lines of text.
+ *
+ * @param[in] font The font.
+ * @param[in] scale The scale of the text.
+ * @return The line height of the font at the given scale.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid font is provided to
+ * the function, or if @p scale is less than or equal to @f$0@f$.
+ * @since 1.0.0
+ */
+STICKY_API Sfloat S_font_get_line_height(const Sfont *, Sfloat);
+
 void _S_font_init(Suint8, Suint8);
 void _S_font_free(void);
+const _Sglyph *_S_font_get_glyph(const Sfont *, Suint32);
+void _S_font_tick(const Sfont *);
+void _S_font_touch(const Sfont *, Suint32);
+void _S_font_upload(const Sfont *);
+Suint32 _S_font_get_generation(const Sfont *);
+Suint32 _S_font_next_codepoint(const Schar *, Ssize_t, Ssize_t *);
+const _Stextlayout *_S_font_get_layout(const Sfont *, const Schar *, Ssize_t,
+                                       Sfloat, Sfloat);
+void _S_font_get_layout_extents(const Sfont *, const Schar *, Ssize_t, Sfloat,
+                                Sfloat, Sfloat *, Sfloat *, Sfloat *, Sfloat *);
+Sbool _S_font_glyph_quad(const Sfont *, const _Sglyph *, Sfloat, Sfloat *,
+                         Sfloat *, Sfloat *);
 
 /**
  * @}
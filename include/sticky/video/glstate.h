@@ -0,0 +1,127 @@
+/*
+ * This file is licensed under BSD 3-Clause.
+ * All license information is available in the included COPYING file.
+ */
+
+/*
+ * glstate.h
+ * OpenGL state cache header.
+ *
+ * Author       : Finn Rayment <finn@rayment.fr>
+ * Date created : 18/10/2026
+ */
+
+#ifndef FR_RAYMENT_STICKY_GLSTATE_H
+#define FR_RAYMENT_STICKY_GLSTATE_H 1
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+#include "sticky/common/defines.h"
+#include "sticky/common/includes.h"
+#include "sticky/common/types.h"
+
+/**
+ * @addtogroup glstate
+ * @{
+ */
+
+/**
+ * @brief The number of texture units whose bindings are cached.
+ *
+ * Bindings to texture units beyond this limit are always passed to the driver.
+ *
+ * @hideinitializer
+ * @since 1.0.0
+ */
+#define S_GLSTATE_TEXTURE_UNITS 32
+
+/**
+ * @brief OpenGL state cache statistics struct.
+ *
+ * Every state change made by the library is routed through a shadow copy of
+ * the OpenGL context state, which only passes a call on to the driver if it
+ * would change the current state. The shadow copy must be invalidated with
+ * {@link S_glstate_invalidate(void)} whenever the context state is changed
+ * outside of the library.
+ *
+ * The counters accumulate from the creation of the window, or from the last
+ * call to {@link S_glstate_reset_stats(void)}.
+ *
+ * @since 1.0.0
+ */
+typedef struct
+Sglstate_stats_s
+{
+	/**
+	 * @brief The number of state changes passed on to the driver.
+	 */
+	Suint64 issued;
+	/**
+	 * @brief The number of redundant state changes that were elided.
+	 */
+	Suint64 elided;
+} Sglstate_stats;
+
+/**
+ * @brief Get the OpenGL state cache statistics.
+ *
+ * @param[out] stats The output statistics.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> statistics struct is provided to
+ * the function.
+ * @since 1.0.0
+ */
+STICKY_API void S_glstate_get_stats(Sglstate_stats *);
+
+/**
+ * @brief Reset the OpenGL state cache statistics to zero.
+ *
+ * This does not affect the cached state itself.
+ *
+ * @since 1.0.0
+ */
+STICKY_API void S_glstate_reset_stats(void);
+
+/**
+ * @brief Forget the cached OpenGL state.
+ *
+ * The cache only knows about state changed through the library. If the
+ * context state is changed by any other means, such as by raw OpenGL calls
+ * or by another library sharing the context, the cache no longer matches the
+ * context and may wrongly elide later changes. Calling this function after
+ * such changes marks every cached value as unknown, so that the next change
+ * of each is always passed on to the driver.
+ *
+ * This does not affect the statistics.
+ *
+ * @since 1.0.0
+ */
+STICKY_API void S_glstate_invalidate(void);
+
+void _S_glstate_reset(void);
+void _S_glstate_use_program(GLuint);
+void _S_glstate_bind_vertex_array(GLuint);
+void _S_glstate_bind_buffer(GLenum, GLuint);
+void _S_glstate_active_texture(Suint32);
+void _S_glstate_bind_texture(GLenum, GLuint);
+void _S_glstate_enable(GLenum);
+void _S_glstate_disable(GLenum);
+void _S_glstate_blend_func(GLenum, GLenum);
+void _S_glstate_depth_mask(GLboolean);
+void _S_glstate_forget_program(GLuint);
+void _S_glstate_forget_vertex_array(GLuint);
+void _S_glstate_forget_buffer(GLuint);
+void _S_glstate_forget_texture(GLuint);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* FR_RAYMENT_STICKY_GLSTATE_H */
+
@@ -21,6 +21,7 @@ extern "C"
 
 #include "sticky/common/defines.h"
 #include "sticky/common/types.h"
+#include "sticky/math/mat4.h"
 #include "sticky/math/vec3.h"
 
 /**
@@ -32,6 +33,120 @@ extern "C"
 #define S_MESH_LINES     GL_LINES
 #define S_MESH_POINTS    GL_POINTS
 
+/**
+ * @brief The maximum number of levels of detail of a mesh, including the
+ * full mesh.
+ *
+ * @hideinitializer
+ * @since 1.0.0
+ */
+#define S_MESH_LODS      8
+
+/**
+ * @brief 32-bit floating point vertex attribute format.
+ *
+ * Valid for positions, normals and UVs.
+ *
+ * @hideinitializer
+ * @since 1.0.0
+ */
+#define S_VERTEX_FLOAT      0
+
+/**
+ * @brief 16-bit floating point vertex attribute format.
+ *
+ * Valid for UVs.
+ *
+ * @hideinitializer
+ * @since 1.0.0
+ */
+#define S_VERTEX_HALF_FLOAT 1
+
+/**
+ * @brief Normalised 16-bit integer vertex attribute format.
+ *
+ * Valid for positions. Each position is quantised relative to the bounds of
+ * the mesh, so that the shader receives coordinates between @f$-1@f$ and
+ * @f$1@f$. The matrix returned by
+ * {@link S_mesh_get_position_transform(const Smesh *, Smat4 *)} maps them back
+ * to model space.
+ *
+ * @hideinitializer
+ * @since 1.0.0
+ */
+#define S_VERTEX_SNORM16    2
+
+/**
+ * @brief Normalised 10:10:10:2 packed vertex attribute format.
+ *
+ * Valid for normals. The normal is decoded by OpenGL, so the shader does not
+ * need to change.
+ *
+ * @hideinitializer
+ * @since 1.0.0
+ */
+#define S_VERTEX_PACKED     3
+
+/**
+ * @brief Octahedral vertex attribute format.
+ *
+ * Valid for normals. Each normal is stored as two normalised 16-bit integers
+ * in a <c>vec2</c> attribute, which the shader must decode:
+ *
+ * @code
+ * vec3 n = vec3(e.xy, 1.0 - abs(e.x) - abs(e.y));
+ * float t = max(-n.z, 0.0);
+ * n.xy += vec2(n.x >= 0.0 ? -t : t, n.y >= 0.0 ? -t : t);
+ * n = normalize(n);
+ * @endcode
+ *
+ * @hideinitializer
+ * @since 1.0.0
+ */
+#define S_VERTEX_OCTAHEDRAL 4
+
+/**
+ * @brief Vertex layout struct.
+ *
+ * Describes the format in which each attribute of a mesh is stored on the GPU.
+ * Every attribute is interleaved into a single vertex buffer, with the
+ * position bound to attribute location 0, the normal to location 1 and the UV
+ * to location 2.
+ *
+ * Smaller formats reduce the memory bandwidth used when drawing a mesh, at the
+ * cost of precision.
+ *
+ * @since 1.0.0
+ */
+typedef struct
+Svertex_layout_s
+{
+	/**
+	 * @brief The format of the position, either {@link S_VERTEX_FLOAT} or
+	 * {@link S_VERTEX_SNORM16}.
+	 */
+	Senum position;
+	/**
+	 * @brief The format of the normal, either {@link S_VERTEX_FLOAT},
+	 * {@link S_VERTEX_PACKED} or {@link S_VERTEX_OCTAHEDRAL}.
+	 */
+	Senum normal;
+	/**
+	 * @brief The format of the UV, either {@link S_VERTEX_FLOAT} or
+	 * {@link S_VERTEX_HALF_FLOAT}.
+	 */
+	Senum uv;
+} Svertex_layout;
+
+typedef struct
+_Smesh_lod_s
+{
+	Suint32 ebo;
+	Ssize_t icount;
+	Senum itype;
+	Sfloat error;
+} _Smesh_lod;
+
 /**
  * @brief Collection of 3D vertices as visual objects.
  *
@@ -41,13 +156,19 @@ extern "C"
  * UV map to map textures onto models giving photographic detail to a given
  * model.
  *
+ * An indexed mesh may hold up to {@link S_MESH_LODS} levels of detail, each of
+ * which is a separate set of indices into the same vertex buffer, such as
+ * those generated by {@link S_meshopt_simplify}. Level 0 is the full mesh.
+ *
  * @since 1.0.0
  */
 typedef struct
 Smesh_s
 {
-	Suint32 vbo, vao, ebo, normals, uv;
-	Ssize_t vlen, ilen, uvlen;
+	Suint32 vbo, vao, instances, nlods;
+	Ssize_t vcount;
+	_Smesh_lod lods[S_MESH_LODS];
+	Svertex_layout layout;
 	Sbool use_indices;
 	Svec3 bounds_min, bounds_max;
 } Smesh;
@@ -59,7 +180,11 @@ Smesh_s
  *
  * Note that rendering will be performed using an element buffer object if the
  * indices array is not <c>NULL</c> which may lead to better rendering
- * performance than drawing via. the vertex array object.
+ * performance than drawing via. the vertex array object. Indices are stored
+ * in 16 bits where every index is less than 65536.
+ *
+ * Every attribute is stored as a 32-bit float. To store them in smaller
+ * formats, use {@link S_mesh_new_layout}.
  *
  * Note that the @p indices, @p normals and @p uv pointers may be <c>NULL</c>,
  * in which case their respective lengths must also be equal to 0 to avoid an
@@ -79,8 +204,9 @@ Smesh_s
  * @param[in] uvlen The number of elements in the @p uv array.
  * @return A given mesh allocated in memory.
  * @exception S_INVALID_VALUE If @p vertices is <c>NULL</c>, @p vlen is equal to
- * 0, or any of @p indices, @p normals or @p uv are <c>NULL</c> but their
- * lengths are not 0.
+ * 0, any of @p indices, @p normals or @p uv are <c>NULL</c> but their
+ * lengths are not 0, or @p normals or @p uv hold fewer points than
+ * @p vertices.
  * @since 1.0.0
  */
 STICKY_API Smesh *S_mesh_new(const Sfloat *, Ssize_t,
@@ -88,6 +214,41 @@ STICKY_API Smesh *S_mesh_new(const Sfloat *, Ssize_t,
                              const Sfloat *, Ssize_t,
                              const Sfloat *, Ssize_t);
 
+/**
+ * @brief Generate a new mesh from components with a given vertex layout.
+ *
+ * As with {@link S_mesh_new}, except that the components are converted to the
+ * formats given by @p layout before being uploaded. The bounds of the mesh are
+ * calculated from the unconverted positions.
+ *
+ * @param[in] layout The formats in which to store each attribute.
+ * @param[in] vertices The array of vertices (3 per point) from which to create
+ * a mesh.
+ * @param[in] vlen The number of elements in the @p vertices array.
+ * @param[in] indices The array of indices (3 per point) from which to create a
+ * mesh.
+ * @param[in] ilen The number of elements in the @p indices array.
+ * @param[in] normals The array of normals (3 per point) from which to create a
+ * mesh.
+ * @param[in] nlen The number of elements in the @p normals array.
+ * @param[in] uv The array of UV points (2 per point) from which to create a
+ * mesh.
+ * @param[in] uvlen The number of elements in the @p uv array.
+ * @return A given mesh allocated in memory.
+ * @exception S_INVALID_VALUE If @p layout or @p vertices is <c>NULL</c>,
+ * @p vlen is equal to 0, any of @p indices, @p normals or @p uv are
+ * <c>NULL</c> but their lengths are not 0, or @p normals or @p uv hold fewer
+ * points than @p vertices.
+ * @exception S_INVALID_ENUM If @p layout contains a format which is not valid
+ * for its attribute.
+ * @since 1.0.0
+ */
+STICKY_API Smesh *S_mesh_new_layout(const Svertex_layout *,
+                                    const Sfloat *, Ssize_t,
+                                    const Suint32 *, Ssize_t,
+                                    const Sfloat *, Ssize_t,
+                                    const Sfloat *, Ssize_t);
+
 /**
  * @brief Free a mesh from memory.
  *
@@ -101,8 +262,67 @@ STICKY_API Smesh *S_mesh_new(const Sfloat *, Ssize_t,
  */
 STICKY_API void   S_mesh_delete(Smesh *);
 
+/**
+ * @brief Get the matrix which maps the stored positions of a mesh to model
+ * space.
+ *
+ * For a mesh whose positions are stored as {@link S_VERTEX_SNORM16}, this is
+ * the scale and translation from the unit cube to the bounds of the mesh, and
+ * should be multiplied into the model matrix of the mesh. For any other mesh,
+ * it is the identity matrix.
+ *
+ * @param[in] mesh The mesh.
+ * @param[out] dest The output matrix.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid mesh or matrix is
+ * provided to the function.
+ * @since 1.0.0
+ */
+STICKY_API void   S_mesh_get_position_transform(const Smesh *, Smat4 *);
+
+/**
+ * @brief Set a level of detail of a mesh.
+ *
+ * Uploads a set of indices into the vertex buffer of the mesh as the given
+ * level of detail, replacing any indices previously set for that level. Levels
+ * must be set in order, so @p level may be at most the current number of
+ * levels. Setting level 0 replaces the indices of the full mesh.
+ *
+ * Each level should have fewer triangles and a greater @p error than the level
+ * before it, since {@link S_model_select_lod} picks the coarsest level whose
+ * error is too small to be seen.
+ *
+ * @param[in,out] mesh The mesh to modify.
+ * @param[in] level The level of detail to set.
+ * @param[in] indices The array of indices (3 per triangle).
+ * @param[in] ilen The number of elements in the @p indices array.
+ * @param[in] error The largest distance between the surface of this level and
+ * the full mesh, in model space, such as that given by
+ * {@link S_meshopt_simplify}.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid mesh or index array
+ * is provided to the function, if @p ilen is equal to 0, if @p level is
+ * greater than the number of levels or not less than {@link S_MESH_LODS}, or
+ * if @p error is negative.
+ * @exception S_INVALID_OPERATION If the mesh was created without indices.
+ * @since 1.0.0
+ */
+STICKY_API void   S_mesh_set_lod(Smesh *, Suint32, const Suint32 *, Ssize_t,
+                                 Sfloat);
+
+/**
+ * @brief Get the number of levels of detail of a mesh.
+ *
+ * @param[in] mesh The mesh.
+ * @return The number of levels of detail, including the full mesh.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid mesh is provided to
+ * the function.
+ * @since 1.0.0
+ */
+STICKY_API Suint32 S_mesh_get_lod_count(const Smesh *);
+
 void _S_mesh_draw(const Smesh *, Senum);
+void _S_mesh_draw_lod(const Smesh *, Senum, Suint32);
 void _S_mesh_draw_count(const Smesh *, Senum, Suint64);
+void _S_mesh_draw_instanced(const Smesh *, Senum, Suint32, Suint32);
 
 /**
  * @}
@@ -16,15 +16,28 @@ extern "C"
 #include "sticky/collections/linkedlist.h"
 #include "sticky/common/defines.h"
 #include "sticky/common/types.h"
+#include "sticky/math/mat4.h"
 #include "sticky/video/material.h"
 #include "sticky/video/mesh.h"
 #include "sticky/video/shader.h"
 
+/* forward declaration */
+struct Scamera_s;
+
 /**
  * @addtogroup model
  * @{
  */
 
+/**
+ * @brief The default level of detail threshold of a model, in pixels.
+ *
+ * @see {@link S_model_set_lod_threshold} For the meaning of the threshold.
+ * @hideinitializer
+ * @since 1.0.0
+ */
+#define S_MODEL_LOD_THRESHOLD 1.0f
+
 /**
  * @brief Renderable model.
  *
@@ -35,6 +48,9 @@ extern "C"
  * form an ancestral hierarchy which are all rendered together in order at
  * runtime.
  *
+ * If the mesh of a model has several levels of detail, the model is drawn at
+ * the level chosen by {@link S_model_select_lod} or {@link S_model_set_lod}.
+ *
  * @since 1.0.0
  */
 typedef struct
@@ -45,6 +61,8 @@ Smodel_s
 	Sshader *shader;
 	Slinkedlist *children;
 	struct Smodel_s *parent;
+	Suint32 lod;
+	Sfloat lod_threshold;
 } Smodel;
 
 /**
@@ -185,6 +203,76 @@ STICKY_API Smaterial *S_model_get_material(const Smodel *);
  */
 STICKY_API Sshader  *S_model_get_shader(const Smodel *);
 
+/**
+ * @brief Set the level of detail of a model.
+ *
+ * If @p lod is not less than the number of levels of the mesh of the model,
+ * the coarsest level is drawn.
+ *
+ * @param[in,out] model The model to modify.
+ * @param[in] lod The level of detail to draw the model at.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid model is provided to
+ * the function.
+ * @since 1.0.0
+ */
+STICKY_API void      S_model_set_lod(Smodel *, Suint32);
+
+/**
+ * @brief Get the level of detail of a model.
+ *
+ * @param[in] model The model.
+ * @return The level of detail the model is drawn at.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid model is provided to
+ * the function.
+ * @since 1.0.0
+ */
+STICKY_API Suint32   S_model_get_lod(const Smodel *);
+
+/**
+ * @brief Set the level of detail threshold of a model.
+ *
+ * The threshold is the largest error, in pixels on the screen, that a level of
+ * detail may show before a finer level is used instead. Greater thresholds
+ * draw coarser levels sooner. By default, the threshold is
+ * {@link S_MODEL_LOD_THRESHOLD}.
+ *
+ * @param[in,out] model The model to modify.
+ * @param[in] threshold The threshold in pixels.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid model is provided to
+ * the function, or if @p threshold is negative.
+ * @since 1.0.0
+ */
+STICKY_API void      S_model_set_lod_threshold(Smodel *, Sfloat);
+
+/**
+ * @brief Choose the level of detail of a model from its size on the screen.
+ *
+ * The bounds of the mesh of the model are transformed by @p transform into a
+ * bounding sphere, and the number of pixels covered by one unit at the nearest
+ * point of that sphere is found from the field-of-view and height of the
+ * camera. The coarsest level of detail whose error, projected at that
+ * distance, is within the threshold of the model is then chosen, and is used
+ * by every later draw of the model.
+ *
+ * Models whose bounding sphere reaches the near-plane of the camera are drawn
+ * at full detail.
+ *
+ * This should be called once per frame for each model whose mesh has more
+ * than one level of detail, before the model is drawn or submitted to an
+ * {@link Srenderqueue}.
+ *
+ * @param[in,out] model The model.
+ * @param[in] camera The camera the model is viewed from.
+ * @param[in] transform The model matrix of the model, or <c>NULL</c> for the
+ * identity matrix.
+ * @return The chosen level of detail.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid model or camera is
+ * provided to the function.
+ * @since 1.0.0
+ */
+STICKY_API Suint32   S_model_select_lod(Smodel *, const struct Scamera_s *,
+                                        const Smat4 *);
+
 /**
  * @}
  */
@@ -0,0 +1,220 @@
+/*
+ * This file is licensed under BSD 3-Clause.
+ * All license information is available in the included COPYING file.
+ */
+
+/*
+ * renderqueue.h
+ * Sorted render queue header.
+ *
+ * Author       : Finn Rayment <finn@rayment.fr>
+ * Date created : 18/10/2026
+ */
+
+#ifndef FR_RAYMENT_STICKY_RENDERQUEUE_H
+#define FR_RAYMENT_STICKY_RENDERQUEUE_H 1
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+#include "sticky/common/defines.h"
+#include "sticky/common/types.h"
+#include "sticky/math/mat4.h"
+#include "sticky/video/model.h"
+#include "sticky/video/window.h"
+
+/**
+ * @addtogroup renderqueue
+ * @{
+ */
+
+/**
+ * @brief The number of layers of a render queue.
+ *
+ * Every command in a lower layer is drawn before any command in a higher
+ * layer.
+ *
+ * @hideinitializer
+ * @since 1.0.0
+ */
+#define S_RENDERQUEUE_LAYERS 16
+
+typedef struct
+_Srenderqueue_cmd_s
+{
+	const Smodel *model;
+	Smat4 transform;
+	Sbool has_transform, translucent;
+} _Srenderqueue_cmd;
+
+/**
+ * @brief Render queue struct.
+ *
+ * A render queue collects draw commands over a frame and draws them in an
+ * order that minimises changes of state. Each command is given a 64-bit sort
+ * key packed from its layer, whether it is translucent, its shader, its
+ * material, its mesh and its depth. The keys are sorted with a radix sort and
+ * the shader and material are only changed where they differ from the
+ * previous command.
+ *
+ * Within a layer, opaque commands are drawn first, grouped by shader, material
+ * and mesh, and front-to-back within each group so that later fragments fail
+ * the depth test early. Translucent commands are then drawn back-to-front
+ * without writing to the depth buffer, so that they blend correctly.
+ *
+ * If instancing is enabled with
+ * {@link S_renderqueue_set_instancing(Srenderqueue *, Sbool)}, consecutive
+ * commands sharing a mesh, material and shader are merged into a single
+ * instanced draw.
+ *
+ * @since 1.0.0
+ */
+typedef struct
+Srenderqueue_s
+{
+	_Srenderqueue_cmd *commands;
+	Suint64 *keys, *tmpkeys;
+	Suint32 *order, *tmporder;
+	Smat4 *transforms;
+	Suint32 len, cap;
+	Sbool sorted, instancing;
+} Srenderqueue;
+
+/**
+ * @brief Create a new render queue.
+ *
+ * @return A new, empty render queue allocated on the heap. To correctly destroy
+ * the render queue, call {@link S_renderqueue_delete(Srenderqueue *)}.
+ * @since 1.0.0
+ */
+STICKY_API Srenderqueue *S_renderqueue_new(void);
+
+/**
+ * @brief Free a render queue from memory.
+ *
+ * The models referenced by the queue are not freed.
+ *
+ * @param[in,out] queue The render queue to free from memory.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid render queue is
+ * provided to the function.
+ * @since 1.0.0
+ */
+STICKY_API void          S_renderqueue_delete(Srenderqueue *);
+
+/**
+ * @brief Remove every command from a render queue.
+ *
+ * This should be called once per frame before submitting commands. The memory
+ * of the queue is kept for the next frame.
+ *
+ * @param[in,out] queue The render queue to clear.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid render queue is
+ * provided to the function.
+ * @since 1.0.0
+ */
+STICKY_API void          S_renderqueue_clear(Srenderqueue *);
+
+/**
+ * @brief Submit a model to a render queue.
+ *
+ * The model is not drawn until the queue is executed, so it must not be freed
+ * or modified before then. As with
+ * {@link S_draw_model(const Swindow *, const Smodel *)}, models without a mesh,
+ * material and shader are ignored.
+ *
+ * If a transform is given, it is uploaded to the <c>u_model</c> uniform of the
+ * shader of the model before it is drawn.
+ *
+ * @param[in,out] queue The render queue.
+ * @param[in] model The model to draw.
+ * @param[in] transform The model matrix of the model, or <c>NULL</c>.
+ * @param[in] depth The distance of the model from the camera.
+ * @param[in] layer The layer of the model, less than
+ * {@link S_RENDERQUEUE_LAYERS}.
+ * @param[in] translucent Whether the model must be blended with what is
+ * behind it.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid render queue or model
+ * is provided to the function, or if @p layer is out of range.
+ * @since 1.0.0
+ */
+STICKY_API void          S_renderqueue_submit(Srenderqueue *, const Smodel *,
+                                              const Smat4 *, Sfloat, Suint8,
+                                              Sbool);
+
+/**
+ * @brief Sort the commands of a render queue.
+ *
+ * This is called automatically by
+ * {@link S_renderqueue_execute(const Swindow *, Srenderqueue *)} if the queue
+ * has changed since it was last sorted, but may be called earlier, such as on
+ * another thread.
+ *
+ * @param[in,out] queue The render queue to sort.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid render queue is
+ * provided to the function.
+ * @since 1.0.0
+ */
+STICKY_API void          S_renderqueue_sort(Srenderqueue *);
+
+/**
+ * @brief Draw every command of a render queue.
+ *
+ * The commands are kept, so that the queue may be executed again, such as for
+ * another view.
+ *
+ * Opaque commands are drawn with blending disabled, and translucent commands
+ * with blending enabled using the standard alpha blend function. Blending is
+ * left enabled with that function once the queue has been drawn, as it is
+ * when the window is created.
+ *
+ * @param[in] window The window to draw to.
+ * @param[in,out] queue The render queue to draw.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid window or render
+ * queue is provided to the function.
+ * @since 1.0.0
+ */
+STICKY_API void          S_renderqueue_execute(const Swindow *,
+                                               Srenderqueue *);
+
+/**
+ * @brief Set whether a render queue merges commands into instanced draws.
+ *
+ * When enabled, every run of consecutive commands with a transform that share
+ * a mesh, material and shader is drawn with a single instanced draw call, so
+ * the shaders of the submitted models must read the model matrix from the
+ * {@link S_DRAW_INSTANCE_TRANSFORM} attribute rather than the <c>u_model</c>
+ * uniform. Commands without a transform are drawn as usual.
+ *
+ * Instancing is disabled by default.
+ *
+ * @param[in,out] queue The render queue.
+ * @param[in] enabled Whether to merge commands into instanced draws.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid render queue is
+ * provided to the function.
+ * @since 1.0.0
+ */
+STICKY_API void          S_renderqueue_set_instancing(Srenderqueue *, Sbool);
+
+/**
+ * @brief Get the number of commands in a render queue.
+ *
+ * @param[in] queue The render queue.
+ * @return The number of commands.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid render queue is
+ * provided to the function.
+ * @since 1.0.0
+ */
+STICKY_API Ssize_t       S_renderqueue_size(const Srenderqueue *);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* FR_RAYMENT_STICKY_RENDERQUEUE_H */
+
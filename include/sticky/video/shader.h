@@ -46,12 +46,34 @@ extern "C"
  *     <li><c>vec2</c>: uv coordinates</li>
  * </ol>
  *
+ * The locations of all active uniforms are read once when the shader is
+ * created and stored in a hash table, so that setting a uniform by name does
+ * not query GL. Hot code may instead fetch a handle for a uniform once with
+ * {@link S_shader_get_uniform_handle(Sshader *, const Schar *)} and set it
+ * with the <c>S_shader_set_uniform_handle_*</c> functions, which skip the
+ * name lookup entirely.
+ *
+ * Once a cache directory is given with
+ * {@link S_shader_set_cache_directory(const Schar *)}, linked programs are
+ * saved there as driver binaries and loaded back instead of being compiled
+ * again, which shortens startup considerably for games with many shaders.
+ *
  * @since 1.0.0
  */
+typedef struct
+_Sshader_uniform_s
+{
+	Schar *name;
+	Suint32 hash;
+	GLint location;
+} _Sshader_uniform;
+
 typedef struct
 Sshader_s
 {
 	GLuint program;
+	_Sshader_uniform *uniforms;
+	Suint32 ulen, ucap;
 } Sshader;
 
 /**
@@ -100,6 +122,28 @@ STICKY_API Sshader *S_shader_load(const Schar *, const Schar *);
  */
 STICKY_API void     S_shader_delete(Sshader *);
 
+/**
+ * @brief Set the directory in which shader programs are cached.
+ *
+ * Every shader program created from then on is looked up in the directory by
+ * a hash of its sources and of the vendor, renderer and version of the GL
+ * driver. If a binary is found and accepted by the driver, the program is
+ * loaded from it without compiling its sources. Otherwise the program is
+ * compiled as usual and its binary is written to the directory for the next
+ * run. Binaries of other drivers or of sources that have since changed are
+ * never used, and are overwritten when they share a file.
+ *
+ * Caching requires OpenGL 4.1 or the <c>ARB_get_program_binary</c> extension,
+ * and is skipped silently without them. The directory must already exist.
+ * To also cache the built-in shaders, set the directory before the window is
+ * created. Caching is disabled by default.
+ *
+ * @param[in] directory The path to the cache directory, or <c>NULL</c> to
+ * disable caching.
+ * @since 1.0.0
+ */
+STICKY_API void     S_shader_set_cache_directory(const Schar *);
+
 /**
  * @brief Set a single-precision floating-point uniform for a shader.
  *
@@ -215,6 +259,140 @@ STICKY_API void     S_shader_set_uniform_mat3(Sshader *, const Schar *,
 STICKY_API void     S_shader_set_uniform_mat4(Sshader *, const Schar *,
                                               const Smat4 *);
 
+/**
+ * @brief Get the handle of a uniform in a shader.
+ *
+ * Looks up the location of a uniform by name. The handle remains valid for the
+ * lifetime of the shader and may be passed to the
+ * <c>S_shader_set_uniform_handle_*</c> functions to set the uniform without
+ * looking up its name again.
+ *
+ * Elements of uniform arrays may be looked up by their full name, such as
+ * <c>u_lights[2]</c>, and the first element also by the name of the array.
+ *
+ * @param[in,out] shader The shader.
+ * @param[in] name The name of the uniform.
+ * @return The handle of the uniform, or <c>-1</c> if the shader has no active
+ * uniform by that name. Setting a uniform with a handle of <c>-1</c> does
+ * nothing.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid shader or uniform name
+ * is provided to the function.
+ * @since 1.0.0
+ */
+STICKY_API Sint32   S_shader_get_uniform_handle(Sshader *, const Schar *);
+
+/**
+ * @brief Set a single-precision floating-point uniform for a shader by handle.
+ *
+ * Sets the value of a uniform in a shader program to a single-precision
+ * floating-point value.
+ *
+ * @warning If a uniform of the incorrect type is provided to this function, GL
+ * may throw an error which shall crash the program.
+ * @param[in,out] shader The shader.
+ * @param[in] handle The handle of the uniform, as returned by
+ * {@link S_shader_get_uniform_handle(Sshader *, const Schar *)}.
+ * @param[in] val The value to set the uniform to.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid shader is provided
+ * to the function.
+ * @since 1.0.0
+ */
+STICKY_API void     S_shader_set_uniform_handle_float(Sshader *, Sint32,
+                                                      Sfloat);
+
+/**
+ * @brief Set a 32-bit signed integer uniform for a shader by handle.
+ *
+ * Sets the value of a uniform in a shader program to a 32-bit signed integer
+ * value.
+ *
+ * @warning If a uniform of the incorrect type is provided to this function, GL
+ * may throw an error which shall crash the program.
+ * @param[in,out] shader The shader.
+ * @param[in] handle The handle of the uniform, as returned by
+ * {@link S_shader_get_uniform_handle(Sshader *, const Schar *)}.
+ * @param[in] val The value to set the uniform to.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid shader is provided
+ * to the function.
+ * @since 1.0.0
+ */
+STICKY_API void     S_shader_set_uniform_handle_int32(Sshader *, Sint32,
+                                                      Sint32);
+
+/**
+ * @brief Set a 3D vector uniform for a shader by handle.
+ *
+ * Sets the value of a uniform in a shader program to a 3D vector value.
+ *
+ * @warning If a uniform of the incorrect type is provided to this function, GL
+ * may throw an error which shall crash the program.
+ * @param[in,out] shader The shader.
+ * @param[in] handle The handle of the uniform, as returned by
+ * {@link S_shader_get_uniform_handle(Sshader *, const Schar *)}.
+ * @param[in] val The value to set the uniform to.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid shader or value is
+ * provided to the function.
+ * @since 1.0.0
+ */
+STICKY_API void     S_shader_set_uniform_handle_vec3(Sshader *, Sint32,
+                                                     const Svec3 *);
+
+/**
+ * @brief Set a 4D vector uniform for a shader by handle.
+ *
+ * Sets the value of a uniform in a shader program to a 4D vector value.
+ *
+ * @warning If a uniform of the incorrect type is provided to this function, GL
+ * may throw an error which shall crash the program.
+ * @param[in,out] shader The shader.
+ * @param[in] handle The handle of the uniform, as returned by
+ * {@link S_shader_get_uniform_handle(Sshader *, const Schar *)}.
+ * @param[in] val The value to set the uniform to.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid shader or value is
+ * provided to the function.
+ * @since 1.0.0
+ */
+STICKY_API void     S_shader_set_uniform_handle_vec4(Sshader *, Sint32,
+                                                     const Svec4 *);
+
+/**
+ * @brief Set a 3D matrix uniform for a shader by handle.
+ *
+ * Sets the value of a uniform in a shader program to a 3D matrix value.
+ *
+ * @warning If a uniform of the incorrect type is provided to this function, GL
+ * may throw an error which shall crash the program.
+ * @param[in,out] shader The shader.
+ * @param[in] handle The handle of the uniform, as returned by
+ * {@link S_shader_get_uniform_handle(Sshader *, const Schar *)}.
+ * @param[in] val The value to set the uniform to.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid shader or value is
+ * provided to the function.
+ * @since 1.0.0
+ */
+STICKY_API void     S_shader_set_uniform_handle_mat3(Sshader *, Sint32,
+                                                     const Smat3 *);
+
+/**
+ * @brief Set a 4D matrix uniform for a shader by handle.
+ *
+ * Sets the value of a uniform in a shader program to a 4D matrix value.
+ *
+ * @warning If a uniform of the incorrect type is provided to this function, GL
+ * may throw an error which shall crash the program.
+ * @param[in,out] shader The shader.
+ * @param[in] handle The handle of the uniform, as returned by
+ * {@link S_shader_get_uniform_handle(Sshader *, const Schar *)}.
+ * @param[in] val The value to set the uniform to.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid shader or value is
+ * provided to the function.
+ * @since 1.0.0
+ */
+STICKY_API void     S_shader_set_uniform_handle_mat4(Sshader *, Sint32,
+                                                     const Smat4 *);
+
+void _S_shader_init(void);
+void _S_shader_free(void);
 void _S_shader_attach(const Sshader *);
 
 /**
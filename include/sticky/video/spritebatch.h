@@ -0,0 +1,228 @@
+/*
+ * This file is licensed under BSD 3-Clause.
+ * All license information is available in the included COPYING file.
+ */
+
+/*
+ * spritebatch.h
+ * Batched 2D quad renderer header.
+ *
+ * Author       : Finn Rayment <finn@rayment.fr>
+ * Date created : 18/10/2026
+ */
+
+#ifndef FR_RAYMENT_STICKY_SPRITEBATCH_H
+#define FR_RAYMENT_STICKY_SPRITEBATCH_H 1
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+#include "sticky/common/defines.h"
+#include "sticky/common/includes.h"
+#include "sticky/common/types.h"
+#include "sticky/math/mat4.h"
+#include "sticky/math/vec2.h"
+#include "sticky/math/vec4.h"
+#include "sticky/video/shader.h"
+#include "sticky/video/streambuffer.h"
+#include "sticky/video/texture.h"
+#include "sticky/video/window.h"
+
+/**
+ * @addtogroup spritebatch
+ * @{
+ */
+
+/**
+ * @brief The maximum number of quads a sprite batch may hold.
+ *
+ * Limited such that every vertex can be addressed by a 16-bit index.
+ *
+ * @hideinitializer
+ * @since 1.0.0
+ */
+#define S_SPRITEBATCH_MAX 16384
+
+/**
+ * @brief Draw quads in the order they were submitted.
+ *
+ * Consecutive quads that share a texture are drawn in a single call, so
+ * overlapping quads are layered exactly as submitted.
+ *
+ * @hideinitializer
+ * @since 1.0.0
+ */
+#define S_SPRITEBATCH_DEFERRED 0
+
+/**
+ * @brief Group quads by texture before drawing.
+ *
+ * Every quad that shares a texture is drawn in a single call, regardless of
+ * the order of submission. Quads that share a texture keep their relative
+ * order, but quads of different textures may be layered in any order.
+ *
+ * @hideinitializer
+ * @since 1.0.0
+ */
+#define S_SPRITEBATCH_TEXTURE  1
+
+typedef struct
+_Sspritebatch_vertex_s
+{
+	Sfloat x, y, u, v;
+	Suint8 color[4];
+} _Sspritebatch_vertex;
+
+/**
+ * @brief Sprite batch struct.
+ *
+ * A sprite batch accumulates textured and coloured quads in 2D space and draws
+ * them with as few draw calls as possible. Quads are written to client memory
+ * and written to an {@link Sstreambuffer} when the batch is flushed, so
+ * drawing a quad costs no calls to the driver and flushing never waits on the
+ * GPU to finish reading an earlier flush.
+ *
+ * A batch is flushed when it is ended, when it is full, or by calling
+ * {@link S_spritebatch_flush(Sspritebatch *)}. Each flush draws every run of
+ * quads that share a texture in one call, so sprites packed into one
+ * {@link Satlas} are drawn together however they are submitted.
+ *
+ * @since 1.0.0
+ */
+typedef struct
+Sspritebatch_s
+{
+	_Sspritebatch_vertex *vertices, *sorted;
+	GLuint *textures;
+	Suint64 *keys;
+	const Swindow *window;
+	Sshader *shader;
+	Sstreambuffer *stream;
+	Smat4 last_projection;
+	Sint32 projection;
+	GLuint vao, ebo, white;
+	Suint32 len, cap, calls;
+	Senum sort;
+	Sbool ordered;
+} Sspritebatch;
+
+/**
+ * @brief Create a new sprite batch.
+ *
+ * Requires an open window with an OpenGL context of at least version 3.3.
+ *
+ * @param[in] capacity The maximum number of quads held before the batch is
+ * flushed automatically.
+ * @return A new sprite batch allocated on the heap, or <c>NULL</c> if the
+ * capacity is invalid. To correctly destroy the sprite batch, call
+ * {@link S_spritebatch_delete(Sspritebatch *)}.
+ * @exception S_INVALID_VALUE If @p capacity is <c>0</c> or greater than
+ * {@link S_SPRITEBATCH_MAX}.
+ * @since 1.0.0
+ */
+STICKY_API Sspritebatch *S_spritebatch_new(Suint32);
+
+/**
+ * @brief Free a sprite batch from memory.
+ *
+ * Any quads that have not been flushed are discarded.
+ *
+ * @param[in,out] batch The sprite batch to free from memory.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid sprite batch is
+ * provided to the function.
+ * @since 1.0.0
+ */
+STICKY_API void          S_spritebatch_delete(Sspritebatch *);
+
+/**
+ * @brief Begin a sprite batch.
+ *
+ * Quads may only be drawn between a call to this function and a call to
+ * {@link S_spritebatch_end(Sspritebatch *)}. The 2D space is defined by the
+ * camera attached to the window at the time of each flush.
+ *
+ * @param[in,out] batch The sprite batch.
+ * @param[in] window The window to draw to.
+ * @param[in] sort The sorting mode. Either one of
+ * {@link S_SPRITEBATCH_DEFERRED} or {@link S_SPRITEBATCH_TEXTURE}.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid sprite batch or window
+ * is provided to the function.
+ * @exception S_INVALID_ENUM If an invalid sorting mode is provided to the
+ * function.
+ * @exception S_INVALID_OPERATION If the sprite batch has already begun.
+ * @since 1.0.0
+ */
+STICKY_API void          S_spritebatch_begin(Sspritebatch *, const Swindow *,
+                                             Senum);
+
+/**
+ * @brief Add a quad to a sprite batch.
+ *
+ * If the batch is full, it is flushed before the quad is added.
+ *
+ * @param[in,out] batch The sprite batch.
+ * @param[in] tex The texture of the quad, or <c>NULL</c> for a solid quad.
+ * @param[in] from The location of one point of the quad on the screen.
+ * @param[in] to The location diagonal to @p from of the quad on the screen.
+ * @param[in] uv The texture coordinates at @p from in <c>x</c> and <c>y</c> and
+ * at @p to in <c>z</c> and <c>w</c>, or <c>NULL</c> for the whole texture.
+ * @param[in] color The colour of the quad, or <c>NULL</c> for the current draw
+ * colour of the window.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid sprite batch or 2D
+ * vector, or a cubemap or array texture is provided to the function.
+ * @exception S_INVALID_OPERATION If the sprite batch has not begun.
+ * @since 1.0.0
+ */
+STICKY_API void          S_spritebatch_draw(Sspritebatch *, const Stexture *,
+                                            const Svec2 *, const Svec2 *,
+                                            const Svec4 *, const Svec4 *);
+
+/**
+ * @brief Draw every quad held by a sprite batch.
+ *
+ * The batch is left empty and may continue to be drawn to.
+ *
+ * @param[in,out] batch The sprite batch.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid sprite batch is
+ * provided to the function.
+ * @exception S_INVALID_OPERATION If the sprite batch has not begun.
+ * @since 1.0.0
+ */
+STICKY_API void          S_spritebatch_flush(Sspritebatch *);
+
+/**
+ * @brief End a sprite batch.
+ *
+ * Flushes the batch.
+ *
+ * @param[in,out] batch The sprite batch.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid sprite batch is
+ * provided to the function.
+ * @exception S_INVALID_OPERATION If the sprite batch has not begun.
+ * @since 1.0.0
+ */
+STICKY_API void          S_spritebatch_end(Sspritebatch *);
+
+/**
+ * @brief Get the number of draw calls made by a sprite batch.
+ *
+ * @param[in] batch The sprite batch.
+ * @return The number of draw calls made since the batch last began.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid sprite batch is
+ * provided to the function.
+ * @since 1.0.0
+ */
+STICKY_API Suint32       S_spritebatch_get_draw_calls(const Sspritebatch *);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* FR_RAYMENT_STICKY_SPRITEBATCH_H */
+
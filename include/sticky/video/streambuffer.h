@@ -0,0 +1,157 @@
+/*
+ * This file is licensed under BSD 3-Clause.
+ * All license information is available in the included COPYING file.
+ */
+
+/*
+ * streambuffer.h
+ * Streaming vertex buffer header.
+ *
+ * Author       : Finn Rayment <finn@rayment.fr>
+ * Date created : 18/10/2026
+ */
+
+#ifndef FR_RAYMENT_STICKY_STREAMBUFFER_H
+#define FR_RAYMENT_STICKY_STREAMBUFFER_H 1
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+#include "sticky/common/defines.h"
+#include "sticky/common/includes.h"
+#include "sticky/common/types.h"
+
+/**
+ * @addtogroup streambuffer
+ * @{
+ */
+
+/**
+ * @brief The number of regions in the ring of a stream buffer.
+ *
+ * The CPU writes to one region while the GPU may still be reading the others.
+ *
+ * @hideinitializer
+ * @since 1.0.0
+ */
+#define S_STREAMBUFFER_REGIONS 3
+
+/**
+ * @brief Stream buffer struct.
+ *
+ * A stream buffer is a vertex buffer for geometry that is rewritten every
+ * frame. It is split into {@link S_STREAMBUFFER_REGIONS} regions which are
+ * filled in turn. When a region is full, a fence is placed behind the draws
+ * reading from it and writing moves on to the next region, only waiting if
+ * the GPU has not yet finished with that region since it was last filled.
+ * Data is never overwritten while it may still be read, so writes do not stall
+ * on the implicit synchronisation of <c>glBufferSubData</c>.
+ *
+ * Where <c>GL_ARB_buffer_storage</c> is available, the buffer is mapped once
+ * with a persistent and coherent mapping and written to directly. Otherwise,
+ * each write maps its range without synchronisation, and the buffer is
+ * orphaned each time the ring wraps around.
+ *
+ * Since every write returns the index of its first element, many draws may
+ * share one buffer and one vertex array object, with attributes pointing at
+ * the start of the buffer.
+ *
+ * @since 1.0.0
+ */
+typedef struct
+Sstreambuffer_s
+{
+	GLuint vbo;
+	GLsync fences[S_STREAMBUFFER_REGIONS];
+	Suint8 *mapped;
+	Ssize_t size, offset;
+	Suint32 region;
+} Sstreambuffer;
+
+/**
+ * @brief Create a new stream buffer.
+ *
+ * Requires an open window with an OpenGL context of at least version 3.3.
+ *
+ * @param[in] size The size of each region of the buffer in bytes. The whole
+ * buffer is {@link S_STREAMBUFFER_REGIONS} times this size.
+ * @return A new stream buffer allocated on the heap. To correctly destroy the
+ * stream buffer, call {@link S_streambuffer_delete(Sstreambuffer *)}.
+ * @exception S_INVALID_VALUE If @p size is equal to 0.
+ * @since 1.0.0
+ */
+STICKY_API Sstreambuffer *S_streambuffer_new(Ssize_t);
+
+/**
+ * @brief Free a stream buffer from memory.
+ *
+ * @param[in,out] stream The stream buffer to free from memory.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid stream buffer is
+ * provided to the function.
+ * @since 1.0.0
+ */
+STICKY_API void           S_streambuffer_delete(Sstreambuffer *);
+
+/**
+ * @brief Bind a stream buffer to <c>GL_ARRAY_BUFFER</c>.
+ *
+ * This is only needed to point the attributes of a vertex array object at the
+ * buffer, which need only be done once.
+ *
+ * @param[in] stream The stream buffer to bind.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid stream buffer is
+ * provided to the function.
+ * @since 1.0.0
+ */
+STICKY_API void           S_streambuffer_bind(const Sstreambuffer *);
+
+/**
+ * @brief Write elements to a stream buffer.
+ *
+ * The data is written at the next position which is a multiple of @p stride,
+ * so that it may be drawn by passing the returned index as the first vertex
+ * of <c>glDrawArrays</c>, or as the base vertex of
+ * <c>glDrawElementsBaseVertex</c>.
+ *
+ * The data must be drawn before the stream buffer has been written to as many
+ * more times as fill {@link S_STREAMBUFFER_REGIONS} regions, which is always
+ * the case if it is drawn immediately.
+ *
+ * @param[in,out] stream The stream buffer.
+ * @param[in] data The data to write.
+ * @param[in] size The size of @p data in bytes.
+ * @param[in] stride The size of each element of @p data in bytes.
+ * @return The index of the first element written, counted in elements of
+ * @p stride from the start of the buffer.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid stream buffer or data
+ * is provided to the function, if @p size or @p stride are equal to 0, or if
+ * @p size plus @p stride is greater than the size of a region.
+ * @since 1.0.0
+ */
+STICKY_API Suint32        S_streambuffer_write(Sstreambuffer *, const void *,
+                                               Ssize_t, Ssize_t);
+
+/**
+ * @brief Check whether a stream buffer is persistently mapped.
+ *
+ * @param[in] stream The stream buffer.
+ * @return {@link S_TRUE} if the buffer is written through a persistent
+ * mapping, or {@link S_FALSE} if it falls back to orphaning.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid stream buffer is
+ * provided to the function.
+ * @since 1.0.0
+ */
+STICKY_API Sbool          S_streambuffer_is_persistent(const Sstreambuffer *);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* FR_RAYMENT_STICKY_STREAMBUFFER_H */
+
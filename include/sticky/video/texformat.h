@@ -0,0 +1,156 @@
+/*
+ * This file is licensed under BSD 3-Clause.
+ * All license information is available in the included COPYING file.
+ */
+
+/*
+ * texformat.h
+ * Compressed texture format header.
+ *
+ * Author       : Finn Rayment <finn@rayment.fr>
+ * Date created : 18/10/2026
+ */
+
+#ifndef FR_RAYMENT_STICKY_TEXFORMAT_H
+#define FR_RAYMENT_STICKY_TEXFORMAT_H 1
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+#include "sticky/common/defines.h"
+#include "sticky/common/includes.h"
+#include "sticky/common/types.h"
+
+/**
+ * @addtogroup texformat
+ * @{
+ */
+
+/**
+ * @brief BC1 (DXT1) compressed format.
+ * @hideinitializer
+ *
+ * Blocks of 4x4 texels in 8 bytes holding two RGB565 endpoints, with either
+ * four colours or three colours and transparent black.
+ *
+ * @since 1.0.0
+ */
+#define S_TEXFORMAT_BC1       0
+/**
+ * @brief BC3 (DXT5) compressed format.
+ * @hideinitializer
+ *
+ * Blocks of 4x4 texels in 16 bytes, an alpha block encoded as one channel of
+ * {@link S_TEXFORMAT_BC5} followed by a colour block as in
+ * {@link S_TEXFORMAT_BC1}.
+ *
+ * @since 1.0.0
+ */
+#define S_TEXFORMAT_BC3       1
+/**
+ * @brief BC5 (RGTC2) compressed format.
+ * @hideinitializer
+ *
+ * Blocks of 4x4 texels in 16 bytes holding the red and green channels only,
+ * each as eight interpolated values. Mostly used for normal maps.
+ *
+ * @since 1.0.0
+ */
+#define S_TEXFORMAT_BC5       2
+/**
+ * @brief BC7 (BPTC) compressed format.
+ * @hideinitializer
+ *
+ * Blocks of 4x4 texels in 16 bytes in one of eight modes, which split the
+ * block into up to three subsets with their own RGBA endpoints.
+ *
+ * @since 1.0.0
+ */
+#define S_TEXFORMAT_BC7       3
+/**
+ * @brief ETC2 RGB compressed format.
+ * @hideinitializer
+ *
+ * Blocks of 4x4 texels in 8 bytes, a superset of ETC1.
+ *
+ * @since 1.0.0
+ */
+#define S_TEXFORMAT_ETC2_RGB  4
+/**
+ * @brief ETC2 RGBA compressed format.
+ * @hideinitializer
+ *
+ * Blocks of 4x4 texels in 16 bytes, an EAC alpha block followed by an
+ * {@link S_TEXFORMAT_ETC2_RGB} block.
+ *
+ * @since 1.0.0
+ */
+#define S_TEXFORMAT_ETC2_RGBA 5
+
+#define _S_TEXFORMAT_COUNT    6
+
+/**
+ * @brief Get the number of bytes taken by an image in a compressed format.
+ *
+ * Images are stored as rows of blocks of 4x4 texels, so the width and height
+ * are rounded up to a multiple of 4.
+ *
+ * @param[in] format The compressed format.
+ * @param[in] width The width of the image in texels.
+ * @param[in] height The height of the image in texels.
+ * @return The size of the image in bytes.
+ * @exception S_INVALID_ENUM If @p format is not a compressed format.
+ * @since 1.0.0
+ */
+STICKY_API Ssize_t S_texformat_get_size(Senum, Suint32, Suint32);
+
+/**
+ * @brief Get whether the GPU can sample a compressed format directly.
+ *
+ * Requires an open window. Textures in a format which is not supported are
+ * decoded with {@link S_texformat_decode} when they are loaded, and take as
+ * much memory as an uncompressed texture.
+ *
+ * @param[in] format The compressed format.
+ * @return {@link S_TRUE} if textures of the format are uploaded compressed,
+ * otherwise {@link S_FALSE}.
+ * @exception S_INVALID_ENUM If @p format is not a compressed format.
+ * @since 1.0.0
+ */
+STICKY_API Sbool   S_texformat_is_supported(Senum);
+
+/**
+ * @brief Decode an image in a compressed format.
+ *
+ * Each texel is written as four bytes of red, green, blue and alpha. Channels
+ * missing from the format are written as @f$0@f$, and alpha as @f$255@f$.
+ *
+ * @param[in] format The compressed format.
+ * @param[in] blocks The compressed image, of
+ * {@link S_texformat_get_size} bytes.
+ * @param[in] width The width of the image in texels.
+ * @param[in] height The height of the image in texels.
+ * @param[out] rgba The decoded image, of @p width by @p height texels.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> image is provided to the
+ * function.
+ * @exception S_INVALID_ENUM If @p format is not a compressed format.
+ * @since 1.0.0
+ */
+STICKY_API void    S_texformat_decode(Senum, const Suint8 *, Suint32, Suint32,
+                                      Suint8 *);
+
+void _S_texformat_init(void);
+GLenum _S_texformat_get_gl_format(Senum);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* FR_RAYMENT_STICKY_TEXFORMAT_H */
+
@@ -0,0 +1,149 @@
+/*
+ * This file is licensed under BSD 3-Clause.
+ * All license information is available in the included COPYING file.
+ */
+
+/*
+ * textmesh.h
+ * Static text mesh header.
+ *
+ * Author       : Finn Rayment <finn@rayment.fr>
+ * Date created : 18/10/2026
+ */
+
+#ifndef FR_RAYMENT_STICKY_TEXTMESH_H
+#define FR_RAYMENT_STICKY_TEXTMESH_H 1
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif /* __cplusplus */
+
+#include "sticky/common/defines.h"
+#include "sticky/common/includes.h"
+#include "sticky/common/types.h"
+#include "sticky/video/font.h"
+
+/**
+ * @addtogroup textmesh
+ * @{
+ */
+
+/**
+ * @brief Text mesh struct.
+ *
+ * A text mesh holds the quads of a string of text in its own vertex buffer, so
+ * that text which rarely changes, such as labels and menus, is laid out and
+ * uploaded once and then drawn with a single call to
+ * {@link S_draw_textmesh_2d}.
+ *
+ * Each UTF-8 character is given a fixed slot of six vertices in the buffer,
+ * with empty glyphs such as spaces left as degenerate triangles. When the text
+ * is changed with {@link S_textmesh_set_text}, only the range of characters
+ * whose quads actually moved or changed is uploaded again, so that changing a
+ * few characters of a counter costs no more than those characters.
+ *
+ * If the font evicts a page of its atlas holding any of the glyphs of the
+ * text, the text is laid out again the next time it is drawn.
+ *
+ * The font must outlive the text mesh.
+ *
+ * @since 1.0.0
+ */
+typedef struct
+Stextmesh_s
+{
+	const Sfont *font;
+	Schar *text;
+	Sfloat *vertices;
+	Ssize_t len, cap, count;
+	Sfloat x, y, scale;
+	Suint32 pages, generation;
+	GLuint vao, vbo;
+} Stextmesh;
+
+/**
+ * @brief Create a new text mesh.
+ *
+ * Requires an open window with an OpenGL context of at least version 3.3.
+ *
+ * @param[in] font The font to lay the text out with.
+ * @param[in] text The UTF-8 text of the mesh, or <c>NULL</c> if @p len is 0.
+ * @param[in] len The number of chars in @p text.
+ * @param[in] x The @f$x@f$ position of the text on the window.
+ * @param[in] y The @f$y@f$ position of the text on the window.
+ * @param[in] scale The scale of the text.
+ * @return A new text mesh allocated on the heap. To correctly destroy the text
+ * mesh, call {@link S_textmesh_delete(Stextmesh *)}.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid font is provided to
+ * the function, if @p text is <c>NULL</c> but @p len is not 0, or if @p scale
+ * is less than or equal to @f$0@f$.
+ * @since 1.0.0
+ */
+STICKY_API Stextmesh *S_textmesh_new(const Sfont *, const Schar *, Ssize_t,
+                                     Sfloat, Sfloat, Sfloat);
+
+/**
+ * @brief Free a text mesh from memory.
+ *
+ * @param[in,out] mesh The text mesh to free from memory.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid text mesh is provided
+ * to the function.
+ * @since 1.0.0
+ */
+STICKY_API void       S_textmesh_delete(Stextmesh *);
+
+/**
+ * @brief Change the text of a text mesh.
+ *
+ * The text is laid out again on the CPU, but only the characters between the
+ * first and last whose quads differ from before are uploaded. If the text no
+ * longer fits in the vertex buffer, the buffer is grown and uploaded whole.
+ *
+ * @param[in,out] mesh The text mesh.
+ * @param[in] text The new UTF-8 text, or <c>NULL</c> if @p len is 0.
+ * @param[in] len The number of chars in @p text.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid text mesh is provided
+ * to the function, or if @p text is <c>NULL</c> but @p len is not 0.
+ * @since 1.0.0
+ */
+STICKY_API void       S_textmesh_set_text(Stextmesh *, const Schar *, Ssize_t);
+
+/**
+ * @brief Move a text mesh.
+ *
+ * Since the positions are held in the vertex buffer, the text is laid out and
+ * every character is uploaded again.
+ *
+ * @param[in,out] mesh The text mesh.
+ * @param[in] x The new @f$x@f$ position of the text on the window.
+ * @param[in] y The new @f$y@f$ position of the text on the window.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid text mesh is provided
+ * to the function.
+ * @since 1.0.0
+ */
+STICKY_API void       S_textmesh_set_position(Stextmesh *, Sfloat, Sfloat);
+
+/**
+ * @brief Get the number of chars in a text mesh.
+ *
+ * @param[in] mesh The text mesh.
+ * @return The number of chars last given to the text mesh.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid text mesh is provided
+ * to the function.
+ * @since 1.0.0
+ */
+STICKY_API Ssize_t    S_textmesh_get_length(const Stextmesh *);
+
+void _S_textmesh_refresh(Stextmesh *);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif /* __cplusplus */
+
+#endif /* FR_RAYMENT_STICKY_TEXTMESH_H */
+
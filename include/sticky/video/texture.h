@@ -69,6 +69,50 @@ extern "C"
  */
 #define S_TEXTURE_REPEAT  GL_REPEAT
 
+/**
+ * @brief The status of a texture which has been uploaded and may be drawn.
+ * @hideinitializer
+ *
+ * @since 1.0.0
+ */
+#define S_TEXTURE_READY   0
+/**
+ * @brief The status of a texture which is still being loaded.
+ * @hideinitializer
+ *
+ * The texture may be drawn, but shows a grey placeholder until it is ready.
+ *
+ * @since 1.0.0
+ */
+#define S_TEXTURE_LOADING 1
+/**
+ * @brief The status of a texture which could not be loaded.
+ * @hideinitializer
+ *
+ * The texture keeps showing the placeholder, and should be deleted.
+ *
+ * @since 1.0.0
+ */
+#define S_TEXTURE_FAILED  2
+
+/**
+ * @brief The number of worker threads which decode textures loaded by
+ * {@link S_texture_load_async}.
+ * @hideinitializer
+ *
+ * @since 1.0.0
+ */
+#define S_TEXTURE_WORKERS 2
+
+/**
+ * @brief The default number of bytes of asynchronously loaded textures that
+ * are uploaded each frame.
+ * @hideinitializer
+ *
+ * @since 1.0.0
+ */
+#define S_TEXTURE_UPLOAD_BUDGET (4 * 1024 * 1024)
+
 /**
  * @brief Texture for use with OpenGL rendering.
  *
@@ -80,32 +124,91 @@ extern "C"
  * which makes it useful for rendering on cubes, such as the skybox of a 3D
  * world.
  *
+ * Array textures hold many 2D layers of the same size, each sampled by its
+ * index in shaders, and are built by {@link S_atlas_build_array}.
+ *
+ * The size of a texture is the number of bytes of video memory it is expected
+ * to take, including its mipmaps, and is @f$0@f$ until it is loaded.
+ *
  * @since 1.0.0
  */
 typedef struct
 Stexture_s
 {
 	GLuint tex;
-	Sbool cubemap;
-	Senum filter, wrap;
+	Sbool cubemap, array;
+	Ssize_t size;
+	Senum filter, wrap, status;
+	struct _Stexture_job_s *job;
 } Stexture;
 
+/**
+ * @brief Callback for a texture that has finished loading.
+ *
+ * Called from the thread drawing to the window, once the texture has either
+ * been uploaded or failed to load, along with the user data given to
+ * {@link S_texture_load_async}. The status of the texture tells which.
+ *
+ * @since 1.0.0
+ */
+typedef void (*Stexture_callback)(Stexture *, void *);
+
 /**
  * @brief Load a 2D texture into memory.
  *
  * Loads a single 2D texture that can be used in shaders.
  *
+ * DDS and KTX2 files holding a 2D image in one of the
+ * @ref texformat "compressed texture formats" are uploaded as they are,
+ * along with the mipmaps stored in the file, instead of generating mipmaps.
+ * If the GPU cannot sample the format, each level is decoded with
+ * {@link S_texformat_decode} first. Any other file is decoded as an
+ * uncompressed image.
+ *
  * @param[in] filename The filename of the image to load.
  * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid filename is provided
  * to the function.
  * @exception S_INVALID_CHANNELS If a given texture does not have three or four
  * channels (RGB and RGBA respectively).
  * @exception S_INVALID_FORMAT If a given texture does not have an even number
- * of pixels in either width or height.
+ * of pixels in either width or height, or if a DDS or KTX2 file holds anything
+ * but a 2D image in a compressed texture format, is larger than the GPU
+ * supports or is shorter than its header claims.
+ * @exception S_IO_ERROR If a DDS or KTX2 file could not be read.
  * @since 1.0.0
  */
 STICKY_API Stexture *S_texture_load(const Schar *);
 
+/**
+ * @brief Load a texture from file in the background.
+ *
+ * Returns a texture straight away which may be attached and drawn at once,
+ * but which shows a grey placeholder until it is ready. The image is decoded
+ * by one of {@link S_TEXTURE_WORKERS} worker threads, and is then uploaded
+ * through a pixel buffer object a band of rows at a time, at most
+ * {@link S_texture_set_upload_budget} bytes each frame, when the window is
+ * swapped. Only once the whole image is uploaded and its mipmaps generated
+ * does the texture switch from the placeholder to the image, so a texture is
+ * never drawn half uploaded. DDS and KTX2 files are read as by
+ * {@link S_texture_load}, and are uploaded whole in the frame they reach.
+ *
+ * The filter and wrapping modes may be set while the texture is loading, and
+ * are applied once it is ready. The texture may also be deleted while it is
+ * loading, in which case the load is abandoned and @p callback is not called.
+ *
+ * @param[in] filename The file path to the texture to be loaded.
+ * @param[in] callback A function to call once the texture is ready or has
+ * failed to load, or <c>NULL</c> to poll {@link S_texture_get_status} instead.
+ * @param[in] data The user data to pass to @p callback.
+ * @return A new texture allocated on the heap. To correctly destroy the
+ * texture, call {@link S_texture_delete(Stexture *)}.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid file path is provided
+ * to the function.
+ * @since 1.0.0
+ */
+STICKY_API Stexture *S_texture_load_async(const Schar *, Stexture_callback,
+                                          void *);
+
 /**
  * @brief Load a cubemap texture into memory.
  *
@@ -183,8 +286,38 @@ STICKY_API void      S_texture_set_filter(Stexture *, Senum);
  */
 STICKY_API void      S_texture_set_wrap(Stexture *, Senum);
 
+/**
+ * @brief Get whether a texture has finished loading.
+ *
+ * @param[in] texture The texture.
+ * @return {@link S_TEXTURE_READY}, {@link S_TEXTURE_LOADING} or
+ * {@link S_TEXTURE_FAILED}.
+ * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid texture is provided
+ * to the function.
+ * @since 1.0.0
+ */
+STICKY_API Senum     S_texture_get_status(const Stexture *);
+
+/**
+ * @brief Set the number of bytes of asynchronously loaded textures that are
+ * uploaded each frame.
+ *
+ * Lowering the budget spreads the uploads of large textures across more
+ * frames. At least one row of a texture is uploaded each frame whatever the
+ * budget. The default budget is {@link S_TEXTURE_UPLOAD_BUDGET}.
+ *
+ * @param[in] budget The number of bytes to upload each frame.
+ * @exception S_INVALID_VALUE If @p budget is equal to 0.
+ * @since 1.0.0
+ */
+STICKY_API void      S_texture_set_upload_budget(Ssize_t);
+
 void _S_texture_init(void);
+void _S_texture_free(void);
+void _S_texture_update(void);
 void _S_texture_attach(const Stexture *, Suint32);
+GLenum _S_texture_get_target(const Stexture *);
+Ssize_t _S_texture_get_size(Suint32, Suint32, Sbool);
 
 /**
  * @}
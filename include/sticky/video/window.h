@@ -324,6 +324,8 @@ STICKY_API void     S_window_poll(Swindow *);
  * is swapped out with the visible one to show the results of the latest render.
  *
  * This function should be called after all render calls for a given frame.
+ * Any queued debug lines and points are drawn before the swap, and the next
+ * band of any textures loading in the background is uploaded.
  *
  * @param[in,out] window The window to swap.
  * @exception S_INVALID_VALUE If a <c>NULL</c> or invalid window is provided to
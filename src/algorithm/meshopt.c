@@ -0,0 +1,1022 @@
+/*
+ * This file is licensed under BSD 3-Clause.
+ * All license information is available in the included COPYING file.
+ */
+
+/*
+ * meshopt.c
+ * Mesh optimisation source.
+ *
+ * Author       : Finn Rayment <finn@rayment.fr>
+ * Date created : 18/10/2026
+ */
+
+#include <string.h>
+
+#include "sticky/algorithm/meshopt.h"
+#include "sticky/algorithm/rsort.h"
+#include "sticky/common/defines.h"
+#include "sticky/common/error.h"
+#include "sticky/common/types.h"
+#include "sticky/math/math.h"
+#include "sticky/memory/allocator.h"
+#include "sticky/util/hash.h"
+
+#define UNUSED S_UINT32_MAX
+
+/* the cache size and scoring constants from Forsyth's paper */
+#define FORSYTH_CACHE         32
+#define FORSYTH_DECAY         1.5f
+#define FORSYTH_LAST_TRIANGLE 0.75f
+#define FORSYTH_VALENCE_SCALE 2.0f
+#define FORSYTH_VALENCE_POWER 0.5f
+
+typedef struct
+_Smeshopt_quadric_s
+{
+	Sdouble a2, b2, c2, d2, ab, ac, ad, bc, bd, cd, w;
+} _Smeshopt_quadric;
+
+static
+Suint32
+_S_meshopt_hash(const Smeshopt *opt,
+                Suint32 v)
+{
+	Suint32 hash;
+	hash = S_hash_fnv1a(opt->vertices + v * 3, 3 * sizeof(Sfloat));
+	if (opt->normals)
+	{
+		hash = hash * 31 +
+		       S_hash_fnv1a(opt->normals + v * 3, 3 * sizeof(Sfloat));
+	}
+	if (opt->uv)
+		hash = hash * 31 + S_hash_fnv1a(opt->uv + v * 2, 2 * sizeof(Sfloat));
+	return hash;
+}
+
+static
+Sbool
+_S_meshopt_equal(const Smeshopt *opt,
+                 Suint32 a,
+                 Suint32 b)
+{
+	if (memcmp(opt->vertices + a * 3, opt->vertices + b * 3,
+	           3 * sizeof(Sfloat)) != 0)
+		return S_FALSE;
+	if (opt->normals && memcmp(opt->normals + a * 3, opt->normals + b * 3,
+	                           3 * sizeof(Sfloat)) != 0)
+		return S_FALSE;
+	if (opt->uv && memcmp(opt->uv + a * 2, opt->uv + b * 2,
+	                      2 * sizeof(Sfloat)) != 0)
+		return S_FALSE;
+	return S_TRUE;
+}
+
+/* move every vertex to remap[v], dropping those that are UNUSED, and point the
+   indices at the new locations */
+static
+void
+_S_meshopt_remap(Smeshopt *opt,
+                 const Suint32 *remap,
+                 Ssize_t vcount)
+{
+	Sfloat *vertices, *normals, *uv;
+	Ssize_t i;
+	Suint32 v;
+	vertices = (Sfloat *) S_memory_new(sizeof(Sfloat) * 3 * vcount);
+	normals = NULL;
+	uv = NULL;
+	if (opt->normals)
+		normals = (Sfloat *) S_memory_new(sizeof(Sfloat) * 3 * vcount);
+	if (opt->uv)
+		uv = (Sfloat *) S_memory_new(sizeof(Sfloat) * 2 * vcount);
+	for (i = 0; i < opt->vcount; ++i)
+	{
+		v = remap[i];
+		if (v == UNUSED)
+			continue;
+		memcpy(vertices + v * 3, opt->vertices + i * 3, 3 * sizeof(Sfloat));
+		if (normals)
+		{
+			memcpy(normals + v * 3, opt->normals + i * 3,
+			       3 * sizeof(Sfloat));
+		}
+		if (uv)
+			memcpy(uv + v * 2, opt->uv + i * 2, 2 * sizeof(Sfloat));
+	}
+	for (i = 0; i < opt->icount; ++i)
+		opt->indices[i] = remap[opt->indices[i]];
+	S_memory_delete(opt->vertices);
+	if (opt->normals)
+		S_memory_delete(opt->normals);
+	if (opt->uv)
+		S_memory_delete(opt->uv);
+	opt->vertices = vertices;
+	opt->normals = normals;
+	opt->uv = uv;
+	opt->vcount = vcount;
+}
+
+/* list the triangles using each vertex, where those of vertex v are
+   adjacency[offsets[v]] to adjacency[offsets[v]+counts[v]-1] */
+static
+void
+_S_meshopt_adjacency(const Suint32 *indices,
+                     Ssize_t icount,
+                     Ssize_t vcount,
+                     Suint32 *offsets,
+                     Suint32 *counts,
+                     Suint32 *adjacency)
+{
+	Ssize_t i;
+	Suint32 v;
+	memset(counts, 0, sizeof(Suint32) * vcount);
+	for (i = 0; i < icount; ++i)
+		++counts[indices[i]];
+	offsets[0] = 0;
+	for (i = 0; i < vcount; ++i)
+	{
+		offsets[i+1] = offsets[i] + counts[i];
+		counts[i] = 0;
+	}
+	for (i = 0; i < icount; ++i)
+	{
+		v = indices[i];
+		adjacency[offsets[v] + counts[v]++] = i / 3;
+	}
+}
+
+/* simulate a FIFO cache, returning the number of misses of one triangle; a
+   vertex is cached if it missed within the last cache_size misses */
+static
+Suint32
+_S_meshopt_cache_misses(const Suint32 *tri,
+                        Suint32 *stamps,
+                        Suint32 *time,
+                        Suint32 cache_size)
+{
+	Suint32 i, misses;
+	misses = 0;
+	for (i = 0; i < 3; ++i)
+	{
+		if (*time - stamps[tri[i]] > cache_size)
+		{
+			stamps[tri[i]] = (*time)++;
+			++misses;
+		}
+	}
+	return misses;
+}
+
+/* get the unnormalised normal of a triangle, returning twice its area */
+static
+Sfloat
+_S_meshopt_normal(const Sfloat *p0,
+                  const Sfloat *p1,
+                  const Sfloat *p2,
+                  Sfloat *cross)
+{
+	Sfloat e1[3], e2[3];
+	Suint32 i;
+	for (i = 0; i < 3; ++i)
+	{
+		e1[i] = p1[i] - p0[i];
+		e2[i] = p2[i] - p0[i];
+	}
+	cross[0] = e1[1] * e2[2] - e1[2] * e2[1];
+	cross[1] = e1[2] * e2[0] - e1[0] * e2[2];
+	cross[2] = e1[0] * e2[1] - e1[1] * e2[0];
+	return S_sqrt(cross[0] * cross[0] + cross[1] * cross[1] +
+	              cross[2] * cross[2]);
+}
+
+/* get the unnormalised normal of a triangle and the sum of its corners,
+   returning twice its area */
+static
+Sfloat
+_S_meshopt_face(const Smeshopt *opt,
+                Ssize_t t,
+                Sfloat *cross,
+                Sfloat *corners)
+{
+	const Sfloat *p0, *p1, *p2;
+	Suint32 i;
+	p0 = opt->vertices + opt->indices[t*3] * 3;
+	p1 = opt->vertices + opt->indices[t*3+1] * 3;
+	p2 = opt->vertices + opt->indices[t*3+2] * 3;
+	for (i = 0; i < 3; ++i)
+		corners[i] = p0[i] + p1[i] + p2[i];
+	return _S_meshopt_normal(p0, p1, p2, cross);
+}
+
+static
+void
+_S_meshopt_quadric_add(_Smeshopt_quadric *dest,
+                       const _Smeshopt_quadric *src)
+{
+	dest->a2 += src->a2;
+	dest->b2 += src->b2;
+	dest->c2 += src->c2;
+	dest->d2 += src->d2;
+	dest->ab += src->ab;
+	dest->ac += src->ac;
+	dest->ad += src->ad;
+	dest->bc += src->bc;
+	dest->bd += src->bd;
+	dest->cd += src->cd;
+	dest->w += src->w;
+}
+
+/* the mean squared distance of a point from the planes of a quadric */
+static
+Sdouble
+_S_meshopt_quadric_error(const _Smeshopt_quadric *q,
+                         const Sfloat *p)
+{
+	Sdouble x, y, z, e;
+	if (q->w <= 0.0)
+		return 0.0;
+	x = p[0];
+	y = p[1];
+	z = p[2];
+	e = q->a2 * x * x + q->b2 * y * y + q->c2 * z * z + q->d2 +
+	    2.0 * (q->ab * x * y + q->ac * x * z + q->bc * y * z) +
+	    2.0 * (q->ad * x + q->bd * y + q->cd * z);
+	return e > 0.0 ? e / q->w : 0.0;
+}
+
+/* sum the area-weighted plane of every triangle into the quadrics of its
+   vertices */
+static
+void
+_S_meshopt_quadrics(const Smeshopt *opt,
+                    _Smeshopt_quadric *quadrics)
+{
+	_Smeshopt_quadric q;
+	Sfloat cross[3], corners[3], area;
+	Sdouble nx, ny, nz, d;
+	Ssize_t t;
+	Suint32 i;
+	memset(quadrics, 0, sizeof(_Smeshopt_quadric) * opt->vcount);
+	for (t = 0; t < opt->icount / 3; ++t)
+	{
+		area = _S_meshopt_face(opt, t, cross, corners);
+		if (area <= 0.0f)
+			continue;
+		nx = cross[0] / area;
+		ny = cross[1] / area;
+		nz = cross[2] / area;
+		d = -(nx * corners[0] + ny * corners[1] + nz * corners[2]) / 3.0;
+		q.w = area * 0.5;
+		q.a2 = q.w * nx * nx;
+		q.b2 = q.w * ny * ny;
+		q.c2 = q.w * nz * nz;
+		q.d2 = q.w * d * d;
+		q.ab = q.w * nx * ny;
+		q.ac = q.w * nx * nz;
+		q.ad = q.w * nx * d;
+		q.bc = q.w * ny * nz;
+		q.bd = q.w * ny * d;
+		q.cd = q.w * nz * d;
+		for (i = 0; i < 3; ++i)
+			_S_meshopt_quadric_add(quadrics + opt->indices[t*3+i], &q);
+	}
+}
+
+/* lock the vertices on open borders, whose edges have no opposite edge, and
+   those which share a position with another vertex, such as along a UV seam,
+   since moving either would open a crack */
+static
+void
+_S_meshopt_locks(const Smeshopt *opt,
+                 Sbool *locked)
+{
+	Suint64 *edges;
+	Suint32 *positions;
+	Suint64 edge, reverse;
+	Suint32 mask, slot, a, b;
+	Ssize_t i;
+	memset(locked, 0, sizeof(Sbool) * opt->vcount);
+	mask = 1;
+	while (mask < opt->icount * 2)
+		mask <<= 1;
+	edges = (Suint64 *) S_memory_new(sizeof(Suint64) * mask);
+	memset(edges, 0xff, sizeof(Suint64) * mask);
+	--mask;
+	for (i = 0; i < opt->icount; ++i)
+	{
+		a = opt->indices[i];
+		b = opt->indices[i - i % 3 + (i + 1) % 3];
+		edge = ((Suint64) a << 32) | b;
+		slot = S_hash_fnv1a(&edge, sizeof(edge)) & mask;
+		while (edges[slot] != S_UINT64_MAX && edges[slot] != edge)
+			slot = (slot + 1) & mask;
+		edges[slot] = edge;
+	}
+	for (i = 0; i < opt->icount; ++i)
+	{
+		a = opt->indices[i];
+		b = opt->indices[i - i % 3 + (i + 1) % 3];
+		reverse = ((Suint64) b << 32) | a;
+		slot = S_hash_fnv1a(&reverse, sizeof(reverse)) & mask;
+		while (edges[slot] != S_UINT64_MAX && edges[slot] != reverse)
+			slot = (slot + 1) & mask;
+		if (edges[slot] == S_UINT64_MAX)
+			locked[a] = locked[b] = S_TRUE;
+	}
+	S_memory_delete(edges);
+	mask = 1;
+	while (mask < opt->vcount * 2)
+		mask <<= 1;
+	positions = (Suint32 *) S_memory_new(sizeof(Suint32) * mask);
+	memset(positions, 0xff, sizeof(Suint32) * mask);
+	--mask;
+	for (i = 0; i < opt->vcount; ++i)
+	{
+		slot = S_hash_fnv1a(opt->vertices + i * 3, 3 * sizeof(Sfloat)) & mask;
+		while (positions[slot] != UNUSED &&
+		       memcmp(opt->vertices + positions[slot] * 3,
+		              opt->vertices + i * 3, 3 * sizeof(Sfloat)) != 0)
+			slot = (slot + 1) & mask;
+		if (positions[slot] == UNUSED)
+			positions[slot] = i;
+		else
+			locked[i] = locked[positions[slot]] = S_TRUE;
+	}
+	S_memory_delete(positions);
+}
+
+/* check whether moving vertex a onto vertex b turns any triangle over */
+static
+Sbool
+_S_meshopt_flips(const Smeshopt *opt,
+                 const Suint32 *indices,
+                 const Suint32 *offsets,
+                 const Suint32 *counts,
+                 const Suint32 *adjacency,
+                 Suint32 a,
+                 Suint32 b)
+{
+	const Sfloat *p[3];
+	Sfloat before[3], after[3];
+	Suint32 k, t, i;
+	for (k = offsets[a]; k < offsets[a] + counts[a]; ++k)
+	{
+		t = adjacency[k];
+		if (indices[t*3] == b || indices[t*3+1] == b || indices[t*3+2] == b)
+			continue;
+		for (i = 0; i < 3; ++i)
+			p[i] = opt->vertices + indices[t*3+i] * 3;
+		_S_meshopt_normal(p[0], p[1], p[2], before);
+		for (i = 0; i < 3; ++i)
+		{
+			if (indices[t*3+i] == a)
+				p[i] = opt->vertices + b * 3;
+		}
+		_S_meshopt_normal(p[0], p[1], p[2], after);
+		if (before[0] * after[0] + before[1] * after[1] +
+		    before[2] * after[2] <= 0.0f)
+			return S_TRUE;
+	}
+	return S_FALSE;
+}
+
+/* map a float to an integer which sorts in the same order */
+static
+Suint32
+_S_meshopt_float_key(Sfloat f)
+{
+	Suint32 bits;
+	memcpy(&bits, &f, sizeof(Suint32));
+	return (bits & 0x80000000) ? ~bits : bits | 0x80000000;
+}
+
+Smeshopt *
+S_meshopt_new(const Sfloat *vertices, Ssize_t vlen,
+              const Suint32 *indices, Ssize_t ilen,
+              const Sfloat *normals, Ssize_t nlen,
+              const Sfloat *uv, Ssize_t uvlen)
+{
+	Smeshopt *opt;
+	Ssize_t vcount, i;
+	if (!vertices || vlen == 0 ||
+	    (!indices && ilen > 0) ||
+	    (!normals && nlen > 0) ||
+	    (!uv && uvlen > 0))
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_meshopt_new");
+		return NULL;
+	}
+	vcount = vlen / 3;
+	if ((nlen > 0 && nlen / 3 < vcount) || (uvlen > 0 && uvlen / 2 < vcount) ||
+	    (indices && ilen % 3 != 0) || (!indices && vcount % 3 != 0))
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_meshopt_new");
+		return NULL;
+	}
+	for (i = 0; indices && i < ilen; ++i)
+	{
+		if (indices[i] >= vcount)
+		{
+			_S_SET_ERROR(S_INVALID_VALUE, "S_meshopt_new");
+			return NULL;
+		}
+	}
+	opt = (Smeshopt *) S_memory_new(sizeof(Smeshopt));
+	opt->vcount = vcount;
+	opt->icount = indices ? ilen : vcount;
+	opt->vertices = (Sfloat *) S_memory_new(sizeof(Sfloat) * 3 * vcount);
+	memcpy(opt->vertices, vertices, sizeof(Sfloat) * 3 * vcount);
+	opt->normals = NULL;
+	opt->uv = NULL;
+	if (normals && nlen > 0)
+	{
+		opt->normals = (Sfloat *) S_memory_new(sizeof(Sfloat) * 3 * vcount);
+		memcpy(opt->normals, normals, sizeof(Sfloat) * 3 * vcount);
+	}
+	if (uv && uvlen > 0)
+	{
+		opt->uv = (Sfloat *) S_memory_new(sizeof(Sfloat) * 2 * vcount);
+		memcpy(opt->uv, uv, sizeof(Sfloat) * 2 * vcount);
+	}
+	opt->indices = (Suint32 *) S_memory_new(sizeof(Suint32) * opt->icount);
+	if (indices)
+	{
+		memcpy(opt->indices, indices, sizeof(Suint32) * opt->icount);
+	}
+	else
+	{
+		for (i = 0; i < opt->icount; ++i)
+			opt->indices[i] = i;
+	}
+	return opt;
+}
+
+void
+S_meshopt_delete(Smeshopt *opt)
+{
+	if (!opt)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_meshopt_delete");
+		return;
+	}
+	S_memory_delete(opt->vertices);
+	if (opt->normals)
+		S_memory_delete(opt->normals);
+	if (opt->uv)
+		S_memory_delete(opt->uv);
+	S_memory_delete(opt->indices);
+	S_memory_delete(opt);
+}
+
+void
+S_meshopt_deduplicate(Smeshopt *opt)
+{
+	Suint32 *table, *remap;
+	Suint32 mask, slot, unique;
+	Ssize_t i;
+	if (!opt)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_meshopt_deduplicate");
+		return;
+	}
+	/* open addressing at no more than half full */
+	mask = 1;
+	while (mask < opt->vcount * 2)
+		mask <<= 1;
+	table = (Suint32 *) S_memory_new(sizeof(Suint32) * mask);
+	remap = (Suint32 *) S_memory_new(sizeof(Suint32) * opt->vcount);
+	memset(table, 0xff, sizeof(Suint32) * mask);
+	--mask;
+	/* point every vertex at the first vertex equal to it */
+	for (i = 0; i < opt->vcount; ++i)
+	{
+		slot = _S_meshopt_hash(opt, i) & mask;
+		while (table[slot] != UNUSED && !_S_meshopt_equal(opt, table[slot], i))
+			slot = (slot + 1) & mask;
+		if (table[slot] == UNUSED)
+			table[slot] = i;
+		remap[i] = table[slot];
+	}
+	S_memory_delete(table);
+	for (i = 0; i < opt->icount; ++i)
+		opt->indices[i] = remap[opt->indices[i]];
+	/* then keep only those first vertices, in their original order */
+	unique = 0;
+	for (i = 0; i < opt->vcount; ++i)
+		remap[i] = remap[i] == i ? unique++ : UNUSED;
+	if (unique < opt->vcount)
+		_S_meshopt_remap(opt, remap, unique);
+	S_memory_delete(remap);
+}
+
+void
+S_meshopt_vertex_cache(Smeshopt *opt)
+{
+	Sfloat cachescore[FORSYTH_CACHE];
+	Suint32 cache[FORSYTH_CACHE+3], newcache[FORSYTH_CACHE+3];
+	Suint32 *offsets, *remaining, *adjacency, *out;
+	Sint32 *cachepos;
+	Sfloat *vscore, *tscore;
+	Sbool *emitted;
+	Ssize_t tricount, i;
+	Suint32 t, v, j, k, cachelen, newlen, cursor, emittedcount;
+	Sint32 best;
+	Sfloat score, bestscore;
+	if (!opt)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_meshopt_vertex_cache");
+		return;
+	}
+	tricount = opt->icount / 3;
+	if (tricount == 0)
+		return;
+	for (i = 0; i < FORSYTH_CACHE; ++i)
+	{
+		if (i < 3)
+		{
+			cachescore[i] = FORSYTH_LAST_TRIANGLE;
+		}
+		else
+		{
+			cachescore[i] = powf(1.0f - (Sfloat) (i - 3) / (FORSYTH_CACHE - 3),
+			                     FORSYTH_DECAY);
+		}
+	}
+	/* build the triangles adjacent to each vertex */
+	offsets = (Suint32 *) S_memory_new(sizeof(Suint32) * (opt->vcount + 1));
+	remaining = (Suint32 *) S_memory_new(sizeof(Suint32) * opt->vcount);
+	adjacency = (Suint32 *) S_memory_new(sizeof(Suint32) * opt->icount);
+	cachepos = (Sint32 *) S_memory_new(sizeof(Sint32) * opt->vcount);
+	vscore = (Sfloat *) S_memory_new(sizeof(Sfloat) * opt->vcount);
+	tscore = (Sfloat *) S_memory_new(sizeof(Sfloat) * tricount);
+	emitted = (Sbool *) S_memory_new(sizeof(Sbool) * tricount);
+	out = (Suint32 *) S_memory_new(sizeof(Suint32) * opt->icount);
+	_S_meshopt_adjacency(opt->indices, opt->icount, opt->vcount, offsets,
+	                     remaining, adjacency);
+	/* score every vertex and triangle before anything is cached */
+	for (i = 0; i < opt->vcount; ++i)
+	{
+		cachepos[i] = -1;
+		vscore[i] = remaining[i] > 0 ?
+		            FORSYTH_VALENCE_SCALE *
+		            powf((Sfloat) remaining[i], -FORSYTH_VALENCE_POWER) :
+		            0.0f;
+	}
+	best = 0;
+	bestscore = -1.0f;
+	for (i = 0; i < tricount; ++i)
+	{
+		emitted[i] = S_FALSE;
+		tscore[i] = vscore[opt->indices[i*3]] +
+		            vscore[opt->indices[i*3+1]] +
+		            vscore[opt->indices[i*3+2]];
+		if (tscore[i] > bestscore)
+		{
+			bestscore = tscore[i];
+			best = i;
+		}
+	}
+	cachelen = 0;
+	cursor = 0;
+	for (emittedcount = 0; emittedcount < tricount; ++emittedcount)
+	{
+		if (best < 0)
+		{
+			/* nothing in the cache has a triangle left, so start afresh */
+			while (emitted[cursor])
+				++cursor;
+			best = cursor;
+		}
+		t = best;
+		emitted[t] = S_TRUE;
+		memcpy(out + emittedcount * 3, opt->indices + t * 3,
+		       3 * sizeof(Suint32));
+		/* remove the triangle from its vertices and push them to the front of
+		   the cache */
+		newlen = 0;
+		for (j = 0; j < 3; ++j)
+		{
+			v = opt->indices[t*3+j];
+			for (k = offsets[v]; adjacency[k] != t; ++k)
+				;
+			adjacency[k] = adjacency[offsets[v] + --remaining[v]];
+			newcache[newlen++] = v;
+		}
+		for (j = 0; j < cachelen; ++j)
+		{
+			v = cache[j];
+			if (v != newcache[0] && v != newcache[1] && v != newcache[2])
+				newcache[newlen++] = v;
+		}
+		/* rescore every vertex that moved, including those pushed out of the
+		   cache, and their remaining triangles */
+		for (j = 0; j < newlen; ++j)
+		{
+			v = newcache[j];
+			cachepos[v] = j < FORSYTH_CACHE ? (Sint32) j : -1;
+			score = 0.0f;
+			if (remaining[v] > 0)
+			{
+				if (cachepos[v] >= 0)
+					score = cachescore[cachepos[v]];
+				score += FORSYTH_VALENCE_SCALE *
+				         powf((Sfloat) remaining[v], -FORSYTH_VALENCE_POWER);
+			}
+			for (k = offsets[v]; k < offsets[v] + remaining[v]; ++k)
+				tscore[adjacency[k]] += score - vscore[v];
+			vscore[v] = score;
+		}
+		cachelen = S_min(newlen, FORSYTH_CACHE);
+		memcpy(cache, newcache, sizeof(Suint32) * cachelen);
+		/* the next triangle is the best one touching the cache */
+		best = -1;
+		bestscore = -1.0f;
+		for (j = 0; j < cachelen; ++j)
+		{
+			v = cache[j];
+			for (k = offsets[v]; k < offsets[v] + remaining[v]; ++k)
+			{
+				if (tscore[adjacency[k]] > bestscore)
+				{
+					bestscore = tscore[adjacency[k]];
+					best = adjacency[k];
+				}
+			}
+		}
+	}
+	memcpy(opt->indices, out, sizeof(Suint32) * opt->icount);
+	S_memory_delete(offsets);
+	S_memory_delete(remaining);
+	S_memory_delete(adjacency);
+	S_memory_delete(cachepos);
+	S_memory_delete(vscore);
+	S_memory_delete(tscore);
+	S_memory_delete(emitted);
+	S_memory_delete(out);
+}
+
+void
+S_meshopt_overdraw(Smeshopt *opt,
+                   Sfloat threshold)
+{
+	Sfloat center[3], centroid[3], normal[3], cross[3], corners[3];
+	Suint32 *stamps, *clusters, *order, *tmporder, *out;
+	Suint64 *keys, *tmpkeys;
+	Ssize_t tricount, nclusters, clustertris, t, k, i, o;
+	Suint32 time, misses, clustermisses, totalmisses;
+	Sfloat acmr, area, totalarea, len, metric;
+	if (!opt || !(threshold >= 1.0f))
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_meshopt_overdraw");
+		return;
+	}
+	tricount = opt->icount / 3;
+	if (tricount < 2)
+		return;
+	stamps = (Suint32 *) S_memory_new(sizeof(Suint32) * opt->vcount);
+	memset(stamps, 0, sizeof(Suint32) * opt->vcount);
+	time = S_MESHOPT_CACHE_SIZE + 1;
+	totalmisses = 0;
+	for (t = 0; t < tricount; ++t)
+	{
+		totalmisses += _S_meshopt_cache_misses(opt->indices + t * 3, stamps,
+		                                       &time, S_MESHOPT_CACHE_SIZE);
+	}
+	acmr = (Sfloat) totalmisses / tricount;
+	/* split where the cache is cold anyway, or where the cluster so far is
+	   cheap enough that a cold cache at the next triangle is affordable */
+	clusters = (Suint32 *) S_memory_new(sizeof(Suint32) * (tricount + 1));
+	nclusters = 0;
+	clusters[nclusters++] = 0;
+	clustermisses = 0;
+	clustertris = 0;
+	time += S_MESHOPT_CACHE_SIZE + 1;
+	for (t = 0; t < tricount; ++t)
+	{
+		misses = _S_meshopt_cache_misses(opt->indices + t * 3, stamps, &time,
+		                                 S_MESHOPT_CACHE_SIZE);
+		if (clustertris > 0 && misses == 3)
+		{
+			clusters[nclusters++] = t;
+			clustermisses = 0;
+			clustertris = 0;
+		}
+		clustermisses += misses;
+		++clustertris;
+		if (t + 1 < tricount &&
+		    clustermisses <= threshold * acmr * clustertris)
+		{
+			clusters[nclusters++] = t + 1;
+			clustermisses = 0;
+			clustertris = 0;
+			time += S_MESHOPT_CACHE_SIZE + 1;
+		}
+	}
+	clusters[nclusters] = tricount;
+	S_memory_delete(stamps);
+	if (nclusters < 2)
+	{
+		S_memory_delete(clusters);
+		return;
+	}
+	/* the area-weighted centre of the whole mesh */
+	center[0] = center[1] = center[2] = 0.0f;
+	totalarea = 0.0f;
+	for (t = 0; t < tricount; ++t)
+	{
+		area = _S_meshopt_face(opt, t, cross, corners);
+		for (i = 0; i < 3; ++i)
+			center[i] += corners[i] * area;
+		totalarea += area;
+	}
+	for (i = 0; i < 3; ++i)
+		center[i] = totalarea > 0.0f ? center[i] / (totalarea * 3.0f) : 0.0f;
+	/* sort the clusters by how far they face away from the centre, so that
+	   the outermost are drawn first */
+	keys = (Suint64 *) S_memory_new(sizeof(Suint64) * nclusters);
+	tmpkeys = (Suint64 *) S_memory_new(sizeof(Suint64) * nclusters);
+	order = (Suint32 *) S_memory_new(sizeof(Suint32) * nclusters);
+	tmporder = (Suint32 *) S_memory_new(sizeof(Suint32) * nclusters);
+	for (k = 0; k < nclusters; ++k)
+	{
+		centroid[0] = centroid[1] = centroid[2] = 0.0f;
+		normal[0] = normal[1] = normal[2] = 0.0f;
+		totalarea = 0.0f;
+		for (t = clusters[k]; t < clusters[k+1]; ++t)
+		{
+			area = _S_meshopt_face(opt, t, cross, corners);
+			for (i = 0; i < 3; ++i)
+			{
+				centroid[i] += corners[i] * area;
+				normal[i] += cross[i];
+			}
+			totalarea += area;
+		}
+		len = S_sqrt(normal[0] * normal[0] + normal[1] * normal[1] +
+		             normal[2] * normal[2]);
+		metric = 0.0f;
+		if (totalarea > 0.0f && len > 0.0f)
+		{
+			for (i = 0; i < 3; ++i)
+			{
+				metric += (centroid[i] / (totalarea * 3.0f) - center[i]) *
+				          normal[i] / len;
+			}
+		}
+		keys[k] = ~_S_meshopt_float_key(metric);
+		order[k] = k;
+	}
+	_S_CALL("S_rsort", S_rsort(keys, order, nclusters, tmpkeys, tmporder));
+	out = (Suint32 *) S_memory_new(sizeof(Suint32) * opt->icount);
+	o = 0;
+	for (k = 0; k < nclusters; ++k)
+	{
+		t = clusters[order[k]];
+		i = clusters[order[k]+1] - t;
+		memcpy(out + o, opt->indices + t * 3, sizeof(Suint32) * 3 * i);
+		o += 3 * i;
+	}
+	memcpy(opt->indices, out, sizeof(Suint32) * opt->icount);
+	S_memory_delete(out);
+	S_memory_delete(keys);
+	S_memory_delete(tmpkeys);
+	S_memory_delete(order);
+	S_memory_delete(tmporder);
+	S_memory_delete(clusters);
+}
+
+void
+S_meshopt_vertex_fetch(Smeshopt *opt)
+{
+	Suint32 *remap;
+	Suint32 next;
+	Ssize_t i;
+	if (!opt)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_meshopt_vertex_fetch");
+		return;
+	}
+	remap = (Suint32 *) S_memory_new(sizeof(Suint32) * opt->vcount);
+	memset(remap, 0xff, sizeof(Suint32) * opt->vcount);
+	next = 0;
+	for (i = 0; i < opt->icount; ++i)
+	{
+		if (remap[opt->indices[i]] == UNUSED)
+			remap[opt->indices[i]] = next++;
+	}
+	_S_meshopt_remap(opt, remap, next);
+	S_memory_delete(remap);
+}
+
+void
+S_meshopt_optimize(Smeshopt *opt,
+                   Smeshopt_stats *before,
+                   Smeshopt_stats *after)
+{
+	if (!opt)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_meshopt_optimize");
+		return;
+	}
+	if (before)
+	{
+		_S_CALL("S_meshopt_analyze",
+		        S_meshopt_analyze(opt, S_MESHOPT_CACHE_SIZE, before));
+	}
+	_S_CALL("S_meshopt_deduplicate", S_meshopt_deduplicate(opt));
+	_S_CALL("S_meshopt_vertex_cache", S_meshopt_vertex_cache(opt));
+	_S_CALL("S_meshopt_overdraw",
+	        S_meshopt_overdraw(opt, S_MESHOPT_OVERDRAW_THRESHOLD));
+	_S_CALL("S_meshopt_vertex_fetch", S_meshopt_vertex_fetch(opt));
+	if (after)
+	{
+		_S_CALL("S_meshopt_analyze",
+		        S_meshopt_analyze(opt, S_MESHOPT_CACHE_SIZE, after));
+	}
+}
+
+void
+S_meshopt_analyze(const Smeshopt *opt,
+                  Suint32 cache_size,
+                  Smeshopt_stats *stats)
+{
+	Suint32 *stamps;
+	Suint32 time, misses, used;
+	Ssize_t tricount, i;
+	if (!opt || !stats || cache_size == 0)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_meshopt_analyze");
+		return;
+	}
+	tricount = opt->icount / 3;
+	stamps = (Suint32 *) S_memory_new(sizeof(Suint32) * opt->vcount);
+	memset(stamps, 0, sizeof(Suint32) * opt->vcount);
+	time = cache_size + 1;
+	misses = 0;
+	for (i = 0; i < tricount; ++i)
+	{
+		misses += _S_meshopt_cache_misses(opt->indices + i * 3, stamps, &time,
+		                                  cache_size);
+	}
+	/* every referenced vertex has missed at least once */
+	used = 0;
+	for (i = 0; i < opt->vcount; ++i)
+	{
+		if (stamps[i] != 0)
+			++used;
+	}
+	S_memory_delete(stamps);
+	stats->acmr = tricount > 0 ? (Sfloat) misses / tricount : 0.0f;
+	stats->atvr = used > 0 ? (Sfloat) misses / used : 0.0f;
+}
+
+Ssize_t
+S_meshopt_simplify(const Smeshopt *opt,
+                   Ssize_t target,
+                   Sfloat max_error,
+                   Suint32 *out,
+                   Sfloat *error)
+{
+	_Smeshopt_quadric *quadrics, q;
+	Suint32 *offsets, *counts, *adjacency, *remap, *from, *to;
+	Suint32 *order, *tmporder;
+	Suint64 *keys, *tmpkeys;
+	Sdouble *costs, cab, cba, worst, limit2;
+	Sbool *locked, *touched;
+	Ssize_t count, newcount, ncand, collapsed, limit, t, k;
+	Suint32 a, b, c, i, j;
+	if (!opt || !out || !(max_error >= 0.0f))
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_meshopt_simplify");
+		return 0;
+	}
+	count = opt->icount;
+	memcpy(out, opt->indices, sizeof(Suint32) * count);
+	worst = 0.0;
+	if (count <= target)
+	{
+		if (error)
+			*error = 0.0f;
+		return count;
+	}
+	quadrics = (_Smeshopt_quadric *)
+		S_memory_new(sizeof(_Smeshopt_quadric) * opt->vcount);
+	locked = (Sbool *) S_memory_new(sizeof(Sbool) * opt->vcount);
+	touched = (Sbool *) S_memory_new(sizeof(Sbool) * opt->vcount);
+	remap = (Suint32 *) S_memory_new(sizeof(Suint32) * opt->vcount);
+	offsets = (Suint32 *) S_memory_new(sizeof(Suint32) * (opt->vcount + 1));
+	counts = (Suint32 *) S_memory_new(sizeof(Suint32) * opt->vcount);
+	adjacency = (Suint32 *) S_memory_new(sizeof(Suint32) * count);
+	from = (Suint32 *) S_memory_new(sizeof(Suint32) * count);
+	to = (Suint32 *) S_memory_new(sizeof(Suint32) * count);
+	costs = (Sdouble *) S_memory_new(sizeof(Sdouble) * count);
+	keys = (Suint64 *) S_memory_new(sizeof(Suint64) * count);
+	tmpkeys = (Suint64 *) S_memory_new(sizeof(Suint64) * count);
+	order = (Suint32 *) S_memory_new(sizeof(Suint32) * count);
+	tmporder = (Suint32 *) S_memory_new(sizeof(Suint32) * count);
+	_S_meshopt_quadrics(opt, quadrics);
+	_S_meshopt_locks(opt, locked);
+	limit2 = (Sdouble) max_error * max_error;
+	while (count > target)
+	{
+		/* find the cheapest direction to collapse each edge */
+		ncand = 0;
+		for (k = 0; k < count; ++k)
+		{
+			a = out[k];
+			b = out[k - k % 3 + (k + 1) % 3];
+			if (a > b)
+				continue;
+			q = quadrics[a];
+			_S_meshopt_quadric_add(&q, quadrics + b);
+			cab = locked[a] ? -1.0 :
+			      _S_meshopt_quadric_error(&q, opt->vertices + b * 3);
+			cba = locked[b] ? -1.0 :
+			      _S_meshopt_quadric_error(&q, opt->vertices + a * 3);
+			if (cab < 0.0 || (cba >= 0.0 && cba < cab))
+			{
+				c = a;
+				a = b;
+				b = c;
+				cab = cba;
+			}
+			if (cab < 0.0 || cab > limit2)
+				continue;
+			from[ncand] = a;
+			to[ncand] = b;
+			costs[ncand] = cab;
+			keys[ncand] = _S_meshopt_float_key((Sfloat) cab);
+			order[ncand] = ncand;
+			++ncand;
+		}
+		if (ncand == 0)
+			break;
+		_S_CALL("S_rsort", S_rsort(keys, order, ncand, tmpkeys, tmporder));
+		_S_meshopt_adjacency(out, count, opt->vcount, offsets, counts,
+		                     adjacency);
+		memset(touched, 0, sizeof(Sbool) * opt->vcount);
+		for (i = 0; i < opt->vcount; ++i)
+			remap[i] = i;
+		/* each collapse removes about two triangles */
+		limit = S_max((count - target) / 6, 1);
+		collapsed = 0;
+		for (k = 0; k < ncand && collapsed < limit; ++k)
+		{
+			c = order[k];
+			a = from[c];
+			b = to[c];
+			if (touched[a] || touched[b] ||
+			    _S_meshopt_flips(opt, out, offsets, counts, adjacency, a, b))
+				continue;
+			remap[a] = b;
+			_S_meshopt_quadric_add(quadrics + b, quadrics + a);
+			worst = S_max(worst, costs[c]);
+			/* keep the neighbourhood still for the rest of the pass, so that
+			   later flip checks see the final positions */
+			touched[b] = S_TRUE;
+			for (j = offsets[a]; j < offsets[a] + counts[a]; ++j)
+			{
+				t = adjacency[j];
+				touched[out[t*3]] = S_TRUE;
+				touched[out[t*3+1]] = S_TRUE;
+				touched[out[t*3+2]] = S_TRUE;
+			}
+			++collapsed;
+		}
+		if (collapsed == 0)
+			break;
+		/* drop the triangles that collapsed */
+		newcount = 0;
+		for (t = 0; t < count / 3; ++t)
+		{
+			a = remap[out[t*3]];
+			b = remap[out[t*3+1]];
+			c = remap[out[t*3+2]];
+			if (a == b || b == c || c == a)
+				continue;
+			out[newcount++] = a;
+			out[newcount++] = b;
+			out[newcount++] = c;
+		}
+		count = newcount;
+	}
+	S_memory_delete(quadrics);
+	S_memory_delete(locked);
+	S_memory_delete(touched);
+	S_memory_delete(remap);
+	S_memory_delete(offsets);
+	S_memory_delete(counts);
+	S_memory_delete(adjacency);
+	S_memory_delete(from);
+	S_memory_delete(to);
+	S_memory_delete(costs);
+	S_memory_delete(keys);
+	S_memory_delete(tmpkeys);
+	S_memory_delete(order);
+	S_memory_delete(tmporder);
+	if (error)
+		*error = (Sfloat) S_sqrt(worst);
+	return count;
+}
+
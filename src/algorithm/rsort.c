@@ -0,0 +1,93 @@
+/*
+ * This file is licensed under BSD 3-Clause.
+ * All license information is available in the included COPYING file.
+ */
+
+/*
+ * rsort.c
+ * Radix sort algorithm source.
+ *
+ * Author       : Finn Rayment <finn@rayment.fr>
+ * Date created : 18/10/2026
+ */
+
+#include <string.h>
+
+#include "sticky/algorithm/rsort.h"
+#include "sticky/common/defines.h"
+#include "sticky/common/error.h"
+#include "sticky/common/types.h"
+
+#define RSORT_PASSES 8
+#define RSORT_RADIX  256
+
+void
+S_rsort(Suint64 *keys,
+        Suint32 *values,
+        Ssize_t elems,
+        Suint64 *tmpkeys,
+        Suint32 *tmpvalues)
+{
+	Ssize_t hist[RSORT_PASSES][RSORT_RADIX];
+	Ssize_t i, sum, count;
+	Suint64 *srck, *dstk, *swapk;
+	Suint32 *srcv, *dstv, *swapv;
+	Suint32 pass, shift, digit;
+	if (!keys || !tmpkeys || (!values != !tmpvalues))
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_rsort");
+		return;
+	}
+	else if (elems <= 0)
+	{
+		_S_SET_ERROR(S_INVALID_OPERATION, "S_rsort");
+		return;
+	}
+	/* count every digit in a single pass over the keys */
+	memset(hist, 0, sizeof(hist));
+	for (i = 0; i < elems; ++i)
+	{
+		for (pass = 0; pass < RSORT_PASSES; ++pass)
+			++hist[pass][(keys[i] >> (pass * 8)) & 0xff];
+	}
+	srck = keys;
+	srcv = values;
+	dstk = tmpkeys;
+	dstv = tmpvalues;
+	for (pass = 0; pass < RSORT_PASSES; ++pass)
+	{
+		shift = pass * 8;
+		/* every key shares this digit, so the pass would not move anything */
+		if (hist[pass][(keys[0] >> shift) & 0xff] == elems)
+			continue;
+		sum = 0;
+		for (digit = 0; digit < RSORT_RADIX; ++digit)
+		{
+			count = hist[pass][digit];
+			hist[pass][digit] = sum;
+			sum += count;
+		}
+		for (i = 0; i < elems; ++i)
+		{
+			digit = (Suint32) ((srck[i] >> shift) & 0xff);
+			dstk[hist[pass][digit]] = srck[i];
+			if (srcv)
+				dstv[hist[pass][digit]] = srcv[i];
+			++hist[pass][digit];
+		}
+		swapk = srck;
+		srck = dstk;
+		dstk = swapk;
+		swapv = srcv;
+		srcv = dstv;
+		dstv = swapv;
+	}
+	/* an odd number of passes leaves the result in the scratch arrays */
+	if (srck != keys)
+	{
+		memcpy(keys, srck, sizeof(Suint64) * elems);
+		if (values)
+			memcpy(values, srcv, sizeof(Suint32) * elems);
+	}
+}
+
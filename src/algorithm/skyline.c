@@ -0,0 +1,205 @@
+/*
+ * This file is licensed under BSD 3-Clause.
+ * All license information is available in the included COPYING file.
+ */
+
+/*
+ * skyline.c
+ * Skyline rectangle packing source.
+ *
+ * Author       : Finn Rayment <finn@rayment.fr>
+ * Date created : 18/10/2026
+ */
+
+#include <string.h>
+
+#include "sticky/algorithm/skyline.h"
+#include "sticky/common/defines.h"
+#include "sticky/common/error.h"
+#include "sticky/common/types.h"
+#include "sticky/math/math.h"
+#include "sticky/memory/allocator.h"
+
+#define SKYLINE_INITIAL_CAPACITY 16
+
+/* find the height at which a rectangle would rest if its left edge were placed
+   at the start of a segment */
+static
+Sbool
+_S_skyline_fit(const Sskyline *skyline,
+               Ssize_t i,
+               Suint32 width,
+               Suint32 height,
+               Suint32 *y)
+{
+	Suint32 left, top;
+	if (skyline->nodes[i].x + width > skyline->width)
+		return S_FALSE;
+	left = width;
+	top = 0;
+	/* the segments span the whole width, so this never runs off the end */
+	while (1)
+	{
+		top = S_max(top, skyline->nodes[i].y);
+		if (top + height > skyline->height)
+			return S_FALSE;
+		if (skyline->nodes[i].width >= left)
+			break;
+		left -= skyline->nodes[i].width;
+		++i;
+	}
+	*y = top;
+	return S_TRUE;
+}
+
+static
+void
+_S_skyline_remove(Sskyline *skyline,
+                  Ssize_t i)
+{
+	memmove(skyline->nodes + i, skyline->nodes + i + 1,
+	        (skyline->len - i - 1) * sizeof(Sskyline_node));
+	--skyline->len;
+}
+
+Sskyline *
+S_skyline_new(Suint32 width,
+              Suint32 height)
+{
+	Sskyline *skyline;
+	if (width == 0 || height == 0)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_skyline_new");
+		return NULL;
+	}
+	skyline = (Sskyline *) S_memory_new(sizeof(Sskyline));
+	skyline->cap = SKYLINE_INITIAL_CAPACITY;
+	skyline->nodes = (Sskyline_node *) S_memory_new(skyline->cap *
+	                                                sizeof(Sskyline_node));
+	skyline->width = width;
+	skyline->height = height;
+	_S_CALL("S_skyline_clear", S_skyline_clear(skyline));
+	return skyline;
+}
+
+void
+S_skyline_delete(Sskyline *skyline)
+{
+	if (!skyline)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_skyline_delete");
+		return;
+	}
+	S_memory_delete(skyline->nodes);
+	S_memory_delete(skyline);
+}
+
+void
+S_skyline_clear(Sskyline *skyline)
+{
+	if (!skyline)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_skyline_clear");
+		return;
+	}
+	skyline->nodes[0].x = 0;
+	skyline->nodes[0].y = 0;
+	skyline->nodes[0].width = skyline->width;
+	skyline->len = 1;
+	skyline->area = 0;
+}
+
+Sbool
+S_skyline_pack(Sskyline *skyline,
+               Suint32 width,
+               Suint32 height,
+               Suint32 *x,
+               Suint32 *y)
+{
+	Sskyline_node *node;
+	Ssize_t i, best;
+	Suint32 top, besttop, bestwidth, end, shrink;
+	if (!skyline || !x || !y || width == 0 || height == 0)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_skyline_pack");
+		return S_FALSE;
+	}
+	/* rest the rectangle where its top is lowest, and then where it covers
+	   the narrowest segment to leave wide segments for wide rectangles */
+	best = skyline->len;
+	besttop = 0;
+	bestwidth = 0;
+	for (i = 0; i < skyline->len; ++i)
+	{
+		if (!_S_skyline_fit(skyline, i, width, height, &top))
+			continue;
+		if (best == skyline->len || top + height < besttop ||
+		    (top + height == besttop && skyline->nodes[i].width < bestwidth))
+		{
+			best = i;
+			besttop = top + height;
+			bestwidth = skyline->nodes[i].width;
+		}
+	}
+	if (best == skyline->len)
+		return S_FALSE;
+
+	if (skyline->len == skyline->cap)
+	{
+		skyline->cap *= 2;
+		skyline->nodes = (Sskyline_node *)
+		                 S_memory_resize(skyline->nodes,
+		                                 skyline->cap * sizeof(Sskyline_node));
+	}
+	memmove(skyline->nodes + best + 1, skyline->nodes + best,
+	        (skyline->len - best) * sizeof(Sskyline_node));
+	++skyline->len;
+	node = skyline->nodes + best;
+	node->y = besttop;
+	node->width = width;
+	*x = node->x;
+	*y = besttop - height;
+
+	/* cut the segments which are now covered by the new one */
+	end = node->x + node->width;
+	i = best + 1;
+	while (i < skyline->len && skyline->nodes[i].x < end)
+	{
+		shrink = end - skyline->nodes[i].x;
+		if (skyline->nodes[i].width > shrink)
+		{
+			skyline->nodes[i].x += shrink;
+			skyline->nodes[i].width -= shrink;
+			break;
+		}
+		_S_skyline_remove(skyline, i);
+	}
+
+	/* merge neighbouring segments of the same height */
+	for (i = 0; i + 1 < skyline->len;)
+	{
+		if (skyline->nodes[i].y == skyline->nodes[i+1].y)
+		{
+			skyline->nodes[i].width += skyline->nodes[i+1].width;
+			_S_skyline_remove(skyline, i + 1);
+		}
+		else
+		{
+			++i;
+		}
+	}
+	skyline->area += (Suint64) width * height;
+	return S_TRUE;
+}
+
+Sfloat
+S_skyline_get_occupancy(const Sskyline *skyline)
+{
+	if (!skyline)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_skyline_get_occupancy");
+		return 0.0f;
+	}
+	return skyline->area / ((Sfloat) skyline->width * skyline->height);
+}
+
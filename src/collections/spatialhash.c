@@ -0,0 +1,492 @@
+/*
+ * This file is licensed under BSD 3-Clause.
+ * All license information is available in the included COPYING file.
+ */
+
+/*
+ * spatialhash.c
+ * Spatial hash source.
+ *
+ * Author       : Finn Rayment <finn@rayment.fr>
+ * Date created : 18/10/2026
+ */
+
+#include <math.h>
+
+#include "sticky/collections/spatialhash.h"
+#include "sticky/common/error.h"
+#include "sticky/common/types.h"
+#include "sticky/math/math.h"
+#include "sticky/memory/allocator.h"
+
+#define _S_SPATIALHASH_INIT_CAP     64
+#define _S_SPATIALHASH_INIT_BUCKETS 64
+/* cell coordinates are clamped so that ranges never overflow */
+#define _S_SPATIALHASH_CELL_LIMIT   1073741824.0f
+
+static
+Sint32
+_S_spatialhash_cell(const Sspatialhash *hash,
+                    Sfloat v)
+{
+	v = floorf(v * hash->invcellsize);
+	if (v < -_S_SPATIALHASH_CELL_LIMIT)
+		v = -_S_SPATIALHASH_CELL_LIMIT;
+	else if (v > _S_SPATIALHASH_CELL_LIMIT || v != v)
+		v = _S_SPATIALHASH_CELL_LIMIT;
+	return (Sint32) v;
+}
+
+static
+Suint32
+_S_spatialhash_bucket(const Sspatialhash *hash,
+                      Sint32 x,
+                      Sint32 y,
+                      Sint32 z)
+{
+	return (((Suint32) x * 73856093u) ^
+	        ((Suint32) y * 19349663u) ^
+	        ((Suint32) z * 83492791u)) & (hash->nbuckets - 1);
+}
+
+static
+void
+_S_spatialhash_link(Sspatialhash *hash,
+                    Suint32 handle)
+{
+	_Sspatialhash_entry *entry;
+	Suint32 bucket;
+	entry = hash->entries+handle;
+	bucket = _S_spatialhash_bucket(hash, entry->x, entry->y, entry->z);
+	entry->bucket = bucket;
+	entry->last = S_SPATIALHASH_NONE;
+	entry->next = hash->buckets[bucket];
+	if (entry->next != S_SPATIALHASH_NONE)
+		hash->entries[entry->next].last = handle;
+	hash->buckets[bucket] = handle;
+}
+
+static
+void
+_S_spatialhash_unlink(Sspatialhash *hash,
+                      Suint32 handle)
+{
+	_Sspatialhash_entry *entry;
+	entry = hash->entries+handle;
+	if (entry->last != S_SPATIALHASH_NONE)
+		hash->entries[entry->last].next = entry->next;
+	else
+		hash->buckets[entry->bucket] = entry->next;
+	if (entry->next != S_SPATIALHASH_NONE)
+		hash->entries[entry->next].last = entry->last;
+}
+
+/* add entries [from, cap) to the free list */
+static
+void
+_S_spatialhash_free_range(Sspatialhash *hash,
+                          Suint32 from)
+{
+	Suint32 i;
+	for (i = hash->cap; i > from; --i)
+	{
+		hash->entries[i-1].bucket = S_SPATIALHASH_NONE;
+		hash->entries[i-1].next = hash->free;
+		hash->free = i-1;
+	}
+}
+
+/* resize the bucket table and relink every entry */
+static
+void
+_S_spatialhash_rehash(Sspatialhash *hash,
+                      Suint32 nbuckets)
+{
+	Suint32 i;
+	hash->buckets = (Suint32 *) S_memory_resize(hash->buckets,
+	                                            sizeof(Suint32) * nbuckets);
+	hash->nbuckets = nbuckets;
+	for (i = 0; i < nbuckets; ++i)
+		hash->buckets[i] = S_SPATIALHASH_NONE;
+	for (i = 0; i < hash->cap; ++i)
+	{
+		if (hash->entries[i].bucket != S_SPATIALHASH_NONE)
+			_S_spatialhash_link(hash, i);
+	}
+}
+
+static
+Sbool
+_S_spatialhash_valid(const Sspatialhash *hash,
+                     Suint32 handle)
+{
+	return handle < hash->cap &&
+	       hash->entries[handle].bucket != S_SPATIALHASH_NONE;
+}
+
+/* find the largest radius of the entries held, and how many share it */
+static
+void
+_S_spatialhash_find_maxradius(Sspatialhash *hash)
+{
+	const _Sspatialhash_entry *entry;
+	Suint32 i;
+	hash->maxradius = 0.0f;
+	hash->nmaxradius = 0;
+	for (i = 0; i < hash->cap; ++i)
+	{
+		entry = hash->entries+i;
+		if (entry->bucket == S_SPATIALHASH_NONE)
+			continue;
+		if (entry->radius > hash->maxradius)
+		{
+			hash->maxradius = entry->radius;
+			hash->nmaxradius = 1;
+		}
+		else if (entry->radius == hash->maxradius)
+		{
+			++hash->nmaxradius;
+		}
+	}
+}
+
+/* test an entry against a sphere, or a box if centre is NULL */
+static
+Sbool
+_S_spatialhash_test(const _Sspatialhash_entry *entry,
+                    const Svec3 *centre,
+                    Sfloat radius,
+                    const Svec3 *min,
+                    const Svec3 *max)
+{
+	Sfloat x, y, z, r;
+	if (centre)
+	{
+		x = entry->pos.x - centre->x;
+		y = entry->pos.y - centre->y;
+		z = entry->pos.z - centre->z;
+		r = entry->radius + radius;
+	}
+	else
+	{
+		x = S_max(S_max(min->x - entry->pos.x, 0.0f), entry->pos.x - max->x);
+		y = S_max(S_max(min->y - entry->pos.y, 0.0f), entry->pos.y - max->y);
+		z = S_max(S_max(min->z - entry->pos.z, 0.0f), entry->pos.z - max->z);
+		r = entry->radius;
+	}
+	return x*x + y*y + z*z <= r*r;
+}
+
+static
+Ssize_t
+_S_spatialhash_query(const Sspatialhash *hash,
+                     const Svec3 *centre,
+                     Sfloat radius,
+                     const Svec3 *min,
+                     const Svec3 *max,
+                     Suint32 *out,
+                     Ssize_t outmax)
+{
+	const _Sspatialhash_entry *entry;
+	Sint32 x0, y0, z0, x1, y1, z1, x, y, z;
+	Suint64 cells;
+	Suint32 i;
+	Ssize_t count;
+	Sfloat pad;
+	count = 0;
+	if (hash->len == 0)
+		return 0;
+	/* entries are stored by their centre, so pad the query by the largest
+	   radius to find every entry that may overlap it */
+	pad = hash->maxradius;
+	x0 = _S_spatialhash_cell(hash, min->x - pad);
+	y0 = _S_spatialhash_cell(hash, min->y - pad);
+	z0 = _S_spatialhash_cell(hash, min->z - pad);
+	x1 = _S_spatialhash_cell(hash, max->x + pad);
+	y1 = _S_spatialhash_cell(hash, max->y + pad);
+	z1 = _S_spatialhash_cell(hash, max->z + pad);
+	cells = (Suint64) ((Sint64) x1 - x0 + 1) * (Suint64) ((Sint64) y1 - y0 + 1);
+	if (cells <= hash->len)
+		cells *= (Suint64) ((Sint64) z1 - z0 + 1);
+	if (cells > hash->len)
+	{
+		/* the query covers more cells than there are entries, so it is
+		   cheaper to test every entry */
+		for (i = 0; i < hash->cap; ++i)
+		{
+			entry = hash->entries+i;
+			if (entry->bucket == S_SPATIALHASH_NONE ||
+			    !_S_spatialhash_test(entry, centre, radius, min, max))
+				continue;
+			if (count < outmax)
+				out[count] = i;
+			++count;
+		}
+		return count;
+	}
+	for (z = z0; z <= z1; ++z)
+	{
+		for (y = y0; y <= y1; ++y)
+		{
+			for (x = x0; x <= x1; ++x)
+			{
+				i = hash->buckets[_S_spatialhash_bucket(hash, x, y, z)];
+				while (i != S_SPATIALHASH_NONE)
+				{
+					entry = hash->entries+i;
+					/* several cells may share a bucket, so skip entries of
+					   other cells to avoid reporting them twice */
+					if (entry->x == x && entry->y == y && entry->z == z &&
+					    _S_spatialhash_test(entry, centre, radius, min, max))
+					{
+						if (count < outmax)
+							out[count] = i;
+						++count;
+					}
+					i = entry->next;
+				}
+			}
+		}
+	}
+	return count;
+}
+
+Sspatialhash *
+S_spatialhash_new(Sfloat cellsize)
+{
+	Sspatialhash *hash;
+	Suint32 i;
+	if (!(cellsize > 0.0f))
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_spatialhash_new");
+		return NULL;
+	}
+	hash = (Sspatialhash *) S_memory_new(sizeof(Sspatialhash));
+	hash->cellsize = cellsize;
+	hash->invcellsize = 1.0f / cellsize;
+	hash->maxradius = 0.0f;
+	hash->nmaxradius = 0;
+	hash->len = 0;
+	hash->cap = _S_SPATIALHASH_INIT_CAP;
+	hash->nbuckets = _S_SPATIALHASH_INIT_BUCKETS;
+	hash->free = S_SPATIALHASH_NONE;
+	hash->entries = (_Sspatialhash_entry *)
+		S_memory_new(sizeof(_Sspatialhash_entry) * hash->cap);
+	hash->buckets = (Suint32 *) S_memory_new(sizeof(Suint32) * hash->nbuckets);
+	for (i = 0; i < hash->nbuckets; ++i)
+		hash->buckets[i] = S_SPATIALHASH_NONE;
+	_S_spatialhash_free_range(hash, 0);
+	return hash;
+}
+
+void
+S_spatialhash_delete(Sspatialhash *hash)
+{
+	if (!hash)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_spatialhash_delete");
+		return;
+	}
+	S_memory_delete(hash->entries);
+	S_memory_delete(hash->buckets);
+	S_memory_delete(hash);
+}
+
+void
+S_spatialhash_clear(Sspatialhash *hash)
+{
+	Suint32 i;
+	if (!hash)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_spatialhash_clear");
+		return;
+	}
+	for (i = 0; i < hash->nbuckets; ++i)
+		hash->buckets[i] = S_SPATIALHASH_NONE;
+	hash->free = S_SPATIALHASH_NONE;
+	_S_spatialhash_free_range(hash, 0);
+	hash->len = 0;
+	hash->maxradius = 0.0f;
+	hash->nmaxradius = 0;
+}
+
+Suint32
+S_spatialhash_insert(Sspatialhash *hash,
+                     const Svec3 *pos,
+                     Sfloat radius,
+                     void *ptr)
+{
+	_Sspatialhash_entry *entry;
+	Suint32 handle, cap;
+	if (!hash || !pos || !(radius >= 0.0f))
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_spatialhash_insert");
+		return S_SPATIALHASH_NONE;
+	}
+	if (hash->free == S_SPATIALHASH_NONE)
+	{
+		if (hash->cap >= S_UINT32_MAX / 2)
+		{
+			_S_SET_ERROR(S_INVALID_OPERATION, "S_spatialhash_insert");
+			return S_SPATIALHASH_NONE;
+		}
+		cap = hash->cap;
+		hash->cap *= 2;
+		hash->entries = (_Sspatialhash_entry *)
+			S_memory_resize(hash->entries,
+			                sizeof(_Sspatialhash_entry) * hash->cap);
+		_S_spatialhash_free_range(hash, cap);
+	}
+	/* keep the load factor of the bucket table at or below two */
+	if (hash->len >= hash->nbuckets * 2)
+		_S_spatialhash_rehash(hash, hash->nbuckets * 2);
+	handle = hash->free;
+	entry = hash->entries+handle;
+	hash->free = entry->next;
+	_S_CALL("S_vec3_copy", S_vec3_copy(&(entry->pos), pos));
+	entry->radius = radius;
+	entry->ptr = ptr;
+	entry->x = _S_spatialhash_cell(hash, pos->x);
+	entry->y = _S_spatialhash_cell(hash, pos->y);
+	entry->z = _S_spatialhash_cell(hash, pos->z);
+	_S_spatialhash_link(hash, handle);
+	if (radius > hash->maxradius)
+	{
+		hash->maxradius = radius;
+		hash->nmaxradius = 1;
+	}
+	else if (radius == hash->maxradius)
+	{
+		++hash->nmaxradius;
+	}
+	++hash->len;
+	return handle;
+}
+
+void
+S_spatialhash_move(Sspatialhash *hash,
+                   Suint32 handle,
+                   const Svec3 *pos)
+{
+	_Sspatialhash_entry *entry;
+	Sint32 x, y, z;
+	if (!hash || !pos)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_spatialhash_move");
+		return;
+	}
+	else if (!_S_spatialhash_valid(hash, handle))
+	{
+		_S_SET_ERROR(S_INVALID_INDEX, "S_spatialhash_move");
+		return;
+	}
+	entry = hash->entries+handle;
+	_S_CALL("S_vec3_copy", S_vec3_copy(&(entry->pos), pos));
+	x = _S_spatialhash_cell(hash, pos->x);
+	y = _S_spatialhash_cell(hash, pos->y);
+	z = _S_spatialhash_cell(hash, pos->z);
+	if (x == entry->x && y == entry->y && z == entry->z)
+		return;
+	_S_spatialhash_unlink(hash, handle);
+	entry->x = x;
+	entry->y = y;
+	entry->z = z;
+	_S_spatialhash_link(hash, handle);
+}
+
+void
+S_spatialhash_remove(Sspatialhash *hash,
+                     Suint32 handle)
+{
+	_Sspatialhash_entry *entry;
+	if (!hash)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_spatialhash_remove");
+		return;
+	}
+	else if (!_S_spatialhash_valid(hash, handle))
+	{
+		_S_SET_ERROR(S_INVALID_INDEX, "S_spatialhash_remove");
+		return;
+	}
+	_S_spatialhash_unlink(hash, handle);
+	entry = hash->entries+handle;
+	entry->bucket = S_SPATIALHASH_NONE;
+	entry->ptr = NULL;
+	entry->next = hash->free;
+	hash->free = handle;
+	--hash->len;
+	/* shrink the query padding once no entry has the largest radius */
+	if (entry->radius == hash->maxradius && --hash->nmaxradius == 0)
+		_S_spatialhash_find_maxradius(hash);
+}
+
+void *
+S_spatialhash_get(const Sspatialhash *hash,
+                  Suint32 handle)
+{
+	if (!hash)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_spatialhash_get");
+		return NULL;
+	}
+	else if (!_S_spatialhash_valid(hash, handle))
+	{
+		_S_SET_ERROR(S_INVALID_INDEX, "S_spatialhash_get");
+		return NULL;
+	}
+	return hash->entries[handle].ptr;
+}
+
+Ssize_t
+S_spatialhash_size(const Sspatialhash *hash)
+{
+	if (!hash)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_spatialhash_size");
+		return 0;
+	}
+	return hash->len;
+}
+
+Ssize_t
+S_spatialhash_query_radius(const Sspatialhash *hash,
+                           const Svec3 *centre,
+                           Sfloat radius,
+                           Suint32 *out,
+                           Ssize_t max)
+{
+	Svec3 vmin, vmax;
+	Ssize_t count;
+	if (!hash || !centre || !(radius >= 0.0f) || (!out && max > 0))
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_spatialhash_query_radius");
+		return 0;
+	}
+	vmin.x = centre->x - radius;
+	vmin.y = centre->y - radius;
+	vmin.z = centre->z - radius;
+	vmax.x = centre->x + radius;
+	vmax.y = centre->y + radius;
+	vmax.z = centre->z + radius;
+	count = _S_spatialhash_query(hash, centre, radius, &vmin, &vmax, out, max);
+	return count;
+}
+
+Ssize_t
+S_spatialhash_query_bounds(const Sspatialhash *hash,
+                           const Svec3 *min,
+                           const Svec3 *max,
+                           Suint32 *out,
+                           Ssize_t outmax)
+{
+	Ssize_t count;
+	if (!hash || !min || !max || (!out && outmax > 0))
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_spatialhash_query_bounds");
+		return 0;
+	}
+	count = _S_spatialhash_query(hash, NULL, 0.0f, min, max, out, outmax);
+	return count;
+}
+
@@ -0,0 +1,825 @@
+/*
+ * This file is licensed under BSD 3-Clause.
+ * All license information is available in the included COPYING file.
+ */
+
+/*
+ * bvh.c
+ * Bounding volume hierarchy source.
+ *
+ * Author       : Finn Rayment <finn@rayment.fr>
+ * Date created : 18/10/2026
+ */
+
+#include <float.h>
+#include <string.h>
+
+#include "sticky/common/error.h"
+#include "sticky/common/types.h"
+#include "sticky/math/bvh.h"
+#include "sticky/math/math.h"
+#include "sticky/memory/allocator.h"
+
+#define _S_BVH_BINS       16
+#define _S_BVH_LEAF_SIZE  4
+#define _S_BVH_LEAF_MAX   16
+#define _S_BVH_STACK_SIZE 64
+/* past this depth, nodes are split at the object median, which halves them
+   and so bounds the depth of the tree to the size of the traversal stack */
+#define _S_BVH_SAH_DEPTH  24
+
+Sbvh *
+S_bvh_new(void)
+{
+	Sbvh *bvh;
+	bvh = (Sbvh *) S_memory_new(sizeof(Sbvh));
+	bvh->nodes = NULL;
+	bvh->mins = NULL;
+	bvh->maxs = NULL;
+	bvh->prims = NULL;
+	bvh->len = 0;
+	bvh->nlen = 0;
+	return bvh;
+}
+
+static
+void
+_S_bvh_clear(Sbvh *bvh)
+{
+	if (bvh->nodes)
+		S_memory_delete(bvh->nodes);
+	if (bvh->mins)
+		S_memory_delete(bvh->mins);
+	if (bvh->maxs)
+		S_memory_delete(bvh->maxs);
+	if (bvh->prims)
+		S_memory_delete(bvh->prims);
+	bvh->nodes = NULL;
+	bvh->mins = NULL;
+	bvh->maxs = NULL;
+	bvh->prims = NULL;
+	bvh->len = 0;
+	bvh->nlen = 0;
+}
+
+void
+S_bvh_delete(Sbvh *bvh)
+{
+	if (!bvh)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_bvh_delete");
+		return;
+	}
+	_S_bvh_clear(bvh);
+	S_memory_delete(bvh);
+}
+
+static
+void
+_S_bvh_grow(Svec3 *min,
+            Svec3 *max,
+            const Svec3 *bmin,
+            const Svec3 *bmax)
+{
+	min->x = S_min(min->x, bmin->x);
+	min->y = S_min(min->y, bmin->y);
+	min->z = S_min(min->z, bmin->z);
+	max->x = S_max(max->x, bmax->x);
+	max->y = S_max(max->y, bmax->y);
+	max->z = S_max(max->z, bmax->z);
+}
+
+static
+Sfloat
+_S_bvh_area(const Svec3 *min,
+            const Svec3 *max)
+{
+	Sfloat x, y, z;
+	x = max->x - min->x;
+	y = max->y - min->y;
+	z = max->z - min->z;
+	return x*y + y*z + z*x;
+}
+
+static
+void
+_S_bvh_empty(Svec3 *min,
+             Svec3 *max)
+{
+	min->x = min->y = min->z = FLT_MAX;
+	max->x = max->y = max->z = -FLT_MAX;
+}
+
+static
+void
+_S_bvh_fit_leaf(Sbvh *bvh,
+                _Sbvh_node *node)
+{
+	Suint32 i, p;
+	_S_bvh_empty(&(node->min), &(node->max));
+	for (i = 0; i < node->count; ++i)
+	{
+		p = bvh->prims[node->first + i];
+		_S_bvh_grow(&(node->min), &(node->max), bvh->mins+p, bvh->maxs+p);
+	}
+}
+
+static
+Sfloat
+_S_bvh_axis(const Svec3 *vec,
+            Suint8 axis)
+{
+	return axis == 0 ? vec->x : (axis == 1 ? vec->y : vec->z);
+}
+
+static
+Sfloat
+_S_bvh_centroid(const Sbvh *bvh,
+                Suint32 prim,
+                Suint8 axis)
+{
+	return 0.5f * (_S_bvh_axis(bvh->mins+prim, axis) +
+	               _S_bvh_axis(bvh->maxs+prim, axis));
+}
+
+/* find the best binned SAH split of a node, returning S_FALSE if the node
+   should remain a leaf or if its centroids share a single point */
+static
+Sbool
+_S_bvh_find_split(const Sbvh *bvh,
+                  const _Sbvh_node *node,
+                  const Svec3 *cmin,
+                  const Svec3 *cmax,
+                  Suint8 *bestaxis,
+                  Sfloat *bestpos)
+{
+	Svec3 bmin[_S_BVH_BINS], bmax[_S_BVH_BINS], lmin, lmax, rmin, rmax;
+	Suint32 bcount[_S_BVH_BINS], lcount, rcount, i, p;
+	Sfloat larea[_S_BVH_BINS], cost, best, lo, extent, scale;
+	Suint8 axis;
+	Sint32 b;
+
+	best = FLT_MAX;
+	for (axis = 0; axis < 3; ++axis)
+	{
+		lo = _S_bvh_axis(cmin, axis);
+		extent = _S_bvh_axis(cmax, axis) - lo;
+		if (extent <= 0.0f)
+			continue;
+		scale = _S_BVH_BINS / extent;
+		for (b = 0; b < _S_BVH_BINS; ++b)
+		{
+			bcount[b] = 0;
+			_S_bvh_empty(bmin+b, bmax+b);
+		}
+		for (i = 0; i < node->count; ++i)
+		{
+			p = bvh->prims[node->first + i];
+			b = (Sint32) ((_S_bvh_centroid(bvh, p, axis) - lo) * scale);
+			b = S_imin(S_imax(b, 0), _S_BVH_BINS - 1);
+			++bcount[b];
+			_S_bvh_grow(bmin+b, bmax+b, bvh->mins+p, bvh->maxs+p);
+		}
+		/* sweep from the left, storing area * count for each split plane */
+		_S_bvh_empty(&lmin, &lmax);
+		lcount = 0;
+		for (b = 0; b < _S_BVH_BINS - 1; ++b)
+		{
+			lcount += bcount[b];
+			if (bcount[b])
+				_S_bvh_grow(&lmin, &lmax, bmin+b, bmax+b);
+			larea[b] = lcount ? _S_bvh_area(&lmin, &lmax) * lcount : 0.0f;
+		}
+		/* sweep from the right and combine */
+		_S_bvh_empty(&rmin, &rmax);
+		rcount = 0;
+		for (b = _S_BVH_BINS - 1; b > 0; --b)
+		{
+			rcount += bcount[b];
+			if (bcount[b])
+				_S_bvh_grow(&rmin, &rmax, bmin+b, bmax+b);
+			if (rcount == 0 || rcount == node->count)
+				continue;
+			cost = larea[b-1] + _S_bvh_area(&rmin, &rmax) * rcount;
+			if (cost < best)
+			{
+				best = cost;
+				*bestaxis = axis;
+				*bestpos = lo + b / scale;
+			}
+		}
+	}
+	if (best == FLT_MAX)
+		return S_FALSE;
+	/* compare against the cost of intersecting every primitive in a leaf, with
+	   a traversal cost of one primitive intersection */
+	cost = 1.0f + best / _S_bvh_area(&(node->min), &(node->max));
+	return cost < (Sfloat) node->count || node->count > _S_BVH_LEAF_MAX;
+}
+
+/* move all primitives with a centroid below pos to the front of the node */
+static
+Suint32
+_S_bvh_partition(Sbvh *bvh,
+                 const _Sbvh_node *node,
+                 Suint8 axis,
+                 Sfloat pos)
+{
+	Suint32 i, j, tmp;
+	i = node->first;
+	j = node->first + node->count;
+	while (i < j)
+	{
+		if (_S_bvh_centroid(bvh, bvh->prims[i], axis) < pos)
+		{
+			++i;
+		}
+		else
+		{
+			--j;
+			tmp = bvh->prims[i];
+			bvh->prims[i] = bvh->prims[j];
+			bvh->prims[j] = tmp;
+		}
+	}
+	return i - node->first;
+}
+
+/* reorder the primitives of a node so that the primitive with the kth
+   smallest centroid along an axis is at position k, with every primitive
+   before it no larger and every primitive after it no smaller */
+static
+void
+_S_bvh_select(Sbvh *bvh,
+              const _Sbvh_node *node,
+              Suint8 axis,
+              Suint32 k)
+{
+	Sint64 lo, hi, i, j, kth;
+	Suint32 tmp;
+	Sfloat pivot;
+	lo = node->first;
+	hi = (Sint64) node->first + node->count - 1;
+	kth = (Sint64) node->first + k;
+	while (lo < hi)
+	{
+		pivot = _S_bvh_centroid(bvh, bvh->prims[lo + (hi - lo) / 2], axis);
+		i = lo;
+		j = hi;
+		while (i <= j)
+		{
+			while (_S_bvh_centroid(bvh, bvh->prims[i], axis) < pivot)
+				++i;
+			while (_S_bvh_centroid(bvh, bvh->prims[j], axis) > pivot)
+				--j;
+			if (i > j)
+				break;
+			tmp = bvh->prims[i];
+			bvh->prims[i] = bvh->prims[j];
+			bvh->prims[j] = tmp;
+			++i;
+			--j;
+		}
+		if (kth <= j)
+			hi = j;
+		else if (kth >= i)
+			lo = i;
+		else
+			break;
+	}
+}
+
+void
+S_bvh_build(Sbvh *bvh,
+            const Svec3 *mins,
+            const Svec3 *maxs,
+            Ssize_t len)
+{
+	Suint32 stack[_S_BVH_STACK_SIZE], depths[_S_BVH_STACK_SIZE];
+	Suint32 sp, idx, depth, i, p, lcount;
+	_Sbvh_node *node, *left, *right;
+	Svec3 cmin, cmax, c;
+	Suint8 axis;
+	Sfloat pos;
+
+	if (!bvh || (len && (!mins || !maxs)) || len >= S_UINT32_MAX / 2)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_bvh_build");
+		return;
+	}
+	_S_bvh_clear(bvh);
+	if (!len)
+		return;
+	bvh->len = (Suint32) len;
+	bvh->mins = (Svec3 *) S_memory_new(sizeof(Svec3) * len);
+	bvh->maxs = (Svec3 *) S_memory_new(sizeof(Svec3) * len);
+	bvh->prims = (Suint32 *) S_memory_new(sizeof(Suint32) * len);
+	/* a binary tree with at most one primitive per leaf has 2n-1 nodes */
+	bvh->nodes = (_Sbvh_node *) S_memory_new(sizeof(_Sbvh_node) * (2*len - 1));
+	memcpy(bvh->mins, mins, sizeof(Svec3) * len);
+	memcpy(bvh->maxs, maxs, sizeof(Svec3) * len);
+	for (i = 0; i < bvh->len; ++i)
+		bvh->prims[i] = i;
+
+	bvh->nodes[0].first = 0;
+	bvh->nodes[0].count = bvh->len;
+	_S_bvh_fit_leaf(bvh, bvh->nodes);
+	bvh->nlen = 1;
+	stack[0] = 0;
+	depths[0] = 0;
+	sp = 1;
+	while (sp > 0)
+	{
+		--sp;
+		idx = stack[sp];
+		depth = depths[sp];
+		node = bvh->nodes+idx;
+		if (node->count <= _S_BVH_LEAF_SIZE)
+			continue;
+		/* bounds of the primitive centroids */
+		_S_bvh_empty(&cmin, &cmax);
+		for (i = 0; i < node->count; ++i)
+		{
+			p = bvh->prims[node->first + i];
+			c.x = _S_bvh_centroid(bvh, p, 0);
+			c.y = _S_bvh_centroid(bvh, p, 1);
+			c.z = _S_bvh_centroid(bvh, p, 2);
+			_S_bvh_grow(&cmin, &cmax, &c, &c);
+		}
+		/* coincident centroids leave no plane to split at, and are split at
+		   the median below like any other failed split */
+		lcount = 0;
+		if (depth < _S_BVH_SAH_DEPTH &&
+		    _S_bvh_find_split(bvh, node, &cmin, &cmax, &axis, &pos))
+			lcount = _S_bvh_partition(bvh, node, axis, pos);
+		if (lcount == 0 || lcount == node->count)
+		{
+			if (node->count <= _S_BVH_LEAF_MAX && depth < _S_BVH_SAH_DEPTH)
+				continue;
+			/* fall back to splitting the primitives in half at the median of
+			   the widest axis of the centroids */
+			axis = 0;
+			if (cmax.y - cmin.y > cmax.x - cmin.x)
+				axis = 1;
+			if (cmax.z - cmin.z > _S_bvh_axis(&cmax, axis) -
+			                      _S_bvh_axis(&cmin, axis))
+				axis = 2;
+			lcount = node->count / 2;
+			_S_bvh_select(bvh, node, axis, lcount);
+		}
+		left = bvh->nodes + bvh->nlen;
+		right = left + 1;
+		left->first = node->first;
+		left->count = lcount;
+		right->first = node->first + lcount;
+		right->count = node->count - lcount;
+		_S_bvh_fit_leaf(bvh, left);
+		_S_bvh_fit_leaf(bvh, right);
+		/* the node becomes an interior node pointing at its children */
+		node->first = bvh->nlen;
+		node->count = 0;
+		stack[sp] = bvh->nlen;
+		depths[sp++] = depth + 1;
+		stack[sp] = bvh->nlen + 1;
+		depths[sp++] = depth + 1;
+		bvh->nlen += 2;
+	}
+}
+
+void
+S_bvh_set_bounds(Sbvh *bvh,
+                 Ssize_t idx,
+                 const Svec3 *min,
+                 const Svec3 *max)
+{
+	if (!bvh || !min || !max)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_bvh_set_bounds");
+		return;
+	}
+	if (idx >= bvh->len)
+	{
+		_S_SET_ERROR(S_INVALID_INDEX, "S_bvh_set_bounds");
+		return;
+	}
+	bvh->mins[idx] = *min;
+	bvh->maxs[idx] = *max;
+}
+
+void
+S_bvh_refit(Sbvh *bvh)
+{
+	Suint32 i;
+	_Sbvh_node *node, *left;
+	if (!bvh)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_bvh_refit");
+		return;
+	}
+	/* children are always stored after their parent */
+	for (i = bvh->nlen; i-- > 0;)
+	{
+		node = bvh->nodes+i;
+		if (node->count)
+		{
+			_S_bvh_fit_leaf(bvh, node);
+		}
+		else
+		{
+			left = bvh->nodes + node->first;
+			node->min = left->min;
+			node->max = left->max;
+			_S_bvh_grow(&(node->min), &(node->max),
+			            &((left+1)->min), &((left+1)->max));
+		}
+	}
+}
+
+Ssize_t
+S_bvh_size(const Sbvh *bvh)
+{
+	if (!bvh)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_bvh_size");
+		return 0;
+	}
+	return bvh->len;
+}
+
+static
+void
+_S_bvh_emit(const Sbvh *bvh,
+            const _Sbvh_node *node,
+            Ssize_t *out,
+            Ssize_t max,
+            Ssize_t *count)
+{
+	Suint32 i;
+	for (i = 0; i < node->count; ++i)
+	{
+		if (*count < max)
+			out[*count] = bvh->prims[node->first + i];
+		++(*count);
+	}
+}
+
+/* emit every primitive below a node without testing */
+static
+void
+_S_bvh_emit_tree(const Sbvh *bvh,
+                 Suint32 idx,
+                 Ssize_t *out,
+                 Ssize_t max,
+                 Ssize_t *count)
+{
+	Suint32 stack[_S_BVH_STACK_SIZE], sp;
+	const _Sbvh_node *node;
+	stack[0] = idx;
+	sp = 1;
+	while (sp > 0)
+	{
+		node = bvh->nodes + stack[--sp];
+		if (node->count)
+		{
+			_S_bvh_emit(bvh, node, out, max, count);
+			continue;
+		}
+		stack[sp++] = node->first;
+		stack[sp++] = node->first + 1;
+	}
+}
+
+/* p-vertex test of a box against the planes set in mask */
+static
+Sbool
+_S_bvh_frustum_outside(const Sfrustum *frustum,
+                       Suint8 mask,
+                       const Svec3 *min,
+                       const Svec3 *max)
+{
+	const Svec4 *p;
+	Suint8 i;
+	for (i = 0; i < 6; ++i)
+	{
+		if (!(mask & (1 << i)))
+			continue;
+		p = frustum->p+i;
+		if (p->x * (p->x >= 0.0f ? max->x : min->x) +
+		    p->y * (p->y >= 0.0f ? max->y : min->y) +
+		    p->z * (p->z >= 0.0f ? max->z : min->z) + p->w < 0.0f)
+			return S_TRUE;
+	}
+	return S_FALSE;
+}
+
+Ssize_t
+S_bvh_query_frustum(const Sbvh *bvh,
+                    const Sfrustum *frustum,
+                    Ssize_t *out,
+                    Ssize_t max)
+{
+	Suint32 stack[_S_BVH_STACK_SIZE], sp, j, prim;
+	Suint8 masks[_S_BVH_STACK_SIZE], mask, i;
+	const _Sbvh_node *node;
+	const Svec4 *p;
+	Ssize_t count;
+	Sfloat nd;
+
+	if (!bvh || !frustum || (max && !out))
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_bvh_query_frustum");
+		return 0;
+	}
+	count = 0;
+	if (!bvh->nlen)
+		return 0;
+	stack[0] = 0;
+	masks[0] = 0x3F;
+	sp = 1;
+	while (sp > 0)
+	{
+		--sp;
+		node = bvh->nodes + stack[sp];
+		mask = masks[sp];
+		/* test only the planes that the parent was not entirely inside of */
+		if (_S_bvh_frustum_outside(frustum, mask, &(node->min), &(node->max)))
+			continue;
+		for (i = 0; i < 6; ++i)
+		{
+			if (!(mask & (1 << i)))
+				continue;
+			/* n-vertex, nearest along the plane normal */
+			p = frustum->p+i;
+			nd = p->x * (p->x >= 0.0f ? node->min.x : node->max.x) +
+			     p->y * (p->y >= 0.0f ? node->min.y : node->max.y) +
+			     p->z * (p->z >= 0.0f ? node->min.z : node->max.z) + p->w;
+			if (nd >= 0.0f)
+				mask &= (Suint8) ~(1 << i);
+		}
+		if (!mask)
+		{
+			_S_bvh_emit_tree(bvh, (Suint32) (node - bvh->nodes),
+			                 out, max, &count);
+			continue;
+		}
+		if (node->count)
+		{
+			for (j = 0; j < node->count; ++j)
+			{
+				prim = bvh->prims[node->first + j];
+				if (!_S_bvh_frustum_outside(frustum, mask, bvh->mins+prim,
+				                            bvh->maxs+prim))
+				{
+					if (count < max)
+						out[count] = prim;
+					++count;
+				}
+			}
+			continue;
+		}
+		stack[sp] = node->first;
+		masks[sp++] = mask;
+		stack[sp] = node->first + 1;
+		masks[sp++] = mask;
+	}
+	return count;
+}
+
+static
+Sbool
+_S_bvh_overlaps(const Svec3 *amin,
+                const Svec3 *amax,
+                const Svec3 *bmin,
+                const Svec3 *bmax)
+{
+	return amin->x <= bmax->x && amax->x >= bmin->x &&
+	       amin->y <= bmax->y && amax->y >= bmin->y &&
+	       amin->z <= bmax->z && amax->z >= bmin->z;
+}
+
+Ssize_t
+S_bvh_query_bounds(const Sbvh *bvh,
+                   const Svec3 *min,
+                   const Svec3 *max,
+                   Ssize_t *out,
+                   Ssize_t outmax)
+{
+	Suint32 stack[_S_BVH_STACK_SIZE], sp, i, p;
+	const _Sbvh_node *node;
+	Ssize_t count;
+
+	if (!bvh || !min || !max || (outmax && !out))
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_bvh_query_bounds");
+		return 0;
+	}
+	count = 0;
+	if (!bvh->nlen)
+		return 0;
+	stack[0] = 0;
+	sp = 1;
+	while (sp > 0)
+	{
+		node = bvh->nodes + stack[--sp];
+		if (!_S_bvh_overlaps(&(node->min), &(node->max), min, max))
+			continue;
+		if (!node->count)
+		{
+			stack[sp++] = node->first;
+			stack[sp++] = node->first + 1;
+			continue;
+		}
+		for (i = 0; i < node->count; ++i)
+		{
+			p = bvh->prims[node->first + i];
+			if (!_S_bvh_overlaps(bvh->mins+p, bvh->maxs+p, min, max))
+				continue;
+			if (count < outmax)
+				out[count] = p;
+			++count;
+		}
+	}
+	return count;
+}
+
+/* slab test, returning the entry distance or a negative value on a miss */
+static
+Sfloat
+_S_bvh_ray_box(const Svec3 *origin,
+               const Svec3 *inv,
+               const Svec3 *min,
+               const Svec3 *max,
+               Sfloat maxdist)
+{
+	Sfloat t1, t2, tmin, tmax;
+	t1 = (min->x - origin->x) * inv->x;
+	t2 = (max->x - origin->x) * inv->x;
+	tmin = S_min(t1, t2);
+	tmax = S_max(t1, t2);
+	t1 = (min->y - origin->y) * inv->y;
+	t2 = (max->y - origin->y) * inv->y;
+	tmin = S_max(tmin, S_min(t1, t2));
+	tmax = S_min(tmax, S_max(t1, t2));
+	t1 = (min->z - origin->z) * inv->z;
+	t2 = (max->z - origin->z) * inv->z;
+	tmin = S_max(tmin, S_min(t1, t2));
+	tmax = S_min(tmax, S_max(t1, t2));
+	tmin = S_max(tmin, 0.0f);
+	if (tmax < tmin || tmin > maxdist)
+		return -1.0f;
+	return tmin;
+}
+
+static
+Sfloat
+_S_bvh_inverse(Sfloat x)
+{
+	/* avoid infinities, whose products with zero are undefined */
+	if (S_abs(x) < 1e-20f)
+		x = x < 0.0f ? -1e-20f : 1e-20f;
+	return 1.0f / x;
+}
+
+Sbool
+S_bvh_raycast(const Sbvh *bvh,
+              const Svec3 *origin,
+              const Svec3 *dir,
+              Sfloat maxdist,
+              Ssize_t *hit,
+              Sfloat *dist)
+{
+	Suint32 stack[_S_BVH_STACK_SIZE], sp, i, p, near, far;
+	const _Sbvh_node *node, *left;
+	Sfloat best, t, tl, tr;
+	Svec3 inv;
+	Sbool found;
+
+	if (!bvh || !origin || !dir || !hit)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_bvh_raycast");
+		return S_FALSE;
+	}
+	if (!bvh->nlen)
+		return S_FALSE;
+	inv.x = _S_bvh_inverse(dir->x);
+	inv.y = _S_bvh_inverse(dir->y);
+	inv.z = _S_bvh_inverse(dir->z);
+	found = S_FALSE;
+	best = maxdist;
+	if (_S_bvh_ray_box(origin, &inv, &(bvh->nodes->min), &(bvh->nodes->max),
+	                   best) < 0.0f)
+		return S_FALSE;
+	stack[0] = 0;
+	sp = 1;
+	while (sp > 0)
+	{
+		node = bvh->nodes + stack[--sp];
+		if (node->count)
+		{
+			for (i = 0; i < node->count; ++i)
+			{
+				p = bvh->prims[node->first + i];
+				t = _S_bvh_ray_box(origin, &inv, bvh->mins+p, bvh->maxs+p,
+				                   best);
+				if (t >= 0.0f && (!found || t < best))
+				{
+					best = t;
+					*hit = p;
+					found = S_TRUE;
+				}
+			}
+			continue;
+		}
+		/* visit the nearer child first so that the farther one may be
+		   pruned */
+		left = bvh->nodes + node->first;
+		tl = _S_bvh_ray_box(origin, &inv, &(left->min), &(left->max), best);
+		tr = _S_bvh_ray_box(origin, &inv, &((left+1)->min), &((left+1)->max),
+		                    best);
+		near = node->first;
+		far = node->first + 1;
+		if (tr >= 0.0f && (tl < 0.0f || tr < tl))
+		{
+			near = node->first + 1;
+			far = node->first;
+			t = tl;
+			tl = tr;
+			tr = t;
+		}
+		if (tr >= 0.0f)
+			stack[sp++] = far;
+		if (tl >= 0.0f)
+			stack[sp++] = near;
+	}
+	if (found && dist)
+		*dist = best;
+	return found;
+}
+
+static
+Sfloat
+_S_bvh_distance_sq(const Svec3 *point,
+                   const Svec3 *min,
+                   const Svec3 *max)
+{
+	Sfloat x, y, z;
+	x = S_max(S_max(min->x - point->x, 0.0f), point->x - max->x);
+	y = S_max(S_max(min->y - point->y, 0.0f), point->y - max->y);
+	z = S_max(S_max(min->z - point->z, 0.0f), point->z - max->z);
+	return x*x + y*y + z*z;
+}
+
+Sbool
+S_bvh_nearest(const Sbvh *bvh,
+              const Svec3 *point,
+              Ssize_t *hit,
+              Sfloat *dist)
+{
+	Suint32 stack[_S_BVH_STACK_SIZE], sp, i, p, near, far;
+	const _Sbvh_node *node, *left;
+	Sfloat best, d, dl, dr;
+
+	if (!bvh || !point || !hit)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_bvh_nearest");
+		return S_FALSE;
+	}
+	if (!bvh->nlen)
+		return S_FALSE;
+	best = FLT_MAX;
+	stack[0] = 0;
+	sp = 1;
+	while (sp > 0)
+	{
+		node = bvh->nodes + stack[--sp];
+		if (_S_bvh_distance_sq(point, &(node->min), &(node->max)) >= best)
+			continue;
+		if (node->count)
+		{
+			for (i = 0; i < node->count; ++i)
+			{
+				p = bvh->prims[node->first + i];
+				d = _S_bvh_distance_sq(point, bvh->mins+p, bvh->maxs+p);
+				if (d < best)
+				{
+					best = d;
+					*hit = p;
+				}
+			}
+			continue;
+		}
+		left = bvh->nodes + node->first;
+		dl = _S_bvh_distance_sq(point, &(left->min), &(left->max));
+		dr = _S_bvh_distance_sq(point, &((left+1)->min), &((left+1)->max));
+		near = dl <= dr ? node->first : node->first + 1;
+		far = dl <= dr ? node->first + 1 : node->first;
+		if (S_max(dl, dr) < best)
+			stack[sp++] = far;
+		if (S_min(dl, dr) < best)
+			stack[sp++] = near;
+	}
+	if (dist)
+		*dist = S_sqrt(best);
+	return S_TRUE;
+}
+
@@ -11,6 +11,8 @@
  * Date created : 27/02/2022
  */
 
+#include <string.h>
+
 #include "sticky/common/error.h"
 #include "sticky/common/types.h"
 #include "sticky/math/frustum.h"
@@ -20,6 +22,12 @@
 #include "sticky/memory/allocator.h"
 #include "sticky/video/camera.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define _S_FRUSTUM_SSE 1
+#endif /* __SSE2__ */
+
 static
 void
 _S_frustum_normalize(Sfrustum *frustum,
@@ -149,6 +157,11 @@ S_frustum_intersects_sphere(const Sfrustum *frustum,
 	return S_TRUE;
 }
 
+/*
+ * Only the corner of the box that lies furthest along the normal of each plane
+ * (the p-vertex) needs to be tested: if it is behind the plane, then so is the
+ * rest of the box.
+ */
 Sbool
 S_frustum_intersects_bounds(const Sfrustum *frustum,
                             const Svec3 *min,
@@ -156,64 +169,218 @@ S_frustum_intersects_bounds(const Sfrustum *frustum,
 {
 	Suint8 i;
 	Sfloat dot;
-	Svec3 a, b, c, d, e, f, g, h;
+	const Svec4 *p;
 	if (!frustum || !min || !max)
 	{
 		_S_SET_ERROR(S_INVALID_VALUE, "S_frustum_intersects_bounds");
 		return S_FALSE;
 	}
-	a.x = min->x; a.y = min->y; a.z=min->z;
-	b.x = min->x; b.y = min->y; b.z=max->z;
-	c.x = min->x; c.y = max->y; c.z=min->z;
-	d.x = min->x; d.y = max->y; d.z=max->z;
-	e.x = max->x; e.y = min->y; e.z=min->z;
-	f.x = max->x; f.y = min->y; f.z=max->z;
-	g.x = max->x; g.y = max->y; g.z=min->z;
-	h.x = max->x; h.y = max->y; h.z=max->z;
 	for (i = 0; i < 6; ++i)
 	{
-		dot = (frustum->p+i)->x*a.x +
-		      (frustum->p+i)->y*a.y +
-		      (frustum->p+i)->z*a.z;
-		if (dot + (frustum->p+i)->w >= 0)
-			continue;
-		dot = (frustum->p+i)->x*b.x +
-		      (frustum->p+i)->y*b.y +
-		      (frustum->p+i)->z*b.z;
-		if (dot + (frustum->p+i)->w >= 0)
-			continue;
-		dot = (frustum->p+i)->x*c.x +
-		      (frustum->p+i)->y*c.y +
-		      (frustum->p+i)->z*c.z;
-		if (dot + (frustum->p+i)->w >= 0)
-			continue;
-		dot = (frustum->p+i)->x*d.x +
-		      (frustum->p+i)->y*d.y +
-		      (frustum->p+i)->z*d.z;
-		if (dot + (frustum->p+i)->w >= 0)
-			continue;
-		dot = (frustum->p+i)->x*e.x +
-		      (frustum->p+i)->y*e.y +
-		      (frustum->p+i)->z*e.z;
-		if (dot + (frustum->p+i)->w >= 0)
-			continue;
-		dot = (frustum->p+i)->x*f.x +
-		      (frustum->p+i)->y*f.y +
-		      (frustum->p+i)->z*f.z;
-		if (dot + (frustum->p+i)->w >= 0)
-			continue;
-		dot = (frustum->p+i)->x*g.x +
-		      (frustum->p+i)->y*g.y +
-		      (frustum->p+i)->z*g.z;
-		if (dot + (frustum->p+i)->w >= 0)
-			continue;
-		dot = (frustum->p+i)->x*h.x +
-		      (frustum->p+i)->y*h.y +
-		      (frustum->p+i)->z*h.z;
-		if (dot + (frustum->p+i)->w >= 0)
-			continue;
-		return S_FALSE;
+		p = frustum->p+i;
+		dot = p->x * (p->x >= 0.0f ? max->x : min->x) +
+		      p->y * (p->y >= 0.0f ? max->y : min->y) +
+		      p->z * (p->z >= 0.0f ? max->z : min->z);
+		if (dot + p->w < 0.0f)
+			return S_FALSE;
 	}
 	return S_TRUE;
 }
 
+static
+void
+_S_frustum_cull_output(Ssize_t idx,
+                       Suint32 bits,
+                       Suint8 nbits,
+                       Suint32 *mask,
+                       Ssize_t *indices,
+                       Ssize_t *count)
+{
+	Suint8 i;
+	if (mask)
+		mask[idx >> 5] |= bits << (idx & 31);
+	for (i = 0; i < nbits; ++i)
+	{
+		if (bits & (1u << i))
+		{
+			if (indices)
+				indices[*count] = idx + i;
+			++(*count);
+		}
+	}
+}
+
+#ifdef _S_FRUSTUM_SSE
+/* transpose four packed Svec3 into one register per component */
+static
+void
+_S_frustum_load_soa(const Svec3 *vec,
+                    __m128 *x,
+                    __m128 *y,
+                    __m128 *z)
+{
+	__m128 a, b, c, t0, t1;
+	a = _mm_loadu_ps(&(vec[0].x)); /* x0 y0 z0 x1 */
+	b = _mm_loadu_ps(&(vec[1].y)); /* y1 z1 x2 y2 */
+	c = _mm_loadu_ps(&(vec[2].z)); /* z2 x3 y3 z3 */
+	t0 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2));
+	*x = _mm_shuffle_ps(a, t0, _MM_SHUFFLE(2, 0, 3, 0));
+	t0 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1));
+	t1 = _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3));
+	*y = _mm_shuffle_ps(t0, t1, _MM_SHUFFLE(2, 0, 2, 0));
+	t0 = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2));
+	t1 = _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0));
+	*z = _mm_shuffle_ps(t0, t1, _MM_SHUFFLE(2, 0, 2, 0));
+}
+#endif /* _S_FRUSTUM_SSE */
+
+Ssize_t
+S_frustum_cull_spheres(const Sfrustum *frustum,
+                       const Svec3 *points,
+                       const Sfloat *radii,
+                       Ssize_t len,
+                       Suint32 *mask,
+                       Ssize_t *indices)
+{
+	Ssize_t i, count;
+	Suint32 bits;
+	Suint8 j;
+	Sfloat dot;
+	const Svec4 *p;
+#ifdef _S_FRUSTUM_SSE
+	__m128 x, y, z, r, d, vis, nx[6], ny[6], nz[6], nw[6];
+#endif /* _S_FRUSTUM_SSE */
+	if (!frustum || (len && (!points || !radii)))
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_frustum_cull_spheres");
+		return 0;
+	}
+	if (mask)
+		memset(mask, 0, sizeof(Suint32) * ((len + 31) / 32));
+	count = 0;
+	i = 0;
+#ifdef _S_FRUSTUM_SSE
+	for (j = 0; j < 6; ++j)
+	{
+		nx[j] = _mm_set1_ps(frustum->p[j].x);
+		ny[j] = _mm_set1_ps(frustum->p[j].y);
+		nz[j] = _mm_set1_ps(frustum->p[j].z);
+		nw[j] = _mm_set1_ps(frustum->p[j].w);
+	}
+	for (; sizeof(Svec3) == 3 * sizeof(Sfloat) && i + 4 <= len; i += 4)
+	{
+		_S_frustum_load_soa(points+i, &x, &y, &z);
+		r = _mm_loadu_ps(radii+i);
+		vis = _mm_castsi128_ps(_mm_set1_epi32(-1));
+		/* testing all six planes without branching is cheaper than an early
+		   exit, whose outcome is unpredictable */
+		for (j = 0; j < 6; ++j)
+		{
+			d = _mm_add_ps(_mm_mul_ps(x, nx[j]), _mm_mul_ps(y, ny[j]));
+			d = _mm_add_ps(d, _mm_mul_ps(z, nz[j]));
+			d = _mm_add_ps(d, _mm_add_ps(r, nw[j]));
+			vis = _mm_and_ps(vis, _mm_cmpge_ps(d, _mm_setzero_ps()));
+		}
+		bits = (Suint32) _mm_movemask_ps(vis);
+		if (bits)
+			_S_frustum_cull_output(i, bits, 4, mask, indices, &count);
+	}
+#endif /* _S_FRUSTUM_SSE */
+	for (; i < len; ++i)
+	{
+		bits = 1;
+		for (j = 0; j < 6; ++j)
+		{
+			p = frustum->p+j;
+			dot = p->x*points[i].x + p->y*points[i].y + p->z*points[i].z;
+			if (dot + p->w < -radii[i])
+			{
+				bits = 0;
+				break;
+			}
+		}
+		if (bits)
+			_S_frustum_cull_output(i, bits, 1, mask, indices, &count);
+	}
+	return count;
+}
+
+Ssize_t
+S_frustum_cull_bounds(const Sfrustum *frustum,
+                      const Svec3 *mins,
+                      const Svec3 *maxs,
+                      Ssize_t len,
+                      Suint32 *mask,
+                      Ssize_t *indices)
+{
+	Ssize_t i, count;
+	Suint32 bits;
+	Suint8 j;
+	Sfloat dot;
+	const Svec4 *p;
+#ifdef _S_FRUSTUM_SSE
+	__m128 minx, miny, minz, maxx, maxy, maxz, d, vis,
+	       nx[6], ny[6], nz[6], nw[6];
+	Sbool sx[6], sy[6], sz[6];
+#endif /* _S_FRUSTUM_SSE */
+	if (!frustum || (len && (!mins || !maxs)))
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_frustum_cull_bounds");
+		return 0;
+	}
+	if (mask)
+		memset(mask, 0, sizeof(Suint32) * ((len + 31) / 32));
+	count = 0;
+	i = 0;
+#ifdef _S_FRUSTUM_SSE
+	/* the plane normals are shared by all boxes, so the p-vertex selection is
+	   made once per plane */
+	for (j = 0; j < 6; ++j)
+	{
+		nx[j] = _mm_set1_ps(frustum->p[j].x);
+		ny[j] = _mm_set1_ps(frustum->p[j].y);
+		nz[j] = _mm_set1_ps(frustum->p[j].z);
+		nw[j] = _mm_set1_ps(frustum->p[j].w);
+		sx[j] = frustum->p[j].x >= 0.0f;
+		sy[j] = frustum->p[j].y >= 0.0f;
+		sz[j] = frustum->p[j].z >= 0.0f;
+	}
+	for (; sizeof(Svec3) == 3 * sizeof(Sfloat) && i + 4 <= len; i += 4)
+	{
+		_S_frustum_load_soa(mins+i, &minx, &miny, &minz);
+		_S_frustum_load_soa(maxs+i, &maxx, &maxy, &maxz);
+		vis = _mm_castsi128_ps(_mm_set1_epi32(-1));
+		for (j = 0; j < 6; ++j)
+		{
+			d = _mm_mul_ps(sx[j] ? maxx : minx, nx[j]);
+			d = _mm_add_ps(d, _mm_mul_ps(sy[j] ? maxy : miny, ny[j]));
+			d = _mm_add_ps(d, _mm_mul_ps(sz[j] ? maxz : minz, nz[j]));
+			d = _mm_add_ps(d, nw[j]);
+			vis = _mm_and_ps(vis, _mm_cmpge_ps(d, _mm_setzero_ps()));
+		}
+		bits = (Suint32) _mm_movemask_ps(vis);
+		if (bits)
+			_S_frustum_cull_output(i, bits, 4, mask, indices, &count);
+	}
+#endif /* _S_FRUSTUM_SSE */
+	for (; i < len; ++i)
+	{
+		bits = 1;
+		for (j = 0; j < 6; ++j)
+		{
+			p = frustum->p+j;
+			dot = p->x * (p->x >= 0.0f ? maxs[i].x : mins[i].x) +
+			      p->y * (p->y >= 0.0f ? maxs[i].y : mins[i].y) +
+			      p->z * (p->z >= 0.0f ? maxs[i].z : mins[i].z);
+			if (dot + p->w < 0.0f)
+			{
+				bits = 0;
+				break;
+			}
+		}
+		if (bits)
+			_S_frustum_cull_output(i, bits, 1, mask, indices, &count);
+	}
+	return count;
+}
+
@@ -0,0 +1,510 @@
+/*
+ * This file is licensed under BSD 3-Clause.
+ * All license information is available in the included COPYING file.
+ */
+
+/*
+ * hierarchy.c
+ * Flat transform hierarchy source.
+ *
+ * Author       : Finn Rayment <finn@rayment.fr>
+ * Date created : 18/10/2026
+ */
+
+#include <string.h>
+
+#include "sticky/common/error.h"
+#include "sticky/math/hierarchy.h"
+#include "sticky/math/mat4.h"
+#include "sticky/math/quat.h"
+#include "sticky/math/vec3.h"
+#include "sticky/memory/allocator.h"
+
+#define _S_HIERARCHY_INITIAL_SIZE 16
+
+Shierarchy *
+S_hierarchy_new(void)
+{
+	Shierarchy *hierarchy;
+	hierarchy = (Shierarchy *) S_memory_new(sizeof(Shierarchy));
+	hierarchy->cap = _S_HIERARCHY_INITIAL_SIZE;
+	hierarchy->hcap = _S_HIERARCHY_INITIAL_SIZE;
+	hierarchy->local = (Stransform *)
+		S_memory_new(sizeof(Stransform) * hierarchy->cap);
+	hierarchy->world = (Smat4 *) S_memory_new(sizeof(Smat4) * hierarchy->cap);
+	hierarchy->parent = (Suint32 *)
+		S_memory_new(sizeof(Suint32) * hierarchy->cap);
+	hierarchy->handle = (Suint32 *)
+		S_memory_new(sizeof(Suint32) * hierarchy->cap);
+	hierarchy->index = (Suint32 *)
+		S_memory_new(sizeof(Suint32) * hierarchy->hcap);
+	hierarchy->levels = (Suint32 *) S_memory_new(sizeof(Suint32));
+	hierarchy->levels[0] = 0;
+	hierarchy->len = 0;
+	hierarchy->hlen = 0;
+	hierarchy->hfree = 0;
+	hierarchy->nlevels = 0;
+	hierarchy->dirty = S_FALSE;
+	return hierarchy;
+}
+
+void
+S_hierarchy_delete(Shierarchy *hierarchy)
+{
+	if (!hierarchy)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_hierarchy_delete");
+		return;
+	}
+	S_memory_delete(hierarchy->local);
+	S_memory_delete(hierarchy->world);
+	S_memory_delete(hierarchy->parent);
+	S_memory_delete(hierarchy->handle);
+	S_memory_delete(hierarchy->index);
+	S_memory_delete(hierarchy->levels);
+	S_memory_delete(hierarchy);
+}
+
+static
+Sbool
+_S_hierarchy_valid(const Shierarchy *hierarchy,
+                   Suint32 node)
+{
+	return node < hierarchy->hlen && hierarchy->index[node] != S_HIERARCHY_NONE;
+}
+
+static
+Suint32
+_S_hierarchy_new_handle(Shierarchy *hierarchy)
+{
+	Suint32 handle;
+	for (handle = hierarchy->hfree; handle < hierarchy->hlen; ++handle)
+	{
+		if (hierarchy->index[handle] == S_HIERARCHY_NONE)
+			break;
+	}
+	if (handle == hierarchy->hlen)
+	{
+		if (hierarchy->hlen == hierarchy->hcap)
+		{
+			hierarchy->hcap *= 2;
+			hierarchy->index = (Suint32 *)
+				S_memory_resize(hierarchy->index,
+				                sizeof(Suint32) * hierarchy->hcap);
+		}
+		++hierarchy->hlen;
+	}
+	hierarchy->hfree = handle + 1;
+	return handle;
+}
+
+Suint32
+S_hierarchy_add(Shierarchy *hierarchy,
+                Suint32 parent)
+{
+	Suint32 handle, idx;
+	Stransform *transform;
+	if (!hierarchy)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_hierarchy_add");
+		return S_HIERARCHY_NONE;
+	}
+	if (parent != S_HIERARCHY_NONE && !_S_hierarchy_valid(hierarchy, parent))
+	{
+		_S_SET_ERROR(S_INVALID_INDEX, "S_hierarchy_add");
+		return S_HIERARCHY_NONE;
+	}
+	if (hierarchy->len == hierarchy->cap)
+	{
+		hierarchy->cap *= 2;
+		hierarchy->local = (Stransform *)
+			S_memory_resize(hierarchy->local,
+			                sizeof(Stransform) * hierarchy->cap);
+		hierarchy->world = (Smat4 *)
+			S_memory_resize(hierarchy->world, sizeof(Smat4) * hierarchy->cap);
+		hierarchy->parent = (Suint32 *)
+			S_memory_resize(hierarchy->parent,
+			                sizeof(Suint32) * hierarchy->cap);
+		hierarchy->handle = (Suint32 *)
+			S_memory_resize(hierarchy->handle,
+			                sizeof(Suint32) * hierarchy->cap);
+	}
+	handle = _S_hierarchy_new_handle(hierarchy);
+	/* nodes are appended unsorted and sorted by depth on the next update */
+	idx = hierarchy->len++;
+	transform = &(hierarchy->local[idx]);
+	_S_CALL("S_vec3_zero", S_vec3_zero(&(transform->pos)));
+	_S_CALL("S_vec3_fill", S_vec3_fill(&(transform->scale), 1.0f));
+	_S_CALL("S_quat_identity", S_quat_identity(&(transform->rot)));
+	transform->parent = NULL;
+	transform->children = NULL;
+	_S_CALL("S_mat4_identity", S_mat4_identity(&(hierarchy->world[idx])));
+	hierarchy->parent[idx] = parent == S_HIERARCHY_NONE ?
+	                         S_HIERARCHY_NONE : hierarchy->index[parent];
+	hierarchy->handle[idx] = handle;
+	hierarchy->index[handle] = idx;
+	hierarchy->dirty = S_TRUE;
+	return handle;
+}
+
+Suint32
+S_hierarchy_add_tree(Shierarchy *hierarchy,
+                     const Stransform *transform,
+                     Suint32 parent)
+{
+	Suint32 handle, idx;
+	Stransform *local, *child;
+	Slinkedlist_iter *iter;
+	Sbool b;
+	if (!hierarchy || !transform)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_hierarchy_add_tree");
+		return S_HIERARCHY_NONE;
+	}
+	_S_CALL("S_hierarchy_add", handle = S_hierarchy_add(hierarchy, parent));
+	if (handle == S_HIERARCHY_NONE)
+		return S_HIERARCHY_NONE;
+	idx = hierarchy->index[handle];
+	local = &(hierarchy->local[idx]);
+	_S_CALL("S_vec3_copy", S_vec3_copy(&(local->pos), &(transform->pos)));
+	_S_CALL("S_vec3_copy", S_vec3_copy(&(local->scale), &(transform->scale)));
+	_S_CALL("S_quat_copy", S_quat_copy(&(local->rot), &(transform->rot)));
+	if (!transform->children)
+		return handle;
+	_S_CALL("S_linkedlist_iter_begin",
+	        iter = S_linkedlist_iter_begin(transform->children));
+	while (1)
+	{
+		_S_CALL("S_linkedlist_iter_hasnext",
+		        b = S_linkedlist_iter_hasnext(iter));
+		if (!b)
+			break;
+		_S_CALL("S_linkedlist_iter_next",
+		        child = (Stransform *) S_linkedlist_iter_next(&iter));
+		_S_CALL("S_hierarchy_add_tree",
+		        S_hierarchy_add_tree(hierarchy, child, handle));
+	}
+	return handle;
+}
+
+void
+S_hierarchy_remove(Shierarchy *hierarchy,
+                   Suint32 node)
+{
+	Suint32 idx, last, i;
+	if (!hierarchy)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_hierarchy_remove");
+		return;
+	}
+	if (!_S_hierarchy_valid(hierarchy, node))
+	{
+		_S_SET_ERROR(S_INVALID_INDEX, "S_hierarchy_remove");
+		return;
+	}
+	idx = hierarchy->index[node];
+	last = hierarchy->len - 1;
+	/* children are inherited by the parent of the removed node */
+	for (i = 0; i < hierarchy->len; ++i)
+	{
+		if (hierarchy->parent[i] == idx)
+			hierarchy->parent[i] = hierarchy->parent[idx];
+	}
+	/* move the last node into the free index */
+	if (idx != last)
+	{
+		memcpy(&(hierarchy->local[idx]), &(hierarchy->local[last]),
+		       sizeof(Stransform));
+		memcpy(&(hierarchy->world[idx]), &(hierarchy->world[last]),
+		       sizeof(Smat4));
+		hierarchy->parent[idx] = hierarchy->parent[last];
+		hierarchy->handle[idx] = hierarchy->handle[last];
+		hierarchy->index[hierarchy->handle[idx]] = idx;
+		for (i = 0; i < last; ++i)
+		{
+			if (hierarchy->parent[i] == last)
+				hierarchy->parent[i] = idx;
+		}
+	}
+	hierarchy->index[node] = S_HIERARCHY_NONE;
+	if (node < hierarchy->hfree)
+		hierarchy->hfree = node;
+	--hierarchy->len;
+	hierarchy->dirty = S_TRUE;
+}
+
+void
+S_hierarchy_set_parent(Shierarchy *hierarchy,
+                       Suint32 node,
+                       Suint32 parent)
+{
+	Suint32 idx, pidx, current;
+	if (!hierarchy || node == parent)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_hierarchy_set_parent");
+		return;
+	}
+	if (!_S_hierarchy_valid(hierarchy, node) ||
+	    (parent != S_HIERARCHY_NONE && !_S_hierarchy_valid(hierarchy, parent)))
+	{
+		_S_SET_ERROR(S_INVALID_INDEX, "S_hierarchy_set_parent");
+		return;
+	}
+	idx = hierarchy->index[node];
+	pidx = parent == S_HIERARCHY_NONE ?
+	       S_HIERARCHY_NONE : hierarchy->index[parent];
+	if (hierarchy->parent[idx] == pidx)
+		return;
+	/* if the new parent descends from this node, detach the direct child of
+	   this node from which it originates */
+	current = pidx;
+	while (current != S_HIERARCHY_NONE)
+	{
+		if (hierarchy->parent[current] == idx)
+		{
+			hierarchy->parent[current] = S_HIERARCHY_NONE;
+			break;
+		}
+		current = hierarchy->parent[current];
+	}
+	hierarchy->parent[idx] = pidx;
+	hierarchy->dirty = S_TRUE;
+}
+
+Suint32
+S_hierarchy_get_parent(const Shierarchy *hierarchy,
+                       Suint32 node)
+{
+	Suint32 pidx;
+	if (!hierarchy)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_hierarchy_get_parent");
+		return S_HIERARCHY_NONE;
+	}
+	if (!_S_hierarchy_valid(hierarchy, node))
+	{
+		_S_SET_ERROR(S_INVALID_INDEX, "S_hierarchy_get_parent");
+		return S_HIERARCHY_NONE;
+	}
+	pidx = hierarchy->parent[hierarchy->index[node]];
+	return pidx == S_HIERARCHY_NONE ? S_HIERARCHY_NONE : hierarchy->handle[pidx];
+}
+
+Suint32
+S_hierarchy_size(const Shierarchy *hierarchy)
+{
+	if (!hierarchy)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_hierarchy_size");
+		return 0;
+	}
+	return hierarchy->len;
+}
+
+Stransform *
+S_hierarchy_get_transform(Shierarchy *hierarchy,
+                          Suint32 node)
+{
+	if (!hierarchy)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_hierarchy_get_transform");
+		return NULL;
+	}
+	if (!_S_hierarchy_valid(hierarchy, node))
+	{
+		_S_SET_ERROR(S_INVALID_INDEX, "S_hierarchy_get_transform");
+		return NULL;
+	}
+	return &(hierarchy->local[hierarchy->index[node]]);
+}
+
+/* stable counting sort of all nodes by depth, such that every parent precedes
+   its children and each depth level is contiguous */
+static
+void
+_S_hierarchy_sort(Shierarchy *hierarchy)
+{
+	Suint32 *depth, *remap, *counts, *parent, *handle;
+	Stransform *local;
+	Suint32 i, d, p, maxdepth, len;
+
+	len = hierarchy->len;
+	depth = (Suint32 *) S_memory_new(sizeof(Suint32) * (len + 1));
+	remap = (Suint32 *) S_memory_new(sizeof(Suint32) * (len + 1));
+	maxdepth = 0;
+	for (i = 0; i < len; ++i)
+	{
+		d = 0;
+		p = hierarchy->parent[i];
+		while (p != S_HIERARCHY_NONE)
+		{
+			++d;
+			p = hierarchy->parent[p];
+		}
+		depth[i] = d;
+		if (d > maxdepth)
+			maxdepth = d;
+	}
+	counts = (Suint32 *) S_memory_new(sizeof(Suint32) * (maxdepth + 2));
+	memset(counts, 0, sizeof(Suint32) * (maxdepth + 2));
+	for (i = 0; i < len; ++i)
+		++counts[depth[i] + 1];
+	for (d = 1; d < maxdepth + 2; ++d)
+		counts[d] += counts[d - 1];
+	/* counts now holds the start offset of each level */
+	S_memory_delete(hierarchy->levels);
+	hierarchy->nlevels = len ? maxdepth + 1 : 0;
+	hierarchy->levels = (Suint32 *)
+		S_memory_new(sizeof(Suint32) * (maxdepth + 2));
+	memcpy(hierarchy->levels, counts, sizeof(Suint32) * (maxdepth + 2));
+	for (i = 0; i < len; ++i)
+		remap[i] = counts[depth[i]]++;
+
+	local = (Stransform *) S_memory_new(sizeof(Stransform) * hierarchy->cap);
+	parent = (Suint32 *) S_memory_new(sizeof(Suint32) * hierarchy->cap);
+	handle = (Suint32 *) S_memory_new(sizeof(Suint32) * hierarchy->cap);
+	for (i = 0; i < len; ++i)
+	{
+		memcpy(&(local[remap[i]]), &(hierarchy->local[i]), sizeof(Stransform));
+		p = hierarchy->parent[i];
+		parent[remap[i]] = p == S_HIERARCHY_NONE ? S_HIERARCHY_NONE : remap[p];
+		handle[remap[i]] = hierarchy->handle[i];
+		hierarchy->index[hierarchy->handle[i]] = remap[i];
+	}
+	S_memory_delete(hierarchy->local);
+	S_memory_delete(hierarchy->parent);
+	S_memory_delete(hierarchy->handle);
+	hierarchy->local = local;
+	hierarchy->parent = parent;
+	hierarchy->handle = handle;
+
+	S_memory_delete(counts);
+	S_memory_delete(remap);
+	S_memory_delete(depth);
+	hierarchy->dirty = S_FALSE;
+}
+
+/* equivalent to S_transform_get_transformation_matrix without the two full
+   matrix multiplications */
+static
+void
+_S_hierarchy_compose(Smat4 *dest,
+                     const Stransform *transform)
+{
+	const Squat *q;
+	const Svec3 *s;
+	q = &(transform->rot);
+	s = &(transform->scale);
+	dest->m00 = (1.0f - 2.0f*q->j*q->j - 2.0f*q->k*q->k) * s->x;
+	dest->m10 = (2.0f*q->i*q->j + 2.0f*q->r*q->k) * s->x;
+	dest->m20 = (2.0f*q->i*q->k - 2.0f*q->r*q->j) * s->x;
+	dest->m30 = 0.0f;
+	dest->m01 = (2.0f*q->i*q->j - 2.0f*q->r*q->k) * s->y;
+	dest->m11 = (1.0f - 2.0f*q->i*q->i - 2.0f*q->k*q->k) * s->y;
+	dest->m21 = (2.0f*q->j*q->k + 2.0f*q->r*q->i) * s->y;
+	dest->m31 = 0.0f;
+	dest->m02 = (2.0f*q->i*q->k + 2.0f*q->r*q->j) * s->z;
+	dest->m12 = (2.0f*q->j*q->k - 2.0f*q->r*q->i) * s->z;
+	dest->m22 = (1.0f - 2.0f*q->i*q->i - 2.0f*q->j*q->j) * s->z;
+	dest->m32 = 0.0f;
+	dest->m03 = transform->pos.x;
+	dest->m13 = transform->pos.y;
+	dest->m23 = transform->pos.z;
+	dest->m33 = 1.0f;
+}
+
+/* dest = parent * local, where the bottom row of local is known to be
+   (0, 0, 0, 1); kept free of library calls so that it is safe to run from
+   several threads when call tracing is enabled */
+static
+void
+_S_hierarchy_multiply(Smat4 *dest,
+                      const Smat4 *a,
+                      const Smat4 *b)
+{
+	dest->m00 = a->m00*b->m00 + a->m01*b->m10 + a->m02*b->m20;
+	dest->m01 = a->m00*b->m01 + a->m01*b->m11 + a->m02*b->m21;
+	dest->m02 = a->m00*b->m02 + a->m01*b->m12 + a->m02*b->m22;
+	dest->m03 = a->m00*b->m03 + a->m01*b->m13 + a->m02*b->m23 + a->m03;
+	dest->m10 = a->m10*b->m00 + a->m11*b->m10 + a->m12*b->m20;
+	dest->m11 = a->m10*b->m01 + a->m11*b->m11 + a->m12*b->m21;
+	dest->m12 = a->m10*b->m02 + a->m11*b->m12 + a->m12*b->m22;
+	dest->m13 = a->m10*b->m03 + a->m11*b->m13 + a->m12*b->m23 + a->m13;
+	dest->m20 = a->m20*b->m00 + a->m21*b->m10 + a->m22*b->m20;
+	dest->m21 = a->m20*b->m01 + a->m21*b->m11 + a->m22*b->m21;
+	dest->m22 = a->m20*b->m02 + a->m21*b->m12 + a->m22*b->m22;
+	dest->m23 = a->m20*b->m03 + a->m21*b->m13 + a->m22*b->m23 + a->m23;
+	dest->m30 = a->m30*b->m00 + a->m31*b->m10 + a->m32*b->m20;
+	dest->m31 = a->m30*b->m01 + a->m31*b->m11 + a->m32*b->m21;
+	dest->m32 = a->m30*b->m02 + a->m31*b->m12 + a->m32*b->m22;
+	dest->m33 = a->m30*b->m03 + a->m31*b->m13 + a->m32*b->m23 + a->m33;
+}
+
+void
+S_hierarchy_update(Shierarchy *hierarchy)
+{
+	Suint32 level;
+	Sint64 i, begin, end;
+	Smat4 local;
+	if (!hierarchy)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_hierarchy_update");
+		return;
+	}
+	if (hierarchy->dirty)
+	{
+		_S_CALL("_S_hierarchy_sort", _S_hierarchy_sort(hierarchy));
+	}
+	/* root nodes have nothing to multiply with */
+	if (hierarchy->nlevels > 0)
+	{
+		end = (Sint64) hierarchy->levels[1];
+#ifdef ENABLE_OPENMP
+#pragma omp parallel for
+#endif /* ENABLE_OPENMP */
+		for (i = 0; i < end; ++i)
+			_S_hierarchy_compose(&(hierarchy->world[i]), &(hierarchy->local[i]));
+	}
+	/* each level only depends on the level before it, so all nodes within a
+	   level may be computed in parallel */
+	for (level = 1; level < hierarchy->nlevels; ++level)
+	{
+		begin = (Sint64) hierarchy->levels[level];
+		end = (Sint64) hierarchy->levels[level + 1];
+#ifdef ENABLE_OPENMP
+#pragma omp parallel for private(local)
+#endif /* ENABLE_OPENMP */
+		for (i = begin; i < end; ++i)
+		{
+			_S_hierarchy_compose(&local, &(hierarchy->local[i]));
+			_S_hierarchy_multiply(&(hierarchy->world[i]),
+			                      &(hierarchy->world[hierarchy->parent[i]]),
+			                      &local);
+		}
+	}
+}
+
+void
+S_hierarchy_get_world_matrix(const Shierarchy *hierarchy,
+                             Suint32 node,
+                             Smat4 *dest)
+{
+	if (!hierarchy || !dest)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_hierarchy_get_world_matrix");
+		return;
+	}
+	if (!_S_hierarchy_valid(hierarchy, node))
+	{
+		_S_SET_ERROR(S_INVALID_INDEX, "S_hierarchy_get_world_matrix");
+		return;
+	}
+	if (hierarchy->dirty)
+	{
+		_S_SET_ERROR(S_INVALID_OPERATION, "S_hierarchy_get_world_matrix");
+		return;
+	}
+	_S_CALL("S_mat4_copy",
+	        S_mat4_copy(dest, &(hierarchy->world[hierarchy->index[node]])));
+}
+
@@ -15,6 +15,7 @@
 
 #include "sticky/common/error.h"
 #include "sticky/common/types.h"
+#include "sticky/math/fastmath.h"
 #include "sticky/math/math.h"
 #include "sticky/math/mat4.h"
 #include "sticky/memory/memtrace.h"
@@ -227,10 +228,12 @@ S_mat4_perspective(Smat4 *dest,
 		_S_SET_ERROR(S_INVALID_VALUE, "S_mat4_perspective");
 		return;
 	}
-	f = S_tan(S_radians(fovy) / 2.0f);
+	/* cotangent of half the field of view */
+	f = S_radians(fovy) / 2.0f;
+	f = _S_COS(f) / _S_SIN(f);
 	_S_CALL("S_mat4_identity", S_mat4_identity(dest));
-	dest->m00 = 1.0f / (aspect*f);
-	dest->m11 = 1.0f / f;
+	dest->m00 = f / aspect;
+	dest->m11 = f;
 	dest->m22 = -(zfar+znear) / (zfar-znear);
 	dest->m23 = -(2.0f*zfar*znear) / (zfar-znear);
 	dest->m32 = -1.0f;
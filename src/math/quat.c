@@ -13,6 +13,7 @@
 
 #include "sticky/common/error.h"
 #include "sticky/common/types.h"
+#include "sticky/math/fastmath.h"
 #include "sticky/math/math.h"
 #include "sticky/math/quat.h"
 #include "sticky/math/vec3.h"
@@ -84,11 +85,11 @@ S_quat_normalize(Squat *quat)
 		return;
 	}
 	_S_CALL("S_quat_dot", norm = S_quat_dot(quat, quat));
-	norm = S_sqrt(norm);
-	quat->r /= norm;
-	quat->i /= norm;
-	quat->j /= norm;
-	quat->k /= norm;
+	norm = _S_RSQRT(norm);
+	quat->r *= norm;
+	quat->i *= norm;
+	quat->j *= norm;
+	quat->k *= norm;
 }
 
 void
@@ -143,12 +144,12 @@ S_quat_slerp(Squat *dest,
 	}
 	time = S_clamp(time, 0.0f, 1.0f);
 	_S_CALL("S_quat_dot", theta = S_quat_dot(src, dest));
-	theta = S_arccos(theta);
+	theta = _S_ARCCOS(theta);
 	if (theta < 0.0)
 		theta = -theta;
-	stheta = S_sin(theta);
-	a = S_sin((1.0f-time)*theta) / stheta;
-	b = S_sin(time*theta) / stheta;
+	stheta = _S_SIN(theta);
+	a = _S_SIN((1.0f-time)*theta) / stheta;
+	b = _S_SIN(time*theta) / stheta;
 	dest->r = dest->r*b + src->r*a;
 	dest->i = dest->i*b + src->i*a;
 	dest->j = dest->j*b + src->j*a;
@@ -169,7 +170,7 @@ S_quat_angle(Squat *dest,
 	_S_CALL("S_quat_copy", S_quat_copy(&inverse, src));
 	_S_CALL("S_quat_inverse", S_quat_inverse(&inverse));
 	_S_CALL("S_quat_multiply", S_quat_multiply(dest, &inverse));
-	return S_degrees(2.0f * S_arccos(dest->r));
+	return S_degrees(2.0f * _S_ARCCOS(dest->r));
 }
 
 void
@@ -183,8 +184,8 @@ S_quat_angleaxis(Squat *dest,
 		_S_SET_ERROR(S_INVALID_VALUE, "S_quat_angleaxis");
 		return;
 	}
-	s = S_sin(S_radians(angle / 2.0f));
-	c = S_cos(S_radians(angle / 2.0f));
+	s = _S_SIN(S_radians(angle / 2.0f));
+	c = _S_COS(S_radians(angle / 2.0f));
 	dest->i = axis->x * s;
 	dest->j = axis->y * s;
 	dest->k = axis->z * s;
@@ -224,7 +225,7 @@ S_quat_lookpoint(Squat *dest,
 		return;
 	}
 	/* build rotation */
-	rotangle = S_degrees(S_arccos(dot));
+	rotangle = S_degrees(_S_ARCCOS(dot));
 	_S_CALL("S_vec3_cross", S_vec3_cross(&forward, &world_forward));
 	_S_CALL("S_vec3_normalize", S_vec3_normalize(&forward));
 	_S_CALL("S_quat_angleaxis", S_quat_angleaxis(dest, &forward, rotangle));
@@ -323,14 +324,14 @@ S_quat_to_vec3(Svec3 *dest,
 	{
 		/* north-pole gimbal lock */
 		dest->x = 0.0f;
-		dest->y = S_degrees(2.0f * S_arctan2(src->i, src->r));
+		dest->y = S_degrees(2.0f * _S_ARCTAN2(src->i, src->r));
 		dest->z = 90.0f;
 	}
 	else if (S_epsilon(S_EPSILON, lock, -0.5f))
 	{
 		/* south-pole gimbal lock */
 		dest->x = 0.0f;
-		dest->y = S_degrees(-2.0f * S_arctan2(src->i, src->r));
+		dest->y = S_degrees(-2.0f * _S_ARCTAN2(src->i, src->r));
 		dest->z = -90.0f;
 	}
 	else
@@ -339,12 +340,12 @@ S_quat_to_vec3(Svec3 *dest,
 		dest->x = S_degrees(S_arcsin(
 			2.0f * (src->r*src->i - src->j*src->k)
 		));
-		dest->y = S_degrees(S_arctan2(
+		dest->y = S_degrees(_S_ARCTAN2(
 			(2.0f * (src->r*src->j + src->k*src->i))
 				,
 			(1.0f - (2.0f * (src->i*src->i + src->j*src->j)))
 		));
-		dest->z = S_degrees(S_arctan2(
+		dest->z = S_degrees(_S_ARCTAN2(
 			(2.0f * (src->r*src->k + src->i*src->j))
 				,
 			(1.0f - (2.0f * (src->k*src->k + src->i*src->i)))
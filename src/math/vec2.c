@@ -13,6 +13,7 @@
 
 #include "sticky/common/error.h"
 #include "sticky/common/types.h"
+#include "sticky/math/fastmath.h"
 #include "sticky/math/math.h"
 #include "sticky/math/vec2.h"
 
@@ -132,16 +133,16 @@ S_vec2_distance(const Svec2 *a,
 void
 S_vec2_normalize(Svec2 *vec)
 {
-	Sfloat sqrtdot;
+	Sfloat invlen;
 	if (!vec)
 	{
 		_S_SET_ERROR(S_INVALID_VALUE, "S_vec2_normalize");
 		return;
 	}
-	_S_CALL("S_vec2_dot", sqrtdot = S_vec2_dot(vec, vec));
-	sqrtdot = S_sqrt(sqrtdot);
-	vec->x /= sqrtdot;
-	vec->y /= sqrtdot;
+	_S_CALL("S_vec2_dot", invlen = S_vec2_dot(vec, vec));
+	invlen = _S_RSQRT(invlen);
+	vec->x *= invlen;
+	vec->y *= invlen;
 }
 
 void
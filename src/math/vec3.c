@@ -13,6 +13,7 @@
 
 #include "sticky/common/error.h"
 #include "sticky/common/types.h"
+#include "sticky/math/fastmath.h"
 #include "sticky/math/math.h"
 #include "sticky/math/vec3.h"
 
@@ -188,17 +189,17 @@ S_vec3_cross(Svec3 *dest,
 void
 S_vec3_normalize(Svec3 *vec)
 {
-	Sfloat sqrtdot;
+	Sfloat invlen;
 	if (!vec)
 	{
 		_S_SET_ERROR(S_INVALID_VALUE, "S_vec3_normalize");
 		return;
 	}
-	_S_CALL("S_vec3_dot", sqrtdot = S_vec3_dot(vec, vec));
-	sqrtdot = S_sqrt(sqrtdot);
-	vec->x /= sqrtdot;
-	vec->y /= sqrtdot;
-	vec->z /= sqrtdot;
+	_S_CALL("S_vec3_dot", invlen = S_vec3_dot(vec, vec));
+	invlen = _S_RSQRT(invlen);
+	vec->x *= invlen;
+	vec->y *= invlen;
+	vec->z *= invlen;
 }
 
 void
@@ -291,12 +292,12 @@ S_vec3_to_quat(Squat *dest,
 		_S_SET_ERROR(S_INVALID_VALUE, "S_vec3_to_quat");
 		return;
 	}
-	cx = S_cos(S_radians(src->x) * 0.5f);
-	sx = S_sin(S_radians(src->x) * 0.5f);
-	cy = S_cos(S_radians(src->y) * 0.5f);
-	sy = S_sin(S_radians(src->y) * 0.5f);
-	cz = S_cos(S_radians(src->z) * 0.5f);
-	sz = S_sin(S_radians(src->z) * 0.5f);
+	cx = _S_COS(S_radians(src->x) * 0.5f);
+	sx = _S_SIN(S_radians(src->x) * 0.5f);
+	cy = _S_COS(S_radians(src->y) * 0.5f);
+	sy = _S_SIN(S_radians(src->y) * 0.5f);
+	cz = _S_COS(S_radians(src->z) * 0.5f);
+	sz = _S_SIN(S_radians(src->z) * 0.5f);
 	dest->r = cz*cx*cy + sz*sx*sy;
 	dest->i = cz*sx*cy + sz*cx*sy;
 	dest->j = cz*cx*sy - sz*sx*cy;
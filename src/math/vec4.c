@@ -13,6 +13,7 @@
 
 #include "sticky/common/error.h"
 #include "sticky/common/types.h"
+#include "sticky/math/fastmath.h"
 #include "sticky/math/math.h"
 #include "sticky/math/vec4.h"
 
@@ -150,18 +151,18 @@ S_vec4_distance(const Svec4 *a,
 void
 S_vec4_normalize(Svec4 *vec)
 {
-	Sfloat sqrtdot;
+	Sfloat invlen;
 	if (!vec)
 	{
 		_S_SET_ERROR(S_INVALID_VALUE, "S_vec4_normalize");
 		return;
 	}
-	_S_CALL("S_vec4_dot", sqrtdot = S_vec4_dot(vec, vec));
-	sqrtdot = S_sqrt(sqrtdot);
-	vec->x /= sqrtdot;
-	vec->y /= sqrtdot;
-	vec->z /= sqrtdot;
-	vec->w /= sqrtdot;
+	_S_CALL("S_vec4_dot", invlen = S_vec4_dot(vec, vec));
+	invlen = _S_RSQRT(invlen);
+	vec->x *= invlen;
+	vec->y *= invlen;
+	vec->z *= invlen;
+	vec->w *= invlen;
 }
 
 void
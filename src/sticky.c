@@ -46,6 +46,7 @@ S_sticky_free(void)
 		SDL_Quit();
 		_S_CALL("_S_sound_free", _S_sound_free());
 	}
+	_S_CALL("_S_shader_free", _S_shader_free());
 	_S_CALL("_S_socket_free", _S_socket_free());
 #ifdef DEBUG
 	_S_memtrace_free();
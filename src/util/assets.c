@@ -0,0 +1,412 @@
+/*
+ * This file is licensed under BSD 3-Clause.
+ * All license information is available in the included COPYING file.
+ */
+
+/*
+ * assets.c
+ * Reference-counted asset cache source.
+ *
+ * Author       : Finn Rayment <finn@rayment.fr>
+ * Date created : 18/10/2026
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "sticky/common/error.h"
+#include "sticky/common/types.h"
+#include "sticky/memory/allocator.h"
+#include "sticky/util/assets.h"
+#include "sticky/util/hash.h"
+
+#define ASSETS_INITIAL_CAPACITY 16
+
+static
+Suint32
+_S_assets_hash_pointer(const void *ptr)
+{
+	return S_hash_fnv1a(&ptr, sizeof(ptr));
+}
+
+static
+void
+_S_assets_rehash(Sassets *assets)
+{
+	_Sasset **keys, **data;
+	_Sasset *asset, *next;
+	Ssize_t cap, i, idx;
+	cap = assets->cap * 2;
+	keys = (_Sasset **) S_memory_new(cap * sizeof(_Sasset *));
+	data = (_Sasset **) S_memory_new(cap * sizeof(_Sasset *));
+	memset(keys, 0, cap * sizeof(_Sasset *));
+	memset(data, 0, cap * sizeof(_Sasset *));
+	for (i = 0; i < assets->cap; ++i)
+	{
+		for (asset = assets->keys[i]; asset; asset = next)
+		{
+			next = asset->next_key;
+			idx = asset->hash % cap;
+			asset->next_key = keys[idx];
+			keys[idx] = asset;
+		}
+		for (asset = assets->data[i]; asset; asset = next)
+		{
+			next = asset->next_data;
+			idx = _S_assets_hash_pointer(asset->data) % cap;
+			asset->next_data = data[idx];
+			data[idx] = asset;
+		}
+	}
+	S_memory_delete(assets->keys);
+	S_memory_delete(assets->data);
+	assets->keys = keys;
+	assets->data = data;
+	assets->cap = cap;
+}
+
+static
+_Sasset *
+_S_assets_find(const Sassets *assets,
+               Senum type,
+               const Schar *key,
+               Suint32 hash)
+{
+	_Sasset *asset;
+	for (asset = assets->keys[hash % assets->cap]; asset;
+	     asset = asset->next_key)
+	{
+		if (asset->hash == hash && asset->type == type &&
+		    strcmp(asset->key, key) == 0)
+			return asset;
+	}
+	return NULL;
+}
+
+_Sasset *
+_S_assets_find_data(const Sassets *assets,
+                    const void *data)
+{
+	_Sasset *asset;
+	Ssize_t idx;
+	idx = _S_assets_hash_pointer(data) % assets->cap;
+	for (asset = assets->data[idx]; asset; asset = asset->next_data)
+	{
+		if (asset->data == data)
+			return asset;
+	}
+	return NULL;
+}
+
+/* look up a key, taking a reference to the asset if it is already held */
+void *
+_S_assets_acquire(Sassets *assets,
+                  Senum type,
+                  const Schar *key)
+{
+	_Sasset *asset;
+	asset = _S_assets_find(assets, type, key, S_hash_fnv1a_string(key));
+	if (!asset)
+		return NULL;
+	++asset->refs;
+	return asset->data;
+}
+
+void
+_S_assets_insert(Sassets *assets,
+                 Senum type,
+                 const Schar *key,
+                 void *data,
+                 Ssize_t size)
+{
+	_Sasset *asset;
+	Ssize_t idx, len;
+	if (assets->len + 1 > assets->cap * 3 / 4)
+		_S_assets_rehash(assets);
+	len = strlen(key);
+	asset = (_Sasset *) S_memory_new(sizeof(_Sasset));
+	asset->key = (Schar *) S_memory_new(len + 1);
+	memcpy(asset->key, key, len + 1);
+	asset->data = data;
+	asset->size = size;
+	asset->hash = S_hash_fnv1a_string(key);
+	asset->refs = 1;
+	asset->type = type;
+	idx = asset->hash % assets->cap;
+	asset->next_key = assets->keys[idx];
+	assets->keys[idx] = asset;
+	idx = _S_assets_hash_pointer(data) % assets->cap;
+	asset->next_data = assets->data[idx];
+	assets->data[idx] = asset;
+	++assets->len;
+	++assets->counts[type];
+	assets->memory[type] += size;
+}
+
+/* give back a reference to an asset, unlinking it from the cache and returning
+   S_TRUE once the last reference is given back */
+Sbool
+_S_assets_unref(Sassets *assets,
+                _Sasset *asset)
+{
+	_Sasset **link;
+	if (--asset->refs > 0)
+		return S_FALSE;
+	link = &assets->keys[asset->hash % assets->cap];
+	while (*link != asset)
+		link = &(*link)->next_key;
+	*link = asset->next_key;
+	link = &assets->data[_S_assets_hash_pointer(asset->data) % assets->cap];
+	while (*link != asset)
+		link = &(*link)->next_data;
+	*link = asset->next_data;
+	--assets->len;
+	--assets->counts[asset->type];
+	assets->memory[asset->type] -= asset->size;
+	return S_TRUE;
+}
+
+static
+void
+_S_assets_free(_Sasset *asset)
+{
+	switch (asset->type)
+	{
+	case S_ASSET_TEXTURE:
+		_S_CALL("S_texture_delete",
+		        S_texture_delete((Stexture *) asset->data));
+		break;
+	case S_ASSET_SHADER:
+		_S_CALL("S_shader_delete",
+		        S_shader_delete((Sshader *) asset->data));
+		break;
+	case S_ASSET_FONT:
+		_S_CALL("S_font_delete", S_font_delete((Sfont *) asset->data));
+		break;
+	case S_ASSET_SOUND:
+		_S_CALL("S_sound_delete", S_sound_delete((Ssound *) asset->data));
+		break;
+	}
+	S_memory_delete(asset->key);
+	S_memory_delete(asset);
+}
+
+Sassets *
+S_assets_new(void)
+{
+	Sassets *assets;
+	assets = (Sassets *) S_memory_new(sizeof(Sassets));
+	memset(assets, 0, sizeof(Sassets));
+	assets->cap = ASSETS_INITIAL_CAPACITY;
+	assets->keys = (_Sasset **) S_memory_new(assets->cap * sizeof(_Sasset *));
+	assets->data = (_Sasset **) S_memory_new(assets->cap * sizeof(_Sasset *));
+	memset(assets->keys, 0, assets->cap * sizeof(_Sasset *));
+	memset(assets->data, 0, assets->cap * sizeof(_Sasset *));
+	return assets;
+}
+
+void
+S_assets_delete(Sassets *assets)
+{
+	_Sasset *asset, *next;
+	Ssize_t i;
+	if (!assets)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_assets_delete");
+		return;
+	}
+	for (i = 0; i < assets->cap; ++i)
+	{
+		for (asset = assets->keys[i]; asset; asset = next)
+		{
+			next = asset->next_key;
+			_S_assets_free(asset);
+		}
+	}
+	S_memory_delete(assets->keys);
+	S_memory_delete(assets->data);
+	S_memory_delete(assets);
+}
+
+Stexture *
+S_assets_load_texture(Sassets *assets,
+                      const Schar *filename)
+{
+	Stexture *tex;
+	if (!assets || !filename)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_assets_load_texture");
+		return NULL;
+	}
+	tex = (Stexture *) _S_assets_acquire(assets, S_ASSET_TEXTURE, filename);
+	if (tex)
+		return tex;
+	_S_CALL("S_texture_load", tex = S_texture_load(filename));
+	if (!tex)
+		return NULL;
+	_S_assets_insert(assets, S_ASSET_TEXTURE, filename, tex, tex->size);
+	return tex;
+}
+
+Sshader *
+S_assets_load_shader(Sassets *assets,
+                     const Schar *vert_filename,
+                     const Schar *frag_filename)
+{
+	Sshader *shader;
+	Schar *key;
+	Ssize_t vlen, flen;
+	if (!assets || !vert_filename || !frag_filename)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_assets_load_shader");
+		return NULL;
+	}
+	/* the pair of paths separated by a newline */
+	vlen = strlen(vert_filename);
+	flen = strlen(frag_filename);
+	key = (Schar *) S_memory_new(vlen + flen + 2);
+	memcpy(key, vert_filename, vlen);
+	key[vlen] = '\n';
+	memcpy(key + vlen + 1, frag_filename, flen + 1);
+	shader = (Sshader *) _S_assets_acquire(assets, S_ASSET_SHADER, key);
+	if (!shader)
+	{
+		_S_CALL("S_shader_load",
+		        shader = S_shader_load(vert_filename, frag_filename));
+		if (shader)
+			_S_assets_insert(assets, S_ASSET_SHADER, key, shader, 0);
+	}
+	S_memory_delete(key);
+	return shader;
+}
+
+Sfont *
+S_assets_load_font(Sassets *assets,
+                   const Schar *filename,
+                   Sfloat pixel_size,
+                   Sbool sdf)
+{
+	Sfont *font;
+	Schar *key;
+	Ssize_t len;
+	if (!assets || !filename || pixel_size <= 0.0f)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_assets_load_font");
+		return NULL;
+	}
+	/* room for the path, the exact size in hexadecimal and the kind */
+	len = strlen(filename);
+	key = (Schar *) S_memory_new(len + 32);
+	sprintf(key, "%s\n%a\n%d", filename, (double) pixel_size, sdf ? 1 : 0);
+	font = (Sfont *) _S_assets_acquire(assets, S_ASSET_FONT, key);
+	if (!font)
+	{
+		if (sdf)
+		{
+			_S_CALL("S_font_load_sdf",
+			        font = S_font_load_sdf(filename, pixel_size));
+		}
+		else
+		{
+			_S_CALL("S_font_load", font = S_font_load(filename, pixel_size));
+		}
+		/* the pages of a font are single-channel */
+		if (font)
+		{
+			_S_assets_insert(assets, S_ASSET_FONT, key, font,
+			                 (Ssize_t) S_FONT_PAGES * S_FONT_PAGE_SIZE *
+			                 S_FONT_PAGE_SIZE);
+		}
+	}
+	S_memory_delete(key);
+	return font;
+}
+
+Ssound *
+S_assets_load_sound(Sassets *assets,
+                    const Schar *filename)
+{
+	Ssound *sound;
+	if (!assets || !filename)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_assets_load_sound");
+		return NULL;
+	}
+	sound = (Ssound *) _S_assets_acquire(assets, S_ASSET_SOUND, filename);
+	if (sound)
+		return sound;
+	_S_CALL("S_sound_load_wav", sound = S_sound_load_wav(filename));
+	if (!sound)
+		return NULL;
+	_S_assets_insert(assets, S_ASSET_SOUND, filename, sound, sound->size);
+	return sound;
+}
+
+void
+S_assets_release(Sassets *assets,
+                 const void *data)
+{
+	_Sasset *asset;
+	if (!assets || !data)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_assets_release");
+		return;
+	}
+	asset = _S_assets_find_data(assets, data);
+	if (!asset)
+	{
+		_S_SET_ERROR(S_INVALID_INDEX, "S_assets_release");
+		return;
+	}
+	if (_S_assets_unref(assets, asset))
+		_S_assets_free(asset);
+}
+
+Suint32
+S_assets_get_refs(const Sassets *assets,
+                  const void *data)
+{
+	_Sasset *asset;
+	if (!assets || !data)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_assets_get_refs");
+		return 0;
+	}
+	asset = _S_assets_find_data(assets, data);
+	return asset ? asset->refs : 0;
+}
+
+Suint32
+S_assets_get_count(const Sassets *assets,
+                   Senum type)
+{
+	if (!assets)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_assets_get_count");
+		return 0;
+	}
+	else if (type >= _S_ASSET_TYPES)
+	{
+		_S_SET_ERROR(S_INVALID_ENUM, "S_assets_get_count");
+		return 0;
+	}
+	return assets->counts[type];
+}
+
+Ssize_t
+S_assets_get_memory(const Sassets *assets,
+                    Senum type)
+{
+	if (!assets)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_assets_get_memory");
+		return 0;
+	}
+	else if (type >= _S_ASSET_TYPES)
+	{
+		_S_SET_ERROR(S_INVALID_ENUM, "S_assets_get_memory");
+		return 0;
+	}
+	return assets->memory[type];
+}
+
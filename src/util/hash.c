@@ -0,0 +1,60 @@
+/*
+ * This file is licensed under BSD 3-Clause.
+ * All license information is available in the included COPYING file.
+ */
+
+/*
+ * hash.c
+ * Non-cryptographic hash function source.
+ *
+ * Author       : Finn Rayment <finn@rayment.fr>
+ * Date created : 18/10/2026
+ */
+
+#include "sticky/common/error.h"
+#include "sticky/common/types.h"
+#include "sticky/util/hash.h"
+
+#define _S_FNV1A_OFFSET 0x811c9dc5u
+#define _S_FNV1A_PRIME  0x01000193u
+
+Suint32
+S_hash_fnv1a(const void *data,
+             Ssize_t len)
+{
+	const Suint8 *ptr;
+	Suint32 hash;
+	Ssize_t i;
+	if (!data && len > 0)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_hash_fnv1a");
+		return 0;
+	}
+	ptr = (const Suint8 *) data;
+	hash = _S_FNV1A_OFFSET;
+	for (i = 0; i < len; ++i)
+	{
+		hash ^= ptr[i];
+		hash *= _S_FNV1A_PRIME;
+	}
+	return hash;
+}
+
+Suint32
+S_hash_fnv1a_string(const Schar *str)
+{
+	Suint32 hash;
+	if (!str)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_hash_fnv1a_string");
+		return 0;
+	}
+	hash = _S_FNV1A_OFFSET;
+	while (*str)
+	{
+		hash ^= (Suint8) *str++;
+		hash *= _S_FNV1A_PRIME;
+	}
+	return hash;
+}
+
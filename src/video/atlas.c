@@ -0,0 +1,415 @@
+/*
+ * This file is licensed under BSD 3-Clause.
+ * All license information is available in the included COPYING file.
+ */
+
+/*
+ * atlas.c
+ * Texture atlas source.
+ *
+ * Author       : Finn Rayment <finn@rayment.fr>
+ * Date created : 18/10/2026
+ */
+
+#include <string.h>
+
+#include "sticky/algorithm/qsort.h"
+#include "sticky/algorithm/skyline.h"
+#include "sticky/common/error.h"
+#include "sticky/common/includes.h"
+#include "sticky/common/types.h"
+#include "sticky/memory/allocator.h"
+#include "sticky/video/atlas.h"
+#include "sticky/video/glstate.h"
+
+#include <stb/stb_image.h>
+
+#define ATLAS_INITIAL_CAPACITY 16
+
+static
+Suint32
+_S_atlas_push(Satlas *atlas,
+              Suint8 *pixels,
+              Suint32 width,
+              Suint32 height)
+{
+	Satlas_sprite *sprite;
+	if (atlas->len == atlas->cap)
+	{
+		atlas->cap *= 2;
+		atlas->sprites = (Satlas_sprite *)
+		                 S_memory_resize(atlas->sprites,
+		                                 atlas->cap * sizeof(Satlas_sprite));
+	}
+	sprite = atlas->sprites + atlas->len;
+	sprite->pixels = pixels;
+	sprite->x = sprite->y = 0;
+	sprite->width = width;
+	sprite->height = height;
+	sprite->layer = 0;
+	return atlas->len++;
+}
+
+/* place every sprite, tallest first, into the first layer with room for it,
+   and return the number of layers used or 0 if more than the limit would be
+   needed */
+Suint32
+_S_atlas_pack(Satlas *atlas,
+              Suint32 limit)
+{
+	Sskyline **packers;
+	Satlas_sprite *sprite;
+	Suint64 *order;
+	Suint32 layers, i, layer, x, y, w, h;
+	Sbool packed;
+
+	order = (Suint64 *) S_memory_new(atlas->len * sizeof(Suint64));
+	for (i = 0; i < atlas->len; ++i)
+	{
+		order[i] = (Suint64) (S_UINT32_MAX - atlas->sprites[i].height) << 32;
+		order[i] |= i;
+	}
+	S_qsort_inline(order, atlas->len, sizeof(Suint64),
+	               (*(Suint64 *) a > *(Suint64 *) b) -
+	               (*(Suint64 *) a < *(Suint64 *) b));
+
+	/* every sprite fits into an empty layer, so there are never more layers
+	   than sprites */
+	packers = (Sskyline **) S_memory_new(atlas->len * sizeof(Sskyline *));
+	layers = 0;
+	for (i = 0; i < atlas->len; ++i)
+	{
+		sprite = atlas->sprites + (order[i] & S_UINT32_MAX);
+		w = sprite->width + 2 * S_ATLAS_PADDING;
+		h = sprite->height + 2 * S_ATLAS_PADDING;
+		for (layer = 0; layer < layers; ++layer)
+		{
+			_S_CALL("S_skyline_pack",
+			        packed = S_skyline_pack(packers[layer], w, h, &x, &y));
+			if (packed)
+				break;
+		}
+		if (layer == layers)
+		{
+			if (layers == limit)
+				break;
+			_S_CALL("S_skyline_new",
+			        packers[layers] = S_skyline_new(atlas->size, atlas->size));
+			++layers;
+			_S_CALL("S_skyline_pack",
+			        S_skyline_pack(packers[layer], w, h, &x, &y));
+		}
+		sprite->x = x + S_ATLAS_PADDING;
+		sprite->y = y + S_ATLAS_PADDING;
+		sprite->layer = layer;
+	}
+	for (layer = 0; layer < layers; ++layer)
+	{
+		_S_CALL("S_skyline_delete", S_skyline_delete(packers[layer]));
+	}
+	S_memory_delete(packers);
+	S_memory_delete(order);
+	return i == atlas->len ? layers : 0;
+}
+
+/* copy the sprites of a layer into it, repeating the edge texels of each
+   sprite into its padding */
+void
+_S_atlas_fill(const Satlas *atlas,
+              Suint32 layer,
+              Suint8 *pixels)
+{
+	const Satlas_sprite *sprite;
+	Sint32 x, y, sx, sy, w, h;
+	Ssize_t i;
+	memset(pixels, 0, (Ssize_t) atlas->size * atlas->size * 4);
+	for (i = 0; i < atlas->len; ++i)
+	{
+		sprite = atlas->sprites + i;
+		if (sprite->layer != layer)
+			continue;
+		w = sprite->width;
+		h = sprite->height;
+		for (y = -S_ATLAS_PADDING; y < h + S_ATLAS_PADDING; ++y)
+		{
+			sy = y < 0 ? 0 : (y >= h ? h - 1 : y);
+			for (x = -S_ATLAS_PADDING; x < w + S_ATLAS_PADDING; ++x)
+			{
+				sx = x < 0 ? 0 : (x >= w ? w - 1 : x);
+				memcpy(pixels + (((Ssize_t) (sprite->y + y)) * atlas->size +
+				                 sprite->x + x) * 4,
+				       sprite->pixels + ((Ssize_t) sy * w + sx) * 4, 4);
+			}
+		}
+	}
+}
+
+static
+void
+_S_atlas_release(Satlas *atlas,
+                 Suint32 layers)
+{
+	Ssize_t i;
+	for (i = 0; i < atlas->len; ++i)
+	{
+		S_memory_delete(atlas->sprites[i].pixels);
+		atlas->sprites[i].pixels = NULL;
+	}
+	atlas->layers = layers;
+	atlas->built = S_TRUE;
+}
+
+static
+Stexture *
+_S_atlas_new_texture(Sbool array)
+{
+	Stexture *tex;
+	tex = (Stexture *) S_memory_new(sizeof(Stexture));
+	tex->cubemap = S_FALSE;
+	tex->array = array;
+	tex->status = S_TEXTURE_READY;
+	tex->job = NULL;
+	_S_GL(glGenTextures(1, &tex->tex));
+	_S_glstate_bind_texture(_S_texture_get_target(tex), tex->tex);
+	_S_CALL("S_texture_set_filter",
+	        S_texture_set_filter(tex, S_TEXTURE_NEAREST));
+	_S_CALL("S_texture_set_wrap",
+	        S_texture_set_wrap(tex, S_TEXTURE_CLAMP));
+	return tex;
+}
+
+Satlas *
+S_atlas_new(Suint32 size)
+{
+	Satlas *atlas;
+	if (size == 0)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_atlas_new");
+		return NULL;
+	}
+	atlas = (Satlas *) S_memory_new(sizeof(Satlas));
+	atlas->cap = ATLAS_INITIAL_CAPACITY;
+	atlas->sprites = (Satlas_sprite *) S_memory_new(atlas->cap *
+	                                                sizeof(Satlas_sprite));
+	atlas->len = 0;
+	atlas->size = size;
+	atlas->layers = 0;
+	atlas->built = S_FALSE;
+	return atlas;
+}
+
+void
+S_atlas_delete(Satlas *atlas)
+{
+	Ssize_t i;
+	if (!atlas)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_atlas_delete");
+		return;
+	}
+	for (i = 0; i < atlas->len; ++i)
+	{
+		if (atlas->sprites[i].pixels)
+			S_memory_delete(atlas->sprites[i].pixels);
+	}
+	S_memory_delete(atlas->sprites);
+	S_memory_delete(atlas);
+}
+
+Suint32
+S_atlas_add(Satlas *atlas,
+            const Schar *filename)
+{
+	Suint8 *data, *pixels;
+	Sint32 w, h, channels;
+	Ssize_t size;
+	if (!atlas || !filename)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_atlas_add");
+		return S_ATLAS_INVALID;
+	}
+	else if (atlas->built)
+	{
+		_S_SET_ERROR(S_INVALID_OPERATION, "S_atlas_add");
+		return S_ATLAS_INVALID;
+	}
+	stbi_set_flip_vertically_on_load(S_FALSE);
+	data = stbi_load(filename, &w, &h, &channels, 4);
+	if (!data)
+		_S_error_stb("S_atlas_add");
+	if ((Suint32) w + 2 * S_ATLAS_PADDING > atlas->size ||
+	    (Suint32) h + 2 * S_ATLAS_PADDING > atlas->size)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_atlas_add");
+		free(data); /* do not replace with S_memory_delete */
+		return S_ATLAS_INVALID;
+	}
+	/* kept in our own memory so that every sprite is freed alike */
+	size = (Ssize_t) w * h * 4;
+	pixels = (Suint8 *) S_memory_new(size);
+	memcpy(pixels, data, size);
+	free(data); /* do not replace with S_memory_delete */
+	return _S_atlas_push(atlas, pixels, w, h);
+}
+
+Suint32
+S_atlas_add_pixels(Satlas *atlas,
+                   const Suint8 *pixels,
+                   Suint32 width,
+                   Suint32 height)
+{
+	Suint8 *copy;
+	Ssize_t size;
+	if (!atlas || !pixels || width == 0 || height == 0 ||
+	    width + 2 * S_ATLAS_PADDING > atlas->size ||
+	    height + 2 * S_ATLAS_PADDING > atlas->size)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_atlas_add_pixels");
+		return S_ATLAS_INVALID;
+	}
+	else if (atlas->built)
+	{
+		_S_SET_ERROR(S_INVALID_OPERATION, "S_atlas_add_pixels");
+		return S_ATLAS_INVALID;
+	}
+	size = (Ssize_t) width * height * 4;
+	copy = (Suint8 *) S_memory_new(size);
+	memcpy(copy, pixels, size);
+	return _S_atlas_push(atlas, copy, width, height);
+}
+
+Stexture *
+S_atlas_build(Satlas *atlas)
+{
+	Stexture *tex;
+	Suint8 *pixels;
+	Suint32 layers;
+	if (!atlas)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_atlas_build");
+		return NULL;
+	}
+	else if (atlas->built || atlas->len == 0)
+	{
+		_S_SET_ERROR(S_INVALID_OPERATION, "S_atlas_build");
+		return NULL;
+	}
+	_S_CALL("_S_atlas_pack", layers = _S_atlas_pack(atlas, 1));
+	if (layers == 0)
+	{
+		_S_SET_ERROR(S_INVALID_INDEX, "S_atlas_build");
+		return NULL;
+	}
+	pixels = (Suint8 *) S_memory_new((Ssize_t) atlas->size * atlas->size * 4);
+	_S_CALL("_S_atlas_fill", _S_atlas_fill(atlas, 0, pixels));
+	_S_CALL("_S_atlas_new_texture", tex = _S_atlas_new_texture(S_FALSE));
+	_S_GL(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, atlas->size, atlas->size, 0,
+	                   GL_RGBA, GL_UNSIGNED_BYTE, pixels));
+	tex->size = _S_texture_get_size(atlas->size, atlas->size, S_FALSE);
+	S_memory_delete(pixels);
+	_S_CALL("_S_atlas_release", _S_atlas_release(atlas, 1));
+	return tex;
+}
+
+Stexture *
+S_atlas_build_array(Satlas *atlas)
+{
+	Stexture *tex;
+	Suint8 *pixels;
+	Suint32 layers, layer;
+	if (!atlas)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_atlas_build_array");
+		return NULL;
+	}
+	else if (atlas->built || atlas->len == 0)
+	{
+		_S_SET_ERROR(S_INVALID_OPERATION, "S_atlas_build_array");
+		return NULL;
+	}
+	_S_CALL("_S_atlas_pack", layers = _S_atlas_pack(atlas, atlas->len));
+	pixels = (Suint8 *) S_memory_new((Ssize_t) atlas->size * atlas->size * 4);
+	_S_CALL("_S_atlas_new_texture", tex = _S_atlas_new_texture(S_TRUE));
+	_S_GL(glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_RGBA, atlas->size,
+	                   atlas->size, layers, 0, GL_RGBA, GL_UNSIGNED_BYTE,
+	                   NULL));
+	/* a layer at a time, so only one layer is ever held in client memory */
+	for (layer = 0; layer < layers; ++layer)
+	{
+		_S_CALL("_S_atlas_fill", _S_atlas_fill(atlas, layer, pixels));
+		_S_GL(glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer,
+		                      atlas->size, atlas->size, 1, GL_RGBA,
+		                      GL_UNSIGNED_BYTE, pixels));
+	}
+	tex->size = _S_texture_get_size(atlas->size, atlas->size, S_FALSE) * layers;
+	S_memory_delete(pixels);
+	_S_CALL("_S_atlas_release", _S_atlas_release(atlas, layers));
+	return tex;
+}
+
+void
+S_atlas_get_uv(const Satlas *atlas,
+               Suint32 sprite,
+               Svec4 *uv)
+{
+	const Satlas_sprite *s;
+	if (!atlas || !uv)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_atlas_get_uv");
+		return;
+	}
+	else if (sprite == S_ATLAS_INVALID || sprite >= atlas->len)
+	{
+		_S_SET_ERROR(S_INVALID_INDEX, "S_atlas_get_uv");
+		return;
+	}
+	else if (!atlas->built)
+	{
+		_S_SET_ERROR(S_INVALID_OPERATION, "S_atlas_get_uv");
+		return;
+	}
+	s = atlas->sprites + sprite;
+	uv->x = (Sfloat) s->x / atlas->size;
+	uv->y = (Sfloat) s->y / atlas->size;
+	uv->z = (Sfloat) (s->x + s->width) / atlas->size;
+	uv->w = (Sfloat) (s->y + s->height) / atlas->size;
+}
+
+Suint32
+S_atlas_get_layer(const Satlas *atlas,
+                  Suint32 sprite)
+{
+	if (!atlas)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_atlas_get_layer");
+		return 0;
+	}
+	else if (sprite == S_ATLAS_INVALID || sprite >= atlas->len)
+	{
+		_S_SET_ERROR(S_INVALID_INDEX, "S_atlas_get_layer");
+		return 0;
+	}
+	else if (!atlas->built)
+	{
+		_S_SET_ERROR(S_INVALID_OPERATION, "S_atlas_get_layer");
+		return 0;
+	}
+	return atlas->sprites[sprite].layer;
+}
+
+Suint32
+S_atlas_get_layers(const Satlas *atlas)
+{
+	if (!atlas)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_atlas_get_layers");
+		return 0;
+	}
+	else if (!atlas->built)
+	{
+		_S_SET_ERROR(S_INVALID_OPERATION, "S_atlas_get_layers");
+		return 0;
+	}
+	return atlas->layers;
+}
+
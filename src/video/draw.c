@@ -11,6 +11,7 @@
  * Date created : 05/03/2022
  */
 
+#include <stddef.h>
 #include <string.h>
 
 #include "sticky/common/error.h"
@@ -26,7 +27,9 @@
 #include "sticky/video/mesh.h"
 #include "sticky/video/draw.h"
 #include "sticky/video/font.h"
+#include "sticky/video/glstate.h"
 #include "sticky/video/shader.h"
+#include "sticky/video/streambuffer.h"
 
 #define DRAW_VERTEX_SOURCE                                                  \
 "#version 330\n                                                            "\
@@ -92,20 +95,21 @@
 
 #define FONT_VERTEX_SOURCE                                                  \
 "#version 330\n                                                            "\
-"in vec4 i_vertex;                                                         "\
-"out vec2 g_texcoord;                                                      "\
+"layout (location = 0) in vec4 i_vertex;                                   "\
+"layout (location = 1) in float i_page;                                    "\
+"out vec3 g_texcoord;                                                      "\
 "uniform mat4 u_projection;                                                "\
 "void main()                                                               "\
 "{                                                                         "\
-"	g_texcoord = i_vertex.zw;                                              "\
+"	g_texcoord = vec3(i_vertex.zw, i_page);                                "\
 "	gl_Position = u_projection * vec4(i_vertex.xy, 0.0, 1.0);              "\
 "}"
 
 #define FONT_FRAGMENT_SOURCE                                                \
 "#version 330\n                                                            "\
-"in vec2 g_texcoord;                                                       "\
+"in vec3 g_texcoord;                                                       "\
 "out vec4 o_color;                                                         "\
-"uniform sampler2D u_text;                                                 "\
+"uniform sampler2DArray u_text;                                            "\
 "uniform vec4 u_color;                                                     "\
 "void main()                                                               "\
 "{                                                                         "\
@@ -113,8 +117,55 @@
 "	o_color = u_color * v_sample;                                          "\
 "}"
 
+/* the outline lies half way through the distance field, and is smoothed over
+   about one pixel of the screen at any scale */
+#define FONT_SDF_FRAGMENT_SOURCE                                            \
+"#version 330\n                                                            "\
+"in vec3 g_texcoord;                                                       "\
+"out vec4 o_color;                                                         "\
+"uniform sampler2DArray u_text;                                            "\
+"uniform vec4 u_color;                                                     "\
+"void main()                                                               "\
+"{                                                                         "\
+"	float v_dist = texture(u_text, g_texcoord).r;                          "\
+"	float v_width = max(fwidth(v_dist), 0.0001);                           "\
+"	float v_alpha = smoothstep(0.5 - v_width, 0.5 + v_width, v_dist);      "\
+"	o_color = vec4(u_color.rgb, u_color.a * v_alpha);                      "\
+"}"
+
+#define DEBUG_VERTEX_SOURCE                                                 \
+"#version 330\n                                                            "\
+"layout (location = 0) in vec3 i_position;                                 "\
+"layout (location = 1) in vec4 i_color;                                    "\
+"out vec4 g_color;                                                         "\
+"uniform mat4 u_view;                                                      "\
+"uniform mat4 u_projection;                                                "\
+"void main()                                                               "\
+"{                                                                         "\
+"	g_color = i_color;                                                     "\
+"	gl_PointSize = 4.0f;                                                   "\
+"	gl_Position = u_projection * u_view * vec4(i_position, 1.0);           "\
+"}"
+
+#define DEBUG_FRAGMENT_SOURCE                                               \
+"#version 330\n                                                            "\
+"in vec4 g_color;                                                          "\
+"out vec4 o_color;                                                         "\
+"void main()                                                               "\
+"{                                                                         "\
+"	o_color = g_color;                                                     "\
+"}"
+
 #define POINT_SIZE 0.005f
 
+#define DEBUG_QUEUE_MIN 256
+
+#define INSTANCES_MIN 64
+
+/* the size of each region of the stream buffer shared by the immediate 2D and
+   debug draws */
+#define DRAW_STREAM_SIZE (256 * 1024)
+
 static
 Sfloat line_vertices[6] =
 {
@@ -144,11 +195,257 @@ Sfloat quad_texcoords[12] =
 	0.0f, 1.0f
 };
 
-static Sshader *shader, *shader2d, *shader2dtex, *shaderfont;
+typedef struct
+_Sdraw_uniforms_s
+{
+	Sint32 projection, view, model, color;
+} _Sdraw_uniforms;
+
+typedef struct
+_Sdraw_debug_vertex_s
+{
+	Sfloat x, y, z;
+	Suint8 color[4];
+} _Sdraw_debug_vertex;
+
+typedef struct
+_Sdraw_instance_s
+{
+	Smat4 transform;
+	Svec4 color, data;
+} _Sdraw_instance;
+
+typedef struct
+_Sdraw_debug_queue_s
+{
+	_Sdraw_debug_vertex *vertices;
+	Ssize_t len, cap;
+} _Sdraw_debug_queue;
+
+static Sshader *shader, *shader2d, *shader2dtex, *shaderfont, *shaderfontsdf;
+static Sshader *shaderdebug;
+static _Sdraw_uniforms uniforms, uniforms2d, uniforms2dtex, uniformsfont;
+static _Sdraw_uniforms uniformsfontsdf;
+static _Sdraw_uniforms uniformsdebug;
+static Smat4 debugprojection, debugview;
+static _Sdraw_debug_queue debuglines, debugpoints;
+static GLuint vaodebug;
+static _Sdraw_instance *instances;
+static Suint32 instancecap;
+static GLuint vboinstance;
 static Smesh *line_mesh, *quad_mesh;
-static GLuint vao2d, vbo2d, vbotex2d;
-static Svec2 last2dfrom, last2dto;
-static Sfloat font_buffer[S_GLYPH_BUFFER_SIZE*6*4];
+static GLuint vao2d, vaotext;
+static Sstreambuffer *stream;
+static Sfloat font_buffer[S_GLYPH_BUFFER_SIZE*_S_GLYPH_QUAD_FLOATS];
+
+/* attach the font shader and texture for drawing text in 2D */
+static
+void
+_S_draw_text_begin(const Swindow *window,
+                   const Sfont *font)
+{
+	Sshader *program;
+	const _Sdraw_uniforms *handles;
+	Smat4 projection;
+	program = font->sdf ? shaderfontsdf : shaderfont;
+	handles = font->sdf ? &uniformsfontsdf : &uniformsfont;
+	_S_CALL("_S_shader_attach", _S_shader_attach(program));
+	_S_CALL("S_shader_set_uniform_handle_vec4",
+	        S_shader_set_uniform_handle_vec4(program, handles->color,
+	                                         &window->dcolor));
+	/* TODO: Dirty check the camera. */
+	_S_CALL("S_camera_get_orthographic_matrix",
+	        S_camera_get_orthographic_matrix(window->cam, &projection));
+	_S_CALL("S_shader_set_uniform_handle_mat4",
+	        S_shader_set_uniform_handle_mat4(program, handles->projection,
+	                                         &projection));
+
+	_S_glstate_disable(GL_DEPTH_TEST);
+	_S_glstate_active_texture(0);
+	_S_glstate_bind_texture(GL_TEXTURE_2D_ARRAY, font->texture);
+}
+
+/* upload any new glyphs and draw the quads waiting in the font buffer */
+static
+void
+_S_draw_text_flush(const Sfont *font,
+                   Suint32 tris)
+{
+	Suint32 first;
+	if (tris == 0)
+		return;
+	_S_CALL("_S_font_upload", _S_font_upload(font));
+	_S_CALL("S_streambuffer_write",
+	        first = S_streambuffer_write(stream, font_buffer,
+	                                     tris * 5 * sizeof(Sfloat),
+	                                     5 * sizeof(Sfloat)));
+	_S_GL(glDrawArrays(GL_TRIANGLES, first, tris));
+}
+
+/* draw text from its cached layout, so that only the quads are built */
+static
+void
+_S_draw_text_layout(const Swindow *window,
+                    const Sfont *font,
+                    const Schar *text,
+                    Ssize_t len,
+                    Sfloat x,
+                    Sfloat y,
+                    Sfloat scale,
+                    Sfloat wrap)
+{
+	const _Stextlayout *layout;
+	const _Sglyph *glyph;
+	Ssize_t i;
+	Sfloat gx, gy;
+	Suint32 tris;
+	Sbool retry;
+
+	if (!window->cam || len == 0)
+		return;
+
+	_S_CALL("_S_draw_text_begin", _S_draw_text_begin(window, font));
+	_S_glstate_bind_vertex_array(vaotext);
+	_S_font_tick(font);
+	_S_CALL("_S_font_get_layout",
+	        layout = _S_font_get_layout(font, text, len, scale, wrap));
+
+	tris = 0;
+	retry = S_FALSE;
+	for (i = 0; i < layout->count;)
+	{
+		_S_CALL("_S_font_get_glyph",
+		        glyph = _S_font_get_glyph(font, layout->glyphs[i].codepoint));
+		if (!glyph)
+		{
+			/* every page holds glyphs waiting to be drawn, so draw them
+			   to free the pages and try once more */
+			_S_CALL("_S_draw_text_flush", _S_draw_text_flush(font, tris));
+			tris = 0;
+			_S_font_tick(font);
+			if (retry)
+				++i;
+			retry = !retry;
+			continue;
+		}
+		retry = S_FALSE;
+
+		gx = x + layout->glyphs[i].x;
+		gy = y + layout->glyphs[i].y;
+		++i;
+		if (!_S_font_glyph_quad(font, glyph, scale, &gx, &gy,
+		                        font_buffer + 5 * tris))
+			continue; /* skip empty glyphs */
+
+		tris += 6;
+		if (tris >= S_GLYPH_BUFFER_SIZE * 6)
+		{
+			_S_CALL("_S_draw_text_flush", _S_draw_text_flush(font, tris));
+			tris = 0;
+		}
+	}
+	_S_CALL("_S_draw_text_flush", _S_draw_text_flush(font, tris));
+}
+
+static
+void
+_S_draw_debug_push(_Sdraw_debug_queue *queue,
+                   const Svec3 *pos,
+                   const Svec4 *color)
+{
+	_Sdraw_debug_vertex *vertex;
+	if (queue->cap == 0)
+	{
+		queue->cap = DEBUG_QUEUE_MIN;
+		queue->vertices = (_Sdraw_debug_vertex *)
+			S_memory_new(sizeof(_Sdraw_debug_vertex) * queue->cap);
+	}
+	else if (queue->len == queue->cap)
+	{
+		queue->cap *= 2;
+		queue->vertices = (_Sdraw_debug_vertex *)
+			S_memory_resize(queue->vertices,
+			                sizeof(_Sdraw_debug_vertex) * queue->cap);
+	}
+	vertex = queue->vertices + queue->len++;
+	vertex->x = pos->x;
+	vertex->y = pos->y;
+	vertex->z = pos->z;
+	vertex->color[0] = (Suint8) (S_clamp(color->x, 0.0f, 1.0f) * 255.0f + 0.5f);
+	vertex->color[1] = (Suint8) (S_clamp(color->y, 0.0f, 1.0f) * 255.0f + 0.5f);
+	vertex->color[2] = (Suint8) (S_clamp(color->z, 0.0f, 1.0f) * 255.0f + 0.5f);
+	vertex->color[3] = (Suint8) (S_clamp(color->w, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+/* stream a debug queue in chunks which fit in a region of the stream buffer,
+   keeping the pairs of vertices of lines together */
+static
+void
+_S_draw_debug_stream(const _Sdraw_debug_queue *queue,
+                     GLenum mode)
+{
+	Ssize_t i, len, chunk;
+	Suint32 first;
+	chunk = (DRAW_STREAM_SIZE / sizeof(_Sdraw_debug_vertex) - 1) / 2 * 2;
+	for (i = 0; i < queue->len; i += len)
+	{
+		len = S_min(queue->len - i, chunk);
+		_S_CALL("S_streambuffer_write",
+		        first = S_streambuffer_write(stream, queue->vertices + i,
+		                                     sizeof(_Sdraw_debug_vertex) * len,
+		                                     sizeof(_Sdraw_debug_vertex)));
+		_S_GL(glDrawArrays(mode, first, len));
+	}
+}
+
+/* point the instance attributes of a mesh at the instance buffer, which only
+   needs to be done once as the buffer is orphaned rather than replaced */
+static
+void
+_S_draw_bind_instances(Smesh *mesh)
+{
+	Suint32 i;
+	if (mesh->instances == vboinstance)
+		return;
+	_S_glstate_bind_vertex_array(mesh->vao);
+	_S_glstate_bind_buffer(GL_ARRAY_BUFFER, vboinstance);
+	for (i = 0; i < 4; ++i)
+	{
+		_S_GL(glEnableVertexAttribArray(S_DRAW_INSTANCE_TRANSFORM + i));
+		_S_GL(glVertexAttribPointer(S_DRAW_INSTANCE_TRANSFORM + i, 4, GL_FLOAT,
+		                            GL_FALSE, sizeof(_Sdraw_instance),
+		                            (void *) (i * 4 * sizeof(Sfloat))));
+		_S_GL(glVertexAttribDivisor(S_DRAW_INSTANCE_TRANSFORM + i, 1));
+	}
+	_S_GL(glEnableVertexAttribArray(S_DRAW_INSTANCE_COLOR));
+	_S_GL(glVertexAttribPointer(S_DRAW_INSTANCE_COLOR, 4, GL_FLOAT, GL_FALSE,
+	                            sizeof(_Sdraw_instance),
+	                            (void *) offsetof(_Sdraw_instance, color)));
+	_S_GL(glVertexAttribDivisor(S_DRAW_INSTANCE_COLOR, 1));
+	_S_GL(glEnableVertexAttribArray(S_DRAW_INSTANCE_DATA));
+	_S_GL(glVertexAttribPointer(S_DRAW_INSTANCE_DATA, 4, GL_FLOAT, GL_FALSE,
+	                            sizeof(_Sdraw_instance),
+	                            (void *) offsetof(_Sdraw_instance, data)));
+	_S_GL(glVertexAttribDivisor(S_DRAW_INSTANCE_DATA, 1));
+	mesh->instances = vboinstance;
+}
+
+/* look up the uniform handles of a draw shader once */
+static
+void
+_S_draw_get_uniforms(Sshader *program,
+                     _Sdraw_uniforms *handles)
+{
+	_S_CALL("S_shader_get_uniform_handle",
+	        handles->projection = S_shader_get_uniform_handle(program,
+	                                                          "u_projection"));
+	_S_CALL("S_shader_get_uniform_handle",
+	        handles->view = S_shader_get_uniform_handle(program, "u_view"));
+	_S_CALL("S_shader_get_uniform_handle",
+	        handles->model = S_shader_get_uniform_handle(program, "u_model"));
+	_S_CALL("S_shader_get_uniform_handle",
+	        handles->color = S_shader_get_uniform_handle(program, "u_color"));
+}
 
 void
 _S_draw_init(Suint8 gl_maj,
@@ -160,6 +457,7 @@ _S_draw_init(Suint8 gl_maj,
 		shader = NULL;
 		shader2d = NULL;
 		shader2dtex = NULL;
+		shaderdebug = NULL;
 		line_mesh = NULL;
 		quad_mesh = NULL;
 		return;
@@ -175,27 +473,80 @@ _S_draw_init(Suint8 gl_maj,
 	                                   strlen(DRAW_VERTEX_SOURCE_2DTEX),
 	                                   DRAW_FRAGMENT_SOURCE_2DTEX,
 	                                   strlen(DRAW_FRAGMENT_SOURCE_2DTEX)));
-	_S_GL(glEnable(GL_PROGRAM_POINT_SIZE));
+	_S_glstate_enable(GL_PROGRAM_POINT_SIZE);
 	_S_CALL("S_shader_new",
 	        shader = S_shader_new(DRAW_VERTEX_SOURCE,
 	                              strlen(DRAW_VERTEX_SOURCE),
 	                              DRAW_FRAGMENT_SOURCE,
 	                              strlen(DRAW_FRAGMENT_SOURCE)));
-	_S_GL(glDisable(GL_PROGRAM_POINT_SIZE));
+	_S_glstate_disable(GL_PROGRAM_POINT_SIZE);
 	_S_CALL("S_shader_new",
 	        shaderfont = S_shader_new(FONT_VERTEX_SOURCE,
 	                                  strlen(FONT_VERTEX_SOURCE),
 	                                  FONT_FRAGMENT_SOURCE,
 	                                  strlen(FONT_FRAGMENT_SOURCE)));
+	_S_CALL("S_shader_new",
+	        shaderfontsdf = S_shader_new(FONT_VERTEX_SOURCE,
+	                                     strlen(FONT_VERTEX_SOURCE),
+	                                     FONT_SDF_FRAGMENT_SOURCE,
+	                                     strlen(FONT_SDF_FRAGMENT_SOURCE)));
+	_S_CALL("_S_draw_get_uniforms", _S_draw_get_uniforms(shader, &uniforms));
+	_S_CALL("_S_draw_get_uniforms",
+	        _S_draw_get_uniforms(shader2d, &uniforms2d));
+	_S_CALL("_S_draw_get_uniforms",
+	        _S_draw_get_uniforms(shader2dtex, &uniforms2dtex));
+	_S_CALL("S_shader_new",
+	        shaderdebug = S_shader_new(DEBUG_VERTEX_SOURCE,
+	                                   strlen(DEBUG_VERTEX_SOURCE),
+	                                   DEBUG_FRAGMENT_SOURCE,
+	                                   strlen(DEBUG_FRAGMENT_SOURCE)));
+	_S_CALL("_S_draw_get_uniforms",
+	        _S_draw_get_uniforms(shaderfont, &uniformsfont));
+	_S_CALL("_S_draw_get_uniforms",
+	        _S_draw_get_uniforms(shaderfontsdf, &uniformsfontsdf));
+	_S_CALL("_S_draw_get_uniforms",
+	        _S_draw_get_uniforms(shaderdebug, &uniformsdebug));
+	/* a new program holds none of the matrices last uploaded */
+	memset(&debugprojection, 0, sizeof(Smat4));
+	memset(&debugview, 0, sizeof(Smat4));
 	/* generate vbos and vaos */
+	_S_GL(glGenBuffers(1, &vboinstance));
 	//_S_GL(glGenVertexArrays(1, &vao3d));
 	//_S_GL(glGenBuffers(1, &vbo3d));
+	_S_CALL("S_streambuffer_new",
+	        stream = S_streambuffer_new(DRAW_STREAM_SIZE));
+	/* quads are streamed as interleaved positions and tex coords, and text
+	   adds the atlas page of each vertex */
 	_S_GL(glGenVertexArrays(1, &vao2d));
-	_S_GL(glGenBuffers(1, &vbo2d));
-	_S_GL(glGenBuffers(1, &vbotex2d));
-
-	_S_CALL("S_vec2_fill", S_vec2_fill(&last2dfrom, -1.0f));
-	_S_CALL("S_vec2_fill", S_vec2_fill(&last2dto, -1.0f));
+	_S_glstate_bind_vertex_array(vao2d);
+	_S_CALL("S_streambuffer_bind", S_streambuffer_bind(stream));
+	_S_GL(glEnableVertexAttribArray(0));
+	_S_GL(glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE,
+	                            4 * sizeof(Sfloat), (void *) 0));
+	_S_GL(glEnableVertexAttribArray(1));
+	_S_GL(glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE,
+	                            4 * sizeof(Sfloat),
+	                            (void *) (2 * sizeof(Sfloat))));
+	_S_GL(glGenVertexArrays(1, &vaotext));
+	_S_glstate_bind_vertex_array(vaotext);
+	_S_CALL("S_streambuffer_bind", S_streambuffer_bind(stream));
+	_S_GL(glEnableVertexAttribArray(0));
+	_S_GL(glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE,
+	                            5 * sizeof(Sfloat), (void *) 0));
+	_S_GL(glEnableVertexAttribArray(1));
+	_S_GL(glVertexAttribPointer(1, 1, GL_FLOAT, GL_FALSE,
+	                            5 * sizeof(Sfloat),
+	                            (void *) (4 * sizeof(Sfloat))));
+	_S_GL(glGenVertexArrays(1, &vaodebug));
+	_S_glstate_bind_vertex_array(vaodebug);
+	_S_CALL("S_streambuffer_bind", S_streambuffer_bind(stream));
+	_S_GL(glEnableVertexAttribArray(0));
+	_S_GL(glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE,
+	                            sizeof(_Sdraw_debug_vertex), (void *) 0));
+	_S_GL(glEnableVertexAttribArray(1));
+	_S_GL(glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE,
+	                            sizeof(_Sdraw_debug_vertex),
+	                            (void *) (3 * sizeof(Sfloat))));
 
 	/* generate meshes */
 	_S_CALL("S_mesh_new",
@@ -221,12 +572,33 @@ _S_draw_free(void)
 		_S_CALL("S_shader_delete", S_shader_delete(shader2d));
 		_S_CALL("S_shader_delete", S_shader_delete(shader2dtex));
 		_S_CALL("S_shader_delete", S_shader_delete(shaderfont));
+		_S_CALL("S_shader_delete", S_shader_delete(shaderfontsdf));
 		_S_CALL("S_mesh_delete", S_mesh_delete(line_mesh));
 		_S_CALL("S_mesh_delete", S_mesh_delete(quad_mesh));
-		_S_GL(glDeleteBuffers(1, &vbo2d));
-		_S_GL(glDeleteBuffers(1, &vbotex2d));
 		_S_GL(glDeleteVertexArrays(1, &vao2d));
+		_S_glstate_forget_vertex_array(vao2d);
+		_S_GL(glDeleteVertexArrays(1, &vaotext));
+		_S_glstate_forget_vertex_array(vaotext);
+		_S_CALL("S_shader_delete", S_shader_delete(shaderdebug));
+		_S_GL(glDeleteVertexArrays(1, &vaodebug));
+		_S_glstate_forget_vertex_array(vaodebug);
+		_S_CALL("S_streambuffer_delete", S_streambuffer_delete(stream));
+		stream = NULL;
+		_S_GL(glDeleteBuffers(1, &vboinstance));
+		_S_glstate_forget_buffer(vboinstance);
+		vboinstance = 0;
 	}
+	if (instances)
+		S_memory_delete(instances);
+	instances = NULL;
+	instancecap = 0;
+	if (debuglines.vertices)
+		S_memory_delete(debuglines.vertices);
+	if (debugpoints.vertices)
+		S_memory_delete(debugpoints.vertices);
+	debuglines.vertices = debugpoints.vertices = NULL;
+	debuglines.len = debuglines.cap = 0;
+	debugpoints.len = debugpoints.cap = 0;
 }
 
 void
@@ -266,19 +638,18 @@ S_draw_line_3d(const Swindow *window,
 	        S_transform_get_transformation_matrix(window->dtrans, &model));
 	/* set shader uniforms */
 	_S_CALL("_S_shader_attach", _S_shader_attach(shader));
-	_S_CALL("S_shader_set_uniform_mat4",
-	        S_shader_set_uniform_mat4(shader,
-	                                  "u_projection", &projection));
-	_S_CALL("S_shader_set_uniform_mat4",
-	        S_shader_set_uniform_mat4(shader,
-	                                  "u_view", &view));
-	_S_CALL("S_shader_set_uniform_mat4",
-	        S_shader_set_uniform_mat4(shader,
-	                                  "u_model", &model));
-	_S_CALL("S_shader_set_uniform_vec4",
-	        S_shader_set_uniform_vec4(shader,
-			                          "u_color", &window->dcolor));
+	_S_CALL("S_shader_set_uniform_handle_mat4",
+	        S_shader_set_uniform_handle_mat4(shader, uniforms.projection,
+	                                         &projection));
+	_S_CALL("S_shader_set_uniform_handle_mat4",
+	        S_shader_set_uniform_handle_mat4(shader, uniforms.view, &view));
+	_S_CALL("S_shader_set_uniform_handle_mat4",
+	        S_shader_set_uniform_handle_mat4(shader, uniforms.model, &model));
+	_S_CALL("S_shader_set_uniform_handle_vec4",
+	        S_shader_set_uniform_handle_vec4(shader, uniforms.color,
+	                                         &window->dcolor));
 	/* draw line */
+	_S_glstate_enable(GL_DEPTH_TEST);
 	_S_CALL("_S_mesh_draw", _S_mesh_draw(line_mesh, S_MESH_LINES));
 }
 
@@ -307,22 +678,103 @@ S_draw_point_3d(const Swindow *window,
 	        S_transform_get_transformation_matrix(window->dtrans, &model));
 	/* set shader uniforms */
 	_S_CALL("_S_shader_attach", _S_shader_attach(shader));
-	_S_CALL("S_shader_set_uniform_mat4",
-	        S_shader_set_uniform_mat4(shader,
-	                                  "u_projection", &projection));
-	_S_CALL("S_shader_set_uniform_mat4",
-	        S_shader_set_uniform_mat4(shader,
-	                                  "u_view", &view));
-	_S_CALL("S_shader_set_uniform_mat4",
-	        S_shader_set_uniform_mat4(shader,
-	                                  "u_model", &model));
-	_S_CALL("S_shader_set_uniform_vec4",
-	        S_shader_set_uniform_vec4(shader,
-			                          "u_color", &window->dcolor));
+	_S_CALL("S_shader_set_uniform_handle_mat4",
+	        S_shader_set_uniform_handle_mat4(shader, uniforms.projection,
+	                                         &projection));
+	_S_CALL("S_shader_set_uniform_handle_mat4",
+	        S_shader_set_uniform_handle_mat4(shader, uniforms.view, &view));
+	_S_CALL("S_shader_set_uniform_handle_mat4",
+	        S_shader_set_uniform_handle_mat4(shader, uniforms.model, &model));
+	_S_CALL("S_shader_set_uniform_handle_vec4",
+	        S_shader_set_uniform_handle_vec4(shader, uniforms.color,
+	                                         &window->dcolor));
+	_S_glstate_enable(GL_DEPTH_TEST);
 	_S_CALL("_S_mesh_draw_count",
 	        _S_mesh_draw_count(line_mesh, S_MESH_POINTS, 1));
 }
 
+void
+S_draw_debug_line_3d(const Swindow *window,
+                     const Svec3 *from,
+                     const Svec3 *to,
+                     const Svec4 *color)
+{
+	if (!window || !from || !to)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_draw_debug_line_3d");
+		return;
+	}
+	if (!color)
+		color = &window->dcolor;
+	_S_draw_debug_push(&debuglines, from, color);
+	_S_draw_debug_push(&debuglines, to, color);
+}
+
+void
+S_draw_debug_point_3d(const Swindow *window,
+                      const Svec3 *point,
+                      const Svec4 *color)
+{
+	if (!window || !point)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_draw_debug_point_3d");
+		return;
+	}
+	if (!color)
+		color = &window->dcolor;
+	_S_draw_debug_push(&debugpoints, point, color);
+}
+
+void
+S_draw_debug_flush(const Swindow *window)
+{
+	Smat4 projection, view;
+	Ssize_t total;
+	if (!window)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_draw_debug_flush");
+		return;
+	}
+	total = debuglines.len + debugpoints.len;
+	if (!shaderdebug || !window->cam || total == 0)
+	{
+		debuglines.len = 0;
+		debugpoints.len = 0;
+		return;
+	}
+	/* only upload the matrices which have changed since the last flush */
+	_S_CALL("S_camera_get_perspective_matrix",
+	        S_camera_get_perspective_matrix(window->cam, &projection));
+	_S_CALL("S_camera_get_view_matrix",
+	        S_camera_get_view_matrix(window->cam, &view));
+	_S_CALL("_S_shader_attach", _S_shader_attach(shaderdebug));
+	if (memcmp(&projection, &debugprojection, sizeof(Smat4)) != 0)
+	{
+		_S_CALL("S_shader_set_uniform_handle_mat4",
+		        S_shader_set_uniform_handle_mat4(shaderdebug,
+		                                         uniformsdebug.projection,
+		                                         &projection));
+		debugprojection = projection;
+	}
+	if (memcmp(&view, &debugview, sizeof(Smat4)) != 0)
+	{
+		_S_CALL("S_shader_set_uniform_handle_mat4",
+		        S_shader_set_uniform_handle_mat4(shaderdebug,
+		                                         uniformsdebug.view, &view));
+		debugview = view;
+	}
+	_S_glstate_enable(GL_DEPTH_TEST);
+	_S_glstate_enable(GL_PROGRAM_POINT_SIZE);
+	_S_glstate_bind_vertex_array(vaodebug);
+	_S_CALL("_S_draw_debug_stream",
+	        _S_draw_debug_stream(&debuglines, GL_LINES));
+	_S_CALL("_S_draw_debug_stream",
+	        _S_draw_debug_stream(&debugpoints, GL_POINTS));
+	_S_glstate_disable(GL_PROGRAM_POINT_SIZE);
+	debuglines.len = 0;
+	debugpoints.len = 0;
+}
+
 void
 S_draw_quad_2d(const Swindow *window,
                const Svec2 *from,
@@ -330,7 +782,9 @@ S_draw_quad_2d(const Swindow *window,
 {
 	Smat4 projection;
 	Sshader *quadshader;
-	Sbool b1, b2;
+	const _Sdraw_uniforms *quaduniforms;
+	Sfloat vertices[24];
+	Suint32 i, first;
 	if (!window || !from || !to)
 	{
 		_S_SET_ERROR(S_INVALID_VALUE, "S_draw_quad_2d");
@@ -338,72 +792,45 @@ S_draw_quad_2d(const Swindow *window,
 	}
 	if (!window->cam)
 		return;
-	_S_CALL("S_vec2_equals", b1 = S_vec2_equals(S_EPSILON, from, &last2dfrom));
-	_S_CALL("S_vec2_equals", b2 = S_vec2_equals(S_EPSILON, to, &last2dto));
-	_S_GL(glBindVertexArray(vao2d));
-	if (!b1 || !b2)
-	{
-		/* the quad is not the same as the last drawn quad, so we must
-		   recalculate the vertices/texcoords again and buffer them into the
-		   vbos */
-		/* calculate vertices */
-		quad_vertices[(0*2)  ] = from->x;
-		quad_vertices[(0*2)+1] = from->y;
-		quad_vertices[(1*2)  ] = to->x;
-		quad_vertices[(1*2)+1] = to->y;
-		quad_vertices[(2*2)  ] = to->x;
-		quad_vertices[(2*2)+1] = from->y;
-		quad_vertices[(3*2)  ] = to->x;
-		quad_vertices[(3*2)+1] = to->y;
-		quad_vertices[(4*2)  ] = from->x;
-		quad_vertices[(4*2)+1] = from->y;
-		quad_vertices[(5*2)  ] = from->x;
-		quad_vertices[(5*2)+1] = to->y;
-
-		/* buffer the vertices */
-		_S_GL(glBindBuffer(GL_ARRAY_BUFFER, vbo2d));
-		_S_GL(glBufferData(GL_ARRAY_BUFFER,
-		                   12 * sizeof(Sfloat),
-		                   quad_vertices,
-		                   GL_STATIC_DRAW));
-		_S_GL(glEnableVertexAttribArray(0));
-		_S_GL(glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE,
-		                            2 * sizeof(Sfloat), (void *) 0));
-		if (window->dtex)
-		{
-			_S_GL(glBindBuffer(GL_ARRAY_BUFFER, vbotex2d));
-			/* buffer the tex coords */
-			_S_GL(glBufferData(GL_ARRAY_BUFFER,
-			                   12 * sizeof(Sfloat),
-			                   quad_texcoords,
-			                   GL_STATIC_DRAW));
-			_S_GL(glEnableVertexAttribArray(1));
-			_S_GL(glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE,
-				                        2 * sizeof(Sfloat), (void *) 0));
-			_S_CALL("_S_texture_attach", _S_texture_attach(window->dtex, 0));
-		}
-		_S_GL(glBindBuffer(GL_ARRAY_BUFFER, 0));
+	/* stretch the unit quad between the two corners */
+	for (i = 0; i < 6; ++i)
+	{
+		vertices[i*4  ] = quad_vertices[i*2  ] == 0.0f ? from->x : to->x;
+		vertices[i*4+1] = quad_vertices[i*2+1] == 0.0f ? from->y : to->y;
+		vertices[i*4+2] = quad_texcoords[i*2  ];
+		vertices[i*4+3] = quad_texcoords[i*2+1];
 	}
+	_S_glstate_bind_vertex_array(vao2d);
+	_S_CALL("S_streambuffer_write",
+	        first = S_streambuffer_write(stream, vertices, sizeof(vertices),
+	                                     4 * sizeof(Sfloat)));
 	/* get matrix */
 	/* TODO: Dirty check the camera. */
 	_S_CALL("S_camera_get_orthographic_matrix",
 	        S_camera_get_orthographic_matrix(window->cam, &projection));
 	/* set shader uniforms */
 	if (window->dtex)
+	{
 		quadshader = shader2dtex;
+		quaduniforms = &uniforms2dtex;
+		_S_CALL("_S_texture_attach", _S_texture_attach(window->dtex, 0));
+	}
 	else
+	{
 		quadshader = shader2d;
+		quaduniforms = &uniforms2d;
+	}
 	_S_CALL("_S_shader_attach", _S_shader_attach(quadshader));
-	_S_CALL("S_shader_set_uniform_mat4",
-	        S_shader_set_uniform_mat4(quadshader,
-	                                  "u_projection", &projection));
-	_S_CALL("S_shader_set_uniform_vec4",
-	        S_shader_set_uniform_vec4(quadshader, "u_color", &window->dcolor));
-	/* draw */
-	_S_GL(glDisable(GL_DEPTH_TEST));
-	_S_GL(glDrawArrays(GL_TRIANGLES, 0, 6));
-	_S_GL(glBindVertexArray(0));
-	_S_GL(glEnable(GL_DEPTH_TEST));
+	_S_CALL("S_shader_set_uniform_handle_mat4",
+	        S_shader_set_uniform_handle_mat4(quadshader,
+	                                         quaduniforms->projection,
+	                                         &projection));
+	_S_CALL("S_shader_set_uniform_handle_vec4",
+	        S_shader_set_uniform_handle_vec4(quadshader, quaduniforms->color,
+	                                         &window->dcolor));
+	/* draw, leaving depth testing off for any following 2D draws */
+	_S_glstate_disable(GL_DEPTH_TEST);
+	_S_GL(glDrawArrays(GL_TRIANGLES, first, 6));
 }
 
 void
@@ -436,117 +863,52 @@ S_draw_text_2d(const Swindow *window,
                Sfloat y,
                Sfloat scale)
 {
-	Schar c;
-	Ssize_t i;
-	const _Sglyph *glyph;
-	Sfloat xp, yp, w, h, offx, offy, offw, offh;
-	Sint32 tris, chars;
-	Smat4 projection;
-
 	if (!window || !font || !text || scale <= 0.0f)
 	{
 		_S_SET_ERROR(S_INVALID_VALUE, "S_draw_text_2d");
 		return;
 	}
+	_S_CALL("_S_draw_text_layout",
+	        _S_draw_text_layout(window, font, text, len, x, y, scale, 0.0f));
+}
 
-	if (!window->cam || len == 0)
+void
+S_draw_text_wrapped_2d(const Swindow *window,
+                       const Sfont *font,
+                       const Schar *text,
+                       Ssize_t len,
+                       Sfloat x,
+                       Sfloat y,
+                       Sfloat scale,
+                       Sfloat width)
+{
+	if (!window || !font || !text || scale <= 0.0f || width <= 0.0f)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_draw_text_wrapped_2d");
 		return;
+	}
+	_S_CALL("_S_draw_text_layout",
+	        _S_draw_text_layout(window, font, text, len, x, y, scale, width));
+}
 
-	_S_CALL("_S_shader_attach", _S_shader_attach(shaderfont));
-	_S_CALL("S_shader_set_uniform_vec4",
-	        S_shader_set_uniform_vec4(shaderfont, "u_color", &window->dcolor));
-	/* TODO: Dirty check the camera. */
-	_S_CALL("S_camera_get_orthographic_matrix",
-	        S_camera_get_orthographic_matrix(window->cam, &projection));
-	_S_CALL("S_shader_set_uniform_mat4",
-	        S_shader_set_uniform_mat4(shaderfont, "u_projection",
-	                                  &projection));
-
-	_S_GL(glDisable(GL_DEPTH_TEST));
-	_S_GL(glActiveTexture(GL_TEXTURE0));
-	_S_GL(glBindTexture(GL_TEXTURE_2D, font->texture));
-	_S_GL(glBindVertexArray(font->vao));
-	_S_GL(glBindBuffer(GL_ARRAY_BUFFER, font->vbo));
-
-	tris = 0;
-	chars = 0;
-
-	while (1)
+void
+S_draw_textmesh_2d(const Swindow *window,
+                   Stextmesh *mesh)
+{
+	if (!window || !mesh)
 	{
-		for (i = 0; i < len; ++i)
-		{
-			c = *(text+i);
-			glyph = font->glyphs+c-S_GLYPH_BEGIN;
-			w = glyph->size.x * scale;
-			h = glyph->size.y * scale;
-
-			xp = x + glyph->xbearing * scale;
-			yp = y - (glyph->size.y - glyph->ybearing) * scale;
-
-			x += glyph->xadvance * scale;
-			y += glyph->yadvance * scale;
-
-			if (w == 0 || h == 0)
-				continue; /* skip empty glyphs */
-
-			offx = glyph->offset.x;
-			offy = glyph->offset.y;
-			offw = glyph->size.x / font->width;
-			offh = glyph->size.y / font->height;
-
-			font_buffer[4*(tris+0)+0] = xp;
-			font_buffer[4*(tris+0)+1] = yp + h;
-			font_buffer[4*(tris+0)+2] = offx;
-			font_buffer[4*(tris+0)+3] = offy;
-			font_buffer[4*(tris+1)+0] = xp;
-			font_buffer[4*(tris+1)+1] = yp;
-			font_buffer[4*(tris+1)+2] = offx;
-			font_buffer[4*(tris+1)+3] = offy + offh;
-			font_buffer[4*(tris+2)+0] = xp + w;
-			font_buffer[4*(tris+2)+1] = yp;
-			font_buffer[4*(tris+2)+2] = offx + offw;
-			font_buffer[4*(tris+2)+3] = offy + offh;
-			font_buffer[4*(tris+3)+0] = xp;
-			font_buffer[4*(tris+3)+1] = yp + h;
-			font_buffer[4*(tris+3)+2] = offx;
-			font_buffer[4*(tris+3)+3] = offy;
-			font_buffer[4*(tris+4)+0] = xp + w;
-			font_buffer[4*(tris+4)+1] = yp;
-			font_buffer[4*(tris+4)+2] = offx + offw;
-			font_buffer[4*(tris+4)+3] = offy + offh;
-			font_buffer[4*(tris+5)+0] = xp + w;
-			font_buffer[4*(tris+5)+1] = yp + h;
-			font_buffer[4*(tris+5)+2] = offx + offw;
-			font_buffer[4*(tris+5)+3] = offy;
-
-			tris += 6;
-			++chars;
-
-			if (chars >= S_GLYPH_BUFFER_SIZE)
-			{
-				++i;
-				break;
-			}
-		}
-
-		if (tris > 0)
-		{
-			_S_GL(glBufferSubData(GL_ARRAY_BUFFER, 0,
-			                      tris * 4 * sizeof(Sfloat), font_buffer));
-			_S_GL(glDrawArrays(GL_TRIANGLES, 0, tris));
-		}
-
-		if (i >= len)
-			break;
-
-		tris = 0;
-		chars = 0;
+		_S_SET_ERROR(S_INVALID_VALUE, "S_draw_textmesh_2d");
+		return;
 	}
-
-	_S_GL(glBindBuffer(GL_ARRAY_BUFFER, 0));
-	_S_GL(glBindVertexArray(0));
-	_S_GL(glBindTexture(GL_TEXTURE_2D, 0));
-	_S_GL(glEnable(GL_DEPTH_TEST));
+	if (!window->cam || mesh->count == 0)
+		return;
+	/* lay the text out again if any of its glyphs were evicted */
+	_S_CALL("_S_textmesh_refresh", _S_textmesh_refresh(mesh));
+	_S_CALL("_S_draw_text_begin", _S_draw_text_begin(window, mesh->font));
+	_S_font_touch(mesh->font, mesh->pages);
+	_S_CALL("_S_font_upload", _S_font_upload(mesh->font));
+	_S_glstate_bind_vertex_array(mesh->vao);
+	_S_GL(glDrawArrays(GL_TRIANGLES, 0, mesh->count * 6));
 }
 
 void
@@ -560,11 +922,92 @@ S_draw_model(const Swindow *window,
 	}
 	if (model->mesh && model->mat && model->shader && model->mat->assigned > 0)
 	{
-		/* TODO: Implement batch calls for shader, texture and mesh. */
+		/* batching across models is left to the render queue */
+		_S_glstate_enable(GL_DEPTH_TEST);
 		_S_shader_attach(model->shader);
 		_S_material_attach(model->mat); /* TODO: Texture order. */
-		_S_mesh_draw(model->mesh, S_MESH_TRIANGLES);
+		_S_mesh_draw_lod(model->mesh, S_MESH_TRIANGLES, model->lod);
+	}
+}
+
+void
+S_draw_model_instanced(const Swindow *window,
+                       const Smodel *model,
+                       const Smat4 *transforms,
+                       const Svec4 *colors,
+                       const Svec4 *data,
+                       Suint32 count)
+{
+	if (!window || !model || !transforms)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_draw_model_instanced");
+		return;
+	}
+	if (count > 0 && model->mesh && model->mat && model->shader &&
+	    model->mat->assigned > 0)
+	{
+		_S_glstate_enable(GL_DEPTH_TEST);
+		_S_shader_attach(model->shader);
+		_S_material_attach(model->mat);
+		_S_CALL("_S_draw_instances",
+		        _S_draw_instances(model->mesh, model->lod, transforms,
+		                          colors, data, count));
+	}
+}
+
+void
+_S_draw_instances(Smesh *mesh,
+                  Suint32 lod,
+                  const Smat4 *transforms,
+                  const Svec4 *colors,
+                  const Svec4 *data,
+                  Suint32 count)
+{
+	Suint32 i;
+	if (!mesh || !transforms)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "_S_draw_instances");
+		return;
+	}
+	if (count == 0 || vboinstance == 0)
+		return;
+	if (instancecap == 0)
+	{
+		instancecap = count > INSTANCES_MIN ? count : INSTANCES_MIN;
+		instances = (_Sdraw_instance *)
+			S_memory_new(sizeof(_Sdraw_instance) * instancecap);
+	}
+	else if (count > instancecap)
+	{
+		while (count > instancecap)
+			instancecap *= 2;
+		instances = (_Sdraw_instance *)
+			S_memory_resize(instances, sizeof(_Sdraw_instance) * instancecap);
+	}
+	for (i = 0; i < count; ++i)
+	{
+		instances[i].transform = transforms[i];
+		if (colors)
+			instances[i].color = colors[i];
+		else
+		{
+			_S_CALL("S_vec4_fill", S_vec4_fill(&instances[i].color, 1.0f));
+		}
+		if (data)
+			instances[i].data = data[i];
+		else
+		{
+			_S_CALL("S_vec4_zero", S_vec4_zero(&instances[i].data));
+		}
 	}
+	_S_CALL("_S_draw_bind_instances", _S_draw_bind_instances(mesh));
+	/* orphan the previous contents so that the upload does not wait on draws
+	   still reading them */
+	_S_glstate_bind_buffer(GL_ARRAY_BUFFER, vboinstance);
+	_S_GL(glBufferData(GL_ARRAY_BUFFER, sizeof(_Sdraw_instance) * count,
+	                   instances, GL_STREAM_DRAW));
+	_S_CALL("_S_mesh_draw_instanced",
+	        _S_mesh_draw_instanced(mesh, S_MESH_TRIANGLES, lod, count));
 }
 
 void
@@ -11,28 +11,75 @@
  * Date created : 19/04/2021
  */
 
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include "sticky/algorithm/qsort.h"
+#include "sticky/algorithm/skyline.h"
 #include "sticky/common/error.h"
 #include "sticky/common/includes.h"
 #include "sticky/common/types.h"
 #include "sticky/math/math.h"
 #include "sticky/math/vec2.h"
 #include "sticky/memory/allocator.h"
+#include "sticky/util/fileio.h"
+#include "sticky/util/hash.h"
 #include "sticky/video/font.h"
+#include "sticky/video/glstate.h"
 
 /*#define STB_IMAGE_WRITE_IMPLEMENTATION
 #include <stb/stb_image_write.h>*/
 
-typedef struct _Stexture_node_s
+#define FONT_TABLE_SIZE   256        /* initial size of the glyph hash table */
+#define FONT_REPLACEMENT  0xfffd     /* drawn in place of invalid UTF-8 */
+#define FONT_FILE_MAGIC   0x43465453 /* "STFC" */
+#define FONT_FILE_VERSION 1
+#define FONT_LAYOUTS      64         /* cached layouts per font */
+#define FONT_LAYOUT_WAYS  4          /* layouts searched per lookup */
+
+/* a page of the atlas, packed until it is full and then cleared whole once it
+   is the least recently drawn */
+typedef struct _Sfont_page_s
+{
+	Sskyline *packer;
+	Suint8 *pixels;
+	Suint32 stamp;
+	Suint32 x0, y0, x1, y1; /* rectangle waiting to be uploaded */
+	Sbool open;
+} _Sfont_page;
+
+typedef struct _Sfont_cache_s
+{
+	FT_Face face;
+	_Sglyph *glyphs;
+	Suint32 *table; /* index of a glyph plus one, or 0 if empty */
+	Ssize_t nglyphs, glyphcap, tablecap;
+	_Sfont_page pages[S_FONT_PAGES];
+	_Stextlayout layouts[FONT_LAYOUTS];
+	Suint32 tick, generation, layout_tick;
+	Sfloat pixel_size, line_height;
+} _Sfont_cache;
+
+typedef struct _Sfont_order_s
 {
-	Schar id;
-	Suint32 xorigin, yorigin, xsize, ysize;
-	Sbool empty;
-	struct _Stexture_node_s *left, *right;
-} _Stexture_node;
+	Suint32 codepoint;
+	FT_Pos height;
+} _Sfont_order;
+
+/* the start of a font cache file, written in the byte order of the machine */
+typedef struct _Sfont_file_header_s
+{
+	Suint32 magic, version;
+	Suint32 page_size, pages, glyph_size;
+	Suint32 face, sdf, nglyphs;
+	Sfloat pixel_size;
+} _Sfont_file_header;
+
+/* FreeType renders distance fields from version 2.11 */
+#if FREETYPE_MAJOR > 2 || (FREETYPE_MAJOR == 2 && FREETYPE_MINOR >= 11)
+#define FONT_HAS_SDF 1
+#endif /* FREETYPE_MAJOR */
 
 static FT_Library font_library;
 static Sbool init;
@@ -50,6 +97,11 @@ _S_font_init(Suint8 gl_maj,
 	init = S_TRUE;
 	if ((i = FT_Init_FreeType(&font_library)) != 0)
 		_S_error_freetype("Failed to init FreeType.", i);
+#ifdef FONT_HAS_SDF
+	i = S_FONT_SDF_SPREAD;
+	FT_Property_Set(font_library, "sdf", "spread", &i);
+	FT_Property_Set(font_library, "bsdf", "spread", &i);
+#endif /* FONT_HAS_SDF */
 }
 
 void
@@ -65,361 +117,859 @@ Scomparator
 _S_font_comparator(const void *p1,
                    const void *p2)
 {
-	_Sglyph *a, *b;
-	Suint32 acond, bcond;
+	_Sfont_order *a, *b;
 
-	a = (_Sglyph *) p1;
-	b = (_Sglyph *) p2;
-	acond = a->xtexsize * a->ytexsize;
-	bcond = b->xtexsize * b->ytexsize;
+	a = (_Sfont_order *) p1;
+	b = (_Sfont_order *) p2;
 
-	if (acond < bcond)
+	if (a->height < b->height)
 		return 1;
-	else if (acond == bcond)
+	else if (a->height == b->height)
 		return 0;
 	else
 		return -1;
 }
 
+
+/* load and rasterise a glyph into the glyph slot of the face */
+static
+FT_Error
+_S_font_render(FT_Face face,
+               Suint32 codepoint,
+               Sbool sdf)
+{
+#ifdef FONT_HAS_SDF
+	FT_Error err;
+	if (sdf)
+	{
+		if ((err = FT_Load_Char(face, codepoint, FT_LOAD_DEFAULT)) != 0)
+			return err;
+		return FT_Render_Glyph(face->glyph, FT_RENDER_MODE_SDF);
+	}
+#else /* FONT_HAS_SDF */
+	(void) sdf;
+#endif /* FONT_HAS_SDF */
+	return FT_Load_Char(face, codepoint, FT_LOAD_RENDER);
+}
+
 static
 void
-_S_font_destroy_packing_tree(_Stexture_node *root)
+_S_font_dirty(_Sfont_page *page,
+              Suint32 x0,
+              Suint32 y0,
+              Suint32 x1,
+              Suint32 y1)
 {
-	if (!root)
+	if (page->x0 >= page->x1)
+	{
+		page->x0 = x0;
+		page->y0 = y0;
+		page->x1 = x1;
+		page->y1 = y1;
 		return;
-	_S_CALL("_S_font_destroy_packing_tree",
-	        _S_font_destroy_packing_tree(root->left));
-	_S_CALL("_S_font_destroy_packing_tree",
-	        _S_font_destroy_packing_tree(root->right));
-	S_memory_delete(root);
+	}
+	page->x0 = S_min(page->x0, x0);
+	page->y0 = S_min(page->y0, y0);
+	page->x1 = S_max(page->x1, x1);
+	page->y1 = S_max(page->y1, y1);
 }
 
 static
-_Stexture_node *
-_S_font_find_glyph(_Stexture_node *root,
-                   Schar id)
+_Sglyph *
+_S_font_lookup(const _Sfont_cache *cache,
+               Suint32 codepoint)
 {
-	_Stexture_node *child;
-	if (!root)
-		return NULL;
-	if (root->id == id)
-		return root;
-	_S_CALL("_S_font_find_glyph", child = _S_font_find_glyph(root->left, id));
-	if (!child)
+	Ssize_t slot, mask;
+	Suint32 entry;
+	mask = cache->tablecap - 1;
+	slot = S_hash_fnv1a(&codepoint, sizeof(codepoint)) & mask;
+	while ((entry = cache->table[slot]) != 0)
+	{
+		if (cache->glyphs[entry-1].codepoint == codepoint)
+			return cache->glyphs + entry - 1;
+		slot = (slot + 1) & mask;
+	}
+	return NULL;
+}
+
+static
+void
+_S_font_insert(_Sfont_cache *cache,
+               Ssize_t index)
+{
+	Ssize_t slot, mask;
+	mask = cache->tablecap - 1;
+	slot = S_hash_fnv1a(&cache->glyphs[index].codepoint,
+	                    sizeof(Suint32)) & mask;
+	while (cache->table[slot] != 0)
+		slot = (slot + 1) & mask;
+	cache->table[slot] = index + 1;
+}
+
+/* rebuild the hash table from the glyph array at a given power of two size */
+static
+void
+_S_font_rehash(_Sfont_cache *cache,
+               Ssize_t cap)
+{
+	Ssize_t i;
+	if (cap != cache->tablecap)
+	{
+		S_memory_delete(cache->table);
+		cache->table = (Suint32 *) S_memory_new(cap * sizeof(Suint32));
+		cache->tablecap = cap;
+	}
+	memset(cache->table, 0, cap * sizeof(Suint32));
+	for (i = 0; i < cache->nglyphs; ++i)
+		_S_font_insert(cache, i);
+}
+
+static
+void
+_S_font_open_page(_Sfont_page *page)
+{
+	page->packer = S_skyline_new(S_FONT_PAGE_SIZE, S_FONT_PAGE_SIZE);
+	page->pixels = (Suint8 *) S_memory_new(S_FONT_PAGE_SIZE *
+	                                       S_FONT_PAGE_SIZE);
+	memset(page->pixels, 0, S_FONT_PAGE_SIZE * S_FONT_PAGE_SIZE);
+	page->open = S_TRUE;
+	/* the texture starts undefined, so upload the empty page once */
+	_S_font_dirty(page, 0, 0, S_FONT_PAGE_SIZE, S_FONT_PAGE_SIZE);
+}
+
+/* drop every glyph on a page and clear it to be packed again */
+static
+void
+_S_font_evict(_Sfont_cache *cache,
+              Suint32 index)
+{
+	_Sfont_page *page;
+	Ssize_t i, kept;
+	page = cache->pages + index;
+	kept = 0;
+	for (i = 0; i < cache->nglyphs; ++i)
 	{
-		_S_CALL("_S_font_find_glyph",
-		        child = _S_font_find_glyph(root->right, id));
+		if (cache->glyphs[i].page == index && cache->glyphs[i].size.x > 0.0f)
+			continue;
+		cache->glyphs[kept++] = cache->glyphs[i];
 	}
-	return child;
+	cache->nglyphs = kept;
+	_S_CALL("_S_font_rehash", _S_font_rehash(cache, cache->tablecap));
+	_S_CALL("S_skyline_clear", S_skyline_clear(page->packer));
+	memset(page->pixels, 0, S_FONT_PAGE_SIZE * S_FONT_PAGE_SIZE);
+	_S_font_dirty(page, 0, 0, S_FONT_PAGE_SIZE, S_FONT_PAGE_SIZE);
+	++cache->generation;
 }
 
+/* find room for a glyph, first on the open pages, then on a new page and
+   finally by evicting the least recently drawn page which is not waiting to be
+   drawn */
 static
-_Stexture_node *
-_S_font_pack_texture(_Stexture_node *node,
-                     Schar id,
-                     Suint32 xsize,
-                     Suint32 ysize,
-                     Suint32 xtexsize,
-                     Suint32 ytexsize)
-{
-	_Stexture_node *n, *left, *right, *tmp;
-	Suint32 xs, ys;
-	Sint32 rx, ry;
-	Sbool vsplit;
-
-	if (!node || !node->empty)
-	{
-		/* node already full, do nothing */
+Sbool
+_S_font_place(_Sfont_cache *cache,
+              Suint32 xsize,
+              Suint32 ysize,
+              Suint32 *index,
+              Suint32 *x,
+              Suint32 *y)
+{
+	Suint32 i, lru;
+	Sbool packed;
+	for (i = 0; i < S_FONT_PAGES; ++i)
+	{
+		if (!cache->pages[i].open)
+		{
+			_S_CALL("_S_font_open_page",
+			        _S_font_open_page(cache->pages + i));
+		}
+		_S_CALL("S_skyline_pack",
+		        packed = S_skyline_pack(cache->pages[i].packer,
+		                                xsize, ysize, x, y));
+		if (packed)
+		{
+			*index = i;
+			return S_TRUE;
+		}
+	}
+	lru = S_FONT_PAGES;
+	for (i = 0; i < S_FONT_PAGES; ++i)
+	{
+		if (cache->pages[i].stamp == cache->tick)
+			continue;
+		if (lru == S_FONT_PAGES ||
+		    cache->tick - cache->pages[i].stamp >
+		    cache->tick - cache->pages[lru].stamp)
+			lru = i;
+	}
+	if (lru == S_FONT_PAGES)
+		return S_FALSE;
+	_S_CALL("_S_font_evict", _S_font_evict(cache, lru));
+	*index = lru;
+	_S_CALL("S_skyline_pack",
+	        packed = S_skyline_pack(cache->pages[lru].packer,
+	                                xsize, ysize, x, y));
+	return packed;
+}
+
+static
+const _Sglyph *
+_S_font_cache_glyph(const Sfont *font,
+                    Suint32 codepoint)
+{
+	_Sfont_cache *cache;
+	_Sfont_page *page;
+	_Sglyph glyph;
+	FT_GlyphSlot slot;
+	Suint32 w, h, row, index, x, y;
+	Sbool placed;
+	cache = font->cache;
+	slot = cache->face->glyph;
+	glyph.codepoint = codepoint;
+	glyph.page = 0;
+	S_vec2_zero(&glyph.size);
+	S_vec2_zero(&glyph.offset);
+	glyph.xbearing = 0;
+	glyph.ybearing = 0;
+	glyph.xadvance = 0;
+	glyph.yadvance = 0;
+	if (_S_font_render(cache->face, codepoint, font->sdf) != 0)
+	{
+		S_warning("Failed to load glyph U+%04X.\n", codepoint);
+		goto l_store;
+	}
+	glyph.xbearing = slot->bitmap_left;
+	glyph.ybearing = slot->bitmap_top;
+	glyph.xadvance = slot->advance.x >> 6;
+	glyph.yadvance = slot->advance.y >> 6;
+	w = slot->bitmap.width;
+	h = slot->bitmap.rows;
+	if (w == 0 || h == 0)
+		goto l_store; /* nothing to draw, such as a space */
+	if (w + 1 > S_FONT_PAGE_SIZE || h + 1 > S_FONT_PAGE_SIZE)
+	{
+		S_warning("Glyph U+%04X is larger than a font page.\n", codepoint);
+		goto l_store;
+	}
+	/* leave a texel between glyphs so that filtering never reads a
+	   neighbour */
+	_S_CALL("_S_font_place",
+	        placed = _S_font_place(cache, w + 1, h + 1, &index, &x, &y));
+	if (!placed)
 		return NULL;
+	page = cache->pages + index;
+	for (row = 0; row < h; ++row)
+	{
+		memcpy(page->pixels + (y + row) * S_FONT_PAGE_SIZE + x,
+		       slot->bitmap.buffer + row * slot->bitmap.pitch, w);
 	}
-	else if (node->left && node->right)
-	{
-		/* not a leaf, try left insert, then right */
-		_S_CALL("_S_font_pack_texture",
-		n = _S_font_pack_texture(node->left, id,
-		                         xsize, ysize,
-		                         xtexsize, ytexsize));
-		if (n)
-			return n;
-		_S_CALL("_S_font_pack_texture",
-		tmp =  _S_font_pack_texture(node->right, id,
-		                            xsize, ysize,
-		                            xtexsize, ytexsize));
-		return tmp;
+	_S_font_dirty(page, x, y, x + w, y + h);
+	page->stamp = cache->tick;
+	glyph.page = index;
+	S_vec2_set(&glyph.size, w, h);
+	S_vec2_set(&glyph.offset,
+	           x / (Sfloat) S_FONT_PAGE_SIZE,
+	           y / (Sfloat) S_FONT_PAGE_SIZE);
+l_store:
+	if (cache->nglyphs == cache->glyphcap)
+	{
+		cache->glyphcap *= 2;
+		cache->glyphs = (_Sglyph *) S_memory_resize(cache->glyphs,
+		                                            cache->glyphcap *
+		                                            sizeof(_Sglyph));
+	}
+	cache->glyphs[cache->nglyphs++] = glyph;
+	/* keep the table at most half full */
+	if (cache->nglyphs * 2 > cache->tablecap)
+	{
+		_S_CALL("_S_font_rehash",
+		        _S_font_rehash(cache, cache->tablecap * 2));
 	}
 	else
 	{
-		/* leaf ready to be packed */
-		xs = node->xsize;
-		ys = node->ysize;
+		_S_font_insert(cache, cache->nglyphs - 1);
+	}
+	return cache->glyphs + cache->nglyphs - 1;
+}
+
+/* lay text out from the origin along its baseline, breaking lines at newlines
+   and, if wrap is positive, at the last space before the pen passes wrap */
+static
+void
+_S_font_layout_build(const Sfont *font,
+                     _Stextlayout *layout,
+                     const Schar *text,
+                     Ssize_t len,
+                     Sfloat scale,
+                     Sfloat wrap)
+{
+	_Stextlayout_glyph *out;
+	const _Sglyph *glyph;
+	Ssize_t i, k, count, start, space;
+	Sfloat x, y, lh, shift, xp, yp, left, right, bottom, top;
+	Suint32 codepoint;
+	Sbool spaced, measured;
 
-		/* if on a boundary, calculate the actual size */
-		if (node->xorigin + node->xsize == S_UINT32_MAX)
-			xs = xtexsize - node->xorigin;
-		if (node->yorigin + node->ysize == S_UINT32_MAX)
-			ys = ytexsize - node->yorigin;
+	if (len > layout->cap)
+	{
+		/* there is never more than one glyph per char */
+		if (layout->glyphs)
+		{
+			S_memory_delete(layout->glyphs);
+			S_memory_delete(layout->text);
+		}
+		layout->cap = len;
+		layout->glyphs = (_Stextlayout_glyph *)
+		                 S_memory_new(len * sizeof(_Stextlayout_glyph));
+		layout->text = (Schar *) S_memory_new(len);
+	}
+	if (len > 0)
+		memcpy(layout->text, text, len);
+	layout->len = len;
+	layout->scale = scale;
+	layout->wrap = wrap;
+	layout->lines = 1;
+	layout->valid = S_TRUE;
 
-		if (node->xsize == xsize && node->ysize == ysize)
+	lh = font->cache->line_height * scale;
+	x = y = 0.0f;
+	count = start = space = 0;
+	spaced = S_FALSE;
+	for (i = 0; i < len;)
+	{
+		codepoint = _S_font_next_codepoint(text, len, &i);
+		if (codepoint == '\n')
 		{
-			/* size is exact, pack directly */
-			node->empty = S_FALSE;
-			return node;
+			x = 0.0f;
+			y -= lh;
+			++layout->lines;
+			start = count;
+			spaced = S_FALSE;
+			continue;
 		}
-		else if (xs < xsize || ys < ysize)
+		_S_CALL("_S_font_get_glyph",
+		        glyph = _S_font_get_glyph(font, codepoint));
+		if (!glyph)
 		{
-			/* node not big enough */
-			return NULL;
+			/* the metrics are unknown, so the layout may not be kept */
+			layout->valid = S_FALSE;
+			continue;
 		}
-		else
+		if (wrap > 0.0f && codepoint != ' ' && count > start &&
+		    x + glyph->xadvance * scale > wrap)
 		{
-			/* node is large enough but needs splitting */
-			rx = xs - xsize;
-			ry = ys - ysize;
-			vsplit = rx < ry;
-
-			/* split whichever way leaves the most room */
-			if (rx == 0 && ry == 0)
-				vsplit = node->xsize <= node->ysize;
-
-			left = (_Stexture_node *) S_memory_new(sizeof(_Stexture_node));
-			right = (_Stexture_node *) S_memory_new(sizeof(_Stexture_node));
-			left->id = 0;
-			left->empty = S_TRUE;
-			left->left = NULL;
-			left->right = NULL;
-			right->id = 0;
-			right->empty = S_TRUE;
-			right->left = NULL;
-			right->right = NULL;
-			if (vsplit)
+			if (spaced)
 			{
-				/* split vertically (left is top) */
-				left->xorigin = node->xorigin;
-				left->yorigin = node->yorigin;
-				left->xsize = node->xsize;
-				left->ysize = ysize;
-				right->xorigin = node->xorigin;
-				right->yorigin = node->yorigin + ysize;
-				right->xsize = node->xsize;
-				right->ysize = node->ysize - ysize;
+				/* move the word after the last space to the next line */
+				shift = space + 1 < count ? layout->glyphs[space+1].x : x;
+				for (k = space + 1; k < count; ++k)
+				{
+					layout->glyphs[k].x -= shift;
+					layout->glyphs[k].y -= lh;
+				}
+				x -= shift;
+				start = space + 1;
 			}
 			else
 			{
-				/* split horizontally */
-				left->xorigin = node->xorigin;
-				left->yorigin = node->yorigin;
-				left->xsize = xsize;
-				left->ysize = node->ysize;
-				right->xorigin = node->xorigin + xsize;
-				right->yorigin = node->yorigin;
-				right->xsize = node->xsize - xsize;
-				right->ysize = node->ysize;
+				x = 0.0f;
+				start = count;
 			}
-			node->left = left;
-			node->right = right;
-			node->id = id;
-			_S_CALL("_S_font_pack_texture",
-			tmp = _S_font_pack_texture(node->left, id,
-			                           xsize, ysize,
-			                           xtexsize, ytexsize));
-			return tmp;
+			y -= lh;
+			++layout->lines;
+			spaced = S_FALSE;
+		}
+		out = layout->glyphs + count++;
+		out->codepoint = codepoint;
+		out->x = x;
+		out->y = y;
+		x += glyph->xadvance * scale;
+		y += glyph->yadvance * scale;
+		if (codepoint == ' ')
+		{
+			space = count - 1;
+			spaced = S_TRUE;
 		}
 	}
+	layout->count = count;
+
+	/* measure the extents of the glyphs where they were placed */
+	left = bottom = 0.0f;
+	right = top = 0.0f;
+	measured = S_FALSE;
+	for (i = 0; i < count; ++i)
+	{
+		_S_CALL("_S_font_get_glyph",
+		        glyph = _S_font_get_glyph(font, layout->glyphs[i].codepoint));
+		if (!glyph || glyph->size.x == 0.0f || glyph->size.y == 0.0f)
+			continue; /* skip empty glyphs */
+		xp = layout->glyphs[i].x + glyph->xbearing * scale;
+		yp = layout->glyphs[i].y - (glyph->size.y - glyph->ybearing) * scale;
+		if (!measured)
+		{
+			left = right = xp;
+			bottom = top = yp;
+			measured = S_TRUE;
+		}
+		left = S_min(left, xp);
+		bottom = S_min(bottom, yp);
+		right = S_max(right, xp + glyph->size.x * scale);
+		top = S_max(top, yp + glyph->size.y * scale);
+	}
+	layout->xoff = left;
+	layout->yoff = bottom;
+	layout->width = right;
+	layout->height = top - bottom;
 }
 
+/* open the face and create an empty font and atlas */
+static
 Sfont *
-S_font_load(const Schar *filename,
-            Sfloat pixel_size)
+_S_font_new(const Schar *filename,
+            Sfloat pixel_size,
+            Sbool sdf)
 {
-	Suint32 width, height, resizes;
-	Sint16 c;
-	_Sglyph *glyph, glyphs[S_GLYPH_NUM];
-	_Stexture_node *root, *node;
-	Suint32 xglyph_size, yglyph_size, xtexsize, ytexsize;
+	_Sfont_cache *cache;
+	FT_Face face;
+	Sfont *font;
+	Sint32 err;
+
+	if ((err = FT_New_Face(font_library, filename, 0, &face)) != 0)
+		_S_error_freetype("Failed to create font face.", err);
+	if ((err = FT_Set_Char_Size(face, 0, 64 * pixel_size, 0, 0)) != 0)
+		_S_error_freetype("Failed to set font size.", err);
+
+	font = (Sfont *) S_memory_new(sizeof(Sfont));
+	font->width = S_FONT_PAGE_SIZE;
+	font->height = S_FONT_PAGE_SIZE;
+	font->sdf = sdf;
+
+	cache = (_Sfont_cache *) S_memory_new(sizeof(_Sfont_cache));
+	memset(cache, 0, sizeof(_Sfont_cache));
+	cache->face = face;
+	cache->pixel_size = pixel_size;
+	cache->line_height = face->size->metrics.height / 64.0f;
+	cache->glyphcap = S_GLYPH_NUM;
+	cache->glyphs = (_Sglyph *) S_memory_new(cache->glyphcap *
+	                                         sizeof(_Sglyph));
+	cache->tablecap = FONT_TABLE_SIZE;
+	cache->table = (Suint32 *) S_memory_new(cache->tablecap *
+	                                        sizeof(Suint32));
+	memset(cache->table, 0, cache->tablecap * sizeof(Suint32));
+	font->cache = cache;
+
+	/* generate the texture atlas */
+	_S_GL(glGenTextures(1, &font->texture));
+	_S_glstate_bind_texture(GL_TEXTURE_2D_ARRAY, font->texture);
+	_S_GL(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S,
+	                      GL_CLAMP_TO_EDGE));
+	_S_GL(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T,
+	                      GL_CLAMP_TO_EDGE));
+	_S_GL(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER,
+	                      GL_LINEAR));
+	_S_GL(glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER,
+	                      GL_LINEAR));
+	_S_GL(glTexImage3D(GL_TEXTURE_2D_ARRAY, 0, GL_R8,
+	                   S_FONT_PAGE_SIZE, S_FONT_PAGE_SIZE, S_FONT_PAGES,
+	                   0, GL_RED, GL_UNSIGNED_BYTE, NULL));
+
+	return font;
+}
+
+static
+Sfont *
+_S_font_load(const Schar *filename,
+             Sfloat pixel_size,
+             Sbool sdf)
+{
+	_Sfont_order order[S_GLYPH_NUM];
 	FT_Face face;
 	Sfont *font;
 	Sint32 i;
 
-	if (!filename || pixel_size <= 0.0f)
+	_S_CALL("_S_font_new", font = _S_font_new(filename, pixel_size, sdf));
+	face = font->cache->face;
+
+	/* preload the printable ASCII range, tallest first so that it packs
+	   tightly */
+	for (i = 0; i < S_GLYPH_NUM; ++i)
 	{
-		_S_SET_ERROR(S_INVALID_VALUE, "S_font_load");
-		return NULL;
+		order[i].codepoint = S_GLYPH_BEGIN + i;
+		order[i].height = 0;
+		if (FT_Load_Char(face, order[i].codepoint, FT_LOAD_DEFAULT) == 0)
+			order[i].height = face->glyph->metrics.height;
 	}
+	_S_CALL("S_qsort",
+	        S_qsort(order, S_GLYPH_NUM, sizeof(_Sfont_order),
+	                _S_font_comparator));
+	for (i = 0; i < S_GLYPH_NUM; ++i)
+	{
+		_S_CALL("_S_font_get_glyph",
+		        _S_font_get_glyph(font, order[i].codepoint));
+	}
+	_S_CALL("_S_font_upload", _S_font_upload(font));
 
-	if ((i = FT_New_Face(font_library, filename, 0, &face)) != 0)
-		_S_error_freetype("Failed to create font face.", i);
-	if ((i = FT_Set_Char_Size(face, 0, 64 * pixel_size, 0, 0)) != 0)
-		_S_error_freetype("Failed to set font size.", i);
+	return font;
+}
 
-	font = (Sfont *) S_memory_new(sizeof(Sfont));
-	/*memset(font->glyphs, 0, S_GLYPH_NUM * sizeof(_Sglyph));*/
-
-	root = (_Stexture_node *) S_memory_new(sizeof(_Stexture_node));
-	root->left = NULL;
-	root->right = NULL;
-	root->id = -1;
-	root->xorigin = 0;
-	root->yorigin = 0;
-	root->xsize = S_UINT32_MAX;
-	root->ysize = S_UINT32_MAX;
-	root->empty = S_TRUE;
-
-	xtexsize = pixel_size;
-	ytexsize = pixel_size;
-	node = NULL;
-
-	/* load glyph sizes and sort */
-	for (c = S_GLYPH_BEGIN; c < S_GLYPH_END; ++c)
-	{
-		glyph = glyphs+c-S_GLYPH_BEGIN;
-		if (FT_Load_Char(face, c, FT_LOAD_RENDER))
-		{
-			S_warning("Failed to load glyph '%c'.", c);
-			glyph->fail = S_TRUE;
-			continue;
-		}
-		glyph->id = c;
-		glyph->xtexsize = face->glyph->bitmap.width;
-		glyph->ytexsize = face->glyph->bitmap.rows;
-		glyph->fail = S_FALSE;
+/* identify a face so that a cache file is not used with another font */
+static
+Suint32
+_S_font_face_hash(FT_Face face)
+{
+	Suint32 hash;
+	hash = (Suint32) face->num_glyphs;
+	if (face->family_name)
+		hash ^= S_hash_fnv1a_string(face->family_name);
+	if (face->style_name)
+		hash = hash * 16777619u ^ S_hash_fnv1a_string(face->style_name);
+	return hash;
+}
+
+/* the number of rows of a page holding any pixels */
+static
+Suint32
+_S_font_page_rows(const _Sfont_page *page)
+{
+	Ssize_t i;
+	Suint32 rows;
+	rows = 0;
+	for (i = 0; i < page->packer->len; ++i)
+		rows = S_max(rows, page->packer->nodes[i].y);
+	return rows;
+}
+
+static
+Sbool
+_S_font_write(FILE *fp,
+              const void *src,
+              Ssize_t size)
+{
+	return size == 0 || fwrite(src, size, 1, fp) == 1;
+}
+
+/* copy the next size bytes of a cache file, or fail if it is too short */
+static
+Sbool
+_S_font_read(const Schar **cursor,
+             const Schar *end,
+             void *dest,
+             Ssize_t size)
+{
+	if ((Ssize_t) (end - *cursor) < size)
+		return S_FALSE;
+	memcpy(dest, *cursor, size);
+	*cursor += size;
+	return S_TRUE;
+}
+
+/* whether a glyph read from a cache file lies within its page */
+static
+Sbool
+_S_font_check_glyph(const _Sglyph *glyph)
+{
+	Sfloat x, y;
+	if (glyph->page >= S_FONT_PAGES ||
+	    !(glyph->size.x >= 0.0f && glyph->size.x < S_FONT_PAGE_SIZE) ||
+	    !(glyph->size.y >= 0.0f && glyph->size.y < S_FONT_PAGE_SIZE))
+		return S_FALSE;
+	if (glyph->size.x == 0.0f || glyph->size.y == 0.0f)
+		return S_TRUE;
+	x = glyph->offset.x * S_FONT_PAGE_SIZE;
+	y = glyph->offset.y * S_FONT_PAGE_SIZE;
+	return x >= 0.0f && y >= 0.0f &&
+	       x + glyph->size.x <= S_FONT_PAGE_SIZE &&
+	       y + glyph->size.y <= S_FONT_PAGE_SIZE;
+}
+
+/* whether the skyline read from a cache file spans the page without gaps,
+   which the packer relies on to never run off the end of its nodes */
+static
+Sbool
+_S_font_check_packer(const Sskyline *packer)
+{
+	Ssize_t i;
+	Suint32 x;
+	x = 0;
+	for (i = 0; i < packer->len; ++i)
+	{
+		if (packer->nodes[i].x != x || packer->nodes[i].width == 0 ||
+		    packer->nodes[i].width > S_FONT_PAGE_SIZE - x ||
+		    packer->nodes[i].y > S_FONT_PAGE_SIZE)
+			return S_FALSE;
+		x += packer->nodes[i].width;
 	}
-	_S_CALL("S_qsort",
-	        S_qsort(glyphs, S_GLYPH_NUM, sizeof(_Sglyph), _S_font_comparator));
+	return x == S_FONT_PAGE_SIZE;
+}
+
+/* restore the glyphs and pages of a cache file into an empty font */
+static
+Sbool
+_S_font_restore(Sfont *font,
+                const _Sfont_file_header *header,
+                const Schar *cursor,
+                const Schar *end)
+{
+	_Sfont_cache *cache;
+	_Sfont_page *page;
+	Sskyline *packer;
+	Suint32 i, open, len, rows;
+	Ssize_t cap;
+	cache = font->cache;
+	/* never size the glyphs by a count the file is too short to hold */
+	if ((Ssize_t) (end - cursor) / sizeof(_Sglyph) < header->nglyphs)
+		return S_FALSE;
+	if (header->nglyphs > cache->glyphcap)
+	{
+		cache->glyphcap = header->nglyphs;
+		cache->glyphs = (_Sglyph *) S_memory_resize(cache->glyphs,
+		                                            cache->glyphcap *
+		                                            sizeof(_Sglyph));
+	}
+	if (!_S_font_read(&cursor, end, cache->glyphs,
+	                  header->nglyphs * sizeof(_Sglyph)))
+		return S_FALSE;
+	cache->nglyphs = header->nglyphs;
+	for (i = 0; i < cache->nglyphs; ++i)
+	{
+		if (!_S_font_check_glyph(cache->glyphs + i))
+			return S_FALSE;
+	}
+	/* keep the table at most half full */
+	cap = FONT_TABLE_SIZE;
+	while (cache->nglyphs * 2 > cap)
+		cap *= 2;
+	_S_CALL("_S_font_rehash", _S_font_rehash(cache, cap));
 
-	width = height = 0;
-	/* pre-pack glyph positions */
-	for (c = S_GLYPH_BEGIN; c < S_GLYPH_END; ++c)
+	for (i = 0; i < S_FONT_PAGES; ++i)
 	{
-		glyph = glyphs+c-S_GLYPH_BEGIN;
-		if (glyphs->fail)
+		page = cache->pages + i;
+		if (!_S_font_read(&cursor, end, &open, sizeof(open)))
+			return S_FALSE;
+		if (!open)
 			continue;
-		xglyph_size = glyph->xtexsize + 1;
-		yglyph_size = glyph->ytexsize + 1;
-		resizes = 0;
-		while (resizes * 2 < pixel_size)
-		{
-			if (xglyph_size == 0 || yglyph_size == 0)
-				break;
-			_S_CALL("_S_font_pack_texture",
-			node = _S_font_pack_texture(root, glyph->id,
-			                            xglyph_size, yglyph_size,
-			                            xtexsize, ytexsize));
-			if (node)
-				break;
-			xtexsize = xtexsize + (pixel_size/2);
-			ytexsize = ytexsize + (pixel_size/2);
-			++resizes;
-		}
-		if (node)
+		_S_CALL("_S_font_open_page", _S_font_open_page(page));
+		packer = page->packer;
+		if (!_S_font_read(&cursor, end, &len, sizeof(len)) ||
+		    len == 0 || len > S_FONT_PAGE_SIZE)
+			return S_FALSE;
+		if (len > packer->cap)
 		{
-			width = S_imax(width, node->xorigin + node->xsize);
-			height = S_imax(height, node->yorigin + node->ysize);
+			packer->cap = len;
+			packer->nodes = (Sskyline_node *)
+			                S_memory_resize(packer->nodes,
+			                                len * sizeof(Sskyline_node));
 		}
+		packer->len = len;
+		if (!_S_font_read(&cursor, end, packer->nodes,
+		                  len * sizeof(Sskyline_node)) ||
+		    !_S_font_read(&cursor, end, &packer->area,
+		                  sizeof(packer->area)) ||
+		    !_S_font_check_packer(packer))
+			return S_FALSE;
+		rows = _S_font_page_rows(page);
+		if (rows > S_FONT_PAGE_SIZE ||
+		    !_S_font_read(&cursor, end, page->pixels,
+		                  rows * S_FONT_PAGE_SIZE))
+			return S_FALSE;
+	}
+	return cursor == end;
+}
+
+Sfont *
+S_font_load(const Schar *filename,
+            Sfloat pixel_size)
+{
+	Sfont *font;
+	if (!filename || pixel_size <= 0.0f)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_font_load");
+		return NULL;
 	}
+	_S_CALL("_S_font_load",
+	        font = _S_font_load(filename, pixel_size, S_FALSE));
+	return font;
+}
 
-	font->width = width;
-	font->height = height;
+Sfont *
+S_font_load_sdf(const Schar *filename,
+                Sfloat pixel_size)
+{
+	Sfont *font;
+	if (!filename || pixel_size <= 0.0f)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_font_load_sdf");
+		return NULL;
+	}
+#ifndef FONT_HAS_SDF
+	_S_SET_ERROR(S_INVALID_OPERATION, "S_font_load_sdf");
+	return NULL;
+#endif /* FONT_HAS_SDF */
+	_S_CALL("_S_font_load",
+	        font = _S_font_load(filename, pixel_size, S_TRUE));
+	return font;
+}
 
-	/* generate vbo and vao */
-	_S_GL(glGenVertexArrays(1, &font->vao));
-	_S_GL(glGenBuffers(1, &font->vbo));
+Sfont *
+S_font_load_cache(const Schar *filename,
+                  const Schar *cache_filename)
+{
+	_Sfont_file_header header;
+	const Schar *cursor, *end;
+	Schar *buf;
+	Sint64 size;
+	Sfont *font;
+	Sbool restored;
+	if (!filename || !cache_filename)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_font_load_cache");
+		return NULL;
+	}
+	_S_CALL("S_file_read_all", buf = S_file_read_all(cache_filename, &size));
+	if (!buf)
+	{
+		_S_SET_ERROR(S_IO_ERROR, "S_font_load_cache");
+		return NULL;
+	}
+	cursor = buf;
+	end = buf + size;
+	if (!_S_font_read(&cursor, end, &header, sizeof(header)) ||
+	    header.magic != FONT_FILE_MAGIC ||
+	    header.version != FONT_FILE_VERSION ||
+	    header.page_size != S_FONT_PAGE_SIZE ||
+	    header.pages != S_FONT_PAGES ||
+	    header.glyph_size != sizeof(_Sglyph) ||
+	    !(header.pixel_size > 0.0f))
+	{
+		S_memory_delete(buf);
+		_S_SET_ERROR(S_INVALID_FORMAT, "S_font_load_cache");
+		return NULL;
+	}
+#ifndef FONT_HAS_SDF
+	if (header.sdf)
+	{
+		S_memory_delete(buf);
+		_S_SET_ERROR(S_INVALID_OPERATION, "S_font_load_cache");
+		return NULL;
+	}
+#endif /* FONT_HAS_SDF */
+	_S_CALL("_S_font_new",
+	        font = _S_font_new(filename, header.pixel_size,
+	                           header.sdf ? S_TRUE : S_FALSE));
+	restored = S_FALSE;
+	if (header.face == _S_font_face_hash(font->cache->face))
+	{
+		_S_CALL("_S_font_restore",
+		        restored = _S_font_restore(font, &header, cursor, end));
+	}
+	S_memory_delete(buf);
+	if (!restored)
+	{
+		_S_CALL("S_font_delete", S_font_delete(font));
+		_S_SET_ERROR(S_INVALID_FORMAT, "S_font_load_cache");
+		return NULL;
+	}
+	_S_CALL("_S_font_upload", _S_font_upload(font));
+	return font;
+}
 
-	/* generate the texture atlas */
-	_S_GL(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
-	_S_GL(glGenTextures(1, &font->texture));
-	_S_GL(glBindTexture(GL_TEXTURE_2D, font->texture));
-	_S_GL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE));
-	_S_GL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE));
-	_S_GL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR));
-	_S_GL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR));
-	_S_GL(glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, width, height,
-	                   0, GL_RED, GL_UNSIGNED_BYTE, 0));
-
-	/* fill the atlas with glyphs */
-	for (c = S_GLYPH_BEGIN; c < S_GLYPH_END; ++c)
-	{
-		glyph = glyphs+c-S_GLYPH_BEGIN;
-		if (glyph->fail)
-			continue;
-		if (FT_Load_Char(face, glyph->id, FT_LOAD_RENDER) != 0)
+void
+S_font_save_cache(const Sfont *font,
+                  const Schar *filename)
+{
+	_Sfont_file_header header;
+	const _Sfont_cache *cache;
+	const _Sfont_page *page;
+	Suint32 i, open, len, rows;
+	FILE *fp;
+	Sbool fail;
+	if (!font || !filename)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_font_save_cache");
+		return;
+	}
+	cache = font->cache;
+	header.magic = FONT_FILE_MAGIC;
+	header.version = FONT_FILE_VERSION;
+	header.page_size = S_FONT_PAGE_SIZE;
+	header.pages = S_FONT_PAGES;
+	header.glyph_size = sizeof(_Sglyph);
+	header.face = _S_font_face_hash(cache->face);
+	header.sdf = font->sdf;
+	header.nglyphs = cache->nglyphs;
+	header.pixel_size = cache->pixel_size;
+	if (!(fp = fopen(filename, "wb")))
+	{
+		perror("fopen");
+		_S_SET_ERROR(S_IO_ERROR, "S_font_save_cache");
+		return;
+	}
+	fail = !_S_font_write(fp, &header, sizeof(header)) ||
+	       !_S_font_write(fp, cache->glyphs,
+	                      cache->nglyphs * sizeof(_Sglyph));
+	for (i = 0; i < S_FONT_PAGES && !fail; ++i)
+	{
+		page = cache->pages + i;
+		open = page->open;
+		if (!_S_font_write(fp, &open, sizeof(open)))
 		{
-			S_warning("Failed to load glyph '%c'.", glyph->id);
-			_S_CALL("S_vec2_zero", S_vec2_zero(&glyph->size));
-			glyph->xbearing = 0;
-			glyph->ybearing = 0;
-			glyph->xadvance = 0;
-			glyph->yadvance = 0;
-			glyph->fail = 1;
-			font->glyphs[glyph->id-S_GLYPH_BEGIN] = *glyph;
-			continue;
+			fail = S_TRUE;
+			break;
 		}
-
-		_S_CALL("S_vec2_set", S_vec2_set(&glyph->size,
-		                                 face->glyph->bitmap.width,
-		                                 face->glyph->bitmap.rows));
-		glyph->xbearing = face->glyph->bitmap_left;
-		glyph->ybearing = face->glyph->bitmap_top;
-		glyph->xadvance = face->glyph->advance.x >> 6;
-		glyph->yadvance = face->glyph->advance.y >> 6;
-		glyph->fail = 0;
-
-		_S_CALL("_S_font_find_glyph",
-		        node = _S_font_find_glyph(root, glyph->id));
-		if (!node)
-		{
-			S_warning("Expected glyph '%c' but was not found.", glyph->id);
+		if (!open)
 			continue;
-		}
-		S_vec2_set(&glyph->offset,
-		           node->xorigin / (Sfloat) width,
-		           node->yorigin / (Sfloat) height);
-		_S_GL(
-		glTexSubImage2D(GL_TEXTURE_2D, 0, node->xorigin, node->yorigin,
-		                glyph->xtexsize, glyph->ytexsize,
-		                GL_RED, GL_UNSIGNED_BYTE,
-		                face->glyph->bitmap.buffer)
-		);
-		font->glyphs[glyph->id-S_GLYPH_BEGIN] = *glyph;
-	}
-
-	_S_CALL("_S_font_destroy_packing_tree", _S_font_destroy_packing_tree(root));
-
-	/* quick and dirty texture extraction */
-	/*
-	_S_GL(glBindTexture(GL_TEXTURE_2D, font->texture));
-	GLubyte *data = (GLubyte *) S_memory_new(sizeof(GLubyte) * width*height*4);
-	_S_GL(glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, data));
-	stbi_write_png("texatlas.png", width, height, 4, data, width*4);
-	*/
-
-	FT_Done_Face(face);
-
-	_S_GL(glBindVertexArray(font->vao));
-	_S_GL(glBindBuffer(GL_ARRAY_BUFFER, font->vbo));
-	_S_GL(glBufferData(GL_ARRAY_BUFFER,
-	                   S_GLYPH_BUFFER_SIZE * 6 * 4 * sizeof(Sfloat),
-	                   NULL, GL_DYNAMIC_DRAW));
-	_S_GL(glEnableVertexAttribArray(0));
-	_S_GL(glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE,
-	                            4 * sizeof(Sfloat), (void *) 0));
-	_S_GL(glBindBuffer(GL_ARRAY_BUFFER, 0));
-	_S_GL(glBindVertexArray(0));
-	_S_GL(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
-
-	return font;
+		/* only the rows below the skyline hold any glyphs */
+		len = page->packer->len;
+		rows = _S_font_page_rows(page);
+		fail = !_S_font_write(fp, &len, sizeof(len)) ||
+		       !_S_font_write(fp, page->packer->nodes,
+		                      len * sizeof(Sskyline_node)) ||
+		       !_S_font_write(fp, &page->packer->area,
+		                      sizeof(page->packer->area)) ||
+		       !_S_font_write(fp, page->pixels, rows * S_FONT_PAGE_SIZE);
+	}
+	if (fail)
+	{
+		perror("fwrite");
+		_S_SET_ERROR(S_IO_ERROR, "S_font_save_cache");
+	}
+	if (fclose(fp) == EOF)
+	{
+		perror("fclose");
+		_S_SET_ERROR(S_IO_ERROR, "S_font_save_cache");
+	}
 }
 
 void
 S_font_delete(Sfont *font)
 {
+	_Sfont_cache *cache;
+	Suint32 i;
 	if (!font)
 	{
 		_S_SET_ERROR(S_INVALID_VALUE, "S_font_delete");
 		return;
 	}
+	cache = font->cache;
+	for (i = 0; i < S_FONT_PAGES; ++i)
+	{
+		if (!cache->pages[i].open)
+			continue;
+		_S_CALL("S_skyline_delete", S_skyline_delete(cache->pages[i].packer));
+		S_memory_delete(cache->pages[i].pixels);
+	}
+	for (i = 0; i < FONT_LAYOUTS; ++i)
+	{
+		if (!cache->layouts[i].glyphs)
+			continue;
+		S_memory_delete(cache->layouts[i].glyphs);
+		S_memory_delete(cache->layouts[i].text);
+	}
+	FT_Done_Face(cache->face);
+	S_memory_delete(cache->glyphs);
+	S_memory_delete(cache->table);
+	S_memory_delete(cache);
 	_S_GL(glDeleteTextures(1, &font->texture));
-	_S_GL(glDeleteVertexArrays(1, &font->vao));
-	_S_GL(glDeleteBuffers(1, &font->vbo));
+	_S_glstate_forget_texture(font->texture);
 	S_memory_delete(font);
 }
 
@@ -433,57 +983,116 @@ S_font_get_extents(const Sfont *font,
 				   Sfloat *w,
 				   Sfloat *h)
 {
-	Schar c;
-	Ssize_t i;
-	const _Sglyph *glyph;
-	Sfloat x, y, xp, yp, gw, gh, tw, th, ox, oy;
-	Sint32 chars;
-
 	if (!font || !text || scale <= 0.0f)
 	{
 		_S_SET_ERROR(S_INVALID_VALUE, "S_font_get_extents");
 		return;
 	}
+	_S_CALL("_S_font_get_layout_extents",
+	        _S_font_get_layout_extents(font, text, len, scale, 0.0f,
+	                                   xoff, yoff, w, h));
+}
 
-	if (len == 0)
+void
+S_font_get_wrapped_extents(const Sfont *font,
+                           const Schar *text,
+                           Ssize_t len,
+                           Sfloat scale,
+                           Sfloat width,
+                           Sfloat *xoff,
+                           Sfloat *yoff,
+                           Sfloat *w,
+                           Sfloat *h)
+{
+	if (!font || !text || scale <= 0.0f || width <= 0.0f)
 	{
-		ox = 0.0f;
-		oy = 0.0f;
-		tw = 0.0f;
-		th = 0.0f;
-		goto l_return_values;
+		_S_SET_ERROR(S_INVALID_VALUE, "S_font_get_wrapped_extents");
+		return;
 	}
+	_S_CALL("_S_font_get_layout_extents",
+	        _S_font_get_layout_extents(font, text, len, scale, width,
+	                                   xoff, yoff, w, h));
+}
 
-	chars = 0;
-	x = y = xp = yp = gw = gh = tw = th = 0.0f;
-	ox = oy = 99999.0f; /* big number so S_min works */
-	for (i = 0; i < len; ++i)
+Sfloat
+S_font_get_line_height(const Sfont *font,
+                       Sfloat scale)
+{
+	if (!font || scale <= 0.0f)
 	{
-		c = *(text+i);
-		glyph = font->glyphs+c-S_GLYPH_BEGIN;
-
-		gw = glyph->size.x * scale;
-		gh = S_max(glyph->size.y * scale, gh);
-
-		xp = x + glyph->xbearing * scale;
-		yp = y - (glyph->size.y - glyph->ybearing) * scale;
-
-		x += glyph->xadvance * scale;
-		y += glyph->yadvance * scale;
-
-		if (gw == 0 || gh == 0)
-			continue; /* skip empty glyphs */
+		_S_SET_ERROR(S_INVALID_VALUE, "S_font_get_line_height");
+		return 0.0f;
+	}
+	return font->cache->line_height * scale;
+}
 
-		ox = S_min(xp, ox);
-		oy = S_min(yp, oy);
-		tw = S_abs(xp) + S_abs(gw);
-		th = S_abs(oy) + S_abs(gh);
+const _Stextlayout *
+_S_font_get_layout(const Sfont *font,
+                   const Schar *text,
+                   Ssize_t len,
+                   Sfloat scale,
+                   Sfloat wrap)
+{
+	_Sfont_cache *cache;
+	_Stextlayout *layout, *victim;
+	Suint32 hash, bits, set, i;
+	cache = font->cache;
+	hash = S_hash_fnv1a(text, len);
+	memcpy(&bits, &scale, sizeof(bits));
+	hash = (hash ^ bits) * 16777619u;
+	memcpy(&bits, &wrap, sizeof(bits));
+	hash = (hash ^ bits) * 16777619u;
+	++cache->layout_tick;
+	/* each text may only be kept in one of a small set of slots, so that a
+	   lookup never searches the whole cache */
+	set = hash & (FONT_LAYOUTS - FONT_LAYOUT_WAYS);
+	victim = NULL;
+	for (i = 0; i < FONT_LAYOUT_WAYS; ++i)
+	{
+		layout = cache->layouts + set + i;
+		if (layout->valid && layout->hash == hash && layout->len == len &&
+		    layout->scale == scale && layout->wrap == wrap &&
+		    memcmp(layout->text, text, len) == 0)
+		{
+			layout->stamp = cache->layout_tick;
+			return layout;
+		}
+		if (!victim || !layout->valid ||
+		    (victim->valid && cache->layout_tick - layout->stamp >
+		                      cache->layout_tick - victim->stamp))
+			victim = layout;
+	}
+	_S_CALL("_S_font_layout_build",
+	        _S_font_layout_build(font, victim, text, len, scale, wrap));
+	victim->hash = hash;
+	victim->stamp = cache->layout_tick;
+	return victim;
+}
 
-		++chars;
-		if (chars >= S_GLYPH_BUFFER_SIZE)
-			break;
+void
+_S_font_get_layout_extents(const Sfont *font,
+                           const Schar *text,
+                           Ssize_t len,
+                           Sfloat scale,
+                           Sfloat wrap,
+                           Sfloat *xoff,
+                           Sfloat *yoff,
+                           Sfloat *w,
+                           Sfloat *h)
+{
+	const _Stextlayout *layout;
+	Sfloat ox, oy, tw, th;
+	ox = oy = tw = th = 0.0f;
+	if (len > 0)
+	{
+		_S_font_tick(font);
+		_S_CALL("_S_font_get_layout",
+		        layout = _S_font_get_layout(font, text, len, scale, wrap));
+		ox = layout->xoff;
+		oy = layout->yoff;
+		tw = layout->width;
+		th = layout->height;
 	}
-l_return_values:
 	if (xoff)
 		*xoff = ox;
 	if (yoff)
@@ -494,3 +1103,195 @@ l_return_values:
 		*h = th;
 }
 
+const _Sglyph *
+_S_font_get_glyph(const Sfont *font,
+                  Suint32 codepoint)
+{
+	_Sfont_cache *cache;
+	const _Sglyph *glyph;
+	cache = font->cache;
+	glyph = _S_font_lookup(cache, codepoint);
+	if (!glyph)
+	{
+		_S_CALL("_S_font_cache_glyph",
+		        glyph = _S_font_cache_glyph(font, codepoint));
+		return glyph;
+	}
+	if (glyph->size.x > 0.0f)
+		cache->pages[glyph->page].stamp = cache->tick;
+	return glyph;
+}
+
+void
+_S_font_tick(const Sfont *font)
+{
+	++font->cache->tick;
+}
+
+void
+_S_font_touch(const Sfont *font,
+              Suint32 pages)
+{
+	Suint32 i;
+	for (i = 0; i < S_FONT_PAGES; ++i)
+	{
+		if (pages & (1u << i))
+			font->cache->pages[i].stamp = font->cache->tick;
+	}
+}
+
+void
+_S_font_upload(const Sfont *font)
+{
+	_Sfont_page *page;
+	Suint32 i;
+	Sbool bound;
+	bound = S_FALSE;
+	for (i = 0; i < S_FONT_PAGES; ++i)
+	{
+		page = font->cache->pages + i;
+		if (page->x0 >= page->x1)
+			continue;
+		if (!bound)
+		{
+			_S_glstate_bind_texture(GL_TEXTURE_2D_ARRAY, font->texture);
+			_S_GL(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+			_S_GL(glPixelStorei(GL_UNPACK_ROW_LENGTH, S_FONT_PAGE_SIZE));
+			bound = S_TRUE;
+		}
+		_S_GL(glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, page->x0, page->y0, i,
+		                      page->x1 - page->x0, page->y1 - page->y0, 1,
+		                      GL_RED, GL_UNSIGNED_BYTE,
+		                      page->pixels + page->y0 * S_FONT_PAGE_SIZE +
+		                      page->x0));
+		page->x0 = page->x1 = 0;
+	}
+	if (bound)
+	{
+		_S_GL(glPixelStorei(GL_UNPACK_ROW_LENGTH, 0));
+		_S_GL(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
+	}
+}
+
+Suint32
+_S_font_get_generation(const Sfont *font)
+{
+	return font->cache->generation;
+}
+
+Suint32
+_S_font_next_codepoint(const Schar *text,
+                       Ssize_t len,
+                       Ssize_t *i)
+{
+	const Suint8 *s;
+	Suint32 codepoint, n, k;
+	s = (const Suint8 *) text + *i;
+	if (s[0] < 0x80)
+	{
+		++*i;
+		return s[0];
+	}
+	else if ((s[0] & 0xe0) == 0xc0)
+	{
+		n = 1;
+		codepoint = s[0] & 0x1f;
+	}
+	else if ((s[0] & 0xf0) == 0xe0)
+	{
+		n = 2;
+		codepoint = s[0] & 0x0f;
+	}
+	else if ((s[0] & 0xf8) == 0xf0)
+	{
+		n = 3;
+		codepoint = s[0] & 0x07;
+	}
+	else
+	{
+		++*i;
+		return FONT_REPLACEMENT;
+	}
+	if (*i + (Ssize_t) n >= len)
+	{
+		++*i;
+		return FONT_REPLACEMENT;
+	}
+	for (k = 1; k <= n; ++k)
+	{
+		if ((s[k] & 0xc0) != 0x80)
+		{
+			++*i;
+			return FONT_REPLACEMENT;
+		}
+		codepoint = (codepoint << 6) | (s[k] & 0x3f);
+	}
+	*i += n + 1;
+	return codepoint;
+}
+
+Sbool
+_S_font_glyph_quad(const Sfont *font,
+                   const _Sglyph *glyph,
+                   Sfloat scale,
+                   Sfloat *x,
+                   Sfloat *y,
+                   Sfloat *out)
+{
+	Sfloat xp, yp, w, h, offx, offy, offw, offh, page;
+	Suint32 i;
+	if (!glyph)
+	{
+		/* the glyph could not be cached, so neither draw nor advance */
+		memset(out, 0, _S_GLYPH_QUAD_FLOATS * sizeof(Sfloat));
+		return S_FALSE;
+	}
+	w = glyph->size.x * scale;
+	h = glyph->size.y * scale;
+
+	xp = *x + glyph->xbearing * scale;
+	yp = *y - (glyph->size.y - glyph->ybearing) * scale;
+
+	*x += glyph->xadvance * scale;
+	*y += glyph->yadvance * scale;
+
+	if (w == 0 || h == 0)
+	{
+		memset(out, 0, _S_GLYPH_QUAD_FLOATS * sizeof(Sfloat));
+		return S_FALSE;
+	}
+
+	offx = glyph->offset.x;
+	offy = glyph->offset.y;
+	offw = glyph->size.x / font->width;
+	offh = glyph->size.y / font->height;
+	page = glyph->page;
+
+	out[ 0] = xp;
+	out[ 1] = yp + h;
+	out[ 2] = offx;
+	out[ 3] = offy;
+	out[ 5] = xp;
+	out[ 6] = yp;
+	out[ 7] = offx;
+	out[ 8] = offy + offh;
+	out[10] = xp + w;
+	out[11] = yp;
+	out[12] = offx + offw;
+	out[13] = offy + offh;
+	out[15] = xp;
+	out[16] = yp + h;
+	out[17] = offx;
+	out[18] = offy;
+	out[20] = xp + w;
+	out[21] = yp;
+	out[22] = offx + offw;
+	out[23] = offy + offh;
+	out[25] = xp + w;
+	out[26] = yp + h;
+	out[27] = offx + offw;
+	out[28] = offy;
+	for (i = 4; i < _S_GLYPH_QUAD_FLOATS; i += 5)
+		out[i] = page;
+	return S_TRUE;
+}
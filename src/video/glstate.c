@@ -0,0 +1,326 @@
+/*
+ * This file is licensed under BSD 3-Clause.
+ * All license information is available in the included COPYING file.
+ */
+
+/*
+ * glstate.c
+ * OpenGL state cache source.
+ *
+ * Author       : Finn Rayment <finn@rayment.fr>
+ * Date created : 18/10/2026
+ */
+
+#include "sticky/common/error.h"
+#include "sticky/common/includes.h"
+#include "sticky/common/types.h"
+#include "sticky/video/glstate.h"
+
+/* a cached value that does not match any object, so that the next call is
+   always passed to the driver */
+#define UNKNOWN S_UINT32_MAX
+
+#define BUFFER_TARGETS  3
+#define TEXTURE_TARGETS 3
+#define CAPABILITIES    5
+
+typedef struct
+_Sglstate_s
+{
+	GLuint program, vao;
+	GLuint buffers[BUFFER_TARGETS];
+	GLuint textures[S_GLSTATE_TEXTURE_UNITS][TEXTURE_TARGETS];
+	Suint32 unit;
+	GLenum blend_src, blend_dst;
+	/* 0 = disabled, 1 = enabled, 2 = unknown */
+	Suint8 caps[CAPABILITIES];
+	Suint8 depth_mask;
+} _Sglstate;
+
+static _Sglstate state;
+static Sglstate_stats stats;
+
+static
+Sint32
+_S_glstate_buffer_slot(GLenum target)
+{
+	switch (target)
+	{
+	case GL_ARRAY_BUFFER:
+		return 0;
+	case GL_ELEMENT_ARRAY_BUFFER:
+		return 1;
+	case GL_PIXEL_UNPACK_BUFFER:
+		return 2;
+	default:
+		return -1;
+	}
+}
+
+static
+Sint32
+_S_glstate_texture_slot(GLenum target)
+{
+	switch (target)
+	{
+	case GL_TEXTURE_2D:
+		return 0;
+	case GL_TEXTURE_CUBE_MAP:
+		return 1;
+	case GL_TEXTURE_2D_ARRAY:
+		return 2;
+	default:
+		return -1;
+	}
+}
+
+static
+Sint32
+_S_glstate_capability_slot(GLenum cap)
+{
+	switch (cap)
+	{
+	case GL_DEPTH_TEST:
+		return 0;
+	case GL_BLEND:
+		return 1;
+	case GL_CULL_FACE:
+		return 2;
+	case GL_PROGRAM_POINT_SIZE:
+		return 3;
+	case GL_SCISSOR_TEST:
+		return 4;
+	default:
+		return -1;
+	}
+}
+
+/* record whether a call reaches the driver, and return whether it should */
+static
+Sbool
+_S_glstate_changed(Sbool changed)
+{
+	if (changed)
+		++stats.issued;
+	else
+		++stats.elided;
+	return changed;
+}
+
+void
+S_glstate_get_stats(Sglstate_stats *out)
+{
+	if (!out)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_glstate_get_stats");
+		return;
+	}
+	*out = stats;
+}
+
+void
+S_glstate_reset_stats(void)
+{
+	stats.issued = 0;
+	stats.elided = 0;
+}
+
+void
+S_glstate_invalidate(void)
+{
+	Suint32 i, j;
+	state.program = UNKNOWN;
+	state.vao = UNKNOWN;
+	for (i = 0; i < BUFFER_TARGETS; ++i)
+		state.buffers[i] = UNKNOWN;
+	for (i = 0; i < S_GLSTATE_TEXTURE_UNITS; ++i)
+	{
+		for (j = 0; j < TEXTURE_TARGETS; ++j)
+			state.textures[i][j] = UNKNOWN;
+	}
+	state.unit = UNKNOWN;
+	state.blend_src = UNKNOWN;
+	state.blend_dst = UNKNOWN;
+	for (i = 0; i < CAPABILITIES; ++i)
+		state.caps[i] = 2;
+	state.depth_mask = 2;
+}
+
+void
+_S_glstate_reset(void)
+{
+	S_glstate_invalidate();
+	S_glstate_reset_stats();
+}
+
+void
+_S_glstate_use_program(GLuint program)
+{
+	if (_S_glstate_changed(state.program != program))
+	{
+		_S_GL(glUseProgram(program));
+		state.program = program;
+	}
+}
+
+void
+_S_glstate_bind_vertex_array(GLuint vao)
+{
+	if (_S_glstate_changed(state.vao != vao))
+	{
+		_S_GL(glBindVertexArray(vao));
+		state.vao = vao;
+		/* the element array binding is part of the vertex array state */
+		state.buffers[1] = UNKNOWN;
+	}
+}
+
+void
+_S_glstate_bind_buffer(GLenum target,
+                       GLuint buffer)
+{
+	Sint32 slot;
+	slot = _S_glstate_buffer_slot(target);
+	if (slot < 0)
+	{
+		++stats.issued;
+		_S_GL(glBindBuffer(target, buffer));
+	}
+	else if (_S_glstate_changed(state.buffers[slot] != buffer))
+	{
+		_S_GL(glBindBuffer(target, buffer));
+		state.buffers[slot] = buffer;
+	}
+}
+
+void
+_S_glstate_active_texture(Suint32 unit)
+{
+	if (_S_glstate_changed(state.unit != unit))
+	{
+		_S_GL(glActiveTexture(GL_TEXTURE0 + unit));
+		state.unit = unit;
+	}
+}
+
+void
+_S_glstate_bind_texture(GLenum target,
+                        GLuint texture)
+{
+	Sint32 slot;
+	GLuint *bound;
+	slot = _S_glstate_texture_slot(target);
+	if (slot < 0 || state.unit >= S_GLSTATE_TEXTURE_UNITS)
+	{
+		++stats.issued;
+		_S_GL(glBindTexture(target, texture));
+		return;
+	}
+	bound = &state.textures[state.unit][slot];
+	if (_S_glstate_changed(*bound != texture))
+	{
+		_S_GL(glBindTexture(target, texture));
+		*bound = texture;
+	}
+}
+
+void
+_S_glstate_enable(GLenum cap)
+{
+	Sint32 slot;
+	slot = _S_glstate_capability_slot(cap);
+	if (slot < 0)
+	{
+		++stats.issued;
+		_S_GL(glEnable(cap));
+	}
+	else if (_S_glstate_changed(state.caps[slot] != 1))
+	{
+		_S_GL(glEnable(cap));
+		state.caps[slot] = 1;
+	}
+}
+
+void
+_S_glstate_disable(GLenum cap)
+{
+	Sint32 slot;
+	slot = _S_glstate_capability_slot(cap);
+	if (slot < 0)
+	{
+		++stats.issued;
+		_S_GL(glDisable(cap));
+	}
+	else if (_S_glstate_changed(state.caps[slot] != 0))
+	{
+		_S_GL(glDisable(cap));
+		state.caps[slot] = 0;
+	}
+}
+
+void
+_S_glstate_blend_func(GLenum src,
+                      GLenum dst)
+{
+	if (_S_glstate_changed(state.blend_src != src || state.blend_dst != dst))
+	{
+		_S_GL(glBlendFunc(src, dst));
+		state.blend_src = src;
+		state.blend_dst = dst;
+	}
+}
+
+void
+_S_glstate_depth_mask(GLboolean mask)
+{
+	if (_S_glstate_changed(state.depth_mask != (mask ? 1 : 0)))
+	{
+		_S_GL(glDepthMask(mask));
+		state.depth_mask = mask ? 1 : 0;
+	}
+}
+
+void
+_S_glstate_forget_program(GLuint program)
+{
+	/* a deleted program stays in use until another is bound, but its name may
+	   be reused by the next program created */
+	if (state.program == program)
+		state.program = UNKNOWN;
+}
+
+void
+_S_glstate_forget_vertex_array(GLuint vao)
+{
+	if (state.vao == vao)
+	{
+		state.vao = UNKNOWN;
+		state.buffers[1] = UNKNOWN;
+	}
+}
+
+void
+_S_glstate_forget_buffer(GLuint buffer)
+{
+	Suint32 i;
+	for (i = 0; i < BUFFER_TARGETS; ++i)
+	{
+		if (state.buffers[i] == buffer)
+			state.buffers[i] = UNKNOWN;
+	}
+}
+
+void
+_S_glstate_forget_texture(GLuint texture)
+{
+	Suint32 i, j;
+	for (i = 0; i < S_GLSTATE_TEXTURE_UNITS; ++i)
+	{
+		for (j = 0; j < TEXTURE_TARGETS; ++j)
+		{
+			if (state.textures[i][j] == texture)
+				state.textures[i][j] = UNKNOWN;
+		}
+	}
+}
+
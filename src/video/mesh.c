@@ -11,29 +11,220 @@
  * Date created : 11/04/2021
  */
 
+#include <string.h>
+
 #include "sticky/common/error.h"
 #include "sticky/common/includes.h"
 #include "sticky/common/types.h"
+#include "sticky/math/mat4.h"
+#include "sticky/math/math.h"
 #include "sticky/math/vec3.h"
 #include "sticky/memory/allocator.h"
+#include "sticky/video/glstate.h"
 #include "sticky/video/mesh.h"
 
+#define SNORM16_MAX 32767.0f
+
+/* bind a level of a mesh, returning the number of vertices or indices it
+   draws and the type of its indices */
+static
+Suint64
+_S_mesh_bind_lod(const Smesh *mesh,
+                 Suint32 lod,
+                 Senum *itype)
+{
+	*itype = GL_UNSIGNED_INT;
+	_S_glstate_bind_vertex_array(mesh->vao);
+	if (!mesh->use_indices)
+		return mesh->vcount;
+	if (lod >= mesh->nlods)
+		lod = mesh->nlods - 1;
+	_S_glstate_bind_buffer(GL_ELEMENT_ARRAY_BUFFER, mesh->lods[lod].ebo);
+	*itype = mesh->lods[lod].itype;
+	return mesh->lods[lod].icount;
+}
+
+/* the number of bytes taken by one attribute in the vertex buffer, or 0 if
+   the format is not valid for an attribute with the given components */
+static
+Ssize_t
+_S_mesh_format_size(Senum format,
+                    Suint32 components)
+{
+	switch (format)
+	{
+	case S_VERTEX_FLOAT:
+		return components * sizeof(Sfloat);
+	case S_VERTEX_HALF_FLOAT:
+		return components == 2 ? 2 * sizeof(Suint16) : 0;
+	case S_VERTEX_SNORM16:
+		/* padded to four components to keep each vertex aligned */
+		return components == 3 ? 4 * sizeof(Sint16) : 0;
+	case S_VERTEX_PACKED:
+		return components == 3 ? sizeof(Suint32) : 0;
+	case S_VERTEX_OCTAHEDRAL:
+		return components == 3 ? 2 * sizeof(Sint16) : 0;
+	default:
+		return 0;
+	}
+}
+
+static
+Sint16
+_S_mesh_snorm16(Sfloat f)
+{
+	f = S_clamp(f, -1.0f, 1.0f) * SNORM16_MAX;
+	return (Sint16) (f >= 0.0f ? f + 0.5f : f - 0.5f);
+}
+
+/* convert to an IEEE 754 half, rounding to nearest and flushing values too
+   small for a half to zero */
+static
+Suint16
+_S_mesh_half(Sfloat f)
+{
+	Suint32 bits, sign, mantissa;
+	Sint32 exponent;
+	memcpy(&bits, &f, sizeof(Suint32));
+	sign = (bits >> 16) & 0x8000;
+	exponent = (Sint32) ((bits >> 23) & 0xFF) - 127 + 15;
+	mantissa = bits & 0x7FFFFF;
+	if (((bits >> 23) & 0xFF) == 0xFF)
+		return sign | 0x7C00 | (mantissa ? 0x200 : 0);
+	if (exponent >= 31)
+		return sign | 0x7C00;
+	if (exponent <= 0)
+	{
+		if (exponent < -10)
+			return sign;
+		mantissa |= 0x800000;
+		return sign | ((mantissa + (1u << (13 - exponent))) >> (14 - exponent));
+	}
+	/* a carry out of the mantissa correctly increments the exponent */
+	return sign + (((Suint32) exponent << 10) | (mantissa >> 13)) +
+	       ((mantissa >> 12) & 1);
+}
+
 static
 Suint32
-_S_mesh_gen_attribute(Suint32 attrib,
-                      const Sfloat *data,
-                      Ssize_t len,
-                      Suint32 dimensions)
-{
-	Suint32 id;
-	_S_GL(glGenBuffers(1, &id));
-	_S_GL(glBindBuffer(GL_ARRAY_BUFFER, id));
-	_S_GL(glBufferData(GL_ARRAY_BUFFER, len, data, GL_STATIC_DRAW));
-	_S_GL(glVertexAttribPointer(attrib, dimensions, GL_FLOAT, GL_FALSE,
-	                            dimensions * sizeof(Sfloat), (void *) 0));
-	_S_GL(glBindBuffer(GL_ARRAY_BUFFER, 0));
+_S_mesh_packed(const Sfloat *n)
+{
+	Suint32 i, packed;
+	Sint32 c;
+	Sfloat f;
+	packed = 0;
+	for (i = 0; i < 3; ++i)
+	{
+		f = S_clamp(n[i], -1.0f, 1.0f) * 511.0f;
+		c = (Sint32) (f >= 0.0f ? f + 0.5f : f - 0.5f);
+		packed |= ((Suint32) c & 0x3FF) << (i * 10);
+	}
+	return packed;
+}
+
+/* project a unit vector onto an octahedron and unfold it into a square */
+static
+void
+_S_mesh_octahedral(const Sfloat *n,
+                   Sint16 *out)
+{
+	Sfloat l1, u, v, t;
+	l1 = S_abs(n[0]) + S_abs(n[1]) + S_abs(n[2]);
+	if (l1 == 0.0f)
+	{
+		out[0] = out[1] = 0;
+		return;
+	}
+	u = n[0] / l1;
+	v = n[1] / l1;
+	if (n[2] < 0.0f)
+	{
+		t = u;
+		u = (1.0f - S_abs(v)) * (t >= 0.0f ? 1.0f : -1.0f);
+		v = (1.0f - S_abs(t)) * (v >= 0.0f ? 1.0f : -1.0f);
+	}
+	out[0] = _S_mesh_snorm16(u);
+	out[1] = _S_mesh_snorm16(v);
+}
+
+static
+void
+_S_mesh_attribute(Suint32 attrib,
+                  Senum format,
+                  Suint32 components,
+                  Ssize_t stride,
+                  Ssize_t offset)
+{
+	GLenum type;
+	GLboolean normalized;
+	normalized = GL_FALSE;
+	switch (format)
+	{
+	case S_VERTEX_HALF_FLOAT:
+		type = GL_HALF_FLOAT;
+		break;
+	case S_VERTEX_SNORM16:
+		type = GL_SHORT;
+		normalized = GL_TRUE;
+		break;
+	case S_VERTEX_PACKED:
+		type = GL_INT_2_10_10_10_REV;
+		components = 4;
+		normalized = GL_TRUE;
+		break;
+	case S_VERTEX_OCTAHEDRAL:
+		type = GL_SHORT;
+		components = 2;
+		normalized = GL_TRUE;
+		break;
+	default:
+		type = GL_FLOAT;
+		break;
+	}
+	_S_GL(glVertexAttribPointer(attrib, components, type, normalized, stride,
+	                            (void *) offset));
 	_S_GL(glEnableVertexAttribArray(attrib));
-	return id;
+}
+
+/* upload the indices of a level, in 16 bits where they all fit, while the
+   vertex array of the mesh is bound */
+static
+void
+_S_mesh_gen_indices(_Smesh_lod *lod,
+                    const Suint32 *indices,
+                    Ssize_t ilen)
+{
+	Suint16 *shorts;
+	Suint32 max;
+	Ssize_t i;
+	max = 0;
+	for (i = 0; i < ilen; ++i)
+	{
+		if (indices[i] > max)
+			max = indices[i];
+	}
+	if (lod->ebo == 0)
+	{
+		_S_GL(glGenBuffers(1, &lod->ebo));
+	}
+	_S_glstate_bind_buffer(GL_ELEMENT_ARRAY_BUFFER, lod->ebo);
+	if (max <= S_UINT16_MAX)
+	{
+		lod->itype = GL_UNSIGNED_SHORT;
+		shorts = (Suint16 *) S_memory_new(sizeof(Suint16) * ilen);
+		for (i = 0; i < ilen; ++i)
+			shorts[i] = (Suint16) indices[i];
+		_S_GL(glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(Suint16) * ilen,
+		                   shorts, GL_STATIC_DRAW));
+		S_memory_delete(shorts);
+	}
+	else
+	{
+		lod->itype = GL_UNSIGNED_INT;
+		_S_GL(glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(Suint32) * ilen,
+		                   indices, GL_STATIC_DRAW));
+	}
+	lod->icount = ilen;
 }
 
 Smesh *
@@ -42,28 +233,76 @@ S_mesh_new(const Sfloat *vertices, Ssize_t vlen,
            const Sfloat *normals, Ssize_t nlen,
            const Sfloat *uv, Ssize_t uvlen)
 {
+	Svertex_layout layout;
 	Smesh *mesh;
+	layout.position = S_VERTEX_FLOAT;
+	layout.normal = S_VERTEX_FLOAT;
+	layout.uv = S_VERTEX_FLOAT;
+	_S_CALL("S_mesh_new_layout",
+	        mesh = S_mesh_new_layout(&layout, vertices, vlen, indices, ilen,
+	                                 normals, nlen, uv, uvlen));
+	return mesh;
+}
+
+Smesh *
+S_mesh_new_layout(const Svertex_layout *layout,
+                  const Sfloat *vertices, Ssize_t vlen,
+                  const Suint32 *indices, Ssize_t ilen,
+                  const Sfloat *normals, Ssize_t nlen,
+                  const Sfloat *uv, Ssize_t uvlen)
+{
+	Smesh *mesh;
+	Suint8 *buffer, *vertex;
 	Sfloat f, minx, miny, minz, maxx, maxy, maxz;
+	Sfloat center[3], extent[3];
+	Sint16 shorts[4];
+	Suint16 halves[2];
+	Suint32 packed;
+	Ssize_t psize, nsize, uvsize, stride, vcount;
 	Sbool xset, yset, zset;
 	Ssize_t i, j;
 
-	if (!vertices || vlen == 0 ||
+	if (!layout || !vertices || vlen == 0 ||
 	    (!indices && ilen > 0) ||
 	    (!normals && nlen > 0) ||
 	    (!uv && uvlen > 0))
 	{
-		_S_SET_ERROR(S_INVALID_VALUE, "S_mesh_new");
+		_S_SET_ERROR(S_INVALID_VALUE, "S_mesh_new_layout");
+		return NULL;
+	}
+	vcount = vlen / 3;
+	if ((nlen > 0 && nlen / 3 < vcount) || (uvlen > 0 && uvlen / 2 < vcount))
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_mesh_new_layout");
+		return NULL;
+	}
+	psize = _S_mesh_format_size(layout->position, 3);
+	nsize = nlen > 0 ? _S_mesh_format_size(layout->normal, 3) : 0;
+	uvsize = uvlen > 0 ? _S_mesh_format_size(layout->uv, 2) : 0;
+	if (psize == 0 || layout->position == S_VERTEX_PACKED ||
+	    layout->position == S_VERTEX_OCTAHEDRAL ||
+	    (nlen > 0 && (nsize == 0 || layout->normal == S_VERTEX_SNORM16)))
+	{
+		_S_SET_ERROR(S_INVALID_ENUM, "S_mesh_new_layout");
+		return NULL;
+	}
+	if (uvlen > 0 && uvsize == 0)
+	{
+		_S_SET_ERROR(S_INVALID_ENUM, "S_mesh_new_layout");
 		return NULL;
 	}
 
 	mesh = (Smesh *) S_memory_new(sizeof(Smesh));
+	memset(mesh->lods, 0, sizeof(mesh->lods));
+	mesh->instances = 0;
+	mesh->layout = *layout;
 	_S_GL(glGenVertexArrays(1, &mesh->vao));
-	_S_GL(glBindVertexArray(mesh->vao));
+	_S_glstate_bind_vertex_array(mesh->vao);
 
 	xset = yset = zset = S_FALSE;
 	minx = miny = minz = maxx = maxy = maxz = 0.0f;
 	/* TODO: Parallelise. */
-	for (i = 0; i < vlen / 3; ++i)
+	for (i = 0; i < vcount; ++i)
 	{
 		for (j = 0; j < 3; ++j)
 		{
@@ -99,44 +338,84 @@ S_mesh_new(const Sfloat *vertices, Ssize_t vlen,
 	}
 	_S_CALL("S_vec3_set", S_vec3_set(&mesh->bounds_min, minx, miny, minz));
 	_S_CALL("S_vec3_set", S_vec3_set(&mesh->bounds_max, maxx, maxy, maxz));
+	center[0] = (minx + maxx) * 0.5f;
+	center[1] = (miny + maxy) * 0.5f;
+	center[2] = (minz + maxz) * 0.5f;
+	extent[0] = maxx > minx ? (maxx - minx) * 0.5f : 1.0f;
+	extent[1] = maxy > miny ? (maxy - miny) * 0.5f : 1.0f;
+	extent[2] = maxz > minz ? (maxz - minz) * 0.5f : 1.0f;
 
-	/* multiply the buffer counts by their respective sizes before buffering
-	   into the vbo and vao */
-	vlen *= sizeof(Sfloat);
-	ilen *= sizeof(Suint32);
-	nlen *= sizeof(Sfloat);
-	uvlen *= sizeof(Sfloat);
-
-	/* buffer everything and setup the attribs */
-	mesh->use_indices = S_FALSE;
-	if (indices && ilen > 0)
+	/* interleave and convert every attribute into one buffer */
+	stride = psize + nsize + uvsize;
+	buffer = (Suint8 *) S_memory_new(stride * vcount);
+	for (i = 0; i < vcount; ++i)
 	{
-		mesh->use_indices = S_TRUE;
-		_S_GL(glGenBuffers(1, &mesh->ebo));
-		_S_GL(glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh->ebo));
-		_S_GL(glBufferData(GL_ELEMENT_ARRAY_BUFFER, ilen, indices,
-		                   GL_STATIC_DRAW));
-	}
-	_S_CALL("_S_mesh_gen_attribute",
-	        mesh->vbo = _S_mesh_gen_attribute(0, vertices, vlen, 3));
-	if (normals && nlen > 0)
-	{
-		_S_CALL("_S_mesh_gen_attribute",
-		        mesh->normals = _S_mesh_gen_attribute(1, normals, nlen, 3));
-	}
-	if (uv && uvlen > 0)
-	{
-		_S_CALL("_S_mesh_gen_attribute",
-		        mesh->uv = _S_mesh_gen_attribute(2, uv, uvlen, 2));
+		vertex = buffer + i * stride;
+		if (layout->position == S_VERTEX_SNORM16)
+		{
+			for (j = 0; j < 3; ++j)
+			{
+				shorts[j] = _S_mesh_snorm16((vertices[i*3+j] - center[j]) /
+				                            extent[j]);
+			}
+			shorts[3] = 0;
+			memcpy(vertex, shorts, psize);
+		}
+		else
+		{
+			memcpy(vertex, vertices + i * 3, psize);
+		}
+		vertex += psize;
+		if (nsize > 0)
+		{
+			switch (layout->normal)
+			{
+			case S_VERTEX_PACKED:
+				packed = _S_mesh_packed(normals + i * 3);
+				memcpy(vertex, &packed, nsize);
+				break;
+			case S_VERTEX_OCTAHEDRAL:
+				_S_mesh_octahedral(normals + i * 3, shorts);
+				memcpy(vertex, shorts, nsize);
+				break;
+			default:
+				memcpy(vertex, normals + i * 3, nsize);
+				break;
+			}
+			vertex += nsize;
+		}
+		if (uvsize > 0)
+		{
+			if (layout->uv == S_VERTEX_HALF_FLOAT)
+			{
+				halves[0] = _S_mesh_half(uv[i*2]);
+				halves[1] = _S_mesh_half(uv[i*2+1]);
+				memcpy(vertex, halves, uvsize);
+			}
+			else
+			{
+				memcpy(vertex, uv + i * 2, uvsize);
+			}
+		}
 	}
-	_S_GL(glBindBuffer(GL_ARRAY_BUFFER, mesh->vbo));
-	_S_GL(glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE,
-	                            3 * sizeof(Sfloat), (void *) 0));
-	_S_GL(glEnableVertexAttribArray(0));
 
-	mesh->vlen = vlen;
-	mesh->ilen = ilen;
-	mesh->uvlen = uvlen;
+	/* buffer everything and setup the attribs */
+	mesh->use_indices = indices && ilen > 0;
+	mesh->nlods = 1;
+	if (mesh->use_indices)
+		_S_mesh_gen_indices(mesh->lods, indices, ilen);
+	_S_GL(glGenBuffers(1, &mesh->vbo));
+	_S_glstate_bind_buffer(GL_ARRAY_BUFFER, mesh->vbo);
+	_S_GL(glBufferData(GL_ARRAY_BUFFER, stride * vcount, buffer,
+	                   GL_STATIC_DRAW));
+	S_memory_delete(buffer);
+	_S_mesh_attribute(0, layout->position, 3, stride, 0);
+	if (nsize > 0)
+		_S_mesh_attribute(1, layout->normal, 3, stride, psize);
+	if (uvsize > 0)
+		_S_mesh_attribute(2, layout->uv, 2, stride, psize + nsize);
+
+	mesh->vcount = vcount;
 
 	return mesh;
 }
@@ -144,26 +423,100 @@ S_mesh_new(const Sfloat *vertices, Ssize_t vlen,
 void
 S_mesh_delete(Smesh *mesh)
 {
+	Suint32 i;
 	if (!mesh)
 	{
 		_S_SET_ERROR(S_INVALID_VALUE, "S_mesh_delete");
 		return;
 	}
 	_S_GL(glDeleteVertexArrays(1, &mesh->vao));
-	if (mesh->uvlen > 0)
+	_S_glstate_forget_vertex_array(mesh->vao);
+	for (i = 0; mesh->use_indices && i < mesh->nlods; ++i)
 	{
-		_S_GL(glDeleteVertexArrays(1, &mesh->uv));
+		_S_GL(glDeleteBuffers(1, &mesh->lods[i].ebo));
+		_S_glstate_forget_buffer(mesh->lods[i].ebo);
 	}
 	_S_GL(glDeleteBuffers(1, &mesh->vbo));
+	_S_glstate_forget_buffer(mesh->vbo);
 	S_memory_delete(mesh);
 }
 
+void
+S_mesh_get_position_transform(const Smesh *mesh,
+                              Smat4 *dest)
+{
+	if (!mesh || !dest)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_mesh_get_position_transform");
+		return;
+	}
+	_S_CALL("S_mat4_identity", S_mat4_identity(dest));
+	if (mesh->layout.position != S_VERTEX_SNORM16)
+		return;
+	/* the inverse of the quantisation in S_mesh_new_layout */
+	dest->m00 = mesh->bounds_max.x > mesh->bounds_min.x ?
+	            (mesh->bounds_max.x - mesh->bounds_min.x) * 0.5f : 1.0f;
+	dest->m11 = mesh->bounds_max.y > mesh->bounds_min.y ?
+	            (mesh->bounds_max.y - mesh->bounds_min.y) * 0.5f : 1.0f;
+	dest->m22 = mesh->bounds_max.z > mesh->bounds_min.z ?
+	            (mesh->bounds_max.z - mesh->bounds_min.z) * 0.5f : 1.0f;
+	dest->m03 = (mesh->bounds_min.x + mesh->bounds_max.x) * 0.5f;
+	dest->m13 = (mesh->bounds_min.y + mesh->bounds_max.y) * 0.5f;
+	dest->m23 = (mesh->bounds_min.z + mesh->bounds_max.z) * 0.5f;
+}
+
+void
+S_mesh_set_lod(Smesh *mesh,
+               Suint32 level,
+               const Suint32 *indices,
+               Ssize_t ilen,
+               Sfloat error)
+{
+	if (!mesh || !indices || ilen == 0 || level > mesh->nlods ||
+	    level >= S_MESH_LODS || !(error >= 0.0f))
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_mesh_set_lod");
+		return;
+	}
+	if (!mesh->use_indices)
+	{
+		_S_SET_ERROR(S_INVALID_OPERATION, "S_mesh_set_lod");
+		return;
+	}
+	/* the element array binding belongs to the vertex array */
+	_S_glstate_bind_vertex_array(mesh->vao);
+	_S_mesh_gen_indices(mesh->lods + level, indices, ilen);
+	mesh->lods[level].error = error;
+	if (level == mesh->nlods)
+		++mesh->nlods;
+}
+
+Suint32
+S_mesh_get_lod_count(const Smesh *mesh)
+{
+	if (!mesh)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_mesh_get_lod_count");
+		return 0;
+	}
+	return mesh->nlods;
+}
+
 /* TODO: Redo when framebuffers are implemented? */
 void
 _S_mesh_draw(const Smesh *mesh,
              Senum mode)
+{
+	_S_CALL("_S_mesh_draw_lod", _S_mesh_draw_lod(mesh, mode, 0));
+}
+
+void
+_S_mesh_draw_lod(const Smesh *mesh,
+                 Senum mode,
+                 Suint32 lod)
 {
 	Suint64 count;
+	Senum itype;
 	if (!mesh || (mode != S_MESH_TRIANGLES &&
 	              mode != S_MESH_LINES &&
 	              mode != S_MESH_POINTS))
@@ -171,11 +524,17 @@ _S_mesh_draw(const Smesh *mesh,
 		_S_SET_ERROR(S_INVALID_VALUE, "S_mesh_draw");
 		return;
 	}
+	count = _S_mesh_bind_lod(mesh, lod, &itype);
+	if (count == 0)
+		return;
 	if (mesh->use_indices)
-		count = mesh->ilen;
+	{
+		_S_GL(glDrawElements(mode, count, itype, 0));
+	}
 	else
-		count = mesh->vlen / sizeof(Sfloat) / 3;
-	_S_CALL("_S_mesh_draw_count", _S_mesh_draw_count(mesh, mode, count));
+	{
+		_S_GL(glDrawArrays(mode, 0, count));
+	}
 }
 
 void
@@ -183,6 +542,7 @@ _S_mesh_draw_count(const Smesh *mesh,
                    Senum mode,
                    Suint64 count)
 {
+	Senum itype;
 	if (!mesh || (mode != S_MESH_TRIANGLES &&
 	              mode != S_MESH_LINES &&
 	              mode != S_MESH_POINTS))
@@ -192,16 +552,44 @@ _S_mesh_draw_count(const Smesh *mesh,
 	}
 	if (count == 0)
 		return;
-	_S_GL(glBindVertexArray(mesh->vao));
+	_S_mesh_bind_lod(mesh, 0, &itype);
 	if (mesh->use_indices)
 	{
-		_S_GL(glDrawElements(mode, count, GL_UNSIGNED_INT, 0));
+		_S_GL(glDrawElements(mode, count, itype, 0));
 	}
 	else
 	{
 		_S_GL(glDrawArrays(mode, 0, count));
 	}
-	/* TODO: Unbind necessary? */
-	_S_GL(glBindVertexArray(0));
+}
+
+void
+_S_mesh_draw_instanced(const Smesh *mesh,
+                       Senum mode,
+                       Suint32 lod,
+                       Suint32 instances)
+{
+	Suint64 count;
+	Senum itype;
+	if (!mesh || (mode != S_MESH_TRIANGLES &&
+	              mode != S_MESH_LINES &&
+	              mode != S_MESH_POINTS))
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_mesh_draw_instanced");
+		return;
+	}
+	if (instances == 0)
+		return;
+	count = _S_mesh_bind_lod(mesh, lod, &itype);
+	if (count == 0)
+		return;
+	if (mesh->use_indices)
+	{
+		_S_GL(glDrawElementsInstanced(mode, count, itype, 0, instances));
+	}
+	else
+	{
+		_S_GL(glDrawArraysInstanced(mode, 0, count, instances));
+	}
 }
 
@@ -7,7 +7,11 @@
 
 #include "sticky/common/error.h"
 #include "sticky/common/types.h"
+#include "sticky/math/math.h"
+#include "sticky/math/transform.h"
+#include "sticky/math/vec3.h"
 #include "sticky/memory/allocator.h"
+#include "sticky/video/camera.h"
 #include "sticky/video/model.h"
 
 Smodel *
@@ -22,6 +26,8 @@ S_model_new(Smesh *mesh,
 	model->mat = mat;
 	model->shader = shader;
 	model->parent = NULL;
+	model->lod = 0;
+	model->lod_threshold = S_MODEL_LOD_THRESHOLD;
 	_S_CALL("S_linkedlist_new", model->children = S_linkedlist_new());
 
 	return model;
@@ -138,3 +144,104 @@ S_model_get_shader(const Smodel *model)
 	return model->shader;
 }
 
+void
+S_model_set_lod(Smodel *model,
+                Suint32 lod)
+{
+	if (!model)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_model_set_lod");
+		return;
+	}
+	model->lod = lod;
+}
+
+Suint32
+S_model_get_lod(const Smodel *model)
+{
+	if (!model)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_model_get_lod");
+		return 0;
+	}
+	return model->lod;
+}
+
+void
+S_model_set_lod_threshold(Smodel *model,
+                          Sfloat threshold)
+{
+	if (!model || !(threshold >= 0.0f))
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_model_set_lod_threshold");
+		return;
+	}
+	model->lod_threshold = threshold;
+}
+
+Suint32
+S_model_select_lod(Smodel *model,
+                   const Scamera *camera,
+                   const Smat4 *transform)
+{
+	const Smesh *mesh;
+	Svec3 pos;
+	Sfloat center[3], scale, radius, dist, ppu, x, y, z;
+	Suint32 i;
+	if (!model || !camera)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_model_select_lod");
+		return 0;
+	}
+	mesh = model->mesh;
+	model->lod = 0;
+	if (!mesh || mesh->nlods < 2)
+		return 0;
+	center[0] = (mesh->bounds_min.x + mesh->bounds_max.x) * 0.5f;
+	center[1] = (mesh->bounds_min.y + mesh->bounds_max.y) * 0.5f;
+	center[2] = (mesh->bounds_min.z + mesh->bounds_max.z) * 0.5f;
+	x = mesh->bounds_max.x - mesh->bounds_min.x;
+	y = mesh->bounds_max.y - mesh->bounds_min.y;
+	z = mesh->bounds_max.z - mesh->bounds_min.z;
+	radius = S_sqrt(x * x + y * y + z * z) * 0.5f;
+	scale = 1.0f;
+	if (transform)
+	{
+		x = transform->m00 * center[0] + transform->m01 * center[1] +
+		    transform->m02 * center[2] + transform->m03;
+		y = transform->m10 * center[0] + transform->m11 * center[1] +
+		    transform->m12 * center[2] + transform->m13;
+		z = transform->m20 * center[0] + transform->m21 * center[1] +
+		    transform->m22 * center[2] + transform->m23;
+		center[0] = x;
+		center[1] = y;
+		center[2] = z;
+		/* the largest scale of any axis bounds the size of the error */
+		x = transform->m00 * transform->m00 + transform->m10 * transform->m10 +
+		    transform->m20 * transform->m20;
+		y = transform->m01 * transform->m01 + transform->m11 * transform->m11 +
+		    transform->m21 * transform->m21;
+		z = transform->m02 * transform->m02 + transform->m12 * transform->m12 +
+		    transform->m22 * transform->m22;
+		scale = S_sqrt(S_max(x, S_max(y, z)));
+	}
+	_S_CALL("S_transform_get_pos",
+	        S_transform_get_pos(camera->transform, &pos));
+	x = center[0] - pos.x;
+	y = center[1] - pos.y;
+	z = center[2] - pos.z;
+	dist = S_sqrt(x * x + y * y + z * z) - radius * scale;
+	if (dist <= camera->near_plane)
+		return 0;
+	/* the number of pixels covered by one unit at the given distance */
+	ppu = camera->height * 0.5f /
+	      (dist * S_tan(S_radians(camera->fov) * 0.5f));
+	for (i = mesh->nlods - 1; i > 0; --i)
+	{
+		if (mesh->lods[i].error * scale * ppu <= model->lod_threshold)
+			break;
+	}
+	model->lod = i;
+	return i;
+}
+
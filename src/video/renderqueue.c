@@ -0,0 +1,322 @@
+/*
+ * This file is licensed under BSD 3-Clause.
+ * All license information is available in the included COPYING file.
+ */
+
+/*
+ * renderqueue.c
+ * Sorted render queue source.
+ *
+ * Author       : Finn Rayment <finn@rayment.fr>
+ * Date created : 18/10/2026
+ */
+
+#include <string.h>
+
+#include "sticky/algorithm/rsort.h"
+#include "sticky/common/error.h"
+#include "sticky/common/includes.h"
+#include "sticky/common/types.h"
+#include "sticky/memory/allocator.h"
+#include "sticky/util/hash.h"
+#include "sticky/video/camera.h"
+#include "sticky/video/draw.h"
+#include "sticky/video/glstate.h"
+#include "sticky/video/material.h"
+#include "sticky/video/mesh.h"
+#include "sticky/video/renderqueue.h"
+#include "sticky/video/shader.h"
+
+#define RENDERQUEUE_MIN 64
+
+/*
+ * sort key layout, from the most significant bit:
+ *   opaque:      layer (4) | 0 (1) | shader (12) | material (12) | mesh (11) |
+ *                depth (24)
+ *   translucent: layer (4) | 1 (1) | far-to-near depth (24) | shader (12) |
+ *                material (12) | mesh (11)
+ * the identifiers are hashed, so two objects may share one, but commands are
+ * only grouped when their objects are equal
+ */
+#define KEY_LAYER_SHIFT       60
+#define KEY_TRANSLUCENT_SHIFT 59
+#define KEY_SHADER_BITS       12
+#define KEY_MATERIAL_BITS     12
+#define KEY_MESH_BITS         11
+#define KEY_DEPTH_BITS        24
+
+static
+Suint64
+_S_renderqueue_id(const void *ptr,
+                  Suint32 bits)
+{
+	Suint32 hash;
+	_S_CALL("S_hash_fnv1a", hash = S_hash_fnv1a(&ptr, sizeof(ptr)));
+	return hash & ((1u << bits) - 1);
+}
+
+/* map a non-negative depth to an integer that sorts in the same order, using
+   the bits of the float which are ordered for positive floats */
+static
+Suint64
+_S_renderqueue_depth(Sfloat depth)
+{
+	Suint32 bits;
+	if (!(depth > 0.0f))
+		depth = 0.0f;
+	memcpy(&bits, &depth, sizeof(Suint32));
+	return bits >> (32 - KEY_DEPTH_BITS);
+}
+
+static
+Suint64
+_S_renderqueue_key(const Smodel *model,
+                   Sfloat depth,
+                   Suint8 layer,
+                   Sbool translucent)
+{
+	Suint64 state, key;
+	state = _S_renderqueue_id(model->shader, KEY_SHADER_BITS);
+	state = (state << KEY_MATERIAL_BITS) |
+	        _S_renderqueue_id(model->mat, KEY_MATERIAL_BITS);
+	state = (state << KEY_MESH_BITS) |
+	        _S_renderqueue_id(model->mesh, KEY_MESH_BITS);
+	key = (Suint64) layer << KEY_LAYER_SHIFT;
+	if (translucent)
+	{
+		key |= (Suint64) 1 << KEY_TRANSLUCENT_SHIFT;
+		key |= (((1u << KEY_DEPTH_BITS) - 1) -
+		        _S_renderqueue_depth(depth)) <<
+		       (KEY_SHADER_BITS + KEY_MATERIAL_BITS + KEY_MESH_BITS);
+		key |= state;
+	}
+	else
+	{
+		key |= state << KEY_DEPTH_BITS;
+		key |= _S_renderqueue_depth(depth);
+	}
+	return key;
+}
+
+Srenderqueue *
+S_renderqueue_new(void)
+{
+	Srenderqueue *queue;
+	queue = (Srenderqueue *) S_memory_new(sizeof(Srenderqueue));
+	queue->cap = RENDERQUEUE_MIN;
+	queue->commands = (_Srenderqueue_cmd *)
+		S_memory_new(sizeof(_Srenderqueue_cmd) * queue->cap);
+	queue->keys = (Suint64 *) S_memory_new(sizeof(Suint64) * queue->cap);
+	queue->tmpkeys = (Suint64 *) S_memory_new(sizeof(Suint64) * queue->cap);
+	queue->order = (Suint32 *) S_memory_new(sizeof(Suint32) * queue->cap);
+	queue->tmporder = (Suint32 *) S_memory_new(sizeof(Suint32) * queue->cap);
+	queue->transforms = (Smat4 *) S_memory_new(sizeof(Smat4) * queue->cap);
+	queue->len = 0;
+	queue->sorted = S_TRUE;
+	queue->instancing = S_FALSE;
+	return queue;
+}
+
+void
+S_renderqueue_delete(Srenderqueue *queue)
+{
+	if (!queue)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_renderqueue_delete");
+		return;
+	}
+	S_memory_delete(queue->commands);
+	S_memory_delete(queue->keys);
+	S_memory_delete(queue->tmpkeys);
+	S_memory_delete(queue->order);
+	S_memory_delete(queue->tmporder);
+	S_memory_delete(queue->transforms);
+	S_memory_delete(queue);
+}
+
+void
+S_renderqueue_clear(Srenderqueue *queue)
+{
+	if (!queue)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_renderqueue_clear");
+		return;
+	}
+	queue->len = 0;
+	queue->sorted = S_TRUE;
+}
+
+void
+S_renderqueue_submit(Srenderqueue *queue,
+                     const Smodel *model,
+                     const Smat4 *transform,
+                     Sfloat depth,
+                     Suint8 layer,
+                     Sbool translucent)
+{
+	_Srenderqueue_cmd *cmd;
+	if (!queue || !model || layer >= S_RENDERQUEUE_LAYERS)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_renderqueue_submit");
+		return;
+	}
+	if (!model->mesh || !model->mat || !model->shader ||
+	    model->mat->assigned == 0)
+		return;
+	if (queue->len == queue->cap)
+	{
+		queue->cap *= 2;
+		queue->commands = (_Srenderqueue_cmd *)
+			S_memory_resize(queue->commands,
+			                sizeof(_Srenderqueue_cmd) * queue->cap);
+		queue->keys = (Suint64 *)
+			S_memory_resize(queue->keys, sizeof(Suint64) * queue->cap);
+		queue->tmpkeys = (Suint64 *)
+			S_memory_resize(queue->tmpkeys, sizeof(Suint64) * queue->cap);
+		queue->order = (Suint32 *)
+			S_memory_resize(queue->order, sizeof(Suint32) * queue->cap);
+		queue->tmporder = (Suint32 *)
+			S_memory_resize(queue->tmporder, sizeof(Suint32) * queue->cap);
+		queue->transforms = (Smat4 *)
+			S_memory_resize(queue->transforms, sizeof(Smat4) * queue->cap);
+	}
+	cmd = queue->commands + queue->len;
+	cmd->model = model;
+	cmd->has_transform = transform != NULL;
+	if (transform)
+		cmd->transform = *transform;
+	cmd->translucent = translucent;
+	queue->keys[queue->len] = _S_renderqueue_key(model, depth, layer,
+	                                             translucent);
+	queue->order[queue->len] = queue->len;
+	++queue->len;
+	queue->sorted = S_FALSE;
+}
+
+void
+S_renderqueue_sort(Srenderqueue *queue)
+{
+	if (!queue)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_renderqueue_sort");
+		return;
+	}
+	if (queue->sorted || queue->len == 0)
+		return;
+	_S_CALL("S_rsort",
+	        S_rsort(queue->keys, queue->order, queue->len,
+	                queue->tmpkeys, queue->tmporder));
+	queue->sorted = S_TRUE;
+}
+
+void
+S_renderqueue_execute(const Swindow *window,
+                      Srenderqueue *queue)
+{
+	const _Srenderqueue_cmd *cmd, *next;
+	const Smodel *model;
+	const Sshader *shader;
+	const Smaterial *mat;
+	Sint32 handle;
+	Suint32 i, j;
+	if (!window || !queue)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_renderqueue_execute");
+		return;
+	}
+	if (queue->len == 0)
+		return;
+	_S_CALL("S_renderqueue_sort", S_renderqueue_sort(queue));
+	shader = NULL;
+	mat = NULL;
+	handle = -1;
+	_S_glstate_enable(GL_DEPTH_TEST);
+	for (i = 0; i < queue->len; ++i)
+	{
+		cmd = queue->commands + queue->order[i];
+		model = cmd->model;
+		if (cmd->translucent)
+		{
+			_S_glstate_enable(GL_BLEND);
+			_S_glstate_blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+			_S_glstate_depth_mask(GL_FALSE);
+		}
+		else
+		{
+			_S_glstate_disable(GL_BLEND);
+			_S_glstate_depth_mask(GL_TRUE);
+		}
+		/* only change state where it differs from the previous command */
+		if (model->shader != shader)
+		{
+			shader = model->shader;
+			_S_CALL("_S_shader_attach", _S_shader_attach(shader));
+			_S_CALL("S_shader_get_uniform_handle",
+			        handle = S_shader_get_uniform_handle(model->shader,
+			                                             "u_model"));
+		}
+		if (model->mat != mat)
+		{
+			mat = model->mat;
+			_S_CALL("_S_material_attach", _S_material_attach(model->mat));
+		}
+		if (queue->instancing && cmd->has_transform)
+		{
+			/* gather the run of commands which can share one draw */
+			queue->transforms[0] = cmd->transform;
+			for (j = 1; i + j < queue->len; ++j)
+			{
+				next = queue->commands + queue->order[i+j];
+				if (!next->has_transform ||
+				    next->translucent != cmd->translucent ||
+				    next->model->mesh != model->mesh ||
+				    next->model->lod != model->lod ||
+				    next->model->mat != model->mat ||
+				    next->model->shader != model->shader)
+					break;
+				queue->transforms[j] = next->transform;
+			}
+			_S_CALL("_S_draw_instances",
+			        _S_draw_instances(model->mesh, model->lod,
+			                          queue->transforms, NULL, NULL, j));
+			i += j - 1;
+			continue;
+		}
+		if (cmd->has_transform && handle >= 0)
+		{
+			_S_CALL("S_shader_set_uniform_handle_mat4",
+			        S_shader_set_uniform_handle_mat4(model->shader, handle,
+			                                         &cmd->transform));
+		}
+		_S_CALL("_S_mesh_draw_lod",
+		        _S_mesh_draw_lod(model->mesh, S_MESH_TRIANGLES, model->lod));
+	}
+	/* leave the state as the window sets it up for other draws */
+	_S_glstate_enable(GL_BLEND);
+	_S_glstate_blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	_S_glstate_depth_mask(GL_TRUE);
+}
+
+void
+S_renderqueue_set_instancing(Srenderqueue *queue,
+                             Sbool enabled)
+{
+	if (!queue)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_renderqueue_set_instancing");
+		return;
+	}
+	queue->instancing = enabled;
+}
+
+Ssize_t
+S_renderqueue_size(const Srenderqueue *queue)
+{
+	if (!queue)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_renderqueue_size");
+		return 0;
+	}
+	return queue->len;
+}
+
@@ -11,6 +11,9 @@
  * Date created : 11/04/2022
  */
 
+#include <stdio.h>
+#include <string.h>
+
 #include "sticky/common/error.h"
 #include "sticky/common/includes.h"
 #include "sticky/common/types.h"
@@ -20,26 +23,145 @@
 #include "sticky/math/mat4.h"
 #include "sticky/memory/allocator.h"
 #include "sticky/util/fileio.h"
+#include "sticky/util/hash.h"
+#include "sticky/video/glstate.h"
 #include "sticky/video/shader.h"
 
 #define ERR_BUF_LEN 512
 
-Sshader *
-S_shader_new(const Schar *vertex_source,
-             Sint64 vlen,
-             const Schar *fragment_source,
-             Sint64 flen)
+#define _S_SHADER_UNIFORM_MIN_CAP 16
+
+#define SHADER_FILE_MAGIC   0x53505453 /* "STPS" */
+#define SHADER_FILE_VERSION 1
+#define SHADER_MAX_FORMATS  16         /* binary formats kept from GL */
+
+typedef struct _Sshader_file_header_s
 {
-	Sshader *shader;
-	Schar errbuf[ERR_BUF_LEN];
-	GLint status;
-	GLuint vs, fs, prog;
+	Suint32 magic, version;
+	Suint32 driver, vhash, fhash;
+	Suint32 vlen, flen;
+	Suint32 format, length;
+} _Sshader_file_header;
 
-	if (!vertex_source || !fragment_source || vlen == 0 || flen == 0)
+static Schar *cache_dir;
+static GLint cache_formats[SHADER_MAX_FORMATS];
+static GLint cache_nformats;
+static Suint32 cache_driver;
+
+/* find the slot of a uniform in the table, or the empty slot it belongs in */
+static
+_Sshader_uniform *
+_S_shader_uniform_find(const Sshader *shader,
+                       const Schar *name,
+                       Suint32 hash)
+{
+	_Sshader_uniform *slot;
+	Suint32 i, mask;
+	mask = shader->ucap - 1;
+	for (i = hash & mask;; i = (i + 1) & mask)
 	{
-		_S_SET_ERROR(S_INVALID_VALUE, "S_shader_new");
-		return NULL;
+		slot = shader->uniforms+i;
+		if (!slot->name ||
+		    (slot->hash == hash && strcmp(slot->name, name) == 0))
+			return slot;
 	}
+}
+
+/* add a uniform location to the table, keyed by a copy of its name */
+static
+void
+_S_shader_uniform_insert(Sshader *shader,
+                         const Schar *name,
+                         GLint location)
+{
+	_Sshader_uniform *old, *slot;
+	Suint32 i, oldcap, hash;
+	Ssize_t len;
+	/* keep the table at most half full so that probes stay short */
+	if ((shader->ulen + 1) * 2 > shader->ucap)
+	{
+		old = shader->uniforms;
+		oldcap = shader->ucap;
+		shader->ucap = oldcap * 2;
+		shader->uniforms = (_Sshader_uniform *)
+			S_memory_new(sizeof(_Sshader_uniform) * shader->ucap);
+		memset(shader->uniforms, 0, sizeof(_Sshader_uniform) * shader->ucap);
+		for (i = 0; i < oldcap; ++i)
+		{
+			if (!old[i].name)
+				continue;
+			slot = _S_shader_uniform_find(shader, old[i].name, old[i].hash);
+			*slot = old[i];
+		}
+		S_memory_delete(old);
+	}
+	hash = S_hash_fnv1a_string(name);
+	slot = _S_shader_uniform_find(shader, name, hash);
+	if (slot->name)
+		return;
+	len = strlen(name);
+	slot->name = (Schar *) S_memory_new(len + 1);
+	memcpy(slot->name, name, len + 1);
+	slot->hash = hash;
+	slot->location = location;
+	++shader->ulen;
+}
+
+/* read the locations of every active uniform of a linked program */
+static
+void
+_S_shader_introspect(Sshader *shader)
+{
+	GLint count, maxlen, size, i;
+	GLsizei len;
+	GLenum type;
+	GLint location;
+	Schar *name;
+	_S_GL(glGetProgramiv(shader->program, GL_ACTIVE_UNIFORMS, &count));
+	_S_GL(glGetProgramiv(shader->program, GL_ACTIVE_UNIFORM_MAX_LENGTH,
+	                     &maxlen));
+	shader->ulen = 0;
+	shader->ucap = _S_SHADER_UNIFORM_MIN_CAP;
+	while (shader->ucap < (Suint32) count * 4)
+		shader->ucap *= 2;
+	shader->uniforms = (_Sshader_uniform *)
+		S_memory_new(sizeof(_Sshader_uniform) * shader->ucap);
+	memset(shader->uniforms, 0, sizeof(_Sshader_uniform) * shader->ucap);
+	if (count <= 0 || maxlen <= 0)
+		return;
+	name = (Schar *) S_memory_new(maxlen + 1);
+	for (i = 0; i < count; ++i)
+	{
+		_S_GL(glGetActiveUniform(shader->program, (GLuint) i, maxlen, &len,
+		                         &size, &type, name));
+		name[len] = '\0';
+		_S_GL(location = glGetUniformLocation(shader->program, name));
+		/* uniforms inside of blocks have no location */
+		if (location < 0)
+			continue;
+		_S_shader_uniform_insert(shader, name, location);
+		/* arrays are reported as name[0], but may be referred to by name */
+		if (len > 3 && strcmp(name+len-3, "[0]") == 0)
+		{
+			name[len-3] = '\0';
+			_S_shader_uniform_insert(shader, name, location);
+		}
+	}
+	S_memory_delete(name);
+}
+
+/* compile both stages of a program and link them, exiting on failure */
+static
+GLuint
+_S_shader_compile(const Schar *vertex_source,
+                  Sint64 vlen,
+                  const Schar *fragment_source,
+                  Sint64 flen,
+                  Sbool retrievable)
+{
+	Schar errbuf[ERR_BUF_LEN];
+	GLint status;
+	GLuint vs, fs, prog;
 
 	_S_GL(vs = glCreateShader(GL_VERTEX_SHADER));
 	_S_GL(fs = glCreateShader(GL_FRAGMENT_SHADER));
@@ -69,6 +191,11 @@ S_shader_new(const Schar *vertex_source,
 		_S_error_gl(_S_ERR_LOC);
 	_S_GL(glAttachShader(prog, vs));
 	_S_GL(glAttachShader(prog, fs));
+	if (retrievable)
+	{
+		_S_GL(glProgramParameteri(prog, GL_PROGRAM_BINARY_RETRIEVABLE_HINT,
+		                          GL_TRUE));
+	}
 	_S_GL(glLinkProgram(prog));
 	_S_GL(glGetProgramiv(prog, GL_LINK_STATUS, &status));
 	if (status == GL_FALSE)
@@ -81,8 +208,165 @@ S_shader_new(const Schar *vertex_source,
 	_S_GL(glDeleteShader(vs));
 	_S_GL(glDeleteShader(fs));
 
+	return prog;
+}
+
+/* the path of the cache file of a program, from the hash of its key */
+static
+Schar *
+_S_shader_cache_path(const _Sshader_file_header *header)
+{
+	Suint32 hash;
+	Ssize_t len;
+	Schar *path;
+	hash = header->driver;
+	hash = hash * 16777619u ^ header->vhash;
+	hash = hash * 16777619u ^ header->fhash;
+	len = strlen(cache_dir);
+	path = (Schar *) S_memory_new(len + 16);
+	sprintf(path, "%s/%08x.bin", cache_dir, (unsigned int) hash);
+	return path;
+}
+
+/* link a program from its cached binary, or return 0 if there is no usable
+   binary for the sources and driver given by the header */
+static
+GLuint
+_S_shader_cache_load(const _Sshader_file_header *key,
+                     const Schar *path)
+{
+	_Sshader_file_header header;
+	FILE *fp;
+	void *binary;
+	long pos, end;
+	GLint status, i;
+	GLuint prog;
+	/* a missing file is only a cold cache */
+	if (!(fp = fopen(path, "rb")))
+		return 0;
+	binary = NULL;
+	prog = 0;
+	if (fread(&header, sizeof(header), 1, fp) != 1 ||
+	    header.magic != SHADER_FILE_MAGIC ||
+	    header.version != SHADER_FILE_VERSION ||
+	    header.driver != key->driver || header.vhash != key->vhash ||
+	    header.fhash != key->fhash || header.vlen != key->vlen ||
+	    header.flen != key->flen || header.length == 0)
+		goto l_close;
+	/* glProgramBinary raises an error for formats the driver never gave */
+	for (i = 0; i < cache_nformats; ++i)
+	{
+		if ((GLenum) cache_formats[i] == header.format)
+			break;
+	}
+	if (i == cache_nformats)
+		goto l_close;
+	/* the binary is the rest of the file, so that a corrupt length never
+	   allocates more than was written */
+	if ((pos = ftell(fp)) == -1L || fseek(fp, 0, SEEK_END) != 0 ||
+	    (end = ftell(fp)) == -1L || fseek(fp, pos, SEEK_SET) != 0 ||
+	    (unsigned long) (end - pos) != header.length)
+		goto l_close;
+	binary = S_memory_new(header.length);
+	if (fread(binary, header.length, 1, fp) != 1)
+		goto l_close;
+	if ((prog = glCreateProgram()) == 0)
+		_S_error_gl(_S_ERR_LOC);
+	_S_GL(glProgramBinary(prog, header.format, binary, header.length));
+	_S_GL(glGetProgramiv(prog, GL_LINK_STATUS, &status));
+	/* drivers may still reject binaries they produced, such as after an
+	   update which kept the same version string */
+	if (status == GL_FALSE)
+	{
+		_S_GL(glDeleteProgram(prog));
+		prog = 0;
+	}
+l_close:
+	if (binary)
+		S_memory_delete(binary);
+	fclose(fp);
+	return prog;
+}
+
+/* write the binary of a linked program to the cache, ignoring failures since
+   the program is simply compiled again the next time */
+static
+void
+_S_shader_cache_save(const _Sshader_file_header *key,
+                     const Schar *path,
+                     GLuint prog)
+{
+	_Sshader_file_header header;
+	FILE *fp;
+	void *binary;
+	GLint length;
+	GLenum format;
+	_S_GL(glGetProgramiv(prog, GL_PROGRAM_BINARY_LENGTH, &length));
+	if (length <= 0)
+		return;
+	binary = S_memory_new(length);
+	_S_GL(glGetProgramBinary(prog, length, &length, &format, binary));
+	header = *key;
+	header.format = format;
+	header.length = length;
+	if (!(fp = fopen(path, "wb")))
+	{
+		S_warning("Failed to write shader cache file '%s'.\n", path);
+		S_memory_delete(binary);
+		return;
+	}
+	if (fwrite(&header, sizeof(header), 1, fp) != 1 ||
+	    fwrite(binary, length, 1, fp) != 1)
+		S_warning("Failed to write shader cache file '%s'.\n", path);
+	fclose(fp);
+	S_memory_delete(binary);
+}
+
+Sshader *
+S_shader_new(const Schar *vertex_source,
+             Sint64 vlen,
+             const Schar *fragment_source,
+             Sint64 flen)
+{
+	_Sshader_file_header key;
+	Sshader *shader;
+	Schar *path;
+	GLuint prog;
+
+	if (!vertex_source || !fragment_source || vlen == 0 || flen == 0)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_shader_new");
+		return NULL;
+	}
+
+	prog = 0;
+	path = NULL;
+	if (cache_dir && cache_nformats > 0)
+	{
+		memset(&key, 0, sizeof(key));
+		key.magic = SHADER_FILE_MAGIC;
+		key.version = SHADER_FILE_VERSION;
+		key.driver = cache_driver;
+		key.vhash = S_hash_fnv1a(vertex_source, vlen);
+		key.fhash = S_hash_fnv1a(fragment_source, flen);
+		key.vlen = (Suint32) vlen;
+		key.flen = (Suint32) flen;
+		path = _S_shader_cache_path(&key);
+		prog = _S_shader_cache_load(&key, path);
+	}
+	if (!prog)
+	{
+		prog = _S_shader_compile(vertex_source, vlen, fragment_source, flen,
+		                         path != NULL);
+		if (path)
+			_S_shader_cache_save(&key, path, prog);
+	}
+	if (path)
+		S_memory_delete(path);
+
 	shader = (Sshader *) S_memory_new(sizeof(Sshader));
 	shader->program = prog;
+	_S_CALL("_S_shader_introspect", _S_shader_introspect(shader));
 
 	return shader;
 }
@@ -126,28 +410,59 @@ S_shader_load(const Schar *vertex_file,
 void
 S_shader_delete(Sshader *shader)
 {
+	Suint32 i;
 	if (!shader)
 	{
 		_S_SET_ERROR(S_INVALID_VALUE, "S_shader_delete");
 		return;
 	}
 	_S_GL(glDeleteProgram(shader->program));
+	_S_glstate_forget_program(shader->program);
+	for (i = 0; i < shader->ucap; ++i)
+	{
+		if (shader->uniforms[i].name)
+			S_memory_delete(shader->uniforms[i].name);
+	}
+	S_memory_delete(shader->uniforms);
 	S_memory_delete(shader);
 }
 
-static
-GLint
-_S_shader_get_uniform(const Sshader *shader,
-                      const Schar *name)
+void
+S_shader_set_cache_directory(const Schar *directory)
+{
+	Ssize_t len;
+	if (cache_dir)
+		S_memory_delete(cache_dir);
+	cache_dir = NULL;
+	if (!directory)
+		return;
+	len = strlen(directory);
+	cache_dir = (Schar *) S_memory_new(len + 1);
+	memcpy(cache_dir, directory, len + 1);
+}
+
+Sint32
+S_shader_get_uniform_handle(Sshader *shader,
+                            const Schar *name)
 {
-	GLint uniform;
+	_Sshader_uniform *slot;
+	Suint32 hash;
+	GLint location;
 	if (!shader || !name)
 	{
-		_S_SET_ERROR(S_INVALID_VALUE, "_S_shader_get_uniform");
-		return 0;
+		_S_SET_ERROR(S_INVALID_VALUE, "S_shader_get_uniform_handle");
+		return -1;
 	}
-	_S_GL(uniform = glGetUniformLocation(shader->program, name));
-	return uniform;
+	hash = S_hash_fnv1a_string(name);
+	slot = _S_shader_uniform_find(shader, name, hash);
+	if (slot->name)
+		return slot->location;
+	/* not an introspected name, such as a later element of an array, so ask
+	   GL once and remember the answer, even if there is no such uniform */
+	_S_GL(location = glGetUniformLocation(shader->program, name));
+	_S_CALL("_S_shader_uniform_insert",
+	        _S_shader_uniform_insert(shader, name, location));
+	return location;
 }
 
 void
@@ -155,16 +470,30 @@ S_shader_set_uniform_float(Sshader *shader,
                            const Schar *name,
                            Sfloat val)
 {
-	GLint uniform;
+	Sint32 handle;
 	if (!shader || !name)
 	{
 		_S_SET_ERROR(S_INVALID_VALUE, "S_shader_set_uniform_float");
 		return;
 	}
+	_S_CALL("S_shader_get_uniform_handle",
+	        handle = S_shader_get_uniform_handle(shader, name));
+	_S_CALL("S_shader_set_uniform_handle_float",
+	        S_shader_set_uniform_handle_float(shader, handle, val));
+}
+
+void
+S_shader_set_uniform_handle_float(Sshader *shader,
+                                  Sint32 handle,
+                                  Sfloat val)
+{
+	if (!shader)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_shader_set_uniform_handle_float");
+		return;
+	}
 	_S_CALL("_S_shader_attach", _S_shader_attach(shader));
-	_S_CALL("_S_shader_get_uniform",
-	        uniform = _S_shader_get_uniform(shader, name));
-	_S_GL(glUniform1f(uniform, val));
+	_S_GL(glUniform1f(handle, val));
 }
 
 void
@@ -172,16 +501,30 @@ S_shader_set_uniform_int32(Sshader *shader,
                            const Schar *name,
                            Sint32 val)
 {
-	GLint uniform;
+	Sint32 handle;
 	if (!shader || !name)
 	{
 		_S_SET_ERROR(S_INVALID_VALUE, "S_shader_set_uniform_int32");
 		return;
 	}
+	_S_CALL("S_shader_get_uniform_handle",
+	        handle = S_shader_get_uniform_handle(shader, name));
+	_S_CALL("S_shader_set_uniform_handle_int32",
+	        S_shader_set_uniform_handle_int32(shader, handle, val));
+}
+
+void
+S_shader_set_uniform_handle_int32(Sshader *shader,
+                                  Sint32 handle,
+                                  Sint32 val)
+{
+	if (!shader)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_shader_set_uniform_handle_int32");
+		return;
+	}
 	_S_CALL("_S_shader_attach", _S_shader_attach(shader));
-	_S_CALL("_S_shader_get_uniform",
-	        uniform = _S_shader_get_uniform(shader, name));
-	_S_GL(glUniform1i(uniform, val));
+	_S_GL(glUniform1i(handle, val));
 }
 
 void
@@ -189,16 +532,30 @@ S_shader_set_uniform_vec3(Sshader *shader,
                           const Schar *name,
                           const Svec3 *val)
 {
-	GLint uniform;
+	Sint32 handle;
 	if (!shader || !name || !val)
 	{
 		_S_SET_ERROR(S_INVALID_VALUE, "S_shader_set_uniform_vec3");
 		return;
 	}
+	_S_CALL("S_shader_get_uniform_handle",
+	        handle = S_shader_get_uniform_handle(shader, name));
+	_S_CALL("S_shader_set_uniform_handle_vec3",
+	        S_shader_set_uniform_handle_vec3(shader, handle, val));
+}
+
+void
+S_shader_set_uniform_handle_vec3(Sshader *shader,
+                                 Sint32 handle,
+                                 const Svec3 *val)
+{
+	if (!shader || !val)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_shader_set_uniform_handle_vec3");
+		return;
+	}
 	_S_CALL("_S_shader_attach", _S_shader_attach(shader));
-	_S_CALL("_S_shader_get_uniform",
-	        uniform = _S_shader_get_uniform(shader, name));
-	_S_GL(glUniform3f(uniform, val->x, val->y, val->z));
+	_S_GL(glUniform3f(handle, val->x, val->y, val->z));
 }
 
 void
@@ -206,16 +563,30 @@ S_shader_set_uniform_vec4(Sshader *shader,
                           const Schar *name,
                           const Svec4 *val)
 {
-	GLint uniform;
+	Sint32 handle;
 	if (!shader || !name || !val)
 	{
 		_S_SET_ERROR(S_INVALID_VALUE, "S_shader_set_uniform_vec4");
 		return;
 	}
+	_S_CALL("S_shader_get_uniform_handle",
+	        handle = S_shader_get_uniform_handle(shader, name));
+	_S_CALL("S_shader_set_uniform_handle_vec4",
+	        S_shader_set_uniform_handle_vec4(shader, handle, val));
+}
+
+void
+S_shader_set_uniform_handle_vec4(Sshader *shader,
+                                 Sint32 handle,
+                                 const Svec4 *val)
+{
+	if (!shader || !val)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_shader_set_uniform_handle_vec4");
+		return;
+	}
 	_S_CALL("_S_shader_attach", _S_shader_attach(shader));
-	_S_CALL("_S_shader_get_uniform",
-	        uniform = _S_shader_get_uniform(shader, name));
-	_S_GL(glUniform4f(uniform, val->x, val->y, val->z, val->w));
+	_S_GL(glUniform4f(handle, val->x, val->y, val->z, val->w));
 }
 
 void
@@ -223,16 +594,30 @@ S_shader_set_uniform_mat3(Sshader *shader,
                           const Schar *name,
                           const Smat3 *val)
 {
-	GLint uniform;
+	Sint32 handle;
 	if (!shader || !name || !val)
 	{
 		_S_SET_ERROR(S_INVALID_VALUE, "S_shader_set_uniform_mat3");
 		return;
 	}
+	_S_CALL("S_shader_get_uniform_handle",
+	        handle = S_shader_get_uniform_handle(shader, name));
+	_S_CALL("S_shader_set_uniform_handle_mat3",
+	        S_shader_set_uniform_handle_mat3(shader, handle, val));
+}
+
+void
+S_shader_set_uniform_handle_mat3(Sshader *shader,
+                                 Sint32 handle,
+                                 const Smat3 *val)
+{
+	if (!shader || !val)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_shader_set_uniform_handle_mat3");
+		return;
+	}
 	_S_CALL("_S_shader_attach", _S_shader_attach(shader));
-	_S_CALL("_S_shader_get_uniform",
-	        uniform = _S_shader_get_uniform(shader, name));
-	_S_GL(glUniformMatrix3fv(uniform, 1, GL_FALSE, (Sfloat *) val));
+	_S_GL(glUniformMatrix3fv(handle, 1, GL_FALSE, (Sfloat *) val));
 }
 
 void
@@ -240,16 +625,68 @@ S_shader_set_uniform_mat4(Sshader *shader,
                           const Schar *name,
                           const Smat4 *val)
 {
-	GLint uniform;
+	Sint32 handle;
 	if (!shader || !name || !val)
 	{
 		_S_SET_ERROR(S_INVALID_VALUE, "S_shader_set_uniform_mat4");
 		return;
 	}
+	_S_CALL("S_shader_get_uniform_handle",
+	        handle = S_shader_get_uniform_handle(shader, name));
+	_S_CALL("S_shader_set_uniform_handle_mat4",
+	        S_shader_set_uniform_handle_mat4(shader, handle, val));
+}
+
+void
+S_shader_set_uniform_handle_mat4(Sshader *shader,
+                                 Sint32 handle,
+                                 const Smat4 *val)
+{
+	if (!shader || !val)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_shader_set_uniform_handle_mat4");
+		return;
+	}
 	_S_CALL("_S_shader_attach", _S_shader_attach(shader));
-	_S_CALL("_S_shader_get_uniform",
-	        uniform = _S_shader_get_uniform(shader, name));
-	_S_GL(glUniformMatrix4fv(uniform, 1, GL_FALSE, (Sfloat *) val));
+	_S_GL(glUniformMatrix4fv(handle, 1, GL_FALSE, (Sfloat *) val));
+}
+
+void
+_S_shader_init(void)
+{
+	static const GLenum strings[3] = {GL_VENDOR, GL_RENDERER, GL_VERSION};
+	const GLubyte *str;
+	GLint count;
+	Suint32 i;
+	cache_nformats = 0;
+	cache_driver = 0;
+	if (!GLEW_VERSION_4_1 && !GLEW_ARB_get_program_binary)
+		return;
+	_S_GL(glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &count));
+	/* a driver with no formats cannot save programs at all */
+	if (count <= 0 || count > SHADER_MAX_FORMATS)
+		return;
+	_S_GL(glGetIntegerv(GL_PROGRAM_BINARY_FORMATS, cache_formats));
+	cache_nformats = count;
+	/* binaries are only valid for the driver that built them */
+	for (i = 0; i < 3; ++i)
+	{
+		_S_GL(str = glGetString(strings[i]));
+		if (str)
+		{
+			cache_driver = cache_driver * 16777619u ^
+			               S_hash_fnv1a_string((const Schar *) str);
+		}
+	}
+	S_debug("GL program binary formats: %d\n", count);
+}
+
+void
+_S_shader_free(void)
+{
+	if (cache_dir)
+		S_memory_delete(cache_dir);
+	cache_dir = NULL;
 }
 
 void
@@ -260,6 +697,6 @@ _S_shader_attach(const Sshader *shader)
 		_S_SET_ERROR(S_INVALID_VALUE, "S_shader_attach");
 		return;
 	}
-	_S_GL(glUseProgram(shader->program));
+	_S_glstate_use_program(shader->program);
 }
 
@@ -0,0 +1,388 @@
+/*
+ * This file is licensed under BSD 3-Clause.
+ * All license information is available in the included COPYING file.
+ */
+
+/*
+ * spritebatch.c
+ * Batched 2D quad renderer source.
+ *
+ * Author       : Finn Rayment <finn@rayment.fr>
+ * Date created : 18/10/2026
+ */
+
+#include <string.h>
+
+#include "sticky/algorithm/qsort.h"
+#include "sticky/common/error.h"
+#include "sticky/common/includes.h"
+#include "sticky/common/types.h"
+#include "sticky/math/mat4.h"
+#include "sticky/math/math.h"
+#include "sticky/memory/allocator.h"
+#include "sticky/video/camera.h"
+#include "sticky/video/glstate.h"
+#include "sticky/video/spritebatch.h"
+
+#define SPRITEBATCH_VERTEX_SOURCE                                           \
+"#version 330\n                                                            "\
+"layout (location = 0) in vec2 i_vertex;                                   "\
+"layout (location = 1) in vec2 i_texcoord;                                 "\
+"layout (location = 2) in vec4 i_color;                                    "\
+"out vec2 g_texcoord;                                                      "\
+"out vec4 g_color;                                                         "\
+"uniform mat4 u_projection;                                                "\
+"void main()                                                               "\
+"{                                                                         "\
+"	g_texcoord = i_texcoord;                                               "\
+"	g_color = i_color;                                                     "\
+"	gl_Position = u_projection * vec4(i_vertex, 0.0, 1.0);                 "\
+"}"
+
+#define SPRITEBATCH_FRAGMENT_SOURCE                                         \
+"#version 330\n                                                            "\
+"in vec2 g_texcoord;                                                       "\
+"in vec4 g_color;                                                          "\
+"out vec4 o_color;                                                         "\
+"uniform sampler2D u_tex;                                                  "\
+"void main()                                                               "\
+"{                                                                         "\
+"	o_color = texture(u_tex, g_texcoord) * g_color;                        "\
+"}"
+
+static const Suint8 white[4] = {255, 255, 255, 255};
+
+static
+Suint8
+_S_spritebatch_unorm(Sfloat f)
+{
+	return (Suint8) (S_clamp(f, 0.0f, 1.0f) * 255.0f + 0.5f);
+}
+
+static
+void
+_S_spritebatch_set_vertex(_Sspritebatch_vertex *vertex,
+                          Sfloat x,
+                          Sfloat y,
+                          Sfloat u,
+                          Sfloat v,
+                          const Suint8 *color)
+{
+	vertex->x = x;
+	vertex->y = y;
+	vertex->u = u;
+	vertex->v = v;
+	memcpy(vertex->color, color, 4);
+}
+
+/* order the quads by texture, keeping submission order within a texture */
+static
+void
+_S_spritebatch_sort(Sspritebatch *batch)
+{
+	Suint32 i, idx;
+	for (i = 0; i < batch->len; ++i)
+		batch->keys[i] = ((Suint64) batch->textures[i] << 32) | i;
+	S_qsort_inline(batch->keys, batch->len, sizeof(Suint64),
+	               (*(Suint64 *) a > *(Suint64 *) b) -
+	               (*(Suint64 *) a < *(Suint64 *) b));
+	for (i = 0; i < batch->len; ++i)
+	{
+		idx = (Suint32) (batch->keys[i] & S_UINT32_MAX);
+		memcpy(batch->sorted+i*4, batch->vertices+idx*4,
+		       4 * sizeof(_Sspritebatch_vertex));
+		batch->textures[i] = (GLuint) (batch->keys[i] >> 32);
+	}
+}
+
+Sspritebatch *
+S_spritebatch_new(Suint32 capacity)
+{
+	Sspritebatch *batch;
+	Suint16 *indices;
+	Suint32 i;
+	Sint32 sampler;
+	if (capacity == 0 || capacity > S_SPRITEBATCH_MAX)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_spritebatch_new");
+		return NULL;
+	}
+	batch = (Sspritebatch *) S_memory_new(sizeof(Sspritebatch));
+	batch->vertices = (_Sspritebatch_vertex *)
+		S_memory_new(sizeof(_Sspritebatch_vertex) * capacity * 4);
+	batch->sorted = (_Sspritebatch_vertex *)
+		S_memory_new(sizeof(_Sspritebatch_vertex) * capacity * 4);
+	batch->textures = (GLuint *) S_memory_new(sizeof(GLuint) * capacity);
+	batch->keys = (Suint64 *) S_memory_new(sizeof(Suint64) * capacity);
+	batch->window = NULL;
+	batch->len = 0;
+	batch->cap = capacity;
+	batch->calls = 0;
+	batch->sort = S_SPRITEBATCH_DEFERRED;
+	batch->ordered = S_TRUE;
+	/* uniforms of a new program start as zero */
+	memset(&(batch->last_projection), 0, sizeof(Smat4));
+
+	/* shader */
+	_S_CALL("S_shader_new",
+	        batch->shader = S_shader_new(SPRITEBATCH_VERTEX_SOURCE,
+	                                     strlen(SPRITEBATCH_VERTEX_SOURCE),
+	                                     SPRITEBATCH_FRAGMENT_SOURCE,
+	                                     strlen(SPRITEBATCH_FRAGMENT_SOURCE)));
+	_S_CALL("S_shader_get_uniform_handle",
+	        batch->projection = S_shader_get_uniform_handle(batch->shader,
+	                                                        "u_projection"));
+	_S_CALL("S_shader_get_uniform_handle",
+	        sampler = S_shader_get_uniform_handle(batch->shader, "u_tex"));
+	_S_CALL("S_shader_set_uniform_handle_int32",
+	        S_shader_set_uniform_handle_int32(batch->shader, sampler, 0));
+
+	/* untextured quads sample a single white texel */
+	_S_GL(glGenTextures(1, &batch->white));
+	_S_glstate_bind_texture(GL_TEXTURE_2D, batch->white);
+	_S_GL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
+	_S_GL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+	_S_GL(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0,
+	                   GL_RGBA, GL_UNSIGNED_BYTE, white));
+
+	/* the vertices are streamed, with room in each region for a full batch
+	   and its alignment, but the indices never change */
+	_S_CALL("S_streambuffer_new",
+	        batch->stream = S_streambuffer_new(sizeof(_Sspritebatch_vertex) *
+	                                           (capacity * 4 + 1)));
+	_S_GL(glGenVertexArrays(1, &batch->vao));
+	_S_GL(glGenBuffers(1, &batch->ebo));
+	_S_glstate_bind_vertex_array(batch->vao);
+	_S_CALL("S_streambuffer_bind", S_streambuffer_bind(batch->stream));
+	_S_GL(glEnableVertexAttribArray(0));
+	_S_GL(glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE,
+	                            sizeof(_Sspritebatch_vertex), (void *) 0));
+	_S_GL(glEnableVertexAttribArray(1));
+	_S_GL(glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE,
+	                            sizeof(_Sspritebatch_vertex),
+	                            (void *) (2 * sizeof(Sfloat))));
+	_S_GL(glEnableVertexAttribArray(2));
+	_S_GL(glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE,
+	                            sizeof(_Sspritebatch_vertex),
+	                            (void *) (4 * sizeof(Sfloat))));
+	indices = (Suint16 *) S_memory_new(sizeof(Suint16) * capacity * 6);
+	for (i = 0; i < capacity; ++i)
+	{
+		indices[i*6+0] = (Suint16) (i*4+0);
+		indices[i*6+1] = (Suint16) (i*4+1);
+		indices[i*6+2] = (Suint16) (i*4+2);
+		indices[i*6+3] = (Suint16) (i*4+2);
+		indices[i*6+4] = (Suint16) (i*4+3);
+		indices[i*6+5] = (Suint16) (i*4+0);
+	}
+	_S_glstate_bind_buffer(GL_ELEMENT_ARRAY_BUFFER, batch->ebo);
+	_S_GL(glBufferData(GL_ELEMENT_ARRAY_BUFFER,
+	                   sizeof(Suint16) * capacity * 6,
+	                   indices, GL_STATIC_DRAW));
+	S_memory_delete(indices);
+	return batch;
+}
+
+void
+S_spritebatch_delete(Sspritebatch *batch)
+{
+	if (!batch)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_spritebatch_delete");
+		return;
+	}
+	_S_CALL("S_shader_delete", S_shader_delete(batch->shader));
+	_S_GL(glDeleteTextures(1, &batch->white));
+	_S_GL(glDeleteVertexArrays(1, &batch->vao));
+	_S_GL(glDeleteBuffers(1, &batch->ebo));
+	_S_glstate_forget_texture(batch->white);
+	_S_glstate_forget_vertex_array(batch->vao);
+	_S_glstate_forget_buffer(batch->ebo);
+	_S_CALL("S_streambuffer_delete", S_streambuffer_delete(batch->stream));
+	S_memory_delete(batch->vertices);
+	S_memory_delete(batch->sorted);
+	S_memory_delete(batch->textures);
+	S_memory_delete(batch->keys);
+	S_memory_delete(batch);
+}
+
+void
+S_spritebatch_begin(Sspritebatch *batch,
+                    const Swindow *window,
+                    Senum sort)
+{
+	if (!batch || !window)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_spritebatch_begin");
+		return;
+	}
+	else if (sort != S_SPRITEBATCH_DEFERRED && sort != S_SPRITEBATCH_TEXTURE)
+	{
+		_S_SET_ERROR(S_INVALID_ENUM, "S_spritebatch_begin");
+		return;
+	}
+	else if (batch->window)
+	{
+		_S_SET_ERROR(S_INVALID_OPERATION, "S_spritebatch_begin");
+		return;
+	}
+	batch->window = window;
+	batch->sort = sort;
+	batch->len = 0;
+	batch->calls = 0;
+	batch->ordered = S_TRUE;
+}
+
+void
+S_spritebatch_draw(Sspritebatch *batch,
+                   const Stexture *tex,
+                   const Svec2 *from,
+                   const Svec2 *to,
+                   const Svec4 *uv,
+                   const Svec4 *color)
+{
+	_Sspritebatch_vertex *quad;
+	Suint8 rgba[4];
+	Sfloat u0, v0, u1, v1;
+	GLuint id;
+	if (!batch || !from || !to || (tex && (tex->cubemap || tex->array)))
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_spritebatch_draw");
+		return;
+	}
+	else if (!batch->window)
+	{
+		_S_SET_ERROR(S_INVALID_OPERATION, "S_spritebatch_draw");
+		return;
+	}
+	if (batch->len == batch->cap)
+	{
+		_S_CALL("S_spritebatch_flush", S_spritebatch_flush(batch));
+	}
+	if (!color)
+		color = &batch->window->dcolor;
+	rgba[0] = _S_spritebatch_unorm(color->x);
+	rgba[1] = _S_spritebatch_unorm(color->y);
+	rgba[2] = _S_spritebatch_unorm(color->z);
+	rgba[3] = _S_spritebatch_unorm(color->w);
+	if (uv)
+	{
+		u0 = uv->x;
+		v0 = uv->y;
+		u1 = uv->z;
+		v1 = uv->w;
+	}
+	else
+	{
+		u0 = v0 = 0.0f;
+		u1 = v1 = 1.0f;
+	}
+	id = tex ? tex->tex : batch->white;
+	/* track whether the quads are already grouped by texture, in which case
+	   sorting can be skipped */
+	if (batch->len > 0 && id < batch->textures[batch->len-1])
+		batch->ordered = S_FALSE;
+	quad = batch->vertices + batch->len * 4;
+	_S_spritebatch_set_vertex(quad+0, from->x, from->y, u0, v0, rgba);
+	_S_spritebatch_set_vertex(quad+1, to->x, from->y, u1, v0, rgba);
+	_S_spritebatch_set_vertex(quad+2, to->x, to->y, u1, v1, rgba);
+	_S_spritebatch_set_vertex(quad+3, from->x, to->y, u0, v1, rgba);
+	batch->textures[batch->len] = id;
+	++batch->len;
+}
+
+void
+S_spritebatch_flush(Sspritebatch *batch)
+{
+	const _Sspritebatch_vertex *vertices;
+	Smat4 projection;
+	Suint32 i, first, base;
+	if (!batch)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_spritebatch_flush");
+		return;
+	}
+	else if (!batch->window)
+	{
+		_S_SET_ERROR(S_INVALID_OPERATION, "S_spritebatch_flush");
+		return;
+	}
+	if (batch->len == 0 || !batch->window->cam)
+	{
+		batch->len = 0;
+		return;
+	}
+	vertices = batch->vertices;
+	if (batch->sort == S_SPRITEBATCH_TEXTURE && !batch->ordered)
+	{
+		_S_spritebatch_sort(batch);
+		vertices = batch->sorted;
+	}
+	/* only upload the projection when the camera has changed since the last
+	   flush */
+	_S_CALL("S_camera_get_orthographic_matrix",
+	        S_camera_get_orthographic_matrix(batch->window->cam, &projection));
+	if (memcmp(&projection, &(batch->last_projection), sizeof(Smat4)) != 0)
+	{
+		_S_CALL("S_shader_set_uniform_handle_mat4",
+		        S_shader_set_uniform_handle_mat4(batch->shader,
+		                                         batch->projection,
+		                                         &projection));
+		batch->last_projection = projection;
+	}
+	/* other draws may have bound their own program since the last flush */
+	_S_CALL("_S_shader_attach", _S_shader_attach(batch->shader));
+	_S_glstate_disable(GL_DEPTH_TEST);
+	_S_glstate_bind_vertex_array(batch->vao);
+	_S_CALL("S_streambuffer_write",
+	        base = S_streambuffer_write(batch->stream, vertices,
+	                                    sizeof(_Sspritebatch_vertex) *
+	                                    batch->len * 4,
+	                                    sizeof(_Sspritebatch_vertex)));
+	_S_glstate_active_texture(0);
+	/* one draw call per run of quads that share a texture */
+	first = 0;
+	for (i = 1; i <= batch->len; ++i)
+	{
+		if (i < batch->len && batch->textures[i] == batch->textures[first])
+			continue;
+		_S_glstate_bind_texture(GL_TEXTURE_2D, batch->textures[first]);
+		_S_GL(glDrawElementsBaseVertex(GL_TRIANGLES, (i - first) * 6,
+		                               GL_UNSIGNED_SHORT,
+		                               (void *) (first * 6 * sizeof(Suint16)),
+		                               base));
+		++batch->calls;
+		first = i;
+	}
+	batch->len = 0;
+	batch->ordered = S_TRUE;
+}
+
+void
+S_spritebatch_end(Sspritebatch *batch)
+{
+	if (!batch)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_spritebatch_end");
+		return;
+	}
+	else if (!batch->window)
+	{
+		_S_SET_ERROR(S_INVALID_OPERATION, "S_spritebatch_end");
+		return;
+	}
+	_S_CALL("S_spritebatch_flush", S_spritebatch_flush(batch));
+	batch->window = NULL;
+}
+
+Suint32
+S_spritebatch_get_draw_calls(const Sspritebatch *batch)
+{
+	if (!batch)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_spritebatch_get_draw_calls");
+		return 0;
+	}
+	return batch->calls;
+}
+
@@ -0,0 +1,195 @@
+/*
+ * This file is licensed under BSD 3-Clause.
+ * All license information is available in the included COPYING file.
+ */
+
+/*
+ * streambuffer.c
+ * Streaming vertex buffer source.
+ *
+ * Author       : Finn Rayment <finn@rayment.fr>
+ * Date created : 18/10/2026
+ */
+
+#include <string.h>
+
+#include "sticky/common/error.h"
+#include "sticky/common/includes.h"
+#include "sticky/common/types.h"
+#include "sticky/memory/allocator.h"
+#include "sticky/video/glstate.h"
+#include "sticky/video/streambuffer.h"
+
+#define STREAMBUFFER_PERSISTENT \
+	(GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT)
+#define STREAMBUFFER_UNSYNCHRONIZED \
+	(GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT)
+#define STREAMBUFFER_TIMEOUT    1000000 /* nanoseconds */
+
+/* fence the region that has just been filled and move on to the next, waiting
+   until the GPU has finished reading it */
+static
+void
+_S_streambuffer_next(Sstreambuffer *stream)
+{
+	GLsync fence;
+	GLenum status;
+	if (stream->mapped)
+	{
+		_S_GL(stream->fences[stream->region] =
+		      glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+	}
+	stream->region = (stream->region + 1) % S_STREAMBUFFER_REGIONS;
+	stream->offset = stream->region * stream->size;
+	if (!stream->mapped)
+	{
+		/* the ring has wrapped, so let the driver hand us fresh memory */
+		if (stream->region == 0)
+		{
+			_S_glstate_bind_buffer(GL_ARRAY_BUFFER, stream->vbo);
+			_S_GL(glBufferData(GL_ARRAY_BUFFER,
+			                   stream->size * S_STREAMBUFFER_REGIONS, NULL,
+			                   GL_STREAM_DRAW));
+		}
+		return;
+	}
+	fence = stream->fences[stream->region];
+	if (!fence)
+		return;
+	do
+	{
+		_S_GL(status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT,
+		                                STREAMBUFFER_TIMEOUT));
+	} while (status == GL_TIMEOUT_EXPIRED);
+	_S_GL(glDeleteSync(fence));
+	stream->fences[stream->region] = NULL;
+}
+
+Sstreambuffer *
+S_streambuffer_new(Ssize_t size)
+{
+	Sstreambuffer *stream;
+	Ssize_t total;
+	Suint32 i;
+	if (size == 0)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_streambuffer_new");
+		return NULL;
+	}
+	stream = (Sstreambuffer *) S_memory_new(sizeof(Sstreambuffer));
+	for (i = 0; i < S_STREAMBUFFER_REGIONS; ++i)
+		stream->fences[i] = NULL;
+	stream->size = size;
+	stream->offset = 0;
+	stream->region = 0;
+	stream->mapped = NULL;
+	total = size * S_STREAMBUFFER_REGIONS;
+	_S_GL(glGenBuffers(1, &stream->vbo));
+	_S_glstate_bind_buffer(GL_ARRAY_BUFFER, stream->vbo);
+	if (GLEW_ARB_buffer_storage)
+	{
+		_S_GL(glBufferStorage(GL_ARRAY_BUFFER, total, NULL,
+		                      STREAMBUFFER_PERSISTENT));
+		_S_GL(stream->mapped = (Suint8 *)
+		      glMapBufferRange(GL_ARRAY_BUFFER, 0, total,
+		                       STREAMBUFFER_PERSISTENT));
+		if (stream->mapped)
+			return stream;
+		/* immutable storage cannot be respecified, so start again */
+		_S_GL(glDeleteBuffers(1, &stream->vbo));
+		_S_glstate_forget_buffer(stream->vbo);
+		_S_GL(glGenBuffers(1, &stream->vbo));
+		_S_glstate_bind_buffer(GL_ARRAY_BUFFER, stream->vbo);
+	}
+	_S_GL(glBufferData(GL_ARRAY_BUFFER, total, NULL, GL_STREAM_DRAW));
+	return stream;
+}
+
+void
+S_streambuffer_delete(Sstreambuffer *stream)
+{
+	Suint32 i;
+	if (!stream)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_streambuffer_delete");
+		return;
+	}
+	for (i = 0; i < S_STREAMBUFFER_REGIONS; ++i)
+	{
+		if (stream->fences[i])
+		{
+			_S_GL(glDeleteSync(stream->fences[i]));
+		}
+	}
+	if (stream->mapped)
+	{
+		_S_glstate_bind_buffer(GL_ARRAY_BUFFER, stream->vbo);
+		_S_GL(glUnmapBuffer(GL_ARRAY_BUFFER));
+	}
+	_S_GL(glDeleteBuffers(1, &stream->vbo));
+	_S_glstate_forget_buffer(stream->vbo);
+	S_memory_delete(stream);
+}
+
+void
+S_streambuffer_bind(const Sstreambuffer *stream)
+{
+	if (!stream)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_streambuffer_bind");
+		return;
+	}
+	_S_glstate_bind_buffer(GL_ARRAY_BUFFER, stream->vbo);
+}
+
+Suint32
+S_streambuffer_write(Sstreambuffer *stream,
+                     const void *data,
+                     Ssize_t size,
+                     Ssize_t stride)
+{
+	Ssize_t offset, end;
+	void *dest;
+	if (!stream || !data || size == 0 || stride == 0 ||
+	    size + stride > stream->size)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_streambuffer_write");
+		return 0;
+	}
+	end = (stream->region + 1) * stream->size;
+	offset = (stream->offset + stride - 1) / stride * stride;
+	if (offset + size > end)
+	{
+		_S_CALL("_S_streambuffer_next", _S_streambuffer_next(stream));
+		offset = (stream->offset + stride - 1) / stride * stride;
+	}
+	if (stream->mapped)
+	{
+		memcpy(stream->mapped + offset, data, size);
+	}
+	else
+	{
+		_S_glstate_bind_buffer(GL_ARRAY_BUFFER, stream->vbo);
+		_S_GL(dest = glMapBufferRange(GL_ARRAY_BUFFER, offset, size,
+		                              STREAMBUFFER_UNSYNCHRONIZED));
+		if (dest)
+		{
+			memcpy(dest, data, size);
+			_S_GL(glUnmapBuffer(GL_ARRAY_BUFFER));
+		}
+	}
+	stream->offset = offset + size;
+	return offset / stride;
+}
+
+Sbool
+S_streambuffer_is_persistent(const Sstreambuffer *stream)
+{
+	if (!stream)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_streambuffer_is_persistent");
+		return S_FALSE;
+	}
+	return stream->mapped != NULL;
+}
+
@@ -0,0 +1,735 @@
+/*
+ * This file is licensed under BSD 3-Clause.
+ * All license information is available in the included COPYING file.
+ */
+
+/*
+ * texformat.c
+ * Compressed texture format source.
+ *
+ * Author       : Finn Rayment <finn@rayment.fr>
+ * Date created : 18/10/2026
+ */
+
+#include <string.h>
+
+#include "sticky/common/error.h"
+#include "sticky/common/includes.h"
+#include "sticky/common/types.h"
+#include "sticky/video/texformat.h"
+
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+#endif /* GL_COMPRESSED_RGBA_S3TC_DXT1_EXT */
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif /* GL_COMPRESSED_RGBA_S3TC_DXT5_EXT */
+
+static Sbool supported[_S_TEXFORMAT_COUNT];
+
+/* bytes per block of 4x4 texels */
+static const Suint8 block_bytes[_S_TEXFORMAT_COUNT] = {
+	8, 16, 16, 16, 8, 16
+};
+
+static const GLenum gl_formats[_S_TEXFORMAT_COUNT] = {
+	GL_COMPRESSED_RGBA_S3TC_DXT1_EXT,
+	GL_COMPRESSED_RGBA_S3TC_DXT5_EXT,
+	GL_COMPRESSED_RG_RGTC2,
+	GL_COMPRESSED_RGBA_BPTC_UNORM,
+	GL_COMPRESSED_RGB8_ETC2,
+	GL_COMPRESSED_RGBA8_ETC2_EAC
+};
+
+/* BC7 partitions of a block into two and three subsets, and the texel of each
+   subset after the first whose index is stored with one bit less */
+static const Suint8 bc7_partitions2[64][16] = {
+	{0,0,1,1,0,0,1,1,0,0,1,1,0,0,1,1}, {0,0,0,1,0,0,0,1,0,0,0,1,0,0,0,1},
+	{0,1,1,1,0,1,1,1,0,1,1,1,0,1,1,1}, {0,0,0,1,0,0,1,1,0,0,1,1,0,1,1,1},
+	{0,0,0,0,0,0,0,1,0,0,0,1,0,0,1,1}, {0,0,1,1,0,1,1,1,0,1,1,1,1,1,1,1},
+	{0,0,0,1,0,0,1,1,0,1,1,1,1,1,1,1}, {0,0,0,0,0,0,0,1,0,0,1,1,0,1,1,1},
+	{0,0,0,0,0,0,0,0,0,0,0,1,0,0,1,1}, {0,0,1,1,0,1,1,1,1,1,1,1,1,1,1,1},
+	{0,0,0,0,0,0,0,1,0,1,1,1,1,1,1,1}, {0,0,0,0,0,0,0,0,0,0,0,1,0,1,1,1},
+	{0,0,0,1,0,1,1,1,1,1,1,1,1,1,1,1}, {0,0,0,0,0,0,0,0,1,1,1,1,1,1,1,1},
+	{0,0,0,0,1,1,1,1,1,1,1,1,1,1,1,1}, {0,0,0,0,0,0,0,0,0,0,0,0,1,1,1,1},
+	{0,0,0,0,1,0,0,0,1,1,1,0,1,1,1,1}, {0,1,1,1,0,0,0,1,0,0,0,0,0,0,0,0},
+	{0,0,0,0,0,0,0,0,1,0,0,0,1,1,1,0}, {0,1,1,1,0,0,1,1,0,0,0,1,0,0,0,0},
+	{0,0,1,1,0,0,0,1,0,0,0,0,0,0,0,0}, {0,0,0,0,1,0,0,0,1,1,0,0,1,1,1,0},
+	{0,0,0,0,0,0,0,0,1,0,0,0,1,1,0,0}, {0,1,1,1,0,0,1,1,0,0,1,1,0,0,0,1},
+	{0,0,1,1,0,0,0,1,0,0,0,1,0,0,0,0}, {0,0,0,0,1,0,0,0,1,0,0,0,1,1,0,0},
+	{0,1,1,0,0,1,1,0,0,1,1,0,0,1,1,0}, {0,0,1,1,0,1,1,0,0,1,1,0,1,1,0,0},
+	{0,0,0,1,0,1,1,1,1,1,1,0,1,0,0,0}, {0,0,0,0,1,1,1,1,1,1,1,1,0,0,0,0},
+	{0,1,1,1,0,0,0,1,1,0,0,0,1,1,1,0}, {0,0,1,1,1,0,0,1,1,0,0,1,1,1,0,0},
+	{0,1,0,1,0,1,0,1,0,1,0,1,0,1,0,1}, {0,0,0,0,1,1,1,1,0,0,0,0,1,1,1,1},
+	{0,1,0,1,1,0,1,0,0,1,0,1,1,0,1,0}, {0,0,1,1,0,0,1,1,1,1,0,0,1,1,0,0},
+	{0,0,1,1,1,1,0,0,0,0,1,1,1,1,0,0}, {0,1,0,1,0,1,0,1,1,0,1,0,1,0,1,0},
+	{0,1,1,0,1,0,0,1,0,1,1,0,1,0,0,1}, {0,1,0,1,1,0,1,0,1,0,1,0,0,1,0,1},
+	{0,1,1,1,0,0,1,1,1,1,0,0,1,1,1,0}, {0,0,0,1,0,0,1,1,1,1,0,0,1,0,0,0},
+	{0,0,1,1,0,0,1,0,0,1,0,0,1,1,0,0}, {0,0,1,1,1,0,1,1,1,1,0,1,1,1,0,0},
+	{0,1,1,0,1,0,0,1,1,0,0,1,0,1,1,0}, {0,0,1,1,1,1,0,0,1,1,0,0,0,0,1,1},
+	{0,1,1,0,0,1,1,0,1,0,0,1,1,0,0,1}, {0,0,0,0,0,1,1,0,0,1,1,0,0,0,0,0},
+	{0,1,0,0,1,1,1,0,0,1,0,0,0,0,0,0}, {0,0,1,0,0,1,1,1,0,0,1,0,0,0,0,0},
+	{0,0,0,0,0,0,1,0,0,1,1,1,0,0,1,0}, {0,0,0,0,0,1,0,0,1,1,1,0,0,1,0,0},
+	{0,1,1,0,1,1,0,0,1,0,0,1,0,0,1,1}, {0,0,1,1,0,1,1,0,1,1,0,0,1,0,0,1},
+	{0,1,1,0,0,0,1,1,1,0,0,1,1,1,0,0}, {0,0,1,1,1,0,0,1,1,1,0,0,0,1,1,0},
+	{0,1,1,0,1,1,0,0,1,1,0,0,1,0,0,1}, {0,1,1,0,0,0,1,1,0,0,1,1,1,0,0,1},
+	{0,1,1,1,1,1,1,0,1,0,0,0,0,0,0,1}, {0,0,0,1,1,0,0,0,1,1,1,0,0,1,1,1},
+	{0,0,0,0,1,1,1,1,0,0,1,1,0,0,1,1}, {0,0,1,1,0,0,1,1,1,1,1,1,0,0,0,0},
+	{0,0,1,0,0,0,1,0,1,1,1,0,1,1,1,0}, {0,1,0,0,0,1,0,0,0,1,1,1,0,1,1,1}
+};
+
+static const Suint8 bc7_partitions3[64][16] = {
+	{0,0,1,1,0,0,1,1,0,2,2,1,2,2,2,2}, {0,0,0,1,0,0,1,1,2,2,1,1,2,2,2,1},
+	{0,0,0,0,2,0,0,1,2,2,1,1,2,2,1,1}, {0,2,2,2,0,0,2,2,0,0,1,1,0,1,1,1},
+	{0,0,0,0,0,0,0,0,1,1,2,2,1,1,2,2}, {0,0,1,1,0,0,1,1,0,0,2,2,0,0,2,2},
+	{0,0,2,2,0,0,2,2,1,1,1,1,1,1,1,1}, {0,0,1,1,0,0,1,1,2,2,1,1,2,2,1,1},
+	{0,0,0,0,0,0,0,0,1,1,1,1,2,2,2,2}, {0,0,0,0,1,1,1,1,1,1,1,1,2,2,2,2},
+	{0,0,0,0,1,1,1,1,2,2,2,2,2,2,2,2}, {0,0,1,2,0,0,1,2,0,0,1,2,0,0,1,2},
+	{0,1,1,2,0,1,1,2,0,1,1,2,0,1,1,2}, {0,1,2,2,0,1,2,2,0,1,2,2,0,1,2,2},
+	{0,0,1,1,0,1,1,2,1,1,2,2,1,2,2,2}, {0,0,1,1,2,0,0,1,2,2,0,0,2,2,2,0},
+	{0,0,0,1,0,0,1,1,0,1,1,2,1,1,2,2}, {0,1,1,1,0,0,1,1,2,0,0,1,2,2,0,0},
+	{0,0,0,0,1,1,2,2,1,1,2,2,1,1,2,2}, {0,0,2,2,0,0,2,2,0,0,2,2,1,1,1,1},
+	{0,1,1,1,0,1,1,1,0,2,2,2,0,2,2,2}, {0,0,0,1,0,0,0,1,2,2,2,1,2,2,2,1},
+	{0,0,0,0,0,0,1,1,0,1,2,2,0,1,2,2}, {0,0,0,0,1,1,0,0,2,2,1,0,2,2,1,0},
+	{0,1,2,2,0,1,2,2,0,0,1,1,0,0,0,0}, {0,0,1,2,0,0,1,2,1,1,2,2,2,2,2,2},
+	{0,1,1,0,1,2,2,1,1,2,2,1,0,1,1,0}, {0,0,0,0,0,1,1,0,1,2,2,1,1,2,2,1},
+	{0,0,2,2,1,1,0,2,1,1,0,2,0,0,2,2}, {0,1,1,0,0,1,1,0,2,0,0,2,2,2,2,2},
+	{0,0,1,1,0,1,2,2,0,1,2,2,0,0,1,1}, {0,0,0,0,2,0,0,0,2,2,1,1,2,2,2,1},
+	{0,0,0,0,0,0,0,2,1,1,2,2,1,2,2,2}, {0,2,2,2,0,0,2,2,0,0,1,2,0,0,1,1},
+	{0,0,1,1,0,0,1,2,0,0,2,2,0,2,2,2}, {0,1,2,0,0,1,2,0,0,1,2,0,0,1,2,0},
+	{0,0,0,0,1,1,1,1,2,2,2,2,0,0,0,0}, {0,1,2,0,1,2,0,1,2,0,1,2,0,1,2,0},
+	{0,1,2,0,2,0,1,2,1,2,0,1,0,1,2,0}, {0,0,1,1,2,2,0,0,1,1,2,2,0,0,1,1},
+	{0,0,1,1,1,1,2,2,2,2,0,0,0,0,1,1}, {0,1,0,1,0,1,0,1,2,2,2,2,2,2,2,2},
+	{0,0,0,0,0,0,0,0,2,1,2,1,2,1,2,1}, {0,0,2,2,1,1,2,2,0,0,2,2,1,1,2,2},
+	{0,0,2,2,0,0,1,1,0,0,2,2,0,0,1,1}, {0,2,2,0,1,2,2,1,0,2,2,0,1,2,2,1},
+	{0,1,0,1,2,2,2,2,2,2,2,2,0,1,0,1}, {0,0,0,0,2,1,2,1,2,1,2,1,2,1,2,1},
+	{0,1,0,1,0,1,0,1,0,1,0,1,2,2,2,2}, {0,2,2,2,0,1,1,1,0,2,2,2,0,1,1,1},
+	{0,0,0,2,1,1,1,2,0,0,0,2,1,1,1,2}, {0,0,0,0,2,1,1,2,2,1,1,2,2,1,1,2},
+	{0,2,2,2,0,1,1,1,0,1,1,1,0,2,2,2}, {0,0,0,2,1,1,1,2,1,1,1,2,0,0,0,2},
+	{0,1,1,0,0,1,1,0,0,1,1,0,2,2,2,2}, {0,0,0,0,0,0,0,0,2,1,1,2,2,1,1,2},
+	{0,1,1,0,0,1,1,0,2,2,2,2,2,2,2,2}, {0,0,2,2,0,0,1,1,0,0,1,1,0,0,2,2},
+	{0,0,2,2,1,1,2,2,1,1,2,2,0,0,2,2}, {0,0,0,0,0,0,0,0,0,0,0,0,2,1,1,2},
+	{0,0,0,2,0,0,0,1,0,0,0,2,0,0,0,1}, {0,2,2,2,1,2,2,2,0,2,2,2,1,2,2,2},
+	{0,1,0,1,2,2,2,2,2,2,2,2,2,2,2,2}, {0,1,1,1,2,0,1,1,2,2,0,1,2,2,2,0}
+};
+
+static const Suint8 bc7_anchors2[64] = {
+	15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+	15,  2,  8,  2,  2,  8,  8, 15,  2,  8,  2,  2,  8,  8,  2,  2,
+	15, 15,  6,  8,  2,  8, 15, 15,  2,  8,  2,  2,  2, 15, 15,  6,
+	 6,  2,  6,  8, 15, 15,  2,  2, 15, 15, 15, 15, 15,  2,  2, 15
+};
+
+static const Suint8 bc7_anchors3[2][64] = {
+	{
+		 3,  3, 15, 15,  8,  3, 15, 15,  8,  8,  6,  6,  6,  5,  3,  3,
+		 3,  3,  8, 15,  3,  3,  6, 10,  5,  8,  8,  6,  8,  5, 15, 15,
+		 8, 15,  3,  5,  6, 10,  8, 15, 15,  3, 15,  5, 15, 15, 15, 15,
+		 3, 15,  5,  5,  5,  8,  5, 10,  5, 10,  8, 13, 15, 12,  3,  3
+	},
+	{
+		15,  8,  8,  3, 15, 15,  3,  8, 15, 15, 15, 15, 15, 15, 15,  8,
+		15,  8, 15,  3, 15,  8, 15,  8,  3, 15,  6, 10, 15, 15, 10,  8,
+		15,  3, 15, 10, 10,  8,  9, 10,  6, 15,  8, 15,  3,  6,  6,  8,
+		15,  3, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,  3, 15, 15,  8
+	}
+};
+
+static const Suint8 bc7_weights2[4] = {0, 21, 43, 64};
+static const Suint8 bc7_weights3[8] = {0, 9, 18, 27, 37, 46, 55, 64};
+static const Suint8 bc7_weights4[16] = {
+	0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64
+};
+
+/* the layout of each BC7 mode */
+typedef struct _Sbc7_mode_s
+{
+	Suint8 subsets, partition_bits, rotation_bits, selection_bits;
+	Suint8 color_bits, alpha_bits, endpoint_pbits, shared_pbits;
+	Suint8 index_bits, index2_bits;
+} _Sbc7_mode;
+
+static const _Sbc7_mode bc7_modes[8] = {
+	{3, 4, 0, 0, 4, 0, 1, 0, 3, 0},
+	{2, 6, 0, 0, 6, 0, 0, 1, 3, 0},
+	{3, 6, 0, 0, 5, 0, 0, 0, 2, 0},
+	{2, 6, 0, 0, 7, 0, 1, 0, 2, 0},
+	{1, 0, 2, 1, 5, 6, 0, 0, 2, 3},
+	{1, 0, 2, 0, 7, 8, 0, 0, 2, 2},
+	{1, 0, 0, 0, 7, 7, 1, 0, 4, 0},
+	{2, 6, 0, 0, 5, 5, 1, 0, 2, 0}
+};
+
+static const Sint16 etc_modifiers[8][4] = {
+	{  2,   8,  -2,   -8}, {  5,  17,  -5,  -17},
+	{  9,  29,  -9,  -29}, { 13,  42, -13,  -42},
+	{ 18,  60, -18,  -60}, { 24,  80, -24,  -80},
+	{ 33, 106, -33, -106}, { 47, 183, -47, -183}
+};
+
+static const Suint8 etc_distances[8] = {3, 6, 11, 16, 23, 32, 41, 64};
+
+static const Sint8 eac_modifiers[16][8] = {
+	{-3, -6, -9, -15, 2, 5, 8, 14}, {-3, -7, -10, -13, 2, 6, 9, 12},
+	{-2, -5, -8, -13, 1, 4, 7, 12}, {-2, -4, -6, -13, 1, 3, 5, 12},
+	{-3, -6, -8, -12, 2, 5, 7, 11}, {-3, -7, -9, -11, 2, 6, 8, 10},
+	{-4, -7, -8, -11, 3, 6, 7, 10}, {-3, -5, -8, -11, 2, 4, 7, 10},
+	{-2, -6, -8, -10, 1, 5, 7,  9}, {-2, -5, -8, -10, 1, 4, 7,  9},
+	{-2, -4, -8, -10, 1, 3, 7,  9}, {-2, -5, -7, -10, 1, 4, 6,  9},
+	{-3, -4, -7, -10, 2, 3, 6,  9}, {-1, -2, -3, -10, 0, 1, 2,  9},
+	{-4, -6, -8,  -9, 3, 5, 7,  8}, {-3, -5, -7,  -9, 2, 4, 6,  8}
+};
+
+static
+Suint8
+_S_texformat_clamp(Sint32 x)
+{
+	return x < 0 ? 0 : (x > 255 ? 255 : (Suint8) x);
+}
+
+static
+void
+_S_texformat_bc1(const Suint8 *block,
+                 Suint8 *out,
+                 Sbool opaque)
+{
+	Suint8 colors[4][4];
+	Suint32 c0, c1, indices, i, k;
+	c0 = block[0] | (block[1] << 8);
+	c1 = block[2] | (block[3] << 8);
+	indices = block[4] | (block[5] << 8) | (block[6] << 16) |
+	          ((Suint32) block[7] << 24);
+	colors[0][0] = ((c0 >> 11) << 3) | (c0 >> 13);
+	colors[0][1] = (((c0 >> 5) & 63) << 2) | ((c0 >> 9) & 3);
+	colors[0][2] = ((c0 & 31) << 3) | ((c0 >> 2) & 7);
+	colors[1][0] = ((c1 >> 11) << 3) | (c1 >> 13);
+	colors[1][1] = (((c1 >> 5) & 63) << 2) | ((c1 >> 9) & 3);
+	colors[1][2] = ((c1 & 31) << 3) | ((c1 >> 2) & 7);
+	colors[0][3] = colors[1][3] = colors[2][3] = colors[3][3] = 255;
+	for (k = 0; k < 3; ++k)
+	{
+		if (c0 > c1 || opaque)
+		{
+			colors[2][k] = (2 * colors[0][k] + colors[1][k]) / 3;
+			colors[3][k] = (colors[0][k] + 2 * colors[1][k]) / 3;
+		}
+		else
+		{
+			colors[2][k] = (colors[0][k] + colors[1][k]) / 2;
+			colors[3][k] = 0;
+		}
+	}
+	if (c0 <= c1 && !opaque)
+		colors[3][3] = 0;
+	for (i = 0; i < 16; ++i)
+		memcpy(out + i * 4, colors[(indices >> (i * 2)) & 3], 4);
+}
+
+/* decode one channel of eight interpolated values into every fourth byte */
+static
+void
+_S_texformat_bc4(const Suint8 *block,
+                 Suint8 *out)
+{
+	Suint8 values[8];
+	Suint64 indices;
+	Suint32 i;
+	values[0] = block[0];
+	values[1] = block[1];
+	if (values[0] > values[1])
+	{
+		for (i = 1; i < 7; ++i)
+			values[i+1] = ((7 - i) * values[0] + i * values[1]) / 7;
+	}
+	else
+	{
+		for (i = 1; i < 5; ++i)
+			values[i+1] = ((5 - i) * values[0] + i * values[1]) / 5;
+		values[6] = 0;
+		values[7] = 255;
+	}
+	indices = 0;
+	for (i = 0; i < 6; ++i)
+		indices |= (Suint64) block[2+i] << (i * 8);
+	for (i = 0; i < 16; ++i)
+		out[i*4] = values[(indices >> (i * 3)) & 7];
+}
+
+/* read bits from a BC7 block, least significant first */
+static
+Suint32
+_S_texformat_bits(const Suint8 *block,
+                  Suint32 *pos,
+                  Suint32 count)
+{
+	Suint32 value, i;
+	value = 0;
+	for (i = 0; i < count; ++i, ++*pos)
+		value |= ((block[*pos >> 3] >> (*pos & 7)) & 1u) << i;
+	return value;
+}
+
+static
+Suint8
+_S_texformat_bc7_interpolate(Suint8 e0,
+                             Suint8 e1,
+                             Suint32 index,
+                             Suint32 bits)
+{
+	Suint32 w;
+	if (bits == 2)
+		w = bc7_weights2[index];
+	else if (bits == 3)
+		w = bc7_weights3[index];
+	else
+		w = bc7_weights4[index];
+	return ((64 - w) * e0 + w * e1 + 32) >> 6;
+}
+
+static
+void
+_S_texformat_bc7(const Suint8 *block,
+                 Suint8 *out)
+{
+	const _Sbc7_mode *mode;
+	const Suint8 *partition;
+	Suint8 endpoints[6][4], swap, texel[4];
+	Suint32 pos, m, part, rotation, selection, n, i, k, bits, pbit, subset;
+	Suint32 indices[16], indices2[16], ci, ai, cbits, abits;
+	static const Suint8 none[16] = {0};
+
+	for (m = 0; m < 8 && !(block[0] & (1u << m)); ++m);
+	if (m == 8)
+	{
+		/* reserved mode, decoded as transparent black */
+		memset(out, 0, 64);
+		return;
+	}
+	mode = bc7_modes + m;
+	pos = m + 1;
+	part = _S_texformat_bits(block, &pos, mode->partition_bits);
+	rotation = _S_texformat_bits(block, &pos, mode->rotation_bits);
+	selection = _S_texformat_bits(block, &pos, mode->selection_bits);
+	n = mode->subsets * 2;
+
+	/* endpoints are stored channel by channel, then their p-bits */
+	for (k = 0; k < 3; ++k)
+	{
+		for (i = 0; i < n; ++i)
+		{
+			endpoints[i][k] = _S_texformat_bits(block, &pos,
+			                                    mode->color_bits);
+		}
+	}
+	for (i = 0; i < n; ++i)
+	{
+		endpoints[i][3] = mode->alpha_bits ?
+		                  _S_texformat_bits(block, &pos, mode->alpha_bits) :
+		                  255;
+	}
+	pbit = 0;
+	cbits = mode->color_bits;
+	abits = mode->alpha_bits;
+	if (mode->endpoint_pbits || mode->shared_pbits)
+	{
+		for (i = 0; i < n; ++i)
+		{
+			if (mode->endpoint_pbits || i % 2 == 0)
+				pbit = _S_texformat_bits(block, &pos, 1);
+			for (k = 0; k < 3; ++k)
+				endpoints[i][k] = (endpoints[i][k] << 1) | pbit;
+			if (abits)
+				endpoints[i][3] = (endpoints[i][3] << 1) | pbit;
+		}
+		++cbits;
+		if (abits)
+			++abits;
+	}
+	for (i = 0; i < n; ++i)
+	{
+		for (k = 0; k < 3; ++k)
+		{
+			endpoints[i][k] = (endpoints[i][k] << (8 - cbits)) |
+			                  (endpoints[i][k] >> (2 * cbits - 8));
+		}
+		if (abits)
+		{
+			endpoints[i][3] = (endpoints[i][3] << (8 - abits)) |
+			                  (endpoints[i][3] >> (2 * abits - 8));
+		}
+	}
+
+	if (mode->subsets == 2)
+		partition = bc7_partitions2[part];
+	else if (mode->subsets == 3)
+		partition = bc7_partitions3[part];
+	else
+		partition = none;
+	/* the first texel of each subset is stored with one bit less, as the
+	   endpoints are swapped so that its top bit is always zero */
+	for (i = 0; i < 16; ++i)
+	{
+		bits = mode->index_bits;
+		if (i == 0 ||
+		    (mode->subsets == 2 && i == bc7_anchors2[part]) ||
+		    (mode->subsets == 3 && (i == bc7_anchors3[0][part] ||
+		                            i == bc7_anchors3[1][part])))
+			--bits;
+		indices[i] = _S_texformat_bits(block, &pos, bits);
+	}
+	for (i = 0; i < 16 && mode->index2_bits; ++i)
+	{
+		indices2[i] = _S_texformat_bits(block, &pos,
+		                                mode->index2_bits - (i == 0));
+	}
+
+	for (i = 0; i < 16; ++i)
+	{
+		subset = partition[i] * 2;
+		ci = indices[i];
+		ai = indices[i];
+		cbits = abits = mode->index_bits;
+		if (mode->index2_bits)
+		{
+			/* the selection bit swaps which index set is used for colour */
+			if (selection)
+			{
+				ci = indices2[i];
+				cbits = mode->index2_bits;
+			}
+			else
+			{
+				ai = indices2[i];
+				abits = mode->index2_bits;
+			}
+		}
+		for (k = 0; k < 3; ++k)
+		{
+			texel[k] = _S_texformat_bc7_interpolate(endpoints[subset][k],
+			                                        endpoints[subset+1][k],
+			                                        ci, cbits);
+		}
+		texel[3] = _S_texformat_bc7_interpolate(endpoints[subset][3],
+		                                        endpoints[subset+1][3],
+		                                        ai, abits);
+		if (rotation)
+		{
+			swap = texel[3];
+			texel[3] = texel[rotation-1];
+			texel[rotation-1] = swap;
+		}
+		memcpy(out + i * 4, texel, 4);
+	}
+}
+
+/* read the 64 bits of an ETC block, which are stored big-endian */
+static
+Suint64
+_S_texformat_etc_bits(const Suint8 *block)
+{
+	Suint64 bits;
+	Suint32 i;
+	bits = 0;
+	for (i = 0; i < 8; ++i)
+		bits = (bits << 8) | block[i];
+	return bits;
+}
+
+static
+void
+_S_texformat_etc2_paint(Suint8 *out,
+                        Suint64 bits,
+                        Suint8 paint[4][3])
+{
+	Suint32 x, y, i, index;
+	for (y = 0; y < 4; ++y)
+	{
+		for (x = 0; x < 4; ++x)
+		{
+			/* texels are indexed in columns */
+			i = x * 4 + y;
+			index = (((bits >> (16 + i)) & 1) << 1) | ((bits >> i) & 1);
+			memcpy(out + (y * 4 + x) * 4, paint[index], 3);
+			out[(y*4+x)*4+3] = 255;
+		}
+	}
+}
+
+static
+void
+_S_texformat_etc2(const Suint8 *block,
+                  Suint8 *out)
+{
+	Suint64 bits;
+	Sint32 base[2][3], r, g, b, d, value, mod;
+	Sint32 o[3], h[3], v[3];
+	Suint8 paint[4][3];
+	Suint32 x, y, i, k, index, table[2], sub;
+	Sbool flip;
+
+	bits = _S_texformat_etc_bits(block);
+	if (!((bits >> 33) & 1))
+	{
+		/* individual mode, two 4-bit colours */
+		for (k = 0; k < 3; ++k)
+		{
+			base[0][k] = ((bits >> (60 - k * 8)) & 15) * 17;
+			base[1][k] = ((bits >> (56 - k * 8)) & 15) * 17;
+		}
+	}
+	else
+	{
+		r = (bits >> 59) & 31;
+		g = (bits >> 51) & 31;
+		b = (bits >> 43) & 31;
+		/* the deltas are 3-bit two's complement */
+		d = ((bits >> 56) & 7) ^ 4;
+		r += d - 4;
+		d = ((bits >> 48) & 7) ^ 4;
+		g += d - 4;
+		d = ((bits >> 40) & 7) ^ 4;
+		b += d - 4;
+		if (r < 0 || r > 31)
+		{
+			/* T mode */
+			base[0][0] = ((((bits >> 59) & 3) << 2) | ((bits >> 56) & 3)) * 17;
+			base[0][1] = ((bits >> 52) & 15) * 17;
+			base[0][2] = ((bits >> 48) & 15) * 17;
+			base[1][0] = ((bits >> 44) & 15) * 17;
+			base[1][1] = ((bits >> 40) & 15) * 17;
+			base[1][2] = ((bits >> 36) & 15) * 17;
+			d = etc_distances[(((bits >> 34) & 3) << 1) | ((bits >> 32) & 1)];
+			for (k = 0; k < 3; ++k)
+			{
+				paint[0][k] = base[0][k];
+				paint[1][k] = _S_texformat_clamp(base[1][k] + d);
+				paint[2][k] = base[1][k];
+				paint[3][k] = _S_texformat_clamp(base[1][k] - d);
+			}
+			_S_texformat_etc2_paint(out, bits, paint);
+			return;
+		}
+		else if (g < 0 || g > 31)
+		{
+			/* H mode */
+			base[0][0] = ((bits >> 59) & 15);
+			base[0][1] = (((bits >> 56) & 7) << 1) | ((bits >> 52) & 1);
+			base[0][2] = (((bits >> 51) & 1) << 3) | ((bits >> 47) & 7);
+			base[1][0] = ((bits >> 43) & 15);
+			base[1][1] = ((bits >> 39) & 15);
+			base[1][2] = ((bits >> 35) & 15);
+			index = (((bits >> 34) & 1) << 2) | (((bits >> 32) & 1) << 1);
+			if (((base[0][0] << 8) | (base[0][1] << 4) | base[0][2]) >=
+			    ((base[1][0] << 8) | (base[1][1] << 4) | base[1][2]))
+				index |= 1;
+			d = etc_distances[index];
+			for (k = 0; k < 3; ++k)
+			{
+				paint[0][k] = _S_texformat_clamp(base[0][k] * 17 + d);
+				paint[1][k] = _S_texformat_clamp(base[0][k] * 17 - d);
+				paint[2][k] = _S_texformat_clamp(base[1][k] * 17 + d);
+				paint[3][k] = _S_texformat_clamp(base[1][k] * 17 - d);
+			}
+			_S_texformat_etc2_paint(out, bits, paint);
+			return;
+		}
+		else if (b < 0 || b > 31)
+		{
+			/* planar mode, a gradient from three colours */
+			o[0] = (bits >> 57) & 63;
+			o[1] = (((bits >> 56) & 1) << 6) | ((bits >> 49) & 63);
+			o[2] = (((bits >> 48) & 1) << 5) | (((bits >> 43) & 3) << 3) |
+			       ((bits >> 39) & 7);
+			h[0] = (((bits >> 34) & 31) << 1) | ((bits >> 32) & 1);
+			h[1] = (bits >> 25) & 127;
+			h[2] = (bits >> 19) & 63;
+			v[0] = (bits >> 13) & 63;
+			v[1] = (bits >> 6) & 127;
+			v[2] = bits & 63;
+			o[0] = (o[0] << 2) | (o[0] >> 4);
+			o[1] = (o[1] << 1) | (o[1] >> 6);
+			o[2] = (o[2] << 2) | (o[2] >> 4);
+			h[0] = (h[0] << 2) | (h[0] >> 4);
+			h[1] = (h[1] << 1) | (h[1] >> 6);
+			h[2] = (h[2] << 2) | (h[2] >> 4);
+			v[0] = (v[0] << 2) | (v[0] >> 4);
+			v[1] = (v[1] << 1) | (v[1] >> 6);
+			v[2] = (v[2] << 2) | (v[2] >> 4);
+			for (y = 0; y < 4; ++y)
+			{
+				for (x = 0; x < 4; ++x)
+				{
+					for (k = 0; k < 3; ++k)
+					{
+						value = (x * (h[k] - o[k]) + y * (v[k] - o[k]) +
+						         4 * o[k] + 2) >> 2;
+						out[(y*4+x)*4+k] = _S_texformat_clamp(value);
+					}
+					out[(y*4+x)*4+3] = 255;
+				}
+			}
+			return;
+		}
+		/* differential mode, a 5-bit colour and a 3-bit delta */
+		base[0][0] = (bits >> 59) & 31;
+		base[0][1] = (bits >> 51) & 31;
+		base[0][2] = (bits >> 43) & 31;
+		base[1][0] = r;
+		base[1][1] = g;
+		base[1][2] = b;
+		for (i = 0; i < 2; ++i)
+		{
+			for (k = 0; k < 3; ++k)
+				base[i][k] = (base[i][k] << 3) | (base[i][k] >> 2);
+		}
+	}
+	table[0] = (bits >> 37) & 7;
+	table[1] = (bits >> 34) & 7;
+	flip = (bits >> 32) & 1;
+	for (y = 0; y < 4; ++y)
+	{
+		for (x = 0; x < 4; ++x)
+		{
+			i = x * 4 + y;
+			index = (((bits >> (16 + i)) & 1) << 1) | ((bits >> i) & 1);
+			sub = flip ? y >= 2 : x >= 2;
+			mod = etc_modifiers[table[sub]][index];
+			for (k = 0; k < 3; ++k)
+				out[(y*4+x)*4+k] = _S_texformat_clamp(base[sub][k] + mod);
+			out[(y*4+x)*4+3] = 255;
+		}
+	}
+}
+
+static
+void
+_S_texformat_eac(const Suint8 *block,
+                 Suint8 *out)
+{
+	Suint64 bits;
+	Sint32 base, multiplier;
+	Suint32 table, x, y, i;
+	bits = _S_texformat_etc_bits(block);
+	base = (bits >> 56) & 255;
+	multiplier = (bits >> 52) & 15;
+	table = (bits >> 48) & 15;
+	for (y = 0; y < 4; ++y)
+	{
+		for (x = 0; x < 4; ++x)
+		{
+			i = x * 4 + y;
+			out[(y*4+x)*4] = _S_texformat_clamp(base + multiplier *
+			                                    eac_modifiers[table]
+			                                    [(bits >> (45 - i * 3)) & 7]);
+		}
+	}
+}
+
+Ssize_t
+S_texformat_get_size(Senum format,
+                     Suint32 width,
+                     Suint32 height)
+{
+	if (format >= _S_TEXFORMAT_COUNT)
+	{
+		_S_SET_ERROR(S_INVALID_ENUM, "S_texformat_get_size");
+		return 0;
+	}
+	return (Ssize_t) ((width + 3) / 4) * ((height + 3) / 4) *
+	       block_bytes[format];
+}
+
+Sbool
+S_texformat_is_supported(Senum format)
+{
+	if (format >= _S_TEXFORMAT_COUNT)
+	{
+		_S_SET_ERROR(S_INVALID_ENUM, "S_texformat_is_supported");
+		return S_FALSE;
+	}
+	return supported[format];
+}
+
+void
+S_texformat_decode(Senum format,
+                   const Suint8 *blocks,
+                   Suint32 width,
+                   Suint32 height,
+                   Suint8 *rgba)
+{
+	Suint8 texels[64];
+	Suint32 bx, by, x, y, row;
+	if (!blocks || !rgba)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_texformat_decode");
+		return;
+	}
+	else if (format >= _S_TEXFORMAT_COUNT)
+	{
+		_S_SET_ERROR(S_INVALID_ENUM, "S_texformat_decode");
+		return;
+	}
+	for (by = 0; by < height; by += 4)
+	{
+		for (bx = 0; bx < width; bx += 4)
+		{
+			switch (format)
+			{
+			case S_TEXFORMAT_BC1:
+				_S_texformat_bc1(blocks, texels, S_FALSE);
+				break;
+			case S_TEXFORMAT_BC3:
+				_S_texformat_bc1(blocks + 8, texels, S_TRUE);
+				_S_texformat_bc4(blocks, texels + 3);
+				break;
+			case S_TEXFORMAT_BC5:
+				memset(texels, 0, sizeof(texels));
+				_S_texformat_bc4(blocks, texels);
+				_S_texformat_bc4(blocks + 8, texels + 1);
+				for (x = 0; x < 16; ++x)
+					texels[x*4+3] = 255;
+				break;
+			case S_TEXFORMAT_BC7:
+				_S_texformat_bc7(blocks, texels);
+				break;
+			case S_TEXFORMAT_ETC2_RGB:
+				_S_texformat_etc2(blocks, texels);
+				break;
+			case S_TEXFORMAT_ETC2_RGBA:
+				_S_texformat_etc2(blocks + 8, texels);
+				_S_texformat_eac(blocks, texels + 3);
+				break;
+			}
+			blocks += block_bytes[format];
+			/* blocks on the right and bottom edges may hang over */
+			for (y = 0; y < 4 && by + y < height; ++y)
+			{
+				row = width - bx < 4 ? width - bx : 4;
+				memcpy(rgba + ((Ssize_t) (by + y) * width + bx) * 4,
+				       texels + y * 16, row * 4);
+			}
+		}
+	}
+}
+
+void
+_S_texformat_init(void)
+{
+	supported[S_TEXFORMAT_BC1] = GLEW_EXT_texture_compression_s3tc;
+	supported[S_TEXFORMAT_BC3] = GLEW_EXT_texture_compression_s3tc;
+	supported[S_TEXFORMAT_BC5] = GLEW_VERSION_3_0 ||
+	                             GLEW_ARB_texture_compression_rgtc;
+	supported[S_TEXFORMAT_BC7] = GLEW_VERSION_4_2 ||
+	                             GLEW_ARB_texture_compression_bptc;
+	supported[S_TEXFORMAT_ETC2_RGB] = GLEW_VERSION_4_3 ||
+	                                  GLEW_ARB_ES3_compatibility;
+	supported[S_TEXFORMAT_ETC2_RGBA] = GLEW_VERSION_4_3 ||
+	                                   GLEW_ARB_ES3_compatibility;
+}
+
+GLenum
+_S_texformat_get_gl_format(Senum format)
+{
+	return gl_formats[format];
+}
+
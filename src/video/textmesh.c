@@ -0,0 +1,204 @@
+/*
+ * This file is licensed under BSD 3-Clause.
+ * All license information is available in the included COPYING file.
+ */
+
+/*
+ * textmesh.c
+ * Static text mesh source.
+ *
+ * Author       : Finn Rayment <finn@rayment.fr>
+ * Date created : 18/10/2026
+ */
+
+#include <string.h>
+
+#include "sticky/common/error.h"
+#include "sticky/common/includes.h"
+#include "sticky/common/types.h"
+#include "sticky/memory/allocator.h"
+#include "sticky/video/font.h"
+#include "sticky/video/glstate.h"
+#include "sticky/video/textmesh.h"
+
+#define TEXTMESH_MIN_CAPACITY 16
+#define TEXTMESH_CHAR_FLOATS  _S_GLYPH_QUAD_FLOATS
+#define TEXTMESH_CHAR_SIZE    (TEXTMESH_CHAR_FLOATS * sizeof(Sfloat))
+
+/* lay out the text and upload the range of characters that changed, or all of
+   them if force is set */
+static
+void
+_S_textmesh_build(Stextmesh *mesh,
+                  const Schar *text,
+                  Ssize_t len,
+                  Sbool force)
+{
+	Sfloat quad[TEXTMESH_CHAR_FLOATS], *dest;
+	Sfloat x, y;
+	const _Sglyph *glyph;
+	Ssize_t i, count, first, last;
+	if (len > mesh->cap)
+	{
+		while (mesh->cap < len)
+			mesh->cap *= 2;
+		mesh->vertices = (Sfloat *) S_memory_resize(mesh->vertices,
+		                                            mesh->cap *
+		                                            TEXTMESH_CHAR_SIZE);
+		mesh->text = (Schar *) S_memory_resize(mesh->text, mesh->cap);
+		_S_glstate_bind_buffer(GL_ARRAY_BUFFER, mesh->vbo);
+		_S_GL(glBufferData(GL_ARRAY_BUFFER, mesh->cap * TEXTMESH_CHAR_SIZE,
+		                   NULL, GL_DYNAMIC_DRAW));
+		force = S_TRUE;
+	}
+	/* quads of evicted glyphs point at whatever replaced them */
+	if (mesh->generation != _S_font_get_generation(mesh->font))
+		force = S_TRUE;
+	_S_font_tick(mesh->font);
+	first = len;
+	last = 0;
+	x = mesh->x;
+	y = mesh->y;
+	mesh->pages = 0;
+	for (i = 0, count = 0; i < len; ++count)
+	{
+		_S_CALL("_S_font_get_glyph",
+		        glyph = _S_font_get_glyph(mesh->font,
+		                                  _S_font_next_codepoint(text, len,
+		                                                         &i)));
+		if (_S_font_glyph_quad(mesh->font, glyph, mesh->scale, &x, &y, quad))
+			mesh->pages |= 1u << glyph->page;
+		dest = mesh->vertices + count * TEXTMESH_CHAR_FLOATS;
+		if (!force && count < mesh->count &&
+		    memcmp(dest, quad, sizeof(quad)) == 0)
+			continue;
+		memcpy(dest, quad, sizeof(quad));
+		if (first > count)
+			first = count;
+		last = count + 1;
+	}
+	if (len > 0 && text != mesh->text)
+		memcpy(mesh->text, text, len);
+	mesh->len = len;
+	mesh->count = count;
+	mesh->generation = _S_font_get_generation(mesh->font);
+	if (first >= last)
+		return;
+	_S_glstate_bind_buffer(GL_ARRAY_BUFFER, mesh->vbo);
+	_S_GL(glBufferSubData(GL_ARRAY_BUFFER, first * TEXTMESH_CHAR_SIZE,
+	                      (last - first) * TEXTMESH_CHAR_SIZE,
+	                      mesh->vertices + first * TEXTMESH_CHAR_FLOATS));
+}
+
+Stextmesh *
+S_textmesh_new(const Sfont *font,
+               const Schar *text,
+               Ssize_t len,
+               Sfloat x,
+               Sfloat y,
+               Sfloat scale)
+{
+	Stextmesh *mesh;
+	if (!font || (!text && len > 0) || scale <= 0.0f)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_textmesh_new");
+		return NULL;
+	}
+	mesh = (Stextmesh *) S_memory_new(sizeof(Stextmesh));
+	mesh->font = font;
+	mesh->len = 0;
+	mesh->count = 0;
+	mesh->pages = 0;
+	mesh->generation = _S_font_get_generation(font);
+	mesh->cap = len > TEXTMESH_MIN_CAPACITY ? len : TEXTMESH_MIN_CAPACITY;
+	mesh->vertices = (Sfloat *) S_memory_new(mesh->cap * TEXTMESH_CHAR_SIZE);
+	mesh->text = (Schar *) S_memory_new(mesh->cap);
+	mesh->x = x;
+	mesh->y = y;
+	mesh->scale = scale;
+	_S_GL(glGenVertexArrays(1, &mesh->vao));
+	_S_GL(glGenBuffers(1, &mesh->vbo));
+	_S_glstate_bind_vertex_array(mesh->vao);
+	_S_glstate_bind_buffer(GL_ARRAY_BUFFER, mesh->vbo);
+	_S_GL(glBufferData(GL_ARRAY_BUFFER, mesh->cap * TEXTMESH_CHAR_SIZE, NULL,
+	                   GL_DYNAMIC_DRAW));
+	_S_GL(glEnableVertexAttribArray(0));
+	_S_GL(glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, 5 * sizeof(Sfloat),
+	                            (void *) 0));
+	_S_GL(glEnableVertexAttribArray(1));
+	_S_GL(glVertexAttribPointer(1, 1, GL_FLOAT, GL_FALSE, 5 * sizeof(Sfloat),
+	                            (void *) (4 * sizeof(Sfloat))));
+	_S_CALL("_S_textmesh_build",
+	        _S_textmesh_build(mesh, text, len, S_TRUE));
+	return mesh;
+}
+
+void
+S_textmesh_delete(Stextmesh *mesh)
+{
+	if (!mesh)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_textmesh_delete");
+		return;
+	}
+	_S_GL(glDeleteVertexArrays(1, &mesh->vao));
+	_S_glstate_forget_vertex_array(mesh->vao);
+	_S_GL(glDeleteBuffers(1, &mesh->vbo));
+	_S_glstate_forget_buffer(mesh->vbo);
+	S_memory_delete(mesh->vertices);
+	S_memory_delete(mesh->text);
+	S_memory_delete(mesh);
+}
+
+void
+S_textmesh_set_text(Stextmesh *mesh,
+                    const Schar *text,
+                    Ssize_t len)
+{
+	if (!mesh || (!text && len > 0))
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_textmesh_set_text");
+		return;
+	}
+	_S_CALL("_S_textmesh_build",
+	        _S_textmesh_build(mesh, text, len, S_FALSE));
+}
+
+void
+S_textmesh_set_position(Stextmesh *mesh,
+                        Sfloat x,
+                        Sfloat y)
+{
+	if (!mesh)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_textmesh_set_position");
+		return;
+	}
+	if (mesh->x == x && mesh->y == y)
+		return;
+	mesh->x = x;
+	mesh->y = y;
+	_S_CALL("_S_textmesh_build",
+	        _S_textmesh_build(mesh, mesh->text, mesh->len, S_TRUE));
+}
+
+Ssize_t
+S_textmesh_get_length(const Stextmesh *mesh)
+{
+	if (!mesh)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_textmesh_get_length");
+		return 0;
+	}
+	return mesh->len;
+}
+
+
+void
+_S_textmesh_refresh(Stextmesh *mesh)
+{
+	if (mesh->generation == _S_font_get_generation(mesh->font))
+		return;
+	_S_CALL("_S_textmesh_build",
+	        _S_textmesh_build(mesh, mesh->text, mesh->len, S_TRUE));
+}
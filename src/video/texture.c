@@ -11,16 +11,96 @@
  * Date created : 18/04/2021
  */
 
+#include <stdio.h>
+#include <string.h>
+
 #include "sticky/common/error.h"
 #include "sticky/common/includes.h"
 #include "sticky/common/types.h"
+#include "sticky/concurrency/mutex.h"
+#include "sticky/concurrency/thread.h"
+#include "sticky/math/math.h"
 #include "sticky/memory/allocator.h"
+#include "sticky/video/glstate.h"
+#include "sticky/video/texformat.h"
 #include "sticky/video/texture.h"
 
 #define STB_IMAGE_IMPLEMENTATION
 #include <stb/stb_image.h>
 
+#define TEXTURE_MAX_LEVELS 16
+#define TEXTURE_MAX_SIZE   16384 /* largest side read from a container */
+
+#define DDS_CUBEMAP        0x200
+#define DDS_VOLUME         0x200000
+#define DDS_DX10_TEXTURE2D 3
+#define DDS_DX10_CUBEMAP   0x4
+
+/* a compressed image read from a DDS or KTX2 file, with its levels stored
+   one after another from the largest */
+typedef struct _Stexture_image_s
+{
+	Suint8 *blocks;
+	Senum format;
+	Suint32 width, height, levels;
+	Ssize_t offsets[TEXTURE_MAX_LEVELS+1];
+} _Stexture_image;
+
+/* a texture loaded in the background, decoded by a worker and then uploaded
+   by the main thread */
+typedef struct _Stexture_job_s
+{
+	Stexture *texture; /* NULL once the texture is deleted */
+	Stexture_callback callback;
+	void *data;
+	Schar *filename;
+	Suint8 *pixels;
+	Sint32 width, height, channels, row;
+	_Stexture_image image; /* no blocks unless read from a container */
+	Senum error;
+	GLuint tex, pbo;
+	struct _Stexture_job_s *next;
+} _Stexture_job;
+
+typedef struct _Stexture_queue_s
+{
+	_Stexture_job *head, *tail;
+} _Stexture_queue;
+
 static GLint max_units;
+static GLint max_size = TEXTURE_MAX_SIZE;
+static GLuint placeholder;
+static Ssize_t upload_budget = S_TEXTURE_UPLOAD_BUDGET;
+
+/* pending and decoded are shared with the workers under the lock, uploading
+   is only touched by the main thread */
+static Smutex queue_lock;
+static _Stexture_queue pending, decoded, uploading;
+static Sthread workers[S_TEXTURE_WORKERS];
+static Sbool working[S_TEXTURE_WORKERS];
+
+static const Suint8 dds_magic[4] = {'D', 'D', 'S', ' '};
+static const Suint8 ktx2_magic[12] = {
+	0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'
+};
+
+/* DXGI and Vulkan formats of each compressed format, with sRGB images read
+   as linear like any other image */
+static const Suint32 dxgi_formats[][2] = {
+	{71, S_TEXFORMAT_BC1}, {72, S_TEXFORMAT_BC1},
+	{77, S_TEXFORMAT_BC3}, {78, S_TEXFORMAT_BC3},
+	{83, S_TEXFORMAT_BC5},
+	{98, S_TEXFORMAT_BC7}, {99, S_TEXFORMAT_BC7}
+};
+static const Suint32 vk_formats[][2] = {
+	{131, S_TEXFORMAT_BC1}, {132, S_TEXFORMAT_BC1},
+	{133, S_TEXFORMAT_BC1}, {134, S_TEXFORMAT_BC1},
+	{137, S_TEXFORMAT_BC3}, {138, S_TEXFORMAT_BC3},
+	{141, S_TEXFORMAT_BC5},
+	{145, S_TEXFORMAT_BC7}, {146, S_TEXFORMAT_BC7},
+	{147, S_TEXFORMAT_ETC2_RGB}, {148, S_TEXFORMAT_ETC2_RGB},
+	{151, S_TEXFORMAT_ETC2_RGBA}, {152, S_TEXFORMAT_ETC2_RGBA}
+};
 
 static
 Sbool
@@ -64,13 +144,308 @@ _S_texture_load_tex(const Schar *filename,
 	return S_TRUE;
 }
 
+static
+Suint32
+_S_texture_read_uint32(const Suint8 *bytes)
+{
+	return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) |
+	       ((Suint32) bytes[3] << 24);
+}
+
+static
+Sbool
+_S_texture_find_format(const Suint32 (*formats)[2],
+                       Ssize_t count,
+                       Suint32 id,
+                       Senum *format)
+{
+	Ssize_t i;
+	for (i = 0; i < count; ++i)
+	{
+		if (formats[i][0] == id)
+		{
+			*format = formats[i][1];
+			return S_TRUE;
+		}
+	}
+	return S_FALSE;
+}
+
+/* find where each level of an image starts, the levels halving in size down
+   to a single texel */
+static
+Sbool
+_S_texture_image_layout(_Stexture_image *image)
+{
+	Suint32 w, h, i;
+	Ssize_t size;
+	/* bounding the sides keeps every level from overflowing its size */
+	if (image->width == 0 || image->height == 0 ||
+	    image->width > (Suint32) max_size ||
+	    image->height > (Suint32) max_size ||
+	    image->levels > TEXTURE_MAX_LEVELS ||
+	    (image->levels > 1 &&
+	     (image->width | image->height) >> (image->levels - 1) == 0))
+		return S_FALSE;
+	w = image->width;
+	h = image->height;
+	image->offsets[0] = 0;
+	for (i = 0; i < image->levels; ++i)
+	{
+		size = S_texformat_get_size(image->format, w, h);
+		if (size == 0 || size > SIZE_MAX - image->offsets[i])
+			return S_FALSE;
+		image->offsets[i+1] = image->offsets[i] + size;
+		w = w > 1 ? w / 2 : 1;
+		h = h > 1 ? h / 2 : 1;
+	}
+	return S_TRUE;
+}
+
+/* the number of bytes of a file from its current position to its end */
+static
+Sbool
+_S_texture_get_remaining(FILE *fp,
+                         Ssize_t *remaining)
+{
+	long pos, end;
+	if ((pos = ftell(fp)) == -1L || fseek(fp, 0, SEEK_END) != 0 ||
+	    (end = ftell(fp)) == -1L || fseek(fp, pos, SEEK_SET) != 0)
+		return S_FALSE;
+	*remaining = (Ssize_t) (end - pos);
+	return S_TRUE;
+}
+
+/* check whether a file is a DDS or KTX2 container from its magic */
+static
+Sbool
+_S_texture_is_container(const Schar *filename)
+{
+	FILE *fp;
+	Suint8 magic[12];
+	Ssize_t len;
+	if (!(fp = fopen(filename, "rb")))
+		return S_FALSE; /* reported when the file is decoded as an image */
+	len = fread(magic, 1, sizeof(magic), fp);
+	fclose(fp);
+	return (len >= 4 && memcmp(magic, dds_magic, 4) == 0) ||
+	       (len == 12 && memcmp(magic, ktx2_magic, 12) == 0);
+}
+
+/* the levels of a DDS file follow its header from the largest */
+static
+Senum
+_S_texture_read_dds(FILE *fp,
+                    const Suint8 *header,
+                    _Stexture_image *image)
+{
+	Suint8 dx10[20];
+	Ssize_t size, remaining;
+	image->height = _S_texture_read_uint32(header + 12);
+	image->width = _S_texture_read_uint32(header + 16);
+	image->levels = _S_texture_read_uint32(header + 28);
+	if (image->levels == 0)
+		image->levels = 1;
+	if (_S_texture_read_uint32(header + 112) & (DDS_CUBEMAP | DDS_VOLUME))
+		return S_INVALID_FORMAT;
+	if (memcmp(header + 84, "DXT1", 4) == 0)
+	{
+		image->format = S_TEXFORMAT_BC1;
+	}
+	else if (memcmp(header + 84, "DXT5", 4) == 0)
+	{
+		image->format = S_TEXFORMAT_BC3;
+	}
+	else if (memcmp(header + 84, "ATI2", 4) == 0 ||
+	         memcmp(header + 84, "BC5U", 4) == 0)
+	{
+		image->format = S_TEXFORMAT_BC5;
+	}
+	else if (memcmp(header + 84, "DX10", 4) == 0)
+	{
+		if (fread(dx10, 1, sizeof(dx10), fp) != sizeof(dx10))
+			return S_IO_ERROR;
+		if (_S_texture_read_uint32(dx10 + 4) != DDS_DX10_TEXTURE2D ||
+		    _S_texture_read_uint32(dx10 + 8) & DDS_DX10_CUBEMAP ||
+		    _S_texture_read_uint32(dx10 + 12) > 1 ||
+		    !_S_texture_find_format(dxgi_formats,
+		                            sizeof(dxgi_formats) /
+		                            sizeof(*dxgi_formats),
+		                            _S_texture_read_uint32(dx10),
+		                            &image->format))
+			return S_INVALID_FORMAT;
+	}
+	else
+	{
+		return S_INVALID_FORMAT;
+	}
+	if (!_S_texture_image_layout(image))
+		return S_INVALID_FORMAT;
+	size = image->offsets[image->levels];
+	/* a header claiming more than the file holds is corrupt */
+	if (!_S_texture_get_remaining(fp, &remaining))
+		return S_IO_ERROR;
+	if (size > remaining)
+		return S_INVALID_FORMAT;
+	image->blocks = (Suint8 *) S_memory_new(size);
+	if (fread(image->blocks, 1, size, fp) != size)
+		return S_IO_ERROR;
+	return S_NO_ERROR;
+}
+
+/* the levels of a KTX2 file are found through an index following its header,
+   and may be stored in any order */
+static
+Senum
+_S_texture_read_ktx2(FILE *fp,
+                     const Suint8 *header,
+                     _Stexture_image *image)
+{
+	Suint8 index[TEXTURE_MAX_LEVELS*24];
+	Suint64 offset, length, filesize;
+	Ssize_t size;
+	Suint32 i;
+	image->width = _S_texture_read_uint32(header + 20);
+	image->height = _S_texture_read_uint32(header + 24);
+	image->levels = _S_texture_read_uint32(header + 40);
+	if (image->levels == 0)
+		image->levels = 1;
+	/* only single 2D textures which are not supercompressed */
+	if (_S_texture_read_uint32(header + 28) > 1 ||
+	    _S_texture_read_uint32(header + 32) > 1 ||
+	    _S_texture_read_uint32(header + 36) != 1 ||
+	    _S_texture_read_uint32(header + 44) != 0 ||
+	    !_S_texture_find_format(vk_formats,
+	                            sizeof(vk_formats) / sizeof(*vk_formats),
+	                            _S_texture_read_uint32(header + 12),
+	                            &image->format) ||
+	    !_S_texture_image_layout(image))
+		return S_INVALID_FORMAT;
+	if (fread(index, 24, image->levels, fp) != image->levels)
+		return S_IO_ERROR;
+	if (!_S_texture_get_remaining(fp, &size))
+		return S_IO_ERROR;
+	/* the header and index were read from the start of the file */
+	filesize = (Suint64) size + 80 + image->levels * 24;
+	/* every level must lie within the file before anything is allocated */
+	for (i = 0; i < image->levels; ++i)
+	{
+		offset = _S_texture_read_uint32(index + i * 24) |
+		         (Suint64) _S_texture_read_uint32(index + i * 24 + 4) << 32;
+		length = _S_texture_read_uint32(index + i * 24 + 8) |
+		         (Suint64) _S_texture_read_uint32(index + i * 24 + 12) << 32;
+		if (length < image->offsets[i+1] - image->offsets[i] ||
+		    offset > filesize || length > filesize - offset)
+			return S_INVALID_FORMAT;
+	}
+	size = image->offsets[image->levels];
+	image->blocks = (Suint8 *) S_memory_new(size);
+	for (i = 0; i < image->levels; ++i)
+	{
+		offset = _S_texture_read_uint32(index + i * 24) |
+		         (Suint64) _S_texture_read_uint32(index + i * 24 + 4) << 32;
+		size = image->offsets[i+1] - image->offsets[i];
+		if (fseek(fp, (long) offset, SEEK_SET) != 0 ||
+		    fread(image->blocks + image->offsets[i], 1, size, fp) != size)
+			return S_IO_ERROR;
+	}
+	return S_NO_ERROR;
+}
+
+/* read a DDS or KTX2 file without touching the error state, so that it may
+   be read by a worker */
+static
+Senum
+_S_texture_read_container(const Schar *filename,
+                          _Stexture_image *image)
+{
+	FILE *fp;
+	Suint8 header[128];
+	Senum error;
+	image->blocks = NULL;
+	if (!(fp = fopen(filename, "rb")))
+		return S_IO_ERROR;
+	if (fread(header, 1, 80, fp) != 80)
+		error = S_IO_ERROR;
+	else if (memcmp(header, ktx2_magic, 12) == 0)
+		error = _S_texture_read_ktx2(fp, header, image);
+	else if (fread(header + 80, 1, 48, fp) != 48)
+		error = S_IO_ERROR;
+	else
+		error = _S_texture_read_dds(fp, header, image);
+	fclose(fp);
+	if (error != S_NO_ERROR && image->blocks)
+	{
+		S_memory_delete(image->blocks);
+		image->blocks = NULL;
+	}
+	return error;
+}
+
+/* upload every level of a compressed image to the bound texture, decoding
+   them first if the GPU cannot sample the format, and return the number of
+   bytes taken */
+static
+Ssize_t
+_S_texture_image_upload(const _Stexture_image *image)
+{
+	Suint8 *rgba;
+	Suint32 w, h, i;
+	Ssize_t size;
+	GLenum format;
+	Sbool compressed;
+	_S_CALL("S_texformat_is_supported",
+	        compressed = S_texformat_is_supported(image->format));
+	format = _S_texformat_get_gl_format(image->format);
+	rgba = NULL;
+	if (!compressed)
+	{
+		rgba = (Suint8 *) S_memory_new((Ssize_t) image->width *
+		                               image->height * 4);
+	}
+	w = image->width;
+	h = image->height;
+	size = 0;
+	for (i = 0; i < image->levels; ++i)
+	{
+		if (compressed)
+		{
+			_S_GL(glCompressedTexImage2D(GL_TEXTURE_2D, i, format, w, h, 0,
+			                             image->offsets[i+1] -
+			                             image->offsets[i],
+			                             image->blocks + image->offsets[i]));
+			size += image->offsets[i+1] - image->offsets[i];
+		}
+		else
+		{
+			_S_CALL("S_texformat_decode",
+			        S_texformat_decode(image->format,
+			                           image->blocks + image->offsets[i],
+			                           w, h, rgba));
+			_S_GL(glTexImage2D(GL_TEXTURE_2D, i, GL_RGBA, w, h, 0, GL_RGBA,
+			                   GL_UNSIGNED_BYTE, rgba));
+			size += _S_texture_get_size(w, h, S_FALSE);
+		}
+		w = w > 1 ? w / 2 : 1;
+		h = h > 1 ? h / 2 : 1;
+	}
+	/* the levels stored in the file are used instead of generated mipmaps */
+	_S_GL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL,
+	                      image->levels - 1));
+	if (rgba)
+		S_memory_delete(rgba);
+	return size;
+}
+
 Stexture *
 S_texture_load(const Schar *filename)
 {
+	_Stexture_image image;
 	Stexture *tex;
 	Suint8 *data;
 	Sint32 w, h;
 	GLint format;
+	Senum error;
 	Sbool b;
 
 	if (!filename)
@@ -79,30 +454,310 @@ S_texture_load(const Schar *filename)
 		return NULL;
 	}
 
-	_S_CALL("_S_texture_load_tex",
-	        b = _S_texture_load_tex(filename, &w, &h, &format, &data));
-	if (!b)
-		return NULL;
+	image.blocks = NULL;
+	if (_S_texture_is_container(filename))
+	{
+		error = _S_texture_read_container(filename, &image);
+		if (error != S_NO_ERROR)
+		{
+			_S_SET_ERROR(error, "S_texture_load");
+			return NULL;
+		}
+	}
+	else
+	{
+		_S_CALL("_S_texture_load_tex",
+		        b = _S_texture_load_tex(filename, &w, &h, &format, &data));
+		if (!b)
+			return NULL;
+	}
 
 	tex = (Stexture *) S_memory_new(sizeof(Stexture));
 	tex->cubemap = S_FALSE;
+	tex->array = S_FALSE;
+	tex->status = S_TEXTURE_READY;
+	tex->job = NULL;
 
 	_S_GL(glGenTextures(1, &tex->tex));
-	_S_GL(glBindTexture(GL_TEXTURE_2D, tex->tex));
+	_S_glstate_bind_texture(GL_TEXTURE_2D, tex->tex);
 
 	_S_CALL("S_texture_set_filter",
 	        S_texture_set_filter(tex, S_TEXTURE_NEAREST));
 	_S_CALL("S_texture_set_wrap",
 	        S_texture_set_wrap(tex, S_TEXTURE_REPEAT));
 
+	if (image.blocks)
+	{
+		_S_CALL("_S_texture_image_upload",
+		        tex->size = _S_texture_image_upload(&image));
+		S_memory_delete(image.blocks);
+		return tex;
+	}
 	_S_GL(glTexImage2D(GL_TEXTURE_2D, 0, format, w, h, 0,
 	                   format, GL_UNSIGNED_BYTE, data));
 	_S_GL(glGenerateMipmap(GL_TEXTURE_2D));
+	tex->size = _S_texture_get_size(w, h, S_TRUE);
 
 	free(data); /* do not replace with S_memory_delete */
 	return tex;
 }
 
+static
+void
+_S_texture_queue_push(_Stexture_queue *queue,
+                      _Stexture_job *job)
+{
+	job->next = NULL;
+	if (queue->tail)
+		queue->tail->next = job;
+	else
+		queue->head = job;
+	queue->tail = job;
+}
+
+static
+_Stexture_job *
+_S_texture_queue_pop(_Stexture_queue *queue)
+{
+	_Stexture_job *job;
+	job = queue->head;
+	if (!job)
+		return NULL;
+	queue->head = job->next;
+	if (!queue->head)
+		queue->tail = NULL;
+	return job;
+}
+
+/* decode images until there are none left to decode */
+static
+void *
+_S_texture_worker(void *working_void)
+{
+	Sbool *busy;
+	_Stexture_job *job;
+	busy = (Sbool *) working_void;
+	while (1)
+	{
+		_S_CALL("S_mutex_lock", S_mutex_lock(queue_lock));
+		job = _S_texture_queue_pop(&pending);
+		if (!job)
+		{
+			/* cleared under the lock, so a new job always finds either a
+			   busy worker or a free slot */
+			*busy = S_FALSE;
+			_S_CALL("S_mutex_unlock", S_mutex_unlock(queue_lock));
+			return NULL;
+		}
+		_S_CALL("S_mutex_unlock", S_mutex_unlock(queue_lock));
+
+		/* errors are reported by the main thread once the job is picked up,
+		   as neither GL nor _S_SET_ERROR may be called from here, and the
+		   failure reason of stb is shared between threads */
+		if (_S_texture_is_container(job->filename))
+		{
+			job->error = _S_texture_read_container(job->filename,
+			                                       &job->image);
+		}
+		else if (!(job->pixels = stbi_load(job->filename, &job->width,
+		                                   &job->height, &job->channels, 0)))
+		{
+			job->error = S_IO_ERROR;
+		}
+		else if (job->width % 2 != 0 || job->height % 2 != 0 ||
+		         (job->channels != 3 && job->channels != 4))
+		{
+			job->error = job->channels != 3 && job->channels != 4 ?
+			             S_INVALID_CHANNELS : S_INVALID_FORMAT;
+			free(job->pixels); /* do not replace with S_memory_delete */
+			job->pixels = NULL;
+		}
+
+		_S_CALL("S_mutex_lock", S_mutex_lock(queue_lock));
+		_S_texture_queue_push(&decoded, job);
+		_S_CALL("S_mutex_unlock", S_mutex_unlock(queue_lock));
+	}
+}
+
+static
+void
+_S_texture_job_delete(_Stexture_job *job)
+{
+	if (job->texture)
+	{
+		job->texture->job = NULL;
+		job->texture->status = S_TEXTURE_FAILED;
+	}
+	if (job->pbo)
+	{
+		_S_GL(glDeleteBuffers(1, &job->pbo));
+		_S_glstate_forget_buffer(job->pbo);
+	}
+	if (job->tex)
+	{
+		_S_GL(glDeleteTextures(1, &job->tex));
+		_S_glstate_forget_texture(job->tex);
+	}
+	if (job->pixels)
+		free(job->pixels); /* do not replace with S_memory_delete */
+	if (job->image.blocks)
+		S_memory_delete(job->image.blocks);
+	S_memory_delete(job->filename);
+	S_memory_delete(job);
+}
+
+/* swap the texture over from the placeholder to the uploaded image */
+static
+void
+_S_texture_job_finish(_Stexture_job *job)
+{
+	Stexture *texture;
+	texture = job->texture;
+	texture->tex = job->tex;
+	texture->status = S_TEXTURE_READY;
+	texture->job = NULL;
+	job->tex = 0;
+	job->texture = NULL;
+	_S_CALL("S_texture_set_filter",
+	        S_texture_set_filter(texture, texture->filter));
+	_S_CALL("S_texture_set_wrap",
+	        S_texture_set_wrap(texture, texture->wrap));
+	if (job->callback)
+		job->callback(texture, job->data);
+	_S_texture_queue_pop(&uploading);
+	_S_CALL("_S_texture_job_delete", _S_texture_job_delete(job));
+}
+
+/* upload a band of rows of a decoded image and return the number of bytes
+   uploaded, swapping the texture over once the last row is uploaded */
+static
+Ssize_t
+_S_texture_job_upload(_Stexture_job *job,
+                      Ssize_t budget)
+{
+	Ssize_t stride, offset, rows;
+	GLenum format;
+	void *dest;
+	if (job->image.blocks)
+	{
+		/* compressed images are small enough to be uploaded whole */
+		_S_GL(glGenTextures(1, &job->tex));
+		_S_glstate_bind_texture(GL_TEXTURE_2D, job->tex);
+		_S_CALL("_S_texture_image_upload",
+		        job->texture->size = _S_texture_image_upload(&job->image));
+		offset = job->image.offsets[job->image.levels];
+		_S_CALL("_S_texture_job_finish", _S_texture_job_finish(job));
+		return offset;
+	}
+	stride = (Ssize_t) job->width * job->channels;
+	format = job->channels == 4 ? GL_RGBA : GL_RGB;
+	if (!job->tex)
+	{
+		_S_GL(glGenTextures(1, &job->tex));
+		_S_glstate_bind_texture(GL_TEXTURE_2D, job->tex);
+		_S_GL(glTexImage2D(GL_TEXTURE_2D, 0, format, job->width, job->height,
+		                   0, format, GL_UNSIGNED_BYTE, NULL));
+		_S_GL(glGenBuffers(1, &job->pbo));
+		_S_glstate_bind_buffer(GL_PIXEL_UNPACK_BUFFER, job->pbo);
+		_S_GL(glBufferData(GL_PIXEL_UNPACK_BUFFER, stride * job->height, NULL,
+		                   GL_STREAM_DRAW));
+	}
+	rows = budget / stride > 0 ? budget / stride : 1;
+	if (rows > (Ssize_t) (job->height - job->row))
+		rows = job->height - job->row;
+	offset = job->row * stride;
+
+	/* each band is written to its own range of the buffer, so the driver
+	   never has to wait for an earlier band to be copied out */
+	_S_glstate_bind_buffer(GL_PIXEL_UNPACK_BUFFER, job->pbo);
+	_S_GL(dest = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, offset,
+	                              rows * stride,
+	                              GL_MAP_WRITE_BIT |
+	                              GL_MAP_INVALIDATE_RANGE_BIT |
+	                              GL_MAP_UNSYNCHRONIZED_BIT));
+	if (dest)
+	{
+		memcpy(dest, job->pixels + offset, rows * stride);
+		_S_GL(glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER));
+	}
+	else
+	{
+		_S_GL(glBufferSubData(GL_PIXEL_UNPACK_BUFFER, offset, rows * stride,
+		                      job->pixels + offset));
+	}
+	_S_glstate_bind_texture(GL_TEXTURE_2D, job->tex);
+	_S_GL(glPixelStorei(GL_UNPACK_ALIGNMENT, 1));
+	_S_GL(glTexSubImage2D(GL_TEXTURE_2D, 0, 0, job->row, job->width, rows,
+	                      format, GL_UNSIGNED_BYTE, (void *) offset));
+	_S_GL(glPixelStorei(GL_UNPACK_ALIGNMENT, 4));
+	_S_glstate_bind_buffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	job->row += rows;
+	if (job->row < job->height)
+		return rows * stride;
+
+	_S_GL(glGenerateMipmap(GL_TEXTURE_2D));
+	job->texture->size = _S_texture_get_size(job->width, job->height, S_TRUE);
+	_S_CALL("_S_texture_job_finish", _S_texture_job_finish(job));
+	return rows * stride;
+}
+
+Stexture *
+S_texture_load_async(const Schar *filename,
+                     Stexture_callback callback,
+                     void *data)
+{
+	Stexture *tex;
+	_Stexture_job *job;
+	Ssize_t len;
+	Suint32 i;
+
+	if (!filename)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_texture_load_async");
+		return NULL;
+	}
+
+	tex = (Stexture *) S_memory_new(sizeof(Stexture));
+	tex->tex = placeholder;
+	tex->cubemap = S_FALSE;
+	tex->array = S_FALSE;
+	tex->filter = S_TEXTURE_NEAREST;
+	tex->wrap = S_TEXTURE_REPEAT;
+	tex->size = 0;
+	tex->status = S_TEXTURE_LOADING;
+
+	len = strlen(filename) + 1;
+	job = (_Stexture_job *) S_memory_new(sizeof(_Stexture_job));
+	memset(job, 0, sizeof(_Stexture_job));
+	job->texture = tex;
+	job->callback = callback;
+	job->data = data;
+	job->filename = (Schar *) S_memory_new(len);
+	memcpy(job->filename, filename, len);
+	tex->job = job;
+
+	_S_CALL("S_mutex_lock", S_mutex_lock(queue_lock));
+	_S_texture_queue_push(&pending, job);
+	/* wake a worker if any is idle, the busy ones take the job otherwise */
+	for (i = 0; i < S_TEXTURE_WORKERS; ++i)
+	{
+		if (working[i])
+			continue;
+		if (workers[i])
+		{
+			/* the worker has already left the lock for the last time */
+			_S_CALL("S_thread_join", S_thread_join(workers[i]));
+		}
+		working[i] = S_TRUE;
+		_S_CALL("S_thread_new",
+		        workers[i] = S_thread_new(_S_texture_worker,
+		                                  (void *) (working + i)));
+		break;
+	}
+	_S_CALL("S_mutex_unlock", S_mutex_unlock(queue_lock));
+	return tex;
+}
+
 Stexture *
 S_texture_load_cubemap(const Schar *px_filename,
                        const Schar *nx_filename,
@@ -152,9 +807,12 @@ S_texture_load_cubemap(const Schar *px_filename,
 
 	tex = (Stexture *) S_memory_new(sizeof(Stexture));
 	tex->cubemap = S_TRUE;
+	tex->array = S_FALSE;
+	tex->status = S_TEXTURE_READY;
+	tex->job = NULL;
 
 	_S_GL(glGenTextures(1, &tex->tex));
-	_S_GL(glBindTexture(GL_TEXTURE_CUBE_MAP, tex->tex));
+	_S_glstate_bind_texture(GL_TEXTURE_CUBE_MAP, tex->tex);
 
 	_S_CALL("S_texture_set_filter",
 	        S_texture_set_filter(tex, S_TEXTURE_NEAREST));
@@ -173,6 +831,12 @@ S_texture_load_cubemap(const Schar *px_filename,
 	                   w_pz, h_pz, 0, format_pz, GL_UNSIGNED_BYTE, data_pz));
 	_S_GL(glTexImage2D(GL_TEXTURE_CUBE_MAP_NEGATIVE_Z, 0, format_nz,
 	                   w_nz, h_nz, 0, format_nz, GL_UNSIGNED_BYTE, data_nz));
+	tex->size = _S_texture_get_size(w_px, h_px, S_FALSE) +
+	            _S_texture_get_size(w_nx, h_nx, S_FALSE) +
+	            _S_texture_get_size(w_py, h_py, S_FALSE) +
+	            _S_texture_get_size(w_ny, h_ny, S_FALSE) +
+	            _S_texture_get_size(w_pz, h_pz, S_FALSE) +
+	            _S_texture_get_size(w_nz, h_nz, S_FALSE);
 	/* do not replace with S_memory_delete */
 	free(data_px);
 	free(data_nx);
@@ -191,7 +855,14 @@ S_texture_delete(Stexture *texture)
 		_S_SET_ERROR(S_INVALID_VALUE, "S_texture_delete");
 		return;
 	}
-	_S_GL(glDeleteTextures(1, &texture->tex));
+	/* the job is reclaimed once it reaches the main thread again */
+	if (texture->job)
+		texture->job->texture = NULL;
+	if (texture->tex != placeholder)
+	{
+		_S_GL(glDeleteTextures(1, &texture->tex));
+		_S_glstate_forget_texture(texture->tex);
+	}
 	S_memory_delete(texture);
 }
 
@@ -211,11 +882,10 @@ S_texture_set_filter(Stexture *texture,
 		return;
 	}
 	texture->filter = filter;
-	if (texture->cubemap)
-		mode = GL_TEXTURE_CUBE_MAP;
-	else
-		mode = GL_TEXTURE_2D;
-	_S_GL(glBindTexture(mode, texture->tex));
+	if (texture->tex == placeholder)
+		return; /* applied once loaded */
+	mode = _S_texture_get_target(texture);
+	_S_glstate_bind_texture(mode, texture->tex);
 	_S_GL(glTexParameteri(mode, GL_TEXTURE_MIN_FILTER, filter));
 	_S_GL(glTexParameteri(mode, GL_TEXTURE_MAG_FILTER, filter));
 }
@@ -236,21 +906,162 @@ S_texture_set_wrap(Stexture *texture,
 		return;
 	}
 	texture->wrap = wrap;
-	if (texture->cubemap)
-		mode = GL_TEXTURE_CUBE_MAP;
-	else
-		mode = GL_TEXTURE_2D;
-	_S_GL(glBindTexture(mode, texture->tex));
+	if (texture->tex == placeholder)
+		return; /* applied once loaded */
+	mode = _S_texture_get_target(texture);
+	_S_glstate_bind_texture(mode, texture->tex);
 	_S_GL(glTexParameteri(mode, GL_TEXTURE_WRAP_S, wrap));
 	_S_GL(glTexParameteri(mode, GL_TEXTURE_WRAP_T, wrap));
 	_S_GL(glTexParameteri(mode, GL_TEXTURE_WRAP_R, wrap));
 }
 
+Senum
+S_texture_get_status(const Stexture *texture)
+{
+	if (!texture)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_texture_get_status");
+		return S_TEXTURE_FAILED;
+	}
+	return texture->status;
+}
+
+void
+S_texture_set_upload_budget(Ssize_t budget)
+{
+	if (budget == 0)
+	{
+		_S_SET_ERROR(S_INVALID_VALUE, "S_texture_set_upload_budget");
+		return;
+	}
+	upload_budget = budget;
+}
+
+/* textures are taken to be stored with four bytes per texel whatever their
+   channels, and a full chain of mipmaps adds a third */
+Ssize_t
+_S_texture_get_size(Suint32 width,
+                    Suint32 height,
+                    Sbool mipmaps)
+{
+	Ssize_t size;
+	size = (Ssize_t) width * height * 4;
+	return mipmaps ? size + size / 3 : size;
+}
+
+GLenum
+_S_texture_get_target(const Stexture *texture)
+{
+	if (texture->cubemap)
+		return GL_TEXTURE_CUBE_MAP;
+	else if (texture->array)
+		return GL_TEXTURE_2D_ARRAY;
+	return GL_TEXTURE_2D;
+}
+
 void
 _S_texture_init(void)
 {
+	/* opaque mid-grey shown by textures until they are loaded */
+	static const Suint8 grey[16] = {
+		128, 128, 128, 255, 128, 128, 128, 255,
+		128, 128, 128, 255, 128, 128, 128, 255
+	};
 	_S_GL(glGetIntegerv(GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS, &max_units));
 	S_debug("GL max combined texture image units: %d\n", max_units);
+	_S_GL(glGetIntegerv(GL_MAX_TEXTURE_SIZE, &max_size));
+	max_size = S_imin(S_imax(max_size, 1), TEXTURE_MAX_SIZE);
+	_S_CALL("_S_texformat_init", _S_texformat_init());
+	_S_GL(glGenTextures(1, &placeholder));
+	_S_glstate_bind_texture(GL_TEXTURE_2D, placeholder);
+	_S_GL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST));
+	_S_GL(glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST));
+	_S_GL(glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 2, 2, 0, GL_RGBA,
+	                   GL_UNSIGNED_BYTE, grey));
+	if (!queue_lock)
+	{
+		_S_CALL("S_mutex_new", queue_lock = S_mutex_new());
+	}
+}
+
+void
+_S_texture_free(void)
+{
+	_Stexture_job *job;
+	Suint32 i;
+	/* abandon the images not yet decoded, and wait for the rest, leaving
+	   their textures with no texture at all once the placeholder is gone */
+	_S_CALL("S_mutex_lock", S_mutex_lock(queue_lock));
+	while ((job = _S_texture_queue_pop(&pending)))
+	{
+		if (job->texture)
+			job->texture->tex = 0;
+		_S_CALL("_S_texture_job_delete", _S_texture_job_delete(job));
+	}
+	_S_CALL("S_mutex_unlock", S_mutex_unlock(queue_lock));
+	for (i = 0; i < S_TEXTURE_WORKERS; ++i)
+	{
+		if (!workers[i])
+			continue;
+		_S_CALL("S_thread_join", S_thread_join(workers[i]));
+		workers[i] = NULL;
+		working[i] = S_FALSE;
+	}
+	while ((job = _S_texture_queue_pop(&decoded)))
+	{
+		if (job->texture)
+			job->texture->tex = 0;
+		_S_CALL("_S_texture_job_delete", _S_texture_job_delete(job));
+	}
+	while ((job = _S_texture_queue_pop(&uploading)))
+	{
+		if (job->texture)
+			job->texture->tex = 0;
+		_S_CALL("_S_texture_job_delete", _S_texture_job_delete(job));
+	}
+	_S_CALL("S_mutex_delete", S_mutex_delete(queue_lock));
+	queue_lock = NULL;
+	_S_GL(glDeleteTextures(1, &placeholder));
+	_S_glstate_forget_texture(placeholder);
+	placeholder = 0;
+}
+
+void
+_S_texture_update(void)
+{
+	_Stexture_job *job;
+	Ssize_t budget, spent;
+	if (!queue_lock)
+		return;
+	_S_CALL("S_mutex_lock", S_mutex_lock(queue_lock));
+	while ((job = _S_texture_queue_pop(&decoded)))
+		_S_texture_queue_push(&uploading, job);
+	_S_CALL("S_mutex_unlock", S_mutex_unlock(queue_lock));
+
+	budget = upload_budget;
+	while ((job = uploading.head) && budget > 0)
+	{
+		if (!job->texture || (!job->pixels && !job->image.blocks))
+		{
+			/* deleted while loading, or failed to decode */
+			if (job->texture)
+			{
+				S_warning("Failed to load texture '%s'.\n", job->filename);
+				_S_SET_ERROR(job->error, "_S_texture_update");
+				job->texture->status = S_TEXTURE_FAILED;
+				job->texture->job = NULL;
+				if (job->callback)
+					job->callback(job->texture, job->data);
+				job->texture = NULL;
+			}
+			_S_texture_queue_pop(&uploading);
+			_S_CALL("_S_texture_job_delete", _S_texture_job_delete(job));
+			continue;
+		}
+		_S_CALL("_S_texture_job_upload",
+		        spent = _S_texture_job_upload(job, budget));
+		budget = spent < budget ? budget - spent : 0;
+	}
 }
 
 void
@@ -267,14 +1078,7 @@ _S_texture_attach(const Stexture *texture,
 		_S_SET_ERROR(S_INVALID_INDEX, "_S_texture_attach");
 		return;
 	}
-	_S_GL(glActiveTexture(GL_TEXTURE0 + idx));
-	if (texture->cubemap)
-	{
-		_S_GL(glBindTexture(GL_TEXTURE_CUBE_MAP, texture->tex));
-	}
-	else
-	{
-		_S_GL(glBindTexture(GL_TEXTURE_2D, texture->tex));
-	}
+	_S_glstate_active_texture(idx);
+	_S_glstate_bind_texture(_S_texture_get_target(texture), texture->tex);
 }
 
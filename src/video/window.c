@@ -27,6 +27,8 @@
 #include "sticky/memory/allocator.h"
 #include "sticky/video/draw.h"
 #include "sticky/video/font.h"
+#include "sticky/video/glstate.h"
+#include "sticky/video/shader.h"
 #include "sticky/video/texture.h"
 #include "sticky/video/window.h"
 
@@ -109,6 +111,7 @@ S_window_delete(Swindow *window)
 		_S_CALL("S_camera_attach", S_camera_attach(window->cam, NULL, S_FALSE));
 	}
 	_S_CALL("S_transform_delete", S_transform_delete(window->dtrans));
+	_S_CALL("_S_texture_free", _S_texture_free());
 	_S_CALL("_S_font_free", _S_font_free());
 	_S_CALL("_S_draw_free", _S_draw_free());
 	SDL_GL_DeleteContext(window->context);
@@ -198,6 +201,8 @@ S_window_apply(Swindow *window)
 		if ((glew = glewInit()) != GLEW_OK)
 			_S_error_glew("S_sticky_init", glew);
 		/* other init that requires GL */
+		_S_CALL("_S_glstate_reset", _S_glstate_reset());
+		_S_CALL("_S_shader_init", _S_shader_init());
 		_S_CALL("_S_texture_init", _S_texture_init());
 		_S_CALL("_S_draw_init",
 		        _S_draw_init(window->gl_major, window->gl_minor));
@@ -227,9 +232,9 @@ S_window_apply(Swindow *window)
 	/* viewport */
 	_S_CALL("_S_window_recalculate_viewport",
 	        _S_window_recalculate_viewport(window));
-	_S_GL(glEnable(GL_DEPTH_TEST));
-	_S_GL(glEnable(GL_BLEND));
-	_S_GL(glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA));
+	_S_glstate_enable(GL_DEPTH_TEST);
+	_S_glstate_enable(GL_BLEND);
+	_S_glstate_blend_func(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 	/* ticks */
 	window->skip_ticks = 1000 / window->tick_limit;
 	window->next_tick = SDL_GetTicks();
@@ -345,6 +350,8 @@ S_window_swap(Swindow *window)
 		_S_SET_ERROR(S_INVALID_VALUE, "S_window_swap");
 		return;
 	}
+	_S_CALL("S_draw_debug_flush", S_draw_debug_flush(window));
+	_S_CALL("_S_texture_update", _S_texture_update());
 	SDL_GL_SwapWindow(window->window);
 }
 
@@ -0,0 +1,242 @@
+/*
+ * This file is licensed under BSD 3-Clause.
+ * All license information is available in the included COPYING file.
+ */
+
+/*
+ * meshopt.c
+ * Mesh optimisation test suite.
+ *
+ * Author       : Finn Rayment <finn@rayment.fr>
+ * Date created : 18/10/2026
+ */
+
+#include "test_common.h"
+
+#define GRID       64
+#define TRIANGLES  (GRID * GRID * 2)
+#define VERTICES   (TRIANGLES * 3)
+
+Sfloat vertices[VERTICES*3], normals[VERTICES*3];
+Suint64 expected[TRIANGLES], actual[TRIANGLES];
+Suint32 lod[VERTICES];
+
+Sfloat
+height(Suint32 x,
+       Suint32 y)
+{
+	return S_sin(x * 0.2f) * S_cos(y * 0.3f);
+}
+
+/* an unindexed height field, with each triangle given its own copy of its
+   vertices and the triangles shuffled */
+void
+mesh_gen(void)
+{
+	Suint32 x, y, t, i, j, corners[6][2] =
+	{
+		{0, 0}, {1, 0}, {1, 1},
+		{0, 0}, {1, 1}, {0, 1}
+	};
+	Sfloat tmp[9];
+	t = 0;
+	for (y = 0; y < GRID; ++y)
+	{
+		for (x = 0; x < GRID; ++x)
+		{
+			for (i = 0; i < 6; ++i, ++t)
+			{
+				vertices[t*3] = x + corners[i][0];
+				vertices[t*3+1] = y + corners[i][1];
+				vertices[t*3+2] = height(x + corners[i][0], y + corners[i][1]);
+				normals[t*3] = 0.0f;
+				normals[t*3+1] = 0.0f;
+				normals[t*3+2] = 1.0f;
+			}
+		}
+	}
+	for (t = TRIANGLES - 1; t > 0; --t)
+	{
+		j = S_random_next_uint32() % (t + 1);
+		memcpy(tmp, vertices + t * 9, sizeof(tmp));
+		memcpy(vertices + t * 9, vertices + j * 9, sizeof(tmp));
+		memcpy(vertices + j * 9, tmp, sizeof(tmp));
+	}
+}
+
+Scomparator
+comparator(const void *a,
+           const void *b)
+{
+	Suint64 x, y;
+	x = *((Suint64 *) a);
+	y = *((Suint64 *) b);
+	if (x < y)
+		return -1;
+	else if (x == y)
+		return 0;
+	else
+		return 1;
+}
+
+/* hash each triangle by its positions, starting from the smallest corner so
+   that rotations match but reversed windings do not */
+void
+triangle_keys(const Smeshopt *opt,
+              Suint64 *keys)
+{
+	Sfloat corners[9];
+	Suint32 t, i, first, v;
+	for (t = 0; t < opt->icount / 3; ++t)
+	{
+		first = 0;
+		for (i = 1; i < 3; ++i)
+		{
+			if (memcmp(opt->vertices + opt->indices[t*3+i] * 3,
+			           opt->vertices + opt->indices[t*3+first] * 3,
+			           3 * sizeof(Sfloat)) < 0)
+				first = i;
+		}
+		for (i = 0; i < 3; ++i)
+		{
+			v = opt->indices[t*3+(first+i)%3];
+			memcpy(corners + i * 3, opt->vertices + v * 3, 3 * sizeof(Sfloat));
+		}
+		keys[t] = ((Suint64) S_hash_fnv1a(corners, sizeof(corners)) << 32) |
+		          S_hash_fnv1a(corners + 3, 6 * sizeof(Sfloat));
+	}
+	S_qsort(keys, opt->icount / 3, sizeof(Suint64), comparator);
+}
+
+/* check that vertices are numbered in the order they are first used */
+Sbool
+in_fetch_order(const Smeshopt *opt)
+{
+	Suint32 next;
+	Ssize_t i;
+	next = 0;
+	for (i = 0; i < opt->icount; ++i)
+	{
+		if (opt->indices[i] > next)
+			return S_FALSE;
+		if (opt->indices[i] == next)
+			++next;
+	}
+	return next == opt->vcount;
+}
+
+/* check that a level of detail only refers to existing vertices and has no
+   degenerate triangles */
+Sbool
+valid_lod(const Smeshopt *opt,
+          Ssize_t count)
+{
+	Ssize_t i;
+	for (i = 0; i < count; ++i)
+	{
+		if (lod[i] >= opt->vcount)
+			return S_FALSE;
+	}
+	for (i = 0; i < count; i += 3)
+	{
+		if (lod[i] == lod[i+1] || lod[i+1] == lod[i+2] || lod[i+2] == lod[i])
+			return S_FALSE;
+	}
+	return S_TRUE;
+}
+
+int
+main(void)
+{
+	Smeshopt *opt;
+	Smeshopt_stats before, after, stats;
+	Suint32 indices[4] = {0, 1, 2, 0};
+	Ssize_t count, i;
+	Sfloat error;
+	Sbool b;
+
+	INIT();
+
+	mesh_gen();
+	opt = S_meshopt_new(vertices, VERTICES * 3, NULL, 0,
+	                    normals, VERTICES * 3, NULL, 0);
+	triangle_keys(opt, expected);
+
+	TEST(
+		S_meshopt_analyze(opt, S_MESHOPT_CACHE_SIZE, &stats);
+	, stats.acmr == 3.0f && stats.atvr == 1.0f
+	, "S_meshopt_analyze (unindexed)");
+
+	TEST(
+		S_meshopt_deduplicate(opt);
+	, opt->vcount == (GRID + 1) * (GRID + 1) && opt->icount == VERTICES
+	, "S_meshopt_deduplicate");
+
+	TEST(
+		S_meshopt_optimize(opt, &before, &after);
+		ATOMIC_PRINT("\nACMR    : %f -> %f\n", before.acmr, after.acmr);
+		ATOMIC_PRINT("ATVR    : %f -> %f\n", before.atvr, after.atvr);
+	, after.acmr < before.acmr && after.atvr < before.atvr &&
+	  after.acmr < 1.0f && after.atvr >= 1.0f
+	, "S_meshopt_optimize (cache efficiency)");
+
+	TEST(
+		triangle_keys(opt, actual);
+	, memcmp(expected, actual, sizeof(expected)) == 0
+	, "S_meshopt_optimize (same triangles)");
+
+	TEST(
+	, in_fetch_order(opt)
+	, "S_meshopt_optimize (fetch order)");
+
+	S_meshopt_delete(opt);
+
+	TEST(
+		opt = S_meshopt_new(vertices, 9, indices, 4, NULL, 0, NULL, 0);
+		b = SERRNO == S_INVALID_VALUE && !opt;
+		SERRNO = S_NO_ERROR;
+	, b
+	, "S_meshopt_new (partial triangle)");
+
+	mesh_gen();
+	opt = S_meshopt_new(vertices, VERTICES * 3, NULL, 0, NULL, 0, NULL, 0);
+	S_meshopt_deduplicate(opt);
+
+	TEST(
+		count = S_meshopt_simplify(opt, VERTICES / 4, 1.0f, lod, &error);
+		ATOMIC_PRINT("\nLOD     : %d -> %d (error %f)\n",
+		             (int) opt->icount, (int) count, error);
+	, count <= VERTICES / 4 && count % 3 == 0 && valid_lod(opt, count) &&
+	  error > 0.0f && error <= 1.0f
+	, "S_meshopt_simplify");
+
+	TEST(
+		count = S_meshopt_simplify(opt, 0, 0.0f, lod, &error);
+	, count == opt->icount && error == 0.0f
+	, "S_meshopt_simplify (no error)");
+
+	/* flatten the height field, so that only its border must remain */
+	for (i = 0; i < opt->vcount; ++i)
+		opt->vertices[i*3+2] = 0.0f;
+
+	TEST(
+		count = S_meshopt_simplify(opt, 0, 0.0f, lod, &error);
+		ATOMIC_PRINT("\nLOD     : %d -> %d (flat)\n",
+		             (int) opt->icount, (int) count);
+	, count < opt->icount / 16 && valid_lod(opt, count) && error == 0.0f
+	, "S_meshopt_simplify (flat)");
+
+	S_meshopt_delete(opt);
+
+	mesh_gen();
+	opt = S_meshopt_new(vertices, VERTICES * 3, NULL, 0, NULL, 0, NULL, 0);
+	TIME(
+		S_meshopt_optimize(opt, NULL, NULL);
+	, "S_meshopt_optimize", 1);
+	S_meshopt_delete(opt);
+
+	FREE();
+
+	return EXIT_SUCCESS;
+}
+
@@ -0,0 +1,125 @@
+/*
+ * This file is licensed under BSD 3-Clause.
+ * All license information is available in the included COPYING file.
+ */
+
+/*
+ * rsort.c
+ * Radix sort algorithm test suite.
+ *
+ * Author       : Finn Rayment <finn@rayment.fr>
+ * Date created : 18/10/2026
+ */
+
+#include "test_common.h"
+
+#define NUM_KEYS 1048576
+
+Suint64 keys[NUM_KEYS], original[NUM_KEYS], tmpkeys[NUM_KEYS];
+Suint32 values[NUM_KEYS], tmpvalues[NUM_KEYS];
+
+void
+key_gen(Suint64 mask)
+{
+	Suint32 i;
+	for (i = 0; i < NUM_KEYS; ++i)
+	{
+		keys[i] = S_random_next_uint64() & mask;
+		original[i] = keys[i];
+		values[i] = i;
+	}
+}
+
+/* check that the keys are in order, that each value still refers to its
+   original key and that equal keys kept their order */
+Sbool
+in_order(void)
+{
+	Suint32 i;
+	for (i = 0; i < NUM_KEYS; ++i)
+	{
+		if (original[values[i]] != keys[i])
+			return S_FALSE;
+		if (i > 0 && (keys[i] < keys[i-1] ||
+		              (keys[i] == keys[i-1] && values[i] < values[i-1])))
+			return S_FALSE;
+	}
+	return S_TRUE;
+}
+
+Scomparator
+comparator(const void *a,
+           const void *b)
+{
+	Suint64 x, y;
+	x = *((Suint64 *) a);
+	y = *((Suint64 *) b);
+	if (x < y)
+		return -1;
+	else if (x == y)
+		return 0;
+	else
+		return 1;
+}
+
+int
+main(void)
+{
+	Sbool b;
+
+	INIT();
+
+	key_gen(S_UINT64_MAX);
+	TEST(
+		S_rsort(keys, values, NUM_KEYS, tmpkeys, tmpvalues);
+	, in_order()
+	, "S_rsort (random)");
+
+	TEST(
+		S_rsort(keys, values, NUM_KEYS, tmpkeys, tmpvalues);
+	, in_order()
+	, "S_rsort (already sorted)");
+
+	/* many duplicates, and bytes that every key shares */
+	key_gen(0x0f000000ff0000f0ull);
+	TEST(
+		S_rsort(keys, values, NUM_KEYS, tmpkeys, tmpvalues);
+	, in_order()
+	, "S_rsort (duplicates)");
+
+	key_gen(S_UINT64_MAX);
+	TEST(
+		S_rsort(keys, NULL, NUM_KEYS, tmpkeys, NULL);
+		S_qsort(original, NUM_KEYS, sizeof(Suint64), comparator);
+	, memcmp(keys, original, sizeof(keys)) == 0
+	, "S_rsort (no values)");
+
+	TEST(
+		S_rsort(keys, values, NUM_KEYS, tmpkeys, NULL);
+		b = SERRNO == S_INVALID_VALUE;
+		SERRNO = S_NO_ERROR;
+	, b
+	, "S_rsort (missing scratch)");
+
+	TEST(
+		S_rsort(keys, values, 0, tmpkeys, tmpvalues);
+		b = SERRNO == S_INVALID_OPERATION;
+		SERRNO = S_NO_ERROR;
+	, b
+	, "S_rsort (empty)");
+
+	key_gen(S_UINT64_MAX);
+	TIME(
+		S_qsort(keys, NUM_KEYS, sizeof(Suint64), comparator);
+	, "S_qsort", 1);
+
+	key_gen(S_UINT64_MAX);
+	TIME(
+		S_rsort(keys, values, NUM_KEYS, tmpkeys, tmpvalues);
+	, "S_rsort", 1);
+
+	FREE();
+
+	return EXIT_SUCCESS;
+}
+
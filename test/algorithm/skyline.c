@@ -0,0 +1,122 @@
+/*
+ * This file is licensed under BSD 3-Clause.
+ * All license information is available in the included COPYING file.
+ */
+
+/*
+ * skyline.c
+ * Skyline rectangle packing test suite.
+ *
+ * Author       : Finn Rayment <finn@rayment.fr>
+ * Date created : 18/10/2026
+ */
+
+#include "test_common.h"
+
+#define SIZE     512
+#define NUM_RECT 4096
+
+Suint32 xs[NUM_RECT], ys[NUM_RECT], ws[NUM_RECT], hs[NUM_RECT];
+Suint8 used[SIZE*SIZE];
+
+/* glyph-like rectangles of similar heights */
+void
+rect_gen(void)
+{
+	Suint32 i;
+	for (i = 0; i < NUM_RECT; ++i)
+	{
+		ws[i] = 4 + S_random_next_uint32() % 20;
+		hs[i] = 16 + S_random_next_uint32() % 8;
+	}
+}
+
+/* pack until the first failure and return the number of rectangles packed */
+Suint32
+pack(Sskyline *skyline)
+{
+	Suint32 i;
+	for (i = 0; i < NUM_RECT; ++i)
+	{
+		if (!S_skyline_pack(skyline, ws[i], hs[i], xs + i, ys + i))
+			break;
+	}
+	return i;
+}
+
+/* check that each rectangle lies within the area and covers no other */
+Sbool
+no_overlap(Suint32 count)
+{
+	Suint32 i, x, y;
+	memset(used, 0, sizeof(used));
+	for (i = 0; i < count; ++i)
+	{
+		if (xs[i] + ws[i] > SIZE || ys[i] + hs[i] > SIZE)
+			return S_FALSE;
+		for (y = ys[i]; y < ys[i] + hs[i]; ++y)
+		{
+			for (x = xs[i]; x < xs[i] + ws[i]; ++x)
+			{
+				if (used[y*SIZE+x])
+					return S_FALSE;
+				used[y*SIZE+x] = 1;
+			}
+		}
+	}
+	return S_TRUE;
+}
+
+int
+main(void)
+{
+	Sskyline *skyline;
+	Suint32 count, x, y;
+	Sfloat occupancy;
+	Sbool b;
+
+	INIT();
+
+	rect_gen();
+	skyline = S_skyline_new(SIZE, SIZE);
+
+	TEST(
+		count = pack(skyline);
+		occupancy = S_skyline_get_occupancy(skyline);
+		ATOMIC_PRINT("\nPACKED  : %u (occupancy %f)\n", count, occupancy);
+	, count > 0 && count < NUM_RECT && occupancy > 0.85f
+	, "S_skyline_pack (occupancy)");
+
+	TEST(
+	, no_overlap(count)
+	, "S_skyline_pack (no overlap)");
+
+	TEST(
+		S_skyline_clear(skyline);
+		b = S_skyline_pack(skyline, SIZE, SIZE, &x, &y);
+	, b && x == 0 && y == 0 && S_skyline_get_occupancy(skyline) == 1.0f
+	, "S_skyline_clear");
+
+	TEST(
+		b = S_skyline_pack(skyline, 1, 1, &x, &y);
+	, !b
+	, "S_skyline_pack (full)");
+
+	TEST(
+		S_skyline_clear(skyline);
+		b = S_skyline_pack(skyline, SIZE + 1, 1, &x, &y);
+	, !b && skyline->len == 1
+	, "S_skyline_pack (too large)");
+
+	TIME(
+		S_skyline_clear(skyline);
+		pack(skyline);
+	, "S_skyline_pack", 100);
+
+	S_skyline_delete(skyline);
+
+	FREE();
+
+	return EXIT_SUCCESS;
+}
+
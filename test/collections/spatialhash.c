@@ -0,0 +1,255 @@
+/*
+ * This file is licensed under BSD 3-Clause.
+ * All license information is available in the included COPYING file.
+ */
+
+/*
+ * spatialhash.c
+ * Spatial hash test suite.
+ *
+ * Author       : Finn Rayment <finn@rayment.fr>
+ * Date created : 18/10/2026
+ */
+
+#include "test_common.h"
+
+#define OBJECTS 10000
+
+Svec3 points[OBJECTS];
+Sfloat radii[OBJECTS];
+Suint32 handles[OBJECTS], out[OBJECTS];
+Sbool alive[OBJECTS], seen[OBJECTS];
+
+Sfloat
+random_range(Sfloat range)
+{
+	return (S_random_next_float() * 2.0f - 1.0f) * range;
+}
+
+void
+random_point(Ssize_t i)
+{
+	S_vec3_set(points+i, random_range(200.0f), random_range(200.0f),
+	           random_range(200.0f));
+}
+
+Sbool
+in_radius(Ssize_t i,
+          const Svec3 *centre,
+          Sfloat radius)
+{
+	Svec3 d;
+	S_vec3_copy(&d, points+i);
+	S_vec3_subtract(&d, centre);
+	return S_vec3_dot(&d, &d) <= (radii[i] + radius) * (radii[i] + radius);
+}
+
+Sbool
+in_bounds(Ssize_t i,
+          const Svec3 *min,
+          const Svec3 *max)
+{
+	Sfloat x, y, z;
+	x = S_max(S_max(min->x - points[i].x, 0.0f), points[i].x - max->x);
+	y = S_max(S_max(min->y - points[i].y, 0.0f), points[i].y - max->y);
+	z = S_max(S_max(min->z - points[i].z, 0.0f), points[i].z - max->z);
+	return x*x + y*y + z*z <= radii[i] * radii[i];
+}
+
+/* check that the output of a query matches a brute-force test, where handles
+   map to object indices through the user pointer */
+Sbool
+compare(const Sspatialhash *hash,
+        Ssize_t count,
+        const Svec3 *centre,
+        Sfloat radius,
+        const Svec3 *min,
+        const Svec3 *max)
+{
+	Ssize_t i, idx, expected;
+	Sbool v;
+	for (i = 0; i < OBJECTS; ++i)
+		seen[i] = S_FALSE;
+	for (i = 0; i < count; ++i)
+	{
+		idx = (Ssize_t) S_spatialhash_get(hash, out[i]) - 1;
+		if (seen[idx] || handles[idx] != out[i])
+			return S_FALSE;
+		seen[idx] = S_TRUE;
+	}
+	expected = 0;
+	for (i = 0; i < OBJECTS; ++i)
+	{
+		if (!alive[i])
+			v = S_FALSE;
+		else if (centre)
+			v = in_radius(i, centre, radius);
+		else
+			v = in_bounds(i, min, max);
+		if (v != seen[i])
+			return S_FALSE;
+		expected += v;
+	}
+	return expected == count;
+}
+
+Sbool
+compare_queries(const Sspatialhash *hash)
+{
+	Svec3 vec1, vec2;
+	Ssize_t i, count;
+	for (i = 0; i < 50; ++i)
+	{
+		S_vec3_set(&vec1, random_range(200.0f), random_range(200.0f),
+		           random_range(200.0f));
+		count = S_spatialhash_query_radius(hash, &vec1, 15.0f, out, OBJECTS);
+		if (!compare(hash, count, &vec1, 15.0f, NULL, NULL))
+			return S_FALSE;
+		S_vec3_set(&vec2, vec1.x + 20.0f, vec1.y + 10.0f, vec1.z + 30.0f);
+		count = S_spatialhash_query_bounds(hash, &vec1, &vec2, out, OBJECTS);
+		if (!compare(hash, count, NULL, 0.0f, &vec1, &vec2))
+			return S_FALSE;
+	}
+	/* large queries fall back to testing every entry */
+	S_vec3_set(&vec1, 0.0f, 0.0f, 0.0f);
+	count = S_spatialhash_query_radius(hash, &vec1, 1000.0f, out, OBJECTS);
+	return compare(hash, count, &vec1, 1000.0f, NULL, NULL);
+}
+
+int
+main(void)
+{
+	Sspatialhash *hash;
+	Svec3 vec1;
+	Ssize_t i, count;
+	Suint32 h;
+	Sbool b;
+
+	INIT();
+
+	TEST(
+		hash = S_spatialhash_new(0.0f);
+		b = SERRNO == S_INVALID_VALUE;
+		SERRNO = S_NO_ERROR;
+	, !hash && b
+	, "S_spatialhash_new (invalid size)");
+
+	TEST(
+		hash = S_spatialhash_new(16.0f);
+	, hash && S_spatialhash_size(hash) == 0
+	, "S_spatialhash_new");
+
+	TEST(
+		S_vec3_set(&vec1, 0.0f, 0.0f, 0.0f);
+		count = S_spatialhash_query_radius(hash, &vec1, 10.0f, out, OBJECTS);
+	, count == 0
+	, "S_spatialhash_query_radius (empty)");
+
+	TEST(
+		for (i = 0; i < OBJECTS; ++i)
+		{
+			random_point(i);
+			radii[i] = S_random_next_float() * 2.0f;
+			alive[i] = S_TRUE;
+			/* store index + 1 so that no user pointer is NULL */
+			handles[i] = S_spatialhash_insert(hash, points+i, radii[i],
+			                                  (void *) (i + 1));
+		}
+	, S_spatialhash_size(hash) == OBJECTS
+	, "S_spatialhash_insert");
+
+	TEST(
+	, compare_queries(hash)
+	, "S_spatialhash_query_radius");
+
+	TEST(
+		S_vec3_set(&vec1, 0.0f, 0.0f, 0.0f);
+		count = S_spatialhash_query_radius(hash, &vec1, 50.0f, out, OBJECTS);
+		i = S_spatialhash_query_radius(hash, &vec1, 50.0f, out, 1);
+	, count > 1 && i == count
+	, "S_spatialhash_query_radius (truncated)");
+
+	TEST(
+		for (i = 0; i < OBJECTS; ++i)
+		{
+			/* mix of small moves within a cell and large moves across cells */
+			if (i % 2)
+			{
+				points[i].x += random_range(1.0f);
+				points[i].y += random_range(1.0f);
+			}
+			else
+			{
+				random_point(i);
+			}
+			S_spatialhash_move(hash, handles[i], points+i);
+		}
+	, compare_queries(hash)
+	, "S_spatialhash_move");
+
+	TEST(
+		for (i = 0; i < OBJECTS; i += 3)
+		{
+			S_spatialhash_remove(hash, handles[i]);
+			alive[i] = S_FALSE;
+		}
+	, S_spatialhash_size(hash) == OBJECTS - (OBJECTS + 2) / 3 &&
+	  compare_queries(hash)
+	, "S_spatialhash_remove");
+
+	TEST(
+		S_spatialhash_remove(hash, handles[0]);
+		b = SERRNO == S_INVALID_INDEX;
+		SERRNO = S_NO_ERROR;
+	, b
+	, "S_spatialhash_remove (invalid handle)");
+
+	TEST(
+		h = S_spatialhash_insert(hash, points, radii[0], (void *) 1);
+		handles[0] = h;
+		alive[0] = S_TRUE;
+	, h != S_SPATIALHASH_NONE && compare_queries(hash)
+	, "S_spatialhash_insert (reuse handle)");
+
+	TEST(
+		/* queries must stop widening once a large entry is gone */
+		S_vec3_set(&vec1, 0.0f, 0.0f, 0.0f);
+		h = S_spatialhash_insert(hash, &vec1, 100.0f, NULL);
+		b = hash->maxradius == 100.0f;
+		S_spatialhash_remove(hash, h);
+	, b && hash->maxradius < 2.0f && compare_queries(hash)
+	, "S_spatialhash_remove (largest radius)");
+
+	TIME(
+		for (i = 0; i < OBJECTS; ++i)
+		{
+			if (alive[i])
+			{
+				points[i].x += 0.1f;
+				S_spatialhash_move(hash, handles[i], points+i);
+			}
+		}
+	, "S_spatialhash_move", 100);
+
+	TIME(
+		for (i = 0; i < 1000; ++i)
+			S_spatialhash_query_radius(hash, points+i, 10.0f, out, OBJECTS);
+	, "S_spatialhash_query_radius", 100);
+
+	TEST(
+		S_spatialhash_clear(hash);
+		S_vec3_set(&vec1, 0.0f, 0.0f, 0.0f);
+		count = S_spatialhash_query_radius(hash, &vec1, 1000.0f, out, OBJECTS);
+	, S_spatialhash_size(hash) == 0 && count == 0
+	, "S_spatialhash_clear");
+
+	TEST(
+		S_spatialhash_delete(hash);
+	, 1
+	, "S_spatialhash_delete");
+
+	FREE();
+
+	return EXIT_SUCCESS;
+}
+
@@ -0,0 +1,293 @@
+/*
+ * This file is licensed under BSD 3-Clause.
+ * All license information is available in the included COPYING file.
+ */
+
+/*
+ * bvh.c
+ * Bounding volume hierarchy test suite.
+ *
+ * Author       : Finn Rayment <finn@rayment.fr>
+ * Date created : 18/10/2026
+ */
+
+#include "test_common.h"
+
+#define EPSILON 0.0001f
+
+#define OBJECTS  20000
+#define LEAF_MAX 16 /* largest leaf left by S_bvh_build */
+
+Svec3 mins[OBJECTS], maxs[OBJECTS];
+Ssize_t out[OBJECTS];
+Sbool seen[OBJECTS];
+
+Sfloat
+random_range(Sfloat range)
+{
+	return (S_random_next_float() * 2.0f - 1.0f) * range;
+}
+
+void
+random_box(Ssize_t i)
+{
+	S_vec3_set(mins+i, random_range(100.0f), random_range(100.0f),
+	           random_range(100.0f));
+	S_vec3_set(maxs+i, mins[i].x + S_random_next_float() * 4.0f,
+	           mins[i].y + S_random_next_float() * 4.0f,
+	           mins[i].z + S_random_next_float() * 4.0f);
+}
+
+Sbool
+overlaps(const Svec3 *amin,
+         const Svec3 *amax,
+         const Svec3 *bmin,
+         const Svec3 *bmax)
+{
+	return amin->x <= bmax->x && amax->x >= bmin->x &&
+	       amin->y <= bmax->y && amax->y >= bmin->y &&
+	       amin->z <= bmax->z && amax->z >= bmin->z;
+}
+
+/* check that the output of a query matches a brute-force test */
+Sbool
+compare(Ssize_t count,
+        const Sfrustum *frustum,
+        const Svec3 *min,
+        const Svec3 *max)
+{
+	Ssize_t i, expected;
+	Sbool v;
+	for (i = 0; i < OBJECTS; ++i)
+		seen[i] = S_FALSE;
+	for (i = 0; i < count; ++i)
+	{
+		if (seen[out[i]])
+			return S_FALSE;
+		seen[out[i]] = S_TRUE;
+	}
+	expected = 0;
+	for (i = 0; i < OBJECTS; ++i)
+	{
+		if (frustum)
+			v = S_frustum_intersects_bounds(frustum, mins+i, maxs+i);
+		else
+			v = overlaps(mins+i, maxs+i, min, max);
+		if (v != seen[i])
+			return S_FALSE;
+		expected += v;
+	}
+	return expected == count;
+}
+
+Sfloat
+distance(const Svec3 *point,
+         const Svec3 *min,
+         const Svec3 *max)
+{
+	Sfloat x, y, z;
+	x = S_max(S_max(min->x - point->x, 0.0f), point->x - max->x);
+	y = S_max(S_max(min->y - point->y, 0.0f), point->y - max->y);
+	z = S_max(S_max(min->z - point->z, 0.0f), point->z - max->z);
+	return S_sqrt(x*x + y*y + z*z);
+}
+
+Sfloat
+ray_entry(const Svec3 *origin,
+          const Svec3 *dir,
+          const Svec3 *min,
+          const Svec3 *max)
+{
+	Sfloat t1, t2, tmin, tmax;
+	t1 = (min->x - origin->x) / dir->x;
+	t2 = (max->x - origin->x) / dir->x;
+	tmin = S_min(t1, t2);
+	tmax = S_max(t1, t2);
+	t1 = (min->y - origin->y) / dir->y;
+	t2 = (max->y - origin->y) / dir->y;
+	tmin = S_max(tmin, S_min(t1, t2));
+	tmax = S_min(tmax, S_max(t1, t2));
+	t1 = (min->z - origin->z) / dir->z;
+	t2 = (max->z - origin->z) / dir->z;
+	tmin = S_max(tmin, S_min(t1, t2));
+	tmax = S_min(tmax, S_max(t1, t2));
+	tmin = S_max(tmin, 0.0f);
+	return tmax >= tmin ? tmin : -1.0f;
+}
+
+int
+main(void)
+{
+	Sbvh *bvh;
+	Scamera *camera;
+	Sfrustum frustum;
+	Svec3 vec1, vec2, dir;
+	Ssize_t i, j, count, hit, best;
+	Sfloat dist, bestdist, t;
+	Sbool b;
+
+	INIT();
+
+	for (i = 0; i < OBJECTS; ++i)
+		random_box(i);
+	camera = S_camera_new();
+	S_camera_set_size(camera, 800, 600);
+	S_frustum_load(&frustum, camera);
+
+	TEST(
+		bvh = S_bvh_new();
+	, bvh && S_bvh_size(bvh) == 0
+	, "S_bvh_new");
+
+	TEST(
+		count = S_bvh_query_frustum(bvh, &frustum, out, OBJECTS);
+		b = S_bvh_nearest(bvh, &vec1, &hit, &dist);
+	, count == 0 && !b
+	, "S_bvh_query_frustum (empty)");
+
+	TIME(
+		S_bvh_build(bvh, mins, maxs, OBJECTS);
+	, "S_bvh_build", 10);
+
+	TEST(
+	, S_bvh_size(bvh) == OBJECTS
+	, "S_bvh_build");
+
+	TEST(
+		count = S_bvh_query_frustum(bvh, &frustum, out, OBJECTS);
+	, count > 0 && compare(count, &frustum, NULL, NULL)
+	, "S_bvh_query_frustum");
+
+	TEST(
+		S_vec3_set(&vec1, -20.0f, -10.0f, -30.0f);
+		S_vec3_set(&vec2, 25.0f, 10.0f, 5.0f);
+		count = S_bvh_query_bounds(bvh, &vec1, &vec2, out, OBJECTS);
+	, count > 0 && compare(count, NULL, &vec1, &vec2)
+	, "S_bvh_query_bounds");
+
+	TEST(
+		j = S_bvh_query_bounds(bvh, &vec1, &vec2, out, 1);
+	, j == count
+	, "S_bvh_query_bounds (truncated)");
+
+	TEST(
+		b = S_TRUE;
+		for (j = 0; j < 100; ++j)
+		{
+			S_vec3_set(&vec1, random_range(150.0f), random_range(150.0f),
+			           random_range(150.0f));
+			S_vec3_set(&dir, random_range(1.0f), random_range(1.0f),
+			           random_range(1.0f));
+			/* brute force entry distance */
+			best = OBJECTS;
+			bestdist = 1000.0f;
+			for (i = 0; i < OBJECTS; ++i)
+			{
+				t = ray_entry(&vec1, &dir, mins+i, maxs+i);
+				if (t >= 0.0f && t < bestdist)
+				{
+					bestdist = t;
+					best = i;
+				}
+			}
+			if (S_bvh_raycast(bvh, &vec1, &dir, 1000.0f, &hit, &t))
+			{
+				if (best == OBJECTS || !S_epsilon(EPSILON, t, bestdist))
+					b = S_FALSE;
+			}
+			else if (best != OBJECTS)
+			{
+				b = S_FALSE;
+			}
+		}
+	, b
+	, "S_bvh_raycast");
+
+	TEST(
+		b = S_TRUE;
+		for (j = 0; j < 100; ++j)
+		{
+			S_vec3_set(&vec1, random_range(150.0f), random_range(150.0f),
+			           random_range(150.0f));
+			bestdist = 1e30f;
+			for (i = 0; i < OBJECTS; ++i)
+				bestdist = S_min(bestdist, distance(&vec1, mins+i, maxs+i));
+			if (!S_bvh_nearest(bvh, &vec1, &hit, &dist) ||
+			    !S_epsilon(EPSILON, dist, bestdist) ||
+			    !S_epsilon(EPSILON, distance(&vec1, mins+hit, maxs+hit), dist))
+				b = S_FALSE;
+		}
+	, b
+	, "S_bvh_nearest");
+
+	TEST(
+		for (i = 0; i < OBJECTS; ++i)
+		{
+			random_box(i);
+			S_bvh_set_bounds(bvh, i, mins+i, maxs+i);
+		}
+		S_bvh_refit(bvh);
+		count = S_bvh_query_frustum(bvh, &frustum, out, OBJECTS);
+	, compare(count, &frustum, NULL, NULL)
+	, "S_bvh_refit");
+
+	TIME(
+		S_bvh_refit(bvh);
+	, "S_bvh_refit", 100);
+
+	TIME(
+		S_bvh_query_frustum(bvh, &frustum, out, OBJECTS);
+	, "S_bvh_query_frustum", 1000);
+
+	TEST(
+		/* exponentially spaced boxes defeat splits at the spatial midpoint,
+		   which would nest the tree deeper than its traversal stacks */
+		for (i = 0; i < 250; ++i)
+		{
+			S_vec3_set(mins+i, ldexpf(1.0f, (i % 200) - 100), 0.0f, 0.0f);
+			maxs[i] = mins[i];
+		}
+		S_bvh_build(bvh, mins, maxs, 250);
+		S_vec3_set(&vec1, 0.0f, 0.0f, 0.0f);
+		b = S_bvh_nearest(bvh, &vec1, &hit, &dist) &&
+		    mins[hit].x == ldexpf(1.0f, -100);
+		S_vec3_set(&vec1, -1.0f, 0.5f, 0.5f);
+		count = S_bvh_query_bounds(bvh, &vec1, &vec1, out, OBJECTS);
+	, b && count == 0 && S_bvh_size(bvh) == 250
+	, "S_bvh_build (exponential spacing)");
+
+	TEST(
+		for (i = 0; i < OBJECTS; ++i)
+			S_vec3_set(mins+i, 0.0f, 0.0f, 0.0f);
+		for (i = 0; i < OBJECTS; ++i)
+			S_vec3_set(maxs+i, 1.0f, 1.0f, 1.0f);
+		S_bvh_build(bvh, mins, maxs, OBJECTS);
+		count = S_bvh_query_bounds(bvh, mins, maxs, out, OBJECTS);
+	, count == OBJECTS
+	, "S_bvh_build (degenerate)");
+
+	TEST(
+		/* coincident boxes have no plane to split at, but must still be split
+		   into leaves of a bounded size */
+		b = bvh->nlen > 1;
+		for (i = 0; i < bvh->nlen; ++i)
+		{
+			if (bvh->nodes[i].count > LEAF_MAX)
+				b = S_FALSE;
+		}
+		count = S_bvh_query_bounds(bvh, mins, mins, out, OBJECTS);
+	, b && count == OBJECTS
+	, "S_bvh_build (coincident)");
+
+	TEST(
+		S_bvh_delete(bvh);
+	, 1
+	, "S_bvh_delete");
+
+	S_camera_delete(camera);
+
+	FREE();
+
+	return EXIT_SUCCESS;
+}
+
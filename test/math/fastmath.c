@@ -0,0 +1,190 @@
+/*
+ * This file is licensed under BSD 3-Clause.
+ * All license information is available in the included COPYING file.
+ */
+
+/*
+ * fastmath.c
+ * Fast approximate math test suite.
+ *
+ * Author       : Finn Rayment <finn@rayment.fr>
+ * Date created : 18/10/2026
+ */
+
+#include "test_common.h"
+
+#define SAMPLES 1000000
+
+#define BOUND_RSQRT 5e-6
+#define BOUND_TRIG  5e-7
+
+volatile Sfloat sink;
+Sfloat values[SAMPLES];
+
+/* maximum relative error of S_fast_rsqrt over [1e-3,1e3] */
+double
+error_rsqrt(void)
+{
+	double x, err, worst;
+	Ssize_t i;
+	worst = 0.0;
+	for (i = 0; i < SAMPLES; ++i)
+	{
+		x = pow(10.0, -3.0 + 6.0 * (double) i / SAMPLES);
+		err = fabs(S_fast_rsqrt((Sfloat) x) * sqrt((double) (Sfloat) x) - 1.0);
+		worst = S_max(worst, err);
+	}
+	return worst;
+}
+
+/* maximum absolute error of S_fast_sin or S_fast_cos over [-range,range] */
+double
+error_trig(Sbool cosine,
+           double range)
+{
+	double x, err, worst;
+	Ssize_t i;
+	worst = 0.0;
+	for (i = 0; i < SAMPLES; ++i)
+	{
+		x = (double) (Sfloat) (range * (2.0 * i / SAMPLES - 1.0));
+		if (cosine)
+			err = fabs(S_fast_cos((Sfloat) x) - cos(x));
+		else
+			err = fabs(S_fast_sin((Sfloat) x) - sin(x));
+		worst = S_max(worst, err);
+	}
+	return worst;
+}
+
+/* maximum absolute error of S_fast_arccos over [-1,1] */
+double
+error_arccos(void)
+{
+	double x, err, worst;
+	Ssize_t i;
+	worst = 0.0;
+	for (i = 0; i <= SAMPLES; ++i)
+	{
+		x = (double) (Sfloat) (2.0 * i / SAMPLES - 1.0);
+		err = fabs(S_fast_arccos((Sfloat) x) - acos(x));
+		worst = S_max(worst, err);
+	}
+	return worst;
+}
+
+/* maximum absolute error of S_fast_arctan2 around the unit circle */
+double
+error_arctan2(void)
+{
+	double a, x, y, err, worst;
+	Ssize_t i;
+	worst = 0.0;
+	for (i = 0; i < SAMPLES; ++i)
+	{
+		a = 2.0 * 3.14159265358979 * i / SAMPLES;
+		x = (double) (Sfloat) ((1.0 + i % 7) * cos(a));
+		y = (double) (Sfloat) ((1.0 + i % 7) * sin(a));
+		err = fabs(S_fast_arctan2((Sfloat) y, (Sfloat) x) - atan2(y, x));
+		worst = S_max(worst, err);
+	}
+	return worst;
+}
+
+int
+main(void)
+{
+	Svec3 vec1;
+	Squat quat1, quat2;
+	Ssize_t i;
+
+	INIT();
+
+	for (i = 0; i < SAMPLES; ++i)
+		values[i] = S_random_next_float() * 100.0f + 0.01f;
+
+	TEST(
+	, error_rsqrt() < BOUND_RSQRT
+	, "S_fast_rsqrt");
+
+	TEST(
+	, error_trig(S_FALSE, 10000.0) < BOUND_TRIG
+	, "S_fast_sin");
+
+	TEST(
+	, error_trig(S_TRUE, 10000.0) < BOUND_TRIG
+	, "S_fast_cos");
+
+	TEST(
+	, error_arccos() < BOUND_TRIG && S_fast_arccos(2.0f) == 0.0f
+	, "S_fast_arccos");
+
+	TEST(
+	, error_arctan2() < BOUND_TRIG && S_fast_arctan2(0.0f, 0.0f) == 0.0f
+	, "S_fast_arctan2");
+
+	/* the library functions must agree whether or not ENABLE_FASTMATH is set */
+	TEST(
+		S_vec3_set(&vec1, 3.0f, -4.0f, 12.0f);
+		S_vec3_normalize(&vec1);
+	, S_epsilon(S_EPSILON, vec1.x, 3.0f / 13.0f) &&
+	  S_epsilon(S_EPSILON, vec1.y, -4.0f / 13.0f) &&
+	  S_epsilon(S_EPSILON, vec1.z, 12.0f / 13.0f)
+	, "S_vec3_normalize");
+
+	TEST(
+		S_vec3_set(&vec1, 0.0f, 1.0f, 0.0f);
+		S_quat_angleaxis(&quat1, &vec1, 90.0f);
+		S_quat_identity(&quat2);
+		S_quat_slerp(&quat2, &quat1, 0.5f);
+	, S_epsilon(S_EPSILON, S_quat_dot(&quat2, &quat2), 1.0f) &&
+	  S_epsilon(S_EPSILON, quat1.r, S_HALFSQRT2) &&
+	  S_epsilon(S_EPSILON, quat1.j, S_HALFSQRT2)
+	, "S_quat_angleaxis");
+
+	TIME(
+		for (i = 0; i < SAMPLES; ++i)
+			sink = 1.0f / S_sqrt(values[i]);
+	, "1 / S_sqrt", 10);
+
+	TIME(
+		for (i = 0; i < SAMPLES; ++i)
+			sink = S_fast_rsqrt(values[i]);
+	, "S_fast_rsqrt", 10);
+
+	TIME(
+		for (i = 0; i < SAMPLES; ++i)
+			sink = S_sin(values[i]);
+	, "S_sin", 10);
+
+	TIME(
+		for (i = 0; i < SAMPLES; ++i)
+			sink = S_fast_sin(values[i]);
+	, "S_fast_sin", 10);
+
+	TIME(
+		for (i = 0; i < SAMPLES; ++i)
+			sink = S_arccos(values[i] * 0.0099f);
+	, "S_arccos", 10);
+
+	TIME(
+		for (i = 0; i < SAMPLES; ++i)
+			sink = S_fast_arccos(values[i] * 0.0099f);
+	, "S_fast_arccos", 10);
+
+	TIME(
+		for (i = 0; i < SAMPLES; ++i)
+			sink = S_arctan2(values[i] - 50.0f, values[SAMPLES-1-i] - 50.0f);
+	, "S_arctan2", 10);
+
+	TIME(
+		for (i = 0; i < SAMPLES; ++i)
+			sink = S_fast_arctan2(values[i] - 50.0f,
+			                      values[SAMPLES-1-i] - 50.0f);
+	, "S_fast_arctan2", 10);
+
+	FREE();
+
+	return EXIT_SUCCESS;
+}
+
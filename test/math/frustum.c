@@ -0,0 +1,132 @@
+/*
+ * This file is licensed under BSD 3-Clause.
+ * All license information is available in the included COPYING file.
+ */
+
+/*
+ * frustum.c
+ * Frustum test suite.
+ *
+ * Author       : Finn Rayment <finn@rayment.fr>
+ * Date created : 18/10/2026
+ */
+
+#include "test_common.h"
+
+#define EPSILON S_EPSILON
+
+#define OBJECTS 100003
+
+Svec3 points[OBJECTS], mins[OBJECTS], maxs[OBJECTS];
+Sfloat radii[OBJECTS];
+Suint32 mask[(OBJECTS + 31) / 32];
+Ssize_t indices[OBJECTS];
+
+Sfloat
+random_range(Sfloat range)
+{
+	return (S_random_next_float() * 2.0f - 1.0f) * range;
+}
+
+int
+main(void)
+{
+	Scamera *camera;
+	Sfrustum frustum;
+	Svec3 vec1, vec2;
+	Ssize_t i, j, count;
+	Sbool b, v;
+
+	INIT();
+
+	camera = S_camera_new();
+	S_camera_set_size(camera, 800, 600);
+
+	TEST(
+		S_frustum_load(&frustum, camera);
+	, 1
+	, "S_frustum_load");
+
+	TEST(
+		S_vec3_set(&vec1, 0.0f, 0.0f, -10.0f);
+		S_vec3_set(&vec2, 0.0f, 0.0f, 10.0f);
+	, S_frustum_intersects_point(&frustum, &vec1) !=
+	  S_frustum_intersects_point(&frustum, &vec2)
+	, "S_frustum_intersects_point");
+
+	for (i = 0; i < OBJECTS; ++i)
+	{
+		S_vec3_set(points+i, random_range(150.0f), random_range(150.0f),
+		           random_range(150.0f));
+		radii[i] = S_random_next_float() * 5.0f;
+		S_vec3_copy(mins+i, points+i);
+		S_vec3_set(maxs+i, points[i].x + S_random_next_float() * 5.0f,
+		           points[i].y + S_random_next_float() * 5.0f,
+		           points[i].z + S_random_next_float() * 5.0f);
+	}
+
+	TEST(
+		S_vec3_set(&vec1, 0.0f, 0.0f, -10.0f);
+		S_vec3_set(&vec2, 1.0f, 1.0f, -9.0f);
+		b = S_frustum_intersects_bounds(&frustum, &vec1, &vec2);
+		S_vec3_set(&vec1, 0.0f, 0.0f, 10.0f);
+		S_vec3_set(&vec2, 1.0f, 1.0f, 11.0f);
+	, b != S_frustum_intersects_bounds(&frustum, &vec1, &vec2)
+	, "S_frustum_intersects_bounds");
+
+	TEST(
+		count = S_frustum_cull_spheres(&frustum, points, radii, OBJECTS,
+		                               mask, indices);
+		b = S_TRUE;
+		j = 0;
+		for (i = 0; i < OBJECTS; ++i)
+		{
+			v = S_frustum_intersects_sphere(&frustum, points+i, radii[i]);
+			if (v != ((mask[i / 32] >> (i % 32)) & 1))
+				b = S_FALSE;
+			if (v && (j >= count || indices[j++] != i))
+				b = S_FALSE;
+		}
+	, b && j == count && count > 0 && count < OBJECTS
+	, "S_frustum_cull_spheres");
+
+	TEST(
+		count = S_frustum_cull_bounds(&frustum, mins, maxs, OBJECTS,
+		                              mask, indices);
+		b = S_TRUE;
+		j = 0;
+		for (i = 0; i < OBJECTS; ++i)
+		{
+			v = S_frustum_intersects_bounds(&frustum, mins+i, maxs+i);
+			if (v != ((mask[i / 32] >> (i % 32)) & 1))
+				b = S_FALSE;
+			if (v && (j >= count || indices[j++] != i))
+				b = S_FALSE;
+		}
+	, b && j == count && count > 0 && count < OBJECTS
+	, "S_frustum_cull_bounds");
+
+	TEST(
+		j = S_frustum_cull_bounds(&frustum, mins, maxs, OBJECTS, NULL, NULL);
+	, j == count
+	, "S_frustum_cull_bounds (count only)");
+
+	TIME(
+		S_frustum_cull_spheres(&frustum, points, radii, OBJECTS, mask, NULL);
+	, "S_frustum_cull_spheres (mask)", 100);
+
+	TIME(
+		S_frustum_cull_bounds(&frustum, mins, maxs, OBJECTS, mask, NULL);
+	, "S_frustum_cull_bounds (mask)", 100);
+
+	TIME(
+		S_frustum_cull_bounds(&frustum, mins, maxs, OBJECTS, NULL, indices);
+	, "S_frustum_cull_bounds (indices)", 100);
+
+	S_camera_delete(camera);
+
+	FREE();
+
+	return EXIT_SUCCESS;
+}
+
@@ -0,0 +1,232 @@
+/*
+ * This file is licensed under BSD 3-Clause.
+ * All license information is available in the included COPYING file.
+ */
+
+/*
+ * hierarchy.c
+ * Flat transform hierarchy test suite.
+ *
+ * Author       : Finn Rayment <finn@rayment.fr>
+ * Date created : 18/10/2026
+ */
+
+#include "test_common.h"
+
+#define EPSILON 0.0001f
+
+#define NODES 2048
+
+void
+world_matrix(const Stransform *transform,
+             Smat4 *dest)
+{
+	Smat4 local;
+	S_transform_get_transformation_matrix(transform, &local);
+	if (transform->parent)
+	{
+		world_matrix(transform->parent, dest);
+		S_mat4_multiply(dest, &local);
+	}
+	else
+	{
+		S_mat4_copy(dest, &local);
+	}
+}
+
+int
+main(void)
+{
+	Shierarchy *hierarchy;
+	Stransform *a, *b, *c, *tmp, *tree[NODES];
+	Suint32 ha, hb, hc, hd, handles[NODES];
+	Svec3 vec1, vec2;
+	Squat quat1;
+	Smat4 mat1, mat2;
+	Suint32 i, p;
+	Sbool b1;
+
+	INIT();
+
+	TEST(
+		hierarchy = S_hierarchy_new();
+	, hierarchy && S_hierarchy_size(hierarchy) == 0
+	, "S_hierarchy_new");
+
+	TEST(
+		ha = S_hierarchy_add(hierarchy, S_HIERARCHY_NONE);
+		hb = S_hierarchy_add(hierarchy, ha);
+		hc = S_hierarchy_add(hierarchy, hb);
+	, ha != S_HIERARCHY_NONE && hb != S_HIERARCHY_NONE &&
+	  hc != S_HIERARCHY_NONE && S_hierarchy_size(hierarchy) == 3
+	, "S_hierarchy_add");
+
+	TEST(
+		p = S_hierarchy_add(hierarchy, 1000);
+		b1 = SERRNO == S_INVALID_INDEX;
+		SERRNO = S_NO_ERROR;
+	, p == S_HIERARCHY_NONE && b1
+	, "S_hierarchy_add (invalid parent)");
+
+	TEST(
+	, S_hierarchy_get_parent(hierarchy, ha) == S_HIERARCHY_NONE &&
+	  S_hierarchy_get_parent(hierarchy, hb) == ha &&
+	  S_hierarchy_get_parent(hierarchy, hc) == hb
+	, "S_hierarchy_get_parent");
+
+	TEST(
+		S_vec3_set(&vec1, 1.0f, 2.0f, 3.0f);
+		S_transform_set_pos(S_hierarchy_get_transform(hierarchy, ha), &vec1);
+		S_transform_set_pos(S_hierarchy_get_transform(hierarchy, hb), &vec1);
+		S_transform_set_pos(S_hierarchy_get_transform(hierarchy, hc), &vec1);
+		S_hierarchy_update(hierarchy);
+		S_hierarchy_get_world_matrix(hierarchy, hc, &mat1);
+	, S_epsilon(EPSILON, mat1.m03, 3.0f) &&
+	  S_epsilon(EPSILON, mat1.m13, 6.0f) &&
+	  S_epsilon(EPSILON, mat1.m23, 9.0f)
+	, "S_hierarchy_update");
+
+	TEST(
+		S_hierarchy_set_parent(hierarchy, ha, hc);
+	, S_hierarchy_get_parent(hierarchy, ha) == hc &&
+	  S_hierarchy_get_parent(hierarchy, hb) == S_HIERARCHY_NONE &&
+	  S_hierarchy_get_parent(hierarchy, hc) == hb
+	, "S_hierarchy_set_parent (cyclic)");
+
+	TEST(
+		S_hierarchy_get_world_matrix(hierarchy, ha, &mat1);
+		b1 = SERRNO == S_INVALID_OPERATION;
+		SERRNO = S_NO_ERROR;
+	, b1
+	, "S_hierarchy_get_world_matrix (dirty)");
+
+	TEST(
+		S_hierarchy_remove(hierarchy, hc);
+		S_hierarchy_update(hierarchy);
+		S_hierarchy_get_world_matrix(hierarchy, ha, &mat1);
+	, S_hierarchy_size(hierarchy) == 2 &&
+	  S_hierarchy_get_parent(hierarchy, ha) == hb &&
+	  S_epsilon(EPSILON, mat1.m03, 2.0f) &&
+	  S_epsilon(EPSILON, mat1.m13, 4.0f) &&
+	  S_epsilon(EPSILON, mat1.m23, 6.0f)
+	, "S_hierarchy_remove");
+
+	TEST(
+		hd = S_hierarchy_add(hierarchy, S_HIERARCHY_NONE);
+	, hd == hc
+	, "S_hierarchy_add (reuse handle)");
+
+	TEST(
+		S_hierarchy_delete(hierarchy);
+	, 1
+	, "S_hierarchy_delete");
+
+	/* compare against the pointer-based transform graph */
+	for (i = 0; i < NODES; ++i)
+	{
+		tree[i] = S_transform_new();
+		S_vec3_set(&vec1, S_random_next_float(), S_random_next_float(),
+		           S_random_next_float());
+		S_vec3_set(&vec2, 30.0f * S_random_next_float(),
+		           30.0f * S_random_next_float(),
+		           30.0f * S_random_next_float());
+		S_vec3_to_quat(&quat1, &vec2);
+		S_transform_set_pos(tree[i], &vec1);
+		S_transform_set_rot(tree[i], &quat1);
+		S_vec3_fill(&vec2, 0.9f + 0.2f * S_random_next_float());
+		S_transform_set_scale(tree[i], &vec2);
+		if (i > 0)
+		{
+			p = (Suint32) S_random_next_int32() % i;
+			if (i % 64 != 0)
+				S_transform_set_parent(tree[i], tree[p]);
+		}
+	}
+
+	TEST(
+		hierarchy = S_hierarchy_new();
+		for (i = 0; i < NODES; ++i)
+		{
+			if (!tree[i]->parent)
+				S_hierarchy_add_tree(hierarchy, tree[i], S_HIERARCHY_NONE);
+		}
+	, S_hierarchy_size(hierarchy) == NODES
+	, "S_hierarchy_add_tree");
+
+	TEST(
+		/* build again node by node so that handles map to tree indices */
+		S_hierarchy_delete(hierarchy);
+		hierarchy = S_hierarchy_new();
+		for (i = 0; i < NODES; ++i)
+			handles[i] = S_hierarchy_add(hierarchy, S_HIERARCHY_NONE);
+		for (i = 0; i < NODES; ++i)
+		{
+			tmp = S_hierarchy_get_transform(hierarchy, handles[i]);
+			S_transform_get_pos(tree[i], &vec1);
+			S_transform_set_pos(tmp, &vec1);
+			S_transform_get_rot(tree[i], &quat1);
+			S_transform_set_rot(tmp, &quat1);
+			S_transform_get_scale(tree[i], &vec1);
+			S_transform_set_scale(tmp, &vec1);
+		}
+		for (i = 0; i < NODES; ++i)
+		{
+			for (p = 0; p < NODES; ++p)
+			{
+				if (tree[i]->parent == tree[p])
+				{
+					S_hierarchy_set_parent(hierarchy, handles[i], handles[p]);
+					break;
+				}
+			}
+		}
+		S_hierarchy_update(hierarchy);
+		b1 = S_TRUE;
+		for (i = 0; i < NODES; ++i)
+		{
+			world_matrix(tree[i], &mat1);
+			S_hierarchy_get_world_matrix(hierarchy, handles[i], &mat2);
+			if (!S_mat4_equals(EPSILON, &mat1, &mat2))
+				b1 = S_FALSE;
+		}
+	, b1
+	, "S_hierarchy_get_world_matrix (compare with transform)");
+
+	TIME(
+		S_hierarchy_update(hierarchy);
+	, "S_hierarchy_update", 1000);
+
+	TEST(
+		a = S_transform_new();
+		b = S_transform_new();
+		c = S_transform_new();
+		S_transform_set_parent(b, a);
+		S_transform_set_parent(c, b);
+		S_vec3_set(&vec1, 0.0f, 1.0f, 0.0f);
+		S_transform_set_pos(b, &vec1);
+		S_transform_set_pos(c, &vec1);
+		S_hierarchy_delete(hierarchy);
+		hierarchy = S_hierarchy_new();
+		ha = S_hierarchy_add_tree(hierarchy, a, S_HIERARCHY_NONE);
+		S_hierarchy_update(hierarchy);
+		/* the deepest node is the last one added */
+		S_hierarchy_get_world_matrix(hierarchy, 2, &mat1);
+		world_matrix(c, &mat2);
+	, S_mat4_equals(EPSILON, &mat1, &mat2)
+	, "S_hierarchy_add_tree (chain)");
+
+	TEST(
+		S_hierarchy_delete(hierarchy);
+		S_transform_delete(a);
+		S_transform_delete(b);
+		S_transform_delete(c);
+		for (i = 0; i < NODES; ++i)
+			S_transform_delete(tree[i]);
+	, 1
+	, "S_hierarchy_delete");
+
+	FREE();
+
+	return EXIT_SUCCESS;
+}
+
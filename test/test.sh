@@ -27,12 +27,19 @@ assert_pass() {
 }
 
 assert_pass algorithm/isort
+assert_pass algorithm/meshopt
 assert_pass algorithm/qsort
+assert_pass algorithm/rsort
+assert_pass algorithm/skyline
 assert_pass collections/linkedlist
+assert_pass collections/spatialhash
 assert_pass collections/tree
 assert_pass concurrency/mutex
 assert_pass concurrency/thread
 assert_pass math/math
+assert_pass math/bvh
+assert_pass math/fastmath
+assert_pass math/frustum
 assert_pass math/mat3
 assert_pass math/mat4
 assert_pass math/quat
@@ -40,10 +47,15 @@ assert_pass math/vec2
 assert_pass math/vec3
 assert_pass math/vec4
 assert_pass math/transform
+assert_pass math/hierarchy
 assert_pass net/tcp_single_block
 assert_pass net/tcp_single_noblock
+assert_pass util/assets
+assert_pass util/hash
 assert_pass util/random
 assert_pass util/string
+assert_pass video/atlas
+assert_pass video/texformat
 
 echo "--- $passed/$total tests passed ---"
 if [ ! $passed -eq $total ];
@@ -0,0 +1,144 @@
+/*
+ * This file is licensed under BSD 3-Clause.
+ * All license information is available in the included COPYING file.
+ */
+
+/*
+ * assets.c
+ * Asset cache test suite.
+ *
+ * Author       : Finn Rayment <finn@rayment.fr>
+ * Date created : 18/10/2026
+ */
+
+#include <stdio.h>
+
+#include "test_common.h"
+
+#define ASSETS 100
+
+/* stand-ins for loaded assets, which are never dereferenced by the cache */
+Suint32 objects[ASSETS];
+Schar key[32];
+
+const Schar *
+get_key(Ssize_t i)
+{
+	sprintf(key, "asset%d", (int) i);
+	return key;
+}
+
+/* give back a reference, freeing the entry the way the cache would without
+   deleting the stand-in asset */
+Sbool
+release(Sassets *assets,
+        const void *data)
+{
+	_Sasset *asset;
+	asset = _S_assets_find_data(assets, data);
+	if (!asset || !_S_assets_unref(assets, asset))
+		return S_FALSE;
+	S_memory_delete(asset->key);
+	S_memory_delete(asset);
+	return S_TRUE;
+}
+
+int
+main(void)
+{
+	Sassets *assets;
+	Ssize_t i, memory;
+	Sbool b;
+
+	INIT();
+
+	TEST(
+		assets = S_assets_new();
+	, assets && S_assets_get_count(assets, S_ASSET_TEXTURE) == 0
+	, "S_assets_new");
+
+	TEST(
+		b = S_TRUE;
+		memory = 0;
+		for (i = 0; i < ASSETS; ++i)
+		{
+			b = b && !_S_assets_acquire(assets, S_ASSET_TEXTURE, get_key(i));
+			_S_assets_insert(assets, S_ASSET_TEXTURE, get_key(i), objects+i,
+			                 16 * (i + 1));
+			memory += 16 * (i + 1);
+		}
+		for (i = 0; i < ASSETS; ++i)
+			b = b && S_assets_get_refs(assets, objects+i) == 1;
+	, b && S_assets_get_count(assets, S_ASSET_TEXTURE) == ASSETS &&
+	  S_assets_get_memory(assets, S_ASSET_TEXTURE) == memory
+	, "_S_assets_insert");
+
+	TEST(
+		b = S_TRUE;
+		for (i = 0; i < ASSETS; ++i)
+		{
+			b = b && _S_assets_acquire(assets, S_ASSET_TEXTURE,
+			                           get_key(i)) == objects+i &&
+			    S_assets_get_refs(assets, objects+i) == 2;
+		}
+	, b && S_assets_get_count(assets, S_ASSET_TEXTURE) == ASSETS
+	, "_S_assets_acquire (repeat load)");
+
+	TEST(
+		b = !_S_assets_acquire(assets, S_ASSET_SOUND, get_key(0));
+	, b && S_assets_get_count(assets, S_ASSET_SOUND) == 0
+	, "_S_assets_acquire (other type)");
+
+	TEST(
+		b = S_TRUE;
+		for (i = 0; i < ASSETS; ++i)
+			b = b && !release(assets, objects+i);
+		for (i = 0; i < ASSETS; ++i)
+			b = b && S_assets_get_refs(assets, objects+i) == 1;
+	, b && S_assets_get_count(assets, S_ASSET_TEXTURE) == ASSETS
+	, "_S_assets_unref");
+
+	TEST(
+		b = S_TRUE;
+		for (i = 0; i < ASSETS; ++i)
+			b = b && release(assets, objects+i);
+		for (i = 0; i < ASSETS; ++i)
+			b = b && S_assets_get_refs(assets, objects+i) == 0;
+	, b && S_assets_get_count(assets, S_ASSET_TEXTURE) == 0 &&
+	  S_assets_get_memory(assets, S_ASSET_TEXTURE) == 0
+	, "_S_assets_unref (last reference)");
+
+	TEST(
+		b = !_S_assets_acquire(assets, S_ASSET_TEXTURE, get_key(0));
+		_S_assets_insert(assets, S_ASSET_TEXTURE, get_key(0), objects, 16);
+		b = b && _S_assets_acquire(assets, S_ASSET_TEXTURE,
+		                           get_key(0)) == objects &&
+		    S_assets_get_refs(assets, objects) == 2;
+		b = b && !release(assets, objects) && release(assets, objects);
+	, b && S_assets_get_count(assets, S_ASSET_TEXTURE) == 0
+	, "_S_assets_insert (load again)");
+
+	TEST(
+		S_assets_release(assets, objects);
+		b = SERRNO == S_INVALID_INDEX;
+		SERRNO = S_NO_ERROR;
+	, b
+	, "S_assets_release (released asset)");
+
+	TEST(
+		S_assets_get_count(assets, _S_ASSET_TYPES);
+		b = SERRNO == S_INVALID_ENUM;
+		SERRNO = S_NO_ERROR;
+	, b
+	, "S_assets_get_count (invalid type)");
+
+	TEST(
+		S_assets_delete(assets);
+	, 1
+	, "S_assets_delete");
+
+	FREE();
+
+	return EXIT_SUCCESS;
+}
+
@@ -0,0 +1,58 @@
+/*
+ * This file is licensed under BSD 3-Clause.
+ * All license information is available in the included COPYING file.
+ */
+
+/*
+ * hash.c
+ * Non-cryptographic hash function test suite.
+ *
+ * Author       : Finn Rayment <finn@rayment.fr>
+ * Date created : 18/10/2026
+ */
+
+#include "test_common.h"
+
+int
+main(void)
+{
+	Suint32 data;
+	Sbool b;
+
+	INIT();
+
+	TEST(
+	, S_hash_fnv1a("", 0) == 0x811c9dc5u &&
+	  S_hash_fnv1a(NULL, 0) == 0x811c9dc5u
+	, "S_hash_fnv1a (empty)");
+
+	TEST(
+	, S_hash_fnv1a("a", 1) == 0xe40c292cu &&
+	  S_hash_fnv1a("foobar", 6) == 0xbf9cf968u
+	, "S_hash_fnv1a");
+
+	TEST(
+	, S_hash_fnv1a_string("") == 0x811c9dc5u &&
+	  S_hash_fnv1a_string("a") == 0xe40c292cu &&
+	  S_hash_fnv1a_string("foobar") == 0xbf9cf968u
+	, "S_hash_fnv1a_string");
+
+	TEST(
+		data = 0xdeadbeefu;
+	, S_hash_fnv1a_string("u_projection") ==
+	  S_hash_fnv1a("u_projection", 12) &&
+	  S_hash_fnv1a(&data, sizeof(data)) != S_hash_fnv1a(&data, 2)
+	, "S_hash_fnv1a (consistency)");
+
+	TEST(
+		S_hash_fnv1a_string(NULL);
+		b = SERRNO == S_INVALID_VALUE;
+		SERRNO = S_NO_ERROR;
+	, b
+	, "S_hash_fnv1a_string (invalid)");
+
+	FREE();
+
+	return EXIT_SUCCESS;
+}
+
@@ -0,0 +1,151 @@
+/*
+ * This file is licensed under BSD 3-Clause.
+ * All license information is available in the included COPYING file.
+ */
+
+/*
+ * atlas.c
+ * Texture atlas packing test suite.
+ *
+ * Author       : Finn Rayment <finn@rayment.fr>
+ * Date created : 18/10/2026
+ */
+
+#include <string.h>
+
+#include "test_common.h"
+
+#define SIZE    128
+#define SPRITES 64
+
+Suint8 image[SIZE*SIZE*4];
+Suint8 layer[SIZE*SIZE*4];
+Suint8 used[SPRITES*SIZE*SIZE];
+
+/* fill a sprite with its own index, so that its texels may be told apart */
+void
+fill(Suint32 index,
+     Suint32 w,
+     Suint32 h)
+{
+	memset(image, (Suint8) (index + 1), w * h * 4);
+}
+
+/* check that each sprite and its padding lie within a layer and cover no
+   other */
+Sbool
+no_overlap(const Satlas *atlas,
+           Suint32 layers)
+{
+	const Satlas_sprite *s;
+	Suint32 i, x, y;
+	memset(used, 0, sizeof(used));
+	for (i = 0; i < atlas->len; ++i)
+	{
+		s = atlas->sprites + i;
+		if (s->layer >= layers || s->x < S_ATLAS_PADDING ||
+		    s->y < S_ATLAS_PADDING ||
+		    s->x + s->width + S_ATLAS_PADDING > SIZE ||
+		    s->y + s->height + S_ATLAS_PADDING > SIZE)
+			return S_FALSE;
+		for (y = s->y - S_ATLAS_PADDING;
+		     y < s->y + s->height + S_ATLAS_PADDING; ++y)
+		{
+			for (x = s->x - S_ATLAS_PADDING;
+			     x < s->x + s->width + S_ATLAS_PADDING; ++x)
+			{
+				if (used[(s->layer*SIZE+y)*SIZE+x])
+					return S_FALSE;
+				used[(s->layer*SIZE+y)*SIZE+x] = 1;
+			}
+		}
+	}
+	return S_TRUE;
+}
+
+/* check that every texel of a sprite and its padding holds its index */
+Sbool
+filled(const Satlas *atlas,
+       Suint32 index)
+{
+	const Satlas_sprite *s;
+	Suint32 x, y;
+	s = atlas->sprites + index;
+	for (y = s->y - S_ATLAS_PADDING;
+	     y < s->y + s->height + S_ATLAS_PADDING; ++y)
+	{
+		for (x = s->x - S_ATLAS_PADDING;
+		     x < s->x + s->width + S_ATLAS_PADDING; ++x)
+		{
+			if (layer[(y*SIZE+x)*4] != index + 1)
+				return S_FALSE;
+		}
+	}
+	return S_TRUE;
+}
+
+int
+main(void)
+{
+	Satlas *atlas;
+	Suint32 i, w, h, layers, idx;
+	Sbool b;
+
+	INIT();
+
+	atlas = S_atlas_new(SIZE);
+
+	TEST(
+		b = S_TRUE;
+		for (i = 0; i < SPRITES; ++i)
+		{
+			w = 4 + (i * 7) % 40;
+			h = 4 + (i * 13) % 40;
+			fill(i, w, h);
+			b = b && S_atlas_add_pixels(atlas, image, w, h) == i;
+		}
+	, b && atlas->len == SPRITES
+	, "S_atlas_add_pixels");
+
+	TEST(
+		idx = S_atlas_add_pixels(atlas, image, SIZE, 4);
+		b = idx == S_ATLAS_INVALID && SERRNO == S_INVALID_VALUE;
+		SERRNO = S_NO_ERROR;
+	, b && atlas->len == SPRITES
+	, "S_atlas_add_pixels (too large)");
+
+	TEST(
+		layers = _S_atlas_pack(atlas, 1);
+	, layers == 0
+	, "_S_atlas_pack (limit)");
+
+	TEST(
+		layers = _S_atlas_pack(atlas, SPRITES);
+	, layers > 1 && layers <= SPRITES && no_overlap(atlas, layers)
+	, "_S_atlas_pack");
+
+	TEST(
+		b = S_TRUE;
+		_S_atlas_fill(atlas, 0, layer);
+		for (i = 0; i < SPRITES; ++i)
+		{
+			if (atlas->sprites[i].layer == 0)
+				b = b && filled(atlas, i);
+		}
+	, b
+	, "_S_atlas_fill");
+
+	TEST(
+		S_atlas_get_layer(atlas, S_ATLAS_INVALID);
+		b = SERRNO == S_INVALID_INDEX;
+		SERRNO = S_NO_ERROR;
+	, b
+	, "S_atlas_get_layer (invalid)");
+
+	S_atlas_delete(atlas);
+
+	FREE();
+
+	return EXIT_SUCCESS;
+}
+
@@ -0,0 +1,183 @@
+/*
+ * This file is licensed under BSD 3-Clause.
+ * All license information is available in the included COPYING file.
+ */
+
+/*
+ * texformat.c
+ * Compressed texture format test suite.
+ *
+ * Author       : Finn Rayment <finn@rayment.fr>
+ * Date created : 18/10/2026
+ */
+
+#include <string.h>
+
+#include "test_common.h"
+
+#define SIZE 256
+
+Suint8 rgba[SIZE*SIZE*4];
+Suint8 blocks[SIZE*SIZE];
+
+/* write bits into a block, least significant first */
+void
+set_bits(Suint8 *block,
+         Suint32 pos,
+         Suint32 count,
+         Suint32 value)
+{
+	Suint32 i;
+	for (i = 0; i < count; ++i, ++pos)
+	{
+		if ((value >> i) & 1)
+			block[pos>>3] |= 1 << (pos & 7);
+		else
+			block[pos>>3] &= ~(1 << (pos & 7));
+	}
+}
+
+Sbool
+texel_is(Suint32 i,
+         Suint8 r,
+         Suint8 g,
+         Suint8 b,
+         Suint8 a)
+{
+	return rgba[i*4] == r && rgba[i*4+1] == g && rgba[i*4+2] == b &&
+	       rgba[i*4+3] == a;
+}
+
+int
+main(void)
+{
+	Suint8 block[16];
+	Ssize_t size;
+	Suint32 i;
+	Sbool b;
+
+	INIT();
+
+	TEST(
+	, S_texformat_get_size(S_TEXFORMAT_BC1, 4, 4) == 8 &&
+	  S_texformat_get_size(S_TEXFORMAT_BC1, 5, 5) == 32 &&
+	  S_texformat_get_size(S_TEXFORMAT_BC7, 1, 1) == 16 &&
+	  S_texformat_get_size(S_TEXFORMAT_ETC2_RGBA, 8, 12) == 96
+	, "S_texformat_get_size");
+
+	TEST(
+		size = S_texformat_get_size(_S_TEXFORMAT_COUNT, 4, 4);
+		b = size == 0 && SERRNO == S_INVALID_ENUM;
+		SERRNO = S_NO_ERROR;
+	, b
+	, "S_texformat_get_size (invalid format)");
+
+	TEST(
+		/* red and blue endpoints, with texels 0 to 3 using each index */
+		memset(block, 0, sizeof(block));
+		block[1] = 0xF8;
+		block[2] = 0x1F;
+		block[4] = 0xE4;
+		S_texformat_decode(S_TEXFORMAT_BC1, block, 4, 4, rgba);
+	, texel_is(0, 255, 0, 0, 255) && texel_is(1, 0, 0, 255, 255) &&
+	  texel_is(2, 170, 0, 85, 255) && texel_is(3, 85, 0, 170, 255) &&
+	  texel_is(15, 255, 0, 0, 255)
+	, "S_texformat_decode (BC1)");
+
+	TEST(
+		/* the same endpoints swapped select three colours and transparency */
+		memset(block, 0, sizeof(block));
+		block[0] = 0x1F;
+		block[3] = 0xF8;
+		block[4] = 0xE4;
+		S_texformat_decode(S_TEXFORMAT_BC1, block, 4, 4, rgba);
+	, texel_is(0, 0, 0, 255, 255) && texel_is(2, 127, 0, 127, 255) &&
+	  texel_is(3, 0, 0, 0, 0)
+	, "S_texformat_decode (BC1 with alpha)");
+
+	TEST(
+		/* every red index is 1, every green index is 7 */
+		memset(block, 0, sizeof(block));
+		block[0] = 255;
+		for (i = 0; i < 16; ++i)
+			set_bits(block, 16 + i * 3, 3, 1);
+		block[9] = 255;
+		memset(block + 10, 0xFF, 6);
+		S_texformat_decode(S_TEXFORMAT_BC5, block, 4, 4, rgba);
+		b = S_TRUE;
+		for (i = 0; i < 16; ++i)
+			b = b && texel_is(i, 0, 255, 0, 255);
+	, b
+	, "S_texformat_decode (BC5)");
+
+	TEST(
+		/* mode 6, from black and transparent to white and opaque with every
+		   index at its largest */
+		memset(block, 0xFF, sizeof(block));
+		block[0] = 0x40;
+		for (i = 0; i < 8; i += 2)
+			set_bits(block, 7 + i * 7, 7, 0);
+		set_bits(block, 63, 1, 0);
+		S_texformat_decode(S_TEXFORMAT_BC7, block, 4, 4, rgba);
+		b = texel_is(0, 120, 120, 120, 120);
+		for (i = 1; i < 16; ++i)
+			b = b && texel_is(i, 255, 255, 255, 255);
+	, b
+	, "S_texformat_decode (BC7)");
+
+	TEST(
+		/* differential mode, red 16 on the left and 17 on the right */
+		memset(block, 0, sizeof(block));
+		block[0] = (16 << 3) | 1;
+		block[3] = 0x02;
+		S_texformat_decode(S_TEXFORMAT_ETC2_RGB, block, 4, 4, rgba);
+	, texel_is(0, 134, 2, 2, 255) && texel_is(4, 134, 2, 2, 255) &&
+	  texel_is(2, 142, 2, 2, 255) && texel_is(15, 142, 2, 2, 255)
+	, "S_texformat_decode (ETC2)");
+
+	TEST(
+		memset(block, 0, sizeof(block));
+		block[0] = 128;
+		block[1] = 0x10;
+		S_texformat_decode(S_TEXFORMAT_ETC2_RGBA, block, 4, 4, rgba);
+	, texel_is(0, 2, 2, 2, 125) && texel_is(15, 2, 2, 2, 125)
+	, "S_texformat_decode (ETC2 with alpha)");
+
+	TEST(
+		/* two blocks of red and blue cut to 5x3 texels */
+		memset(blocks, 0, 16);
+		blocks[1] = 0xF8;
+		blocks[8] = 0x1F;
+		memset(rgba, 0, 64);
+		S_texformat_decode(S_TEXFORMAT_BC1, blocks, 5, 3, rgba);
+	, texel_is(3, 255, 0, 0, 255) && texel_is(4, 0, 0, 255, 255) &&
+	  texel_is(14, 0, 0, 255, 255) && texel_is(15, 0, 0, 0, 0)
+	, "S_texformat_decode (edges)");
+
+	TEST(
+		S_texformat_decode(S_TEXFORMAT_BC1, NULL, 4, 4, rgba);
+		b = SERRNO == S_INVALID_VALUE;
+		SERRNO = S_NO_ERROR;
+	, b
+	, "S_texformat_decode (null)");
+
+	for (i = 0; i < SIZE * SIZE; ++i)
+		blocks[i] = S_random_next_uint32();
+
+	TIME(
+		S_texformat_decode(S_TEXFORMAT_BC1, blocks, SIZE, SIZE, rgba);
+	, "S_texformat_decode (BC1)", 100);
+
+	TIME(
+		S_texformat_decode(S_TEXFORMAT_BC7, blocks, SIZE, SIZE, rgba);
+	, "S_texformat_decode (BC7)", 100);
+
+	TIME(
+		S_texformat_decode(S_TEXFORMAT_ETC2_RGBA, blocks, SIZE, SIZE, rgba);
+	, "S_texformat_decode (ETC2)", 100);
+
+	FREE();
+
+	return EXIT_SUCCESS;
+}
+
@@ -35,6 +35,7 @@ DEBUG_ANALYZE=1
 # code and library toggles - 0 = off, 1 = on
 ENABLE_ASSIMP=1
 ENABLE_OPENMP=1
+ENABLE_FASTMATH=0
 
 # -----------------------------------------------------
 # LINUX/UNIX VARIABLES